@@ -3,8 +3,16 @@
  *
  * The functions here manage pools of often-used buffers of fixed-size.  It
  * adds value by greatly reducing the number and strength of calls to the
- * underlying platform's memory management. It also adds headers and footer to
- * detect misuse of buffers by its callers.
+ * underlying platform's memory management.  Buffers are carved out of larger
+ * slabs, and each thread keeps a small magazine of free buffers per pool so
+ * that most allocations and frees do not need to take the pool lock.  Each
+ * thread's magazines have their own lock, which only a thread walking the
+ * slabs ever contends for.
+ *
+ * Each buffer header starts with a magic number, so a client writing past
+ * the end of its buffer is caught when the next buffer in the slab is
+ * allocated or freed.  In self-checking builds, it also adds footers and
+ * further checks to detect misuse of buffers by its callers.
  */
 
 #include "copyright.h"
@@ -12,31 +20,49 @@
 #include "config.h"
 #include "externs.h"
 
+#if defined(SELFCHECK)
+#define POOL_MAGIC
+#endif // SELFCHECK
+
+#define POOL_SLAB_SIZE  65536   // Target size of one slab.
+#define POOL_MAGAZINE   16      // Free buffers cached per thread and pool.
+
+// Buffer states.
+//
+#define POOL_INUSE      1       // Allocated to a client.
+#define POOL_FREE       2       // On the pool freelist.
+#define POOL_CACHED     3       // In some thread's magazine.
+#define POOL_LOST       4       // Header was corrupted.  Never reused.
+
 /*! \brief Per-buffer header to manage and organize client allocation.
  *
  * The POOLHDR structure preceeds a client area which must be properly
  * aligned to avoid faults when the client accesses structure members within
  * in the client area.  64-bit alignment should be sufficient.
  *
- * The magicnum and pool_size are chosen when the pool it initialized. next
- * and nxtfree are managed as buffers are allocated and freed. buf_tag comes
- * from the client so that buffers can be associated with the places that
- * allocated them.
+ * magicnum comes first so that a client overrunning the previous buffer in
+ * the slab damages it before anything else.  poolnum and state are used to
+ * catch buffers which are freed twice or into the wrong pool.  nxtfree links
+ * the buffer on the pool freelist or in a magazine.  buf_tag, file, and line
+ * come from the client so that buffers can be associated with the places
+ * that allocated them.  pool_size is only kept in self-checking builds.
  */
 
 typedef struct pool_header
 {
     unsigned int        magicnum;   // For consistency check
-    size_t              pool_size;  // For consistency check
-    struct pool_header *next;       // Next pool header in chain
+    unsigned short      poolnum;    // Pool which owns this buffer
+    unsigned short      state;      // POOL_INUSE, POOL_FREE, POOL_CACHED, or POOL_LOST
     struct pool_header *nxtfree;    // Next pool header in freelist
-    union
-    {
-        const UTF8     *buf_tag;    // Debugging/trace tag
-        UINT64 align;               // Not used.
-    } u;
+    const UTF8         *buf_tag;    // Debugging/trace tag
+    const UTF8         *file;       // File name of allocating caller
+    int                 line;       // Line number of allocating caller
+#if defined(POOL_MAGIC)
+    size_t              pool_size;  // For consistency check
+#endif // POOL_MAGIC
 } POOLHDR;
 
+#if defined(POOL_MAGIC)
 /*! \brief Per-buffer footer to catch buffer overruns.
  *
  * The POOLFTR structure helps detect when a client has written beyond the
@@ -47,22 +73,41 @@ typedef struct pool_footer
 {
     unsigned int magicnum;          // For consistency check
 } POOLFTR;
+#define POOL_FOOTER_SIZE sizeof(POOLFTR)
+#else
+#define POOL_FOOTER_SIZE 0
+#endif // POOL_MAGIC
+
+/*! \brief Header of a slab of buffers.
+ *
+ * Buffers are allocated from the system a slab at a time.  The buffers of a
+ * slab follow this header back to back.
+ */
+
+typedef struct pool_slab
+{
+    struct pool_slab   *next;       // Next slab in this pool
+    UINT64              align;      // Not used.
+} POOLSLAB;
 
 /*! \brief Per-pool structure containing statistics and list heads.
  *
- * The head of the free list and in-use list are contained here.
+ * The head of the free list and the slab list are contained here.  They are
+ * protected by the pool lock.
  */
 
 typedef struct pooldata
 {
     size_t pool_client_size;        // Size in bytes of a buffer as seen by client.
-    size_t pool_alloc_size;         // Size as allocated from system.
+    size_t pool_alloc_size;         // Size of a buffer within a slab.
+    size_t slab_buffers;            // Number of buffers in each slab.
     unsigned int poolmagic;         // Magic number specific to this pool
     POOLHDR *free_head;             // Buffer freelist head
-    POOLHDR *chain_head;            // Buffer chain head
+    POOLSLAB *slab_head;            // Slab chain head
+    UINT64 num_slabs;               // Number of slabs allocated
     UINT64 tot_alloc;               // Total buffers allocated
     UINT64 num_alloc;               // Number of buffers currently allocated
-    UINT64 max_alloc;               // Max # buffers allocated at one time
+    UINT64 max_alloc;               // Number of buffers in all slabs
     UINT64 num_lost;                // Buffers lost due to corruption
 } POOL;
 
@@ -78,13 +123,163 @@ static const UTF8 *poolnames[] =
     T("Pcaches"),
     T("Lbufrefs"),
     T("Regrefs"),
-    T("Strings")
+    T("Strings"),
+    T("Gbufs"),
+    T("Regframes")
+};
+
+/*! \brief Per-thread cache of free buffers for one pool.
+ *
+ * Allocations and frees are counted here and folded into the pool
+ * statistics whenever the magazine is refilled or drained.
+ */
+
+typedef struct
+{
+    POOLHDR *head;                  // Free buffers
+    int      count;                 // Number of buffers at head
+    UINT64   nAllocs;               // Allocations not yet counted by the pool
+    UINT64   nFrees;                // Frees not yet counted by the pool
+} MAGAZINE;
+
+static void pool_drain(int poolnum, MAGAZINE *pm, int n);
+
+// Locks are always taken in this order: the magazine list lock, then the
+// lock of one or more threads' magazines, then the pool lock.  A thread
+// only changes the headers of its own buffers while holding the lock of its
+// magazines, so holding every magazine lock keeps all buffer states still.
+//
+#if defined(UNIX_THREADS)
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define POOL_LOCK()     pthread_mutex_lock(&pool_mutex)
+#define POOL_UNLOCK()   pthread_mutex_unlock(&pool_mutex)
+static pthread_mutex_t maglist_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define MAGLIST_LOCK()  pthread_mutex_lock(&maglist_mutex)
+#define MAGLIST_UNLOCK() pthread_mutex_unlock(&maglist_mutex)
+#define MAG_LOCK(pms)   pthread_mutex_lock(&(pms)->m_mutex)
+#define MAG_UNLOCK(pms) pthread_mutex_unlock(&(pms)->m_mutex)
+#elif defined(WINDOWS_THREADS)
+static CRITICAL_SECTION csPool;
+static CRITICAL_SECTION csMagList;
+static bool bPoolLock = false;
+#define POOL_LOCK()     EnterCriticalSection(&csPool)
+#define POOL_UNLOCK()   LeaveCriticalSection(&csPool)
+#define MAGLIST_LOCK()  EnterCriticalSection(&csMagList)
+#define MAGLIST_UNLOCK() LeaveCriticalSection(&csMagList)
+#define MAG_LOCK(pms)   EnterCriticalSection(&(pms)->m_cs)
+#define MAG_UNLOCK(pms) LeaveCriticalSection(&(pms)->m_cs)
+#else
+#define POOL_LOCK()
+#define POOL_UNLOCK()
+#define MAGLIST_LOCK()
+#define MAGLIST_UNLOCK()
+#define MAG_LOCK(pms)
+#define MAG_UNLOCK(pms)
+#endif // UNIX_THREADS
+
+// The magazines of every thread are kept on a list so that they can be
+// locked while the slabs are walked.  They are returned to the pools when
+// the thread exits.
+//
+class CMagazines;
+static CMagazines *maglist_head = nullptr;
+
+class CMagazines
+{
+public:
+    MAGAZINE    m_mag[NUM_POOLS];
+    CMagazines *m_next;
+#if defined(UNIX_THREADS)
+    pthread_mutex_t m_mutex;
+#elif defined(WINDOWS_THREADS)
+    CRITICAL_SECTION m_cs;
+#endif // UNIX_THREADS
+
+    CMagazines()
+    {
+        for (int i = 0; i < NUM_POOLS; i++)
+        {
+            m_mag[i].head = nullptr;
+            m_mag[i].count = 0;
+            m_mag[i].nAllocs = 0;
+            m_mag[i].nFrees = 0;
+        }
+#if defined(UNIX_THREADS)
+        pthread_mutex_init(&m_mutex, nullptr);
+#elif defined(WINDOWS_THREADS)
+        InitializeCriticalSection(&m_cs);
+#endif // UNIX_THREADS
+
+        MAGLIST_LOCK();
+        m_next = maglist_head;
+        maglist_head = this;
+        MAGLIST_UNLOCK();
+    }
+
+    ~CMagazines()
+    {
+        MAGLIST_LOCK();
+        CMagazines **pp = &maglist_head;
+        while (this != *pp)
+        {
+            pp = &(*pp)->m_next;
+        }
+        *pp = m_next;
+        MAGLIST_UNLOCK();
+
+        // No other thread can reach these magazines now.
+        //
+        for (int i = 0; i < NUM_POOLS; i++)
+        {
+            pool_drain(i, &m_mag[i], m_mag[i].count);
+        }
+#if defined(UNIX_THREADS)
+        pthread_mutex_destroy(&m_mutex);
+#elif defined(WINDOWS_THREADS)
+        DeleteCriticalSection(&m_cs);
+#endif // UNIX_THREADS
+    }
 };
 
+#if defined(UNIX_THREADS) || defined(WINDOWS_THREADS)
+static thread_local CMagazines magazines;
+#else
+static CMagazines magazines;
+#endif // UNIX_THREADS || WINDOWS_THREADS
+
+/*! \brief Holds every thread's magazines still, and takes the pool lock.
+ *
+ * While this is in effect, buffer headers and pool statistics can be read
+ * and repaired.  It must be ended with pool_resume(), and the caller must
+ * not allocate or free pool buffers in between.
+ *
+ * \return         None.
+ */
+
+static void pool_quiesce(void)
+{
+    MAGLIST_LOCK();
+    for (CMagazines *pms = maglist_head; nullptr != pms; pms = pms->m_next)
+    {
+        MAG_LOCK(pms);
+    }
+    POOL_LOCK();
+}
+
+static void pool_resume(void)
+{
+    POOL_UNLOCK();
+    for (CMagazines *pms = maglist_head; nullptr != pms; pms = pms->m_next)
+    {
+        MAG_UNLOCK(pms);
+    }
+    MAGLIST_UNLOCK();
+}
+
 /*! \brief Initialize a buffer pool.
  *
- * This is done once. The client size, magic, and allocation size are chosen
- * at this time, and the free list and in-use list are initialized to empty.
+ * This is done once. The client size, magic, and slab layout are chosen
+ * at this time, and the free list and slab list are initialized to empty.
  * After this initialization, allocations can be done.
  *
  * \param poolnum  An integer uniquely indicating which pool.
@@ -94,12 +289,30 @@ static const UTF8 *poolnames[] =
 
 void pool_init(int poolnum, int poolsize)
 {
+#if defined(WINDOWS_THREADS)
+    if (!bPoolLock)
+    {
+        InitializeCriticalSection(&csPool);
+        InitializeCriticalSection(&csMagList);
+        bPoolLock = true;
+    }
+#endif // WINDOWS_THREADS
+
+    size_t nAlloc = sizeof(POOLHDR) + poolsize + POOL_FOOTER_SIZE;
+    nAlloc = (nAlloc + sizeof(UINT64) - 1) & ~(sizeof(UINT64) - 1);
+
     pools[poolnum].pool_client_size = poolsize;
-    pools[poolnum].pool_alloc_size  = poolsize + sizeof(POOLHDR) + sizeof(POOLFTR);
+    pools[poolnum].pool_alloc_size  = nAlloc;
     mux_assert(pools[poolnum].pool_client_size < pools[poolnum].pool_alloc_size);
+    pools[poolnum].slab_buffers = (POOL_SLAB_SIZE - sizeof(POOLSLAB)) / nAlloc;
+    if (0 == pools[poolnum].slab_buffers)
+    {
+        pools[poolnum].slab_buffers = 1;
+    }
     pools[poolnum].poolmagic = CRC32_ProcessInteger2(poolnum, poolsize);
     pools[poolnum].free_head = nullptr;
-    pools[poolnum].chain_head = nullptr;
+    pools[poolnum].slab_head = nullptr;
+    pools[poolnum].num_slabs = 0;
     pools[poolnum].tot_alloc = 0;
     pools[poolnum].num_alloc = 0;
     pools[poolnum].max_alloc = 0;
@@ -151,12 +364,19 @@ static void pool_err
     }
 }
 
-/*! \brief Validates the buffers in the in-use list.
+static inline POOLHDR *slab_buffer(int poolnum, POOLSLAB *ps, size_t i)
+{
+    UTF8 *p = reinterpret_cast<UTF8 *>(ps + 1);
+    return reinterpret_cast<POOLHDR *>(p + i * pools[poolnum].pool_alloc_size);
+}
+
+/*! \brief Validates the buffers in every slab of a pool.
  *
- * This walks the in-use list, validates that all the buffers in the list go
- * with the pool in which they appear and that all the magic is correct.  If
- * a buffer is found to be compromised, part of the list is intentionally
- * leaked rather than risk a crash.
+ * This walks the slabs, and validates that all the buffers go with the pool
+ * in which they appear, that their header magic is intact, and that their
+ * state is sensible.  In self-checking builds, the size and footer are also
+ * checked.  The first problem found is repaired and reported.  Every
+ * thread's magazines are held still during the walk.
  *
  * \param poolnum  Which pool.
  * \param tag      Client tag of problem buffer.
@@ -173,51 +393,61 @@ static void pool_vfy
     const int line
 )
 {
-    POOLHDR *lastph = nullptr;
-    size_t psize = pools[poolnum].pool_client_size;
-    for (POOLHDR *ph = pools[poolnum].chain_head; nullptr != ph; lastph = ph, ph = ph->next)
-    {
-        UTF8 *h = (UTF8 *)ph;
-        h += sizeof(POOLHDR);
-        h += pools[poolnum].pool_client_size;
-        POOLFTR *pf = (POOLFTR *) h;
+    POOLHDR *phBad = nullptr;
+    const UTF8 *reason = nullptr;
 
-        if (ph->magicnum != pools[poolnum].poolmagic)
+    // Problems are logged after the magazines are released.
+    //
+    pool_quiesce();
+    for (POOLSLAB *ps = pools[poolnum].slab_head; nullptr != ps && nullptr == phBad; ps = ps->next)
+    {
+        for (size_t i = 0; i < pools[poolnum].slab_buffers; i++)
         {
-            pool_err(T("BUG"), LOG_ALWAYS, poolnum, tag, ph, T("Verify"),
-                     T("header corrupted (clearing freelist)"), file, line);
-
-            // Break the header chain at this point so we don't
-            // generate an error for EVERY alloc and free, also we
-            // can't continue the scan because the next pointer might
-            // be trash too.
-            //
-            if (nullptr != lastph)
+            POOLHDR *ph = slab_buffer(poolnum, ps, i);
+            if (  ph->poolnum != poolnum
+               || (  POOL_INUSE != ph->state
+                  && POOL_FREE != ph->state
+                  && POOL_CACHED != ph->state
+                  && POOL_LOST != ph->state))
             {
-                lastph->next = nullptr;
+                reason = T("header corrupted");
+                ph->poolnum = static_cast<unsigned short>(poolnum);
+            }
+            else if (ph->magicnum != pools[poolnum].poolmagic)
+            {
+                reason = T("header corrupted");
+                ph->magicnum = pools[poolnum].poolmagic;
+            }
+#if defined(POOL_MAGIC)
+            else if (ph->pool_size != pools[poolnum].pool_client_size)
+            {
+                reason = T("header has incorrect size");
+                ph->pool_size = pools[poolnum].pool_client_size;
             }
             else
             {
-                pools[poolnum].chain_head = nullptr;
+                POOLFTR *pf = (POOLFTR *)((UTF8 *)(ph + 1) + pools[poolnum].pool_client_size);
+                if (pf->magicnum != pools[poolnum].poolmagic)
+                {
+                    reason = T("footer corrupted");
+                    pf->magicnum = pools[poolnum].poolmagic;
+                }
             }
+#endif // POOL_MAGIC
 
-            // It's not safe to continue.
-            //
-            return;
-        }
-
-        if (pf->magicnum != pools[poolnum].poolmagic)
-        {
-            pool_err(T("BUG"), LOG_ALWAYS, poolnum, tag, ph, T("Verify"),
-                T("footer corrupted"), file, line);
-            pf->magicnum = pools[poolnum].poolmagic;
+            if (nullptr != reason)
+            {
+                phBad = ph;
+                break;
+            }
         }
+    }
+    pool_resume();
 
-        if (ph->pool_size != psize)
-        {
-            pool_err(T("BUG"), LOG_ALWAYS, poolnum, tag, ph,
-                 T("Verify"), T("header has incorrect size"), file, line);
-        }
+    if (nullptr != phBad)
+    {
+        pool_err(T("BUG"), LOG_ALWAYS, poolnum, tag, phBad, T("Verify"),
+            reason, file, line);
     }
 }
 
@@ -230,279 +460,398 @@ static void pool_check(const UTF8 *tag, const UTF8 *file, const int line)
     }
 }
 
-UTF8 *pool_alloc(int poolnum, __in const UTF8 *tag, __in const UTF8 *file, const int line)
+/*! \brief Adds a slab of free buffers to a pool.
+ *
+ * The caller must hold the pool lock.
+ *
+ * \param poolnum  Which pool.
+ * \return         false if the system is out of memory.
+ */
+
+static bool pool_grow(int poolnum)
 {
-    if (mudconf.paranoid_alloc)
+    POOL *pp = &pools[poolnum];
+    char *p = nullptr;
+    try
     {
-        pool_check(tag, file, line);
+        p = new char[sizeof(POOLSLAB) + pp->slab_buffers * pp->pool_alloc_size];
     }
-
-    UTF8 *p;
-    POOLFTR *pf;
-    POOLHDR *ph = (POOLHDR *)pools[poolnum].free_head;
-    if (  ph
-       && ph->magicnum == pools[poolnum].poolmagic)
+    catch (...)
     {
-        p = (UTF8 *)(ph + 1);
-        pf = (POOLFTR *)(p + pools[poolnum].pool_client_size);
-        pools[poolnum].free_head = ph->nxtfree;
+        ; // Nothing.
+    }
 
-        // Check for corrupted footer, just report and fix it.
-        //
-        if (pf->magicnum != pools[poolnum].poolmagic)
-        {
-            pool_err(T("BUG"), LOG_ALWAYS, poolnum, tag, ph, T("Alloc"),
-                T("corrupted buffer footer"), file, line);
-            pf->magicnum = pools[poolnum].poolmagic;
-        }
+    if (nullptr == p)
+    {
+        return false;
     }
-    else
+
+    POOLSLAB *ps = reinterpret_cast<POOLSLAB *>(p);
+    ps->next = pp->slab_head;
+    pp->slab_head = ps;
+    pp->num_slabs++;
+
+    // Link the buffers in address order.
+    //
+    for (size_t i = pp->slab_buffers; 0 < i; i--)
     {
-        if (ph)
-        {
-            // Header is corrupt. Throw away the freelist and start a new
-            // one.
-            pool_err(T("BUG"), LOG_ALWAYS, poolnum, tag, ph, T("Alloc"),
-                T("corrupted buffer header"), file, line);
+        POOLHDR *ph = slab_buffer(poolnum, ps, i - 1);
+        ph->magicnum = pp->poolmagic;
+        ph->buf_tag = nullptr;
+        ph->file = nullptr;
+        ph->line = 0;
+        ph->poolnum = static_cast<unsigned short>(poolnum);
+        ph->state = POOL_FREE;
+#if defined(POOL_MAGIC)
+        UTF8 *q = (UTF8 *)(ph + 1);
+        POOLFTR *pf = (POOLFTR *)(q + pp->pool_client_size);
+        ph->pool_size = pp->pool_client_size;
+        pf->magicnum = pp->poolmagic;
+        *((unsigned int *)q) = pp->poolmagic;
+#endif // POOL_MAGIC
+        ph->nxtfree = pp->free_head;
+        pp->free_head = ph;
+    }
+    pp->max_alloc += pp->slab_buffers;
+    return true;
+}
 
-            // Start a new free list and record stats.
-            //
-            pools[poolnum].free_head = nullptr;
-            pools[poolnum].num_lost += (pools[poolnum].tot_alloc
-                                     -  pools[poolnum].num_alloc);
-            pools[poolnum].tot_alloc = pools[poolnum].num_alloc;
-        }
+// Counts held by a magazine are folded into the pool.  The caller must hold
+// the pool lock.
+//
+static inline void pool_fold(int poolnum, MAGAZINE *pm)
+{
+    pools[poolnum].tot_alloc += pm->nAllocs;
+    pools[poolnum].num_alloc += pm->nAllocs;
+    pools[poolnum].num_alloc -= pm->nFrees;
+    pm->nAllocs = 0;
+    pm->nFrees = 0;
+}
 
-        ph = nullptr;
-        try
-        {
-            ph = reinterpret_cast<POOLHDR *>(new char[pools[poolnum].pool_alloc_size]);
-        }
-        catch (...)
-        {
-            ; // Nothing.
-        }
+/*! \brief Rebuilds a pool freelist from its slabs.
+ *
+ * This is used when a buffer on the freelist is found with a damaged
+ * header, and its nxtfree link cannot be trusted.  Free buffers with damaged
+ * headers are set aside as lost.  The caller must hold the pool lock.
+ *
+ * \param poolnum  Which pool.
+ * \return         None.
+ */
 
-        if (nullptr == ph)
+static void pool_relink(int poolnum)
+{
+    POOL *pp = &pools[poolnum];
+    pp->free_head = nullptr;
+    for (POOLSLAB *ps = pp->slab_head; nullptr != ps; ps = ps->next)
+    {
+        for (size_t i = pp->slab_buffers; 0 < i; i--)
         {
-            ISOUTOFMEMORY(ph);
-            return nullptr;
+            POOLHDR *ph = slab_buffer(poolnum, ps, i - 1);
+            if (POOL_FREE == ph->state)
+            {
+                if (ph->magicnum != pp->poolmagic)
+                {
+                    ph->state = POOL_LOST;
+                    pp->num_lost++;
+                }
+                else
+                {
+                    ph->nxtfree = pp->free_head;
+                    pp->free_head = ph;
+                }
+            }
         }
-
-        p = (UTF8 *)(ph + 1);
-        pf = (POOLFTR *)(p + pools[poolnum].pool_client_size);
-
-        // Initialize.
-        //
-        ph->next = pools[poolnum].chain_head;
-        ph->nxtfree = nullptr;
-        ph->magicnum = pools[poolnum].poolmagic;
-        ph->pool_size = pools[poolnum].pool_client_size;
-        pf->magicnum = pools[poolnum].poolmagic;
-        *((unsigned int *)p) = pools[poolnum].poolmagic;
-        pools[poolnum].chain_head = ph;
-        pools[poolnum].max_alloc++;
     }
+}
 
-    ph->u.buf_tag = tag;
-    pools[poolnum].tot_alloc++;
-    pools[poolnum].num_alloc++;
+/*! \brief Moves half a magazine of buffers from the pool to a magazine.
+ *
+ * The caller must hold the lock of its magazines.  A damaged header found
+ * on the freelist is returned through pphBad for the caller to report once
+ * it has released its magazines.
+ *
+ * \param poolnum  Which pool.
+ * \param pm       The magazine of the calling thread.
+ * \param pphBad   Damaged buffer header, or nullptr.
+ * \return         false if the system is out of memory.
+ */
 
-    if (  (LOG_ALLOCATE & mudconf.log_options)
-       && mudstate.logging == 0
-       && start_log(T("DBG"), T("ALLOC")))
+static bool pool_refill(int poolnum, MAGAZINE *pm, POOLHDR **pphBad)
+{
+    POOLHDR *phBad = nullptr;
+    POOL_LOCK();
+    pool_fold(poolnum, pm);
+    for (int i = 0; i < POOL_MAGAZINE/2; i++)
     {
-        Log.tinyprintf(T("Alloc[%d] (tag %s) in %s line %d buffer at %p. (%s)"),
-            pools[poolnum].pool_client_size, tag, file, line, ph,
-            mudstate.debug_cmd);
-        end_log();
+        if (  nullptr == pools[poolnum].free_head
+           && !pool_grow(poolnum))
+        {
+            break;
+        }
+        POOLHDR *ph = pools[poolnum].free_head;
+        if (ph->magicnum != pools[poolnum].poolmagic)
+        {
+            phBad = ph;
+            pool_relink(poolnum);
+            i--;
+            continue;
+        }
+        pools[poolnum].free_head = ph->nxtfree;
+        ph->state = POOL_CACHED;
+        ph->nxtfree = pm->head;
+        pm->head = ph;
+        pm->count++;
     }
+    POOL_UNLOCK();
+    *pphBad = phBad;
+    return 0 < pm->count;
+}
 
-    // If the buffer was modified after it was last freed, log it.
-    //
-    unsigned int *pui = (unsigned int *)p;
-    if (*pui != pools[poolnum].poolmagic)
+/*! \brief Moves buffers from a magazine to the pool freelist.
+ *
+ * \param poolnum  Which pool.
+ * \param pm       The magazine of the calling thread.
+ * \param n        Number of buffers to move.
+ * \return         None.
+ */
+
+static void pool_drain(int poolnum, MAGAZINE *pm, int n)
+{
+    POOL_LOCK();
+    pool_fold(poolnum, pm);
+    while (  0 < n
+          && nullptr != pm->head)
     {
-        pool_err(T("BUG"), LOG_PROBLEMS, poolnum, tag, ph, T("Alloc"),
-            T("buffer modified after free"), file, line);
+        POOLHDR *ph = pm->head;
+        pm->head = ph->nxtfree;
+        pm->count--;
+        n--;
+        ph->state = POOL_FREE;
+        ph->nxtfree = pools[poolnum].free_head;
+        pools[poolnum].free_head = ph;
     }
-    *pui = 0;
-    return p;
+    POOL_UNLOCK();
 }
 
-UTF8 *pool_alloc_lbuf(__in const UTF8 *tag, __in const UTF8 *file, const int line)
+static inline UTF8 *pool_get(int poolnum, __in const UTF8 *tag, __in const UTF8 *file, const int line)
 {
     if (mudconf.paranoid_alloc)
     {
         pool_check(tag, file, line);
     }
 
-    UTF8 *p;
-    POOLFTR *pf;
-    POOLHDR *ph = (POOLHDR *)pools[POOL_LBUF].free_head;
-    if (  ph
-       && ph->magicnum == pools[POOL_LBUF].poolmagic)
-    {
-        p = (UTF8 *)(ph + 1);
-        pf = (POOLFTR *)(p + LBUF_SIZE);
-        pools[POOL_LBUF].free_head = ph->nxtfree;
-
-        // Check for corrupted footer, just report and fix it.
-        //
-        if (pf->magicnum != pools[POOL_LBUF].poolmagic)
-        {
-            pool_err(T("BUG"), LOG_ALWAYS, POOL_LBUF, tag, ph, T("Alloc"),
-                T("corrupted buffer footer"), file, line);
-            pf->magicnum = pools[POOL_LBUF].poolmagic;
-        }
-    }
-    else
+    CMagazines *pms = &magazines;
+    MAGAZINE *pm = &pms->m_mag[poolnum];
+    POOLHDR *ph;
+    MAG_LOCK(pms);
+    for (;;)
     {
-        if (ph)
+        POOLHDR *phBad = nullptr;
+        if (  0 == pm->count
+           && !pool_refill(poolnum, pm, &phBad))
         {
-            // Header is corrupt. Throw away the freelist and start a new
-            // one.
-            pool_err(T("BUG"), LOG_ALWAYS, POOL_LBUF, tag, ph, T("Alloc"),
-                T("corrupted buffer header"), file, line);
-
-            // Start a new free list and record stats.
-            //
-            pools[POOL_LBUF].free_head = nullptr;
-            pools[POOL_LBUF].num_lost += (pools[POOL_LBUF].tot_alloc
-                                     -  pools[POOL_LBUF].num_alloc);
-            pools[POOL_LBUF].tot_alloc = pools[POOL_LBUF].num_alloc;
+            MAG_UNLOCK(pms);
+            ISOUTOFMEMORY(pm->head);
+            return nullptr;
         }
 
-        ph = nullptr;
-        try
-        {
-            ph = reinterpret_cast<POOLHDR *>(new char[LBUF_SIZE + sizeof(POOLHDR) + sizeof(POOLFTR)]);
-        }
-        catch (...)
+        if (nullptr != phBad)
         {
-            ; // Nothing.
+            MAG_UNLOCK(pms);
+            pool_err(T("BUG"), LOG_ALWAYS, poolnum, tag, phBad, T("Alloc"),
+                T("corrupted buffer header on freelist"), file, line);
+            MAG_LOCK(pms);
         }
 
-        if (nullptr == ph)
+        ph = pm->head;
+        if (ph->magicnum != pools[poolnum].poolmagic)
         {
-            ISOUTOFMEMORY(ph);
-            return nullptr;
-        }
-
-        p = (UTF8 *)(ph + 1);
-        pf = (POOLFTR *)(p + LBUF_SIZE);
+            // Header is corrupt, and the link to the rest of the magazine
+            // cannot be trusted.  Throw it away and record stats.
+            //
+            ph->state = POOL_LOST;
+            POOL_LOCK();
+            pools[poolnum].num_lost += pm->count;
+            POOL_UNLOCK();
+            pm->head = nullptr;
+            pm->count = 0;
 
-        // Initialize.
-        //
-        ph->next = pools[POOL_LBUF].chain_head;
-        ph->nxtfree = nullptr;
-        ph->magicnum = pools[POOL_LBUF].poolmagic;
-        ph->pool_size = LBUF_SIZE;
-        pf->magicnum = pools[POOL_LBUF].poolmagic;
-        *((unsigned int *)p) = pools[POOL_LBUF].poolmagic;
-        pools[POOL_LBUF].chain_head = ph;
-        pools[POOL_LBUF].max_alloc++;
+            MAG_UNLOCK(pms);
+            pool_err(T("BUG"), LOG_ALWAYS, poolnum, tag, ph, T("Alloc"),
+                T("corrupted buffer header"), file, line);
+            MAG_LOCK(pms);
+            continue;
+        }
+        break;
     }
+    pm->head = ph->nxtfree;
+    pm->count--;
+    pm->nAllocs++;
+
+    UTF8 *p = (UTF8 *)(ph + 1);
+    ph->nxtfree = nullptr;
+    ph->state = POOL_INUSE;
+    ph->buf_tag = tag;
+    ph->file = file;
+    ph->line = line;
 
-    ph->u.buf_tag = tag;
-    pools[POOL_LBUF].tot_alloc++;
-    pools[POOL_LBUF].num_alloc++;
+#if defined(POOL_MAGIC)
+    // Check for corrupted footer, repair it now, and report it below.
+    //
+    POOLFTR *pf = (POOLFTR *)(p + pools[poolnum].pool_client_size);
+    bool bFooter = (pf->magicnum != pools[poolnum].poolmagic);
+    pf->magicnum = pools[poolnum].poolmagic;
+#endif // POOL_MAGIC
+    MAG_UNLOCK(pms);
 
     if (  (LOG_ALLOCATE & mudconf.log_options)
        && mudstate.logging == 0
        && start_log(T("DBG"), T("ALLOC")))
     {
         Log.tinyprintf(T("Alloc[%d] (tag %s) in %s line %d buffer at %p. (%s)"),
-            LBUF_SIZE, tag, file, line, ph, mudstate.debug_cmd);
+            pools[poolnum].pool_client_size, tag, file, line, ph,
+            mudstate.debug_cmd);
         end_log();
     }
 
+#if defined(POOL_MAGIC)
+    if (bFooter)
+    {
+        pool_err(T("BUG"), LOG_ALWAYS, poolnum, tag, ph, T("Alloc"),
+            T("corrupted buffer footer"), file, line);
+    }
+
     // If the buffer was modified after it was last freed, log it.
     //
     unsigned int *pui = (unsigned int *)p;
-    if (*pui != pools[POOL_LBUF].poolmagic)
+    if (*pui != pools[poolnum].poolmagic)
     {
-        pool_err(T("BUG"), LOG_PROBLEMS, POOL_LBUF, tag, ph, T("Alloc"),
+        pool_err(T("BUG"), LOG_PROBLEMS, poolnum, tag, ph, T("Alloc"),
             T("buffer modified after free"), file, line);
     }
     *pui = 0;
+#endif // POOL_MAGIC
     return p;
 }
 
-void pool_free(int poolnum, __in UTF8 *buf, __in const UTF8 *file, const int line)
+static inline void pool_put(int poolnum, __in UTF8 *buf, __in const UTF8 *file, const int line)
 {
-    if (buf == nullptr)
-    {
-        STARTLOG(LOG_PROBLEMS, "BUG", "ALLOC")
-        log_printf(T("Attempt to free null pointer in %s line %d."), file, line);
-        ENDLOG
-        return;
-    }
     POOLHDR *ph = ((POOLHDR *)buf) - 1;
-    POOLFTR *pf = (POOLFTR *)(buf + pools[poolnum].pool_client_size);
-    unsigned int *pui = (unsigned int *)buf;
 
     if (mudconf.paranoid_alloc)
     {
-        pool_check(ph->u.buf_tag, file, line);
+        pool_check(ph->buf_tag, file, line);
     }
 
-    // Make sure the buffer header is good.  If it isn't, log the error and
-    // throw away the buffer.
+    // The header is checked and the buffer is put in this thread's magazine
+    // while holding the magazine lock.  Problems are logged afterwards.
+    //
+    const UTF8 *reason = nullptr;
+    int logflag = LOG_ALWAYS;
+    bool bLost = false;
+    CMagazines *pms = &magazines;
+    MAGAZINE *pm = &pms->m_mag[poolnum];
+    MAG_LOCK(pms);
+    const UTF8 *tag = ph->buf_tag;
+
+    // Make sure the buffer header is good.  If it isn't, throw away the
+    // buffer.
     //
     if (ph->magicnum != pools[poolnum].poolmagic)
     {
-        pool_err(T("BUG"), LOG_ALWAYS, poolnum, ph->u.buf_tag, ph, T("Free"),
-                 T("corrupted buffer header"), file, line);
-        pools[poolnum].num_lost++;
-        pools[poolnum].num_alloc--;
-        pools[poolnum].tot_alloc--;
-        return;
+        reason = T("corrupted buffer header");
+        ph->state = POOL_LOST;
+        bLost = true;
     }
-
-    // Verify the buffer footer.  Don't unlink if damaged, just repair.
-    //
-    if (pf->magicnum != pools[poolnum].poolmagic)
+    else
     {
-        pool_err(T("BUG"), LOG_ALWAYS, poolnum, ph->u.buf_tag, ph, T("Free"),
-             T("corrupted buffer footer"), file, line);
-        pf->magicnum = pools[poolnum].poolmagic;
+#if defined(POOL_MAGIC)
+        // Verify the buffer footer.  Don't unlink if damaged, just repair.
+        //
+        POOLFTR *pf = (POOLFTR *)(buf + pools[poolnum].pool_client_size);
+        if (pf->magicnum != pools[poolnum].poolmagic)
+        {
+            reason = T("corrupted buffer footer");
+            pf->magicnum = pools[poolnum].poolmagic;
+        }
+#endif // POOL_MAGIC
+
+        // Verify that we are not trying to free someone else's buffer, and
+        // that we aren't freeing an already free buffer.
+        //
+        if (ph->poolnum != poolnum)
+        {
+            reason = T("Attempt to free into a different pool.");
+        }
+        else if (POOL_INUSE != ph->state)
+        {
+            reason = T("buffer already freed");
+            logflag = LOG_BUGS;
+        }
+        else
+        {
+#if defined(POOL_MAGIC)
+            *((unsigned int *)buf) = pools[poolnum].poolmagic;
+#endif // POOL_MAGIC
+
+            ph->state = POOL_CACHED;
+            ph->nxtfree = pm->head;
+            pm->head = ph;
+            pm->count++;
+            pm->nFrees++;
+            if (POOL_MAGAZINE <= pm->count)
+            {
+                pool_drain(poolnum, pm, POOL_MAGAZINE/2);
+            }
+        }
     }
+    MAG_UNLOCK(pms);
 
-    // Verify that we are not trying to free someone else's buffer.
-    //
-    if (ph->pool_size != pools[poolnum].pool_client_size)
+    if (bLost)
     {
-        pool_err(T("BUG"), LOG_ALWAYS, poolnum, ph->u.buf_tag, ph, T("Free"),
-                 T("Attempt to free into a different pool."), file, line);
-        return;
+        POOL_LOCK();
+        pools[poolnum].num_lost++;
+        pools[poolnum].num_alloc--;
+        pools[poolnum].tot_alloc--;
+        POOL_UNLOCK();
     }
 
-    if (  (LOG_ALLOCATE & mudconf.log_options)
-       && mudstate.logging == 0
-       && start_log(T("DBG"), T("ALLOC")))
+    if (nullptr != reason)
+    {
+        pool_err(T("BUG"), logflag, poolnum, tag, ph, T("Free"), reason,
+            file, line);
+    }
+    else if (  (LOG_ALLOCATE & mudconf.log_options)
+            && mudstate.logging == 0
+            && start_log(T("DBG"), T("ALLOC")))
     {
         Log.tinyprintf(T("Free[%d] (tag %s) in %s line %d buffer at %p. (%s)"),
-            pools[poolnum].pool_client_size, ph->u.buf_tag, file, line, ph,
+            pools[poolnum].pool_client_size, tag, file, line, ph,
             mudstate.debug_cmd);
         end_log();
     }
+}
 
-    // Make sure we aren't freeing an already free buffer.  If we are, log an
-    // error, otherwise update the pool header and stats.
-    //
-    if (*pui == pools[poolnum].poolmagic)
-    {
-        pool_err(T("BUG"), LOG_BUGS, poolnum, ph->u.buf_tag, ph, T("Free"),
-                 T("buffer already freed"), file, line);
-    }
-    else
+UTF8 *pool_alloc(int poolnum, __in const UTF8 *tag, __in const UTF8 *file, const int line)
+{
+    return pool_get(poolnum, tag, file, line);
+}
+
+UTF8 *pool_alloc_lbuf(__in const UTF8 *tag, __in const UTF8 *file, const int line)
+{
+    return pool_get(POOL_LBUF, tag, file, line);
+}
+
+void pool_free(int poolnum, __in UTF8 *buf, __in const UTF8 *file, const int line)
+{
+    if (buf == nullptr)
     {
-        *pui = pools[poolnum].poolmagic;
-        ph->nxtfree = pools[poolnum].free_head;
-        pools[poolnum].free_head = ph;
-        pools[poolnum].num_alloc--;
+        STARTLOG(LOG_PROBLEMS, "BUG", "ALLOC")
+        log_printf(T("Attempt to free null pointer in %s line %d."), file, line);
+        ENDLOG
+        return;
     }
+    pool_put(poolnum, buf, file, line);
 }
 
 void pool_free_lbuf(__in_ecount(LBUF_SIZE) UTF8 *buf, __in const UTF8 *file, const int line)
@@ -514,121 +863,147 @@ void pool_free_lbuf(__in_ecount(LBUF_SIZE) UTF8 *buf, __in const UTF8 *file, con
         ENDLOG
         return;
     }
-    POOLHDR *ph = ((POOLHDR *)buf) - 1;
-    POOLFTR *pf = (POOLFTR *)(buf + LBUF_SIZE);
-    unsigned int *pui = (unsigned int *)buf;
-
-    if (mudconf.paranoid_alloc)
-    {
-        pool_check(ph->u.buf_tag, file, line);
-    }
+    pool_put(POOL_LBUF, buf, file, line);
+}
 
-    if (  ph->magicnum != pools[POOL_LBUF].poolmagic
-       || pf->magicnum != pools[POOL_LBUF].poolmagic
-       || ph->pool_size != LBUF_SIZE
-       || *pui == pools[POOL_LBUF].poolmagic)
+void list_bufstats(dbref player)
+{
+    notify(player, T("Buffer Stats  Size      InUse      Total           Allocs   Lost"));
+    for (int i = 0; i < NUM_POOLS; i++)
     {
-        if (ph->magicnum != pools[POOL_LBUF].poolmagic)
-        {
-            // The buffer header is damaged. Log the error and throw away the
-            // buffer.
-            //
-            pool_err(T("BUG"), LOG_ALWAYS, POOL_LBUF, ph->u.buf_tag, ph, T("Free"),
-                     T("corrupted buffer header"), file, line);
-            pools[POOL_LBUF].num_lost++;
-            pools[POOL_LBUF].num_alloc--;
-            pools[POOL_LBUF].tot_alloc--;
-            return;
-        }
-        else if (pf->magicnum != pools[POOL_LBUF].poolmagic)
-        {
-            // The buffer footer is damaged.  Don't unlink, just repair.
-            //
-            pool_err(T("BUG"), LOG_ALWAYS, POOL_LBUF, ph->u.buf_tag, ph, T("Free"),
-                T("corrupted buffer footer"), file, line);
-            pf->magicnum = pools[POOL_LBUF].poolmagic;
-        }
-        else if (ph->pool_size != LBUF_SIZE)
+        pool_quiesce();
+        for (CMagazines *pms = maglist_head; nullptr != pms; pms = pms->m_next)
         {
-            // We are trying to free someone else's buffer.
-            //
-            pool_err(T("BUG"), LOG_ALWAYS, POOL_LBUF, ph->u.buf_tag, ph, T("Free"),
-                T("Attempt to free into a different pool."), file, line);
-            return;
+            pool_fold(i, &pms->m_mag[i]);
         }
+        POOL p = pools[i];
+        pool_resume();
 
-        // If we are freeing a buffer that was already free, report an error.
-        //
-        if (*pui == pools[POOL_LBUF].poolmagic)
-        {
-            pool_err(T("BUG"), LOG_BUGS, POOL_LBUF, ph->u.buf_tag, ph, T("Free"),
-                T("buffer already freed"), file, line);
-            return;
-        }
+        UTF8 buff[MBUF_SIZE];
+        UTF8 *q = buff;
+
+        q += LeftJustifyString(q,  12, poolnames[i]);            *q++ = ' ';
+        q += RightJustifyNumber(q,  5, p.pool_client_size, ' '); *q++ = ' ';
+        q += RightJustifyNumber(q, 10, p.num_alloc,        ' '); *q++ = ' ';
+        q += RightJustifyNumber(q, 10, p.max_alloc,        ' '); *q++ = ' ';
+        q += RightJustifyNumber(q, 16, p.tot_alloc,        ' '); *q++ = ' ';
+        q += RightJustifyNumber(q,  6, p.num_lost,         ' '); *q++ = '\0';
+        notify(player, buff);
     }
+}
 
-    if (  (LOG_ALLOCATE & mudconf.log_options)
-       && mudstate.logging == 0
-       && start_log(T("DBG"), T("ALLOC")))
+// One call site with buffers in use.
+//
+typedef struct
+{
+    const UTF8 *file;
+    int         line;
+    const UTF8 *tag;
+    size_t      count;
+} POOLSITE;
+
+static int DCL_CDECL site_comp(const void *s1, const void *s2)
+{
+    const POOLSITE *ps1 = (const POOLSITE *)s1;
+    const POOLSITE *ps2 = (const POOLSITE *)s2;
+    int cmp = strcmp((const char *)ps1->file, (const char *)ps2->file);
+    if (0 != cmp)
     {
-        Log.tinyprintf(T("Free[%d] (tag %s) in %s line %d buffer at %p. (%s)"),
-            LBUF_SIZE, ph->u.buf_tag, file, line, ph, mudstate.debug_cmd);
-        end_log();
+        return cmp;
     }
-
-    // Update the pool header and stats.
-    //
-    *pui = pools[POOL_LBUF].poolmagic;
-    ph->nxtfree = pools[POOL_LBUF].free_head;
-    pools[POOL_LBUF].free_head = ph;
-    pools[POOL_LBUF].num_alloc--;
+    else if (ps1->line != ps2->line)
+    {
+        return (ps1->line < ps2->line) ? -1 : 1;
+    }
+    return strcmp((const char *)ps1->tag, (const char *)ps2->tag);
 }
 
 static void pool_trace(dbref player, int poolnum, __in const UTF8 *text)
 {
-    POOLHDR *ph;
-    int numfree = 0;
     notify(player, tprintf(T("----- %s -----"), text));
-    for (ph = pools[poolnum].chain_head; ph != nullptr; ph = ph->next)
+
+    // The in-use buffers are collected while the magazines are held still
+    // and reported after they are released.
+    //
+    pool_quiesce();
+    size_t nSites = static_cast<size_t>(pools[poolnum].max_alloc);
+    POOLSITE *aSites = nullptr;
+    if (0 < nSites)
     {
-        if (ph->magicnum != pools[poolnum].poolmagic)
+        aSites = (POOLSITE *)MEMALLOC(nSites * sizeof(POOLSITE));
+        if (nullptr == aSites)
         {
-            notify(player, T("*** CORRUPTED BUFFER HEADER, ABORTING SCAN ***"));
-            notify(player, tprintf(T("%d free %s (before corruption)"),
-                       numfree, text));
+            pool_resume();
+            ISOUTOFMEMORY(aSites);
             return;
         }
-        char *h = (char *)ph;
-        h += sizeof(POOLHDR);
-        unsigned int *ibuf = (unsigned int *)h;
-        if (*ibuf != pools[poolnum].poolmagic)
+    }
+
+    size_t nInUse = 0;
+    UINT64 nSlabs = pools[poolnum].num_slabs;
+    for (POOLSLAB *ps = pools[poolnum].slab_head; nullptr != ps; ps = ps->next)
+    {
+        for (size_t i = 0; i < pools[poolnum].slab_buffers; i++)
         {
-            notify(player, ph->u.buf_tag);
+            POOLHDR *ph = slab_buffer(poolnum, ps, i);
+            if (  POOL_INUSE == ph->state
+               && nInUse < nSites)
+            {
+                aSites[nInUse].file = (nullptr != ph->file) ? ph->file : T("?");
+                aSites[nInUse].line = ph->line;
+                aSites[nInUse].tag = (nullptr != ph->buf_tag) ? ph->buf_tag : T("?");
+                aSites[nInUse].count = 1;
+                nInUse++;
+            }
         }
-        else
+    }
+    pool_resume();
+
+    // Fragmentation is the share of slab memory which is not holding client
+    // data, either because the buffer is free or because of the header.
+    //
+    size_t nReserved = static_cast<size_t>(nSlabs)
+        * (sizeof(POOLSLAB) + pools[poolnum].slab_buffers * pools[poolnum].pool_alloc_size);
+    size_t nUsed = nInUse * pools[poolnum].pool_client_size;
+    int iFrag = (0 == nReserved) ? 0
+        : static_cast<int>(((nReserved - nUsed) * 100) / nReserved);
+    notify(player, tprintf(T("%u slabs, %u bytes reserved, %u bytes in use, %d%% fragmentation"),
+        static_cast<unsigned int>(nSlabs), static_cast<unsigned int>(nReserved),
+        static_cast<unsigned int>(nUsed), iFrag));
+
+    // Merge buffers allocated at the same call site.
+    //
+    if (0 < nInUse)
+    {
+        qsort(aSites, nInUse, sizeof(POOLSITE), site_comp);
+        size_t j = 0;
+        for (size_t i = 1; i < nInUse; i++)
         {
-            numfree++;
+            if (0 == site_comp(&aSites[j], &aSites[i]))
+            {
+                aSites[j].count++;
+            }
+            else
+            {
+                aSites[++j] = aSites[i];
+            }
+        }
+
+        for (size_t i = 0; i <= j; i++)
+        {
+            notify(player, tprintf(T("%8u bytes %5u %s (%s line %d)"),
+                static_cast<unsigned int>(aSites[i].count * pools[poolnum].pool_client_size),
+                static_cast<unsigned int>(aSites[i].count), aSites[i].tag,
+                aSites[i].file, aSites[i].line));
         }
     }
-    notify(player, tprintf(T("%d free %s"), numfree, text));
-}
 
-void list_bufstats(dbref player)
-{
-    notify(player, T("Buffer Stats  Size      InUse      Total           Allocs   Lost"));
-    for (int i = 0; i < NUM_POOLS; i++)
+    if (nullptr != aSites)
     {
-        UTF8 buff[MBUF_SIZE];
-        UTF8 *p = buff;
-
-        p += LeftJustifyString(p,  12, poolnames[i]);                   *p++ = ' ';
-        p += RightJustifyNumber(p,  5, pools[i].pool_client_size, ' '); *p++ = ' ';
-        p += RightJustifyNumber(p, 10, pools[i].num_alloc,        ' '); *p++ = ' ';
-        p += RightJustifyNumber(p, 10, pools[i].max_alloc,        ' '); *p++ = ' ';
-        p += RightJustifyNumber(p, 16, pools[i].tot_alloc,        ' '); *p++ = ' ';
-        p += RightJustifyNumber(p,  6, pools[i].num_lost,         ' '); *p++ = '\0';
-        notify(player, buff);
+        MEMFREE(aSites);
     }
+    notify(player, tprintf(T("%u free %s"),
+        static_cast<unsigned int>(pools[poolnum].max_alloc - nInUse), text));
 }
 
 void list_buftrace(dbref player)
@@ -640,35 +1015,68 @@ void list_buftrace(dbref player)
     }
 }
 
+/*! \brief Returns slabs with no buffers in use to the system.
+ *
+ * The magazines of the calling thread are emptied first.  Buffers cached by
+ * other threads keep their slabs alive, and those threads are held still
+ * while the slabs are examined.
+ *
+ * \return         None.
+ */
+
 void pool_reset(void)
 {
     int i;
     for (i = 0; i < NUM_POOLS; i++)
     {
-        POOLHDR *newchain = nullptr;
-        POOLHDR *phnext;
-        POOLHDR *ph;
-        for (ph = pools[i].chain_head; ph != nullptr; ph = phnext)
+        MAGAZINE *pm = &magazines.m_mag[i];
+        MAG_LOCK(&magazines);
+        pool_drain(i, pm, pm->count);
+        MAG_UNLOCK(&magazines);
+
+        pool_quiesce();
+        POOL *pp = &pools[i];
+        POOLSLAB *newchain = nullptr;
+        POOLSLAB *psnext;
+        pp->free_head = nullptr;
+        for (POOLSLAB *ps = pp->slab_head; nullptr != ps; ps = psnext)
         {
-            char *h = (char *)ph;
-            phnext = ph->next;
-            h += sizeof(POOLHDR);
-            unsigned int *ibuf = (unsigned int *)h;
-            if (*ibuf == pools[i].poolmagic)
+            psnext = ps->next;
+
+            size_t j;
+            bool bEmpty = true;
+            for (j = 0; j < pp->slab_buffers; j++)
+            {
+                if (POOL_FREE != slab_buffer(i, ps, j)->state)
+                {
+                    bEmpty = false;
+                    break;
+                }
+            }
+
+            if (bEmpty)
             {
-                char *p = reinterpret_cast<char *>(ph);
+                char *p = reinterpret_cast<char *>(ps);
                 delete [] p;
-                ph = nullptr;
+                pp->num_slabs--;
+                pp->max_alloc -= pp->slab_buffers;
             }
             else
             {
-                ph->next = newchain;
-                newchain = ph;
-                ph->nxtfree = nullptr;
+                ps->next = newchain;
+                newchain = ps;
+                for (j = pp->slab_buffers; 0 < j; j--)
+                {
+                    POOLHDR *ph = slab_buffer(i, ps, j - 1);
+                    if (POOL_FREE == ph->state)
+                    {
+                        ph->nxtfree = pp->free_head;
+                        pp->free_head = ph;
+                    }
+                }
             }
         }
-        pools[i].chain_head = newchain;
-        pools[i].free_head = nullptr;
-        pools[i].max_alloc = pools[i].num_alloc;
+        pp->slab_head = newchain;
+        pool_resume();
     }
 }
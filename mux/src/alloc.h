@@ -16,7 +16,9 @@
 #define POOL_LBUFREF 7
 #define POOL_REGREF  8
 #define POOL_STRING  9
-#define NUM_POOLS    10
+#define POOL_GBUF    10
+#define POOL_REGFRAME 11
+#define NUM_POOLS    12
 
 #ifdef FIRANMUX
 #define LBUF_SIZE   24000   // Large
@@ -43,6 +45,8 @@ extern void pool_reset(void);
 #define free_lbuf(b)     pool_free_lbuf((UTF8 *)(b), (UTF8 *)__FILE__, __LINE__)
 #define alloc_mbuf(s)    pool_alloc(POOL_MBUF, (UTF8 *)s, (UTF8 *)__FILE__, __LINE__)
 #define free_mbuf(b)     pool_free(POOL_MBUF,(UTF8 *)(b), (UTF8 *)__FILE__, __LINE__)
+#define alloc_gbuf(s)    pool_alloc(POOL_GBUF, (UTF8 *)s, (UTF8 *)__FILE__, __LINE__)
+#define free_gbuf(b)     pool_free(POOL_GBUF,(UTF8 *)(b), (UTF8 *)__FILE__, __LINE__)
 #define alloc_sbuf(s)    pool_alloc(POOL_SBUF, (UTF8 *)s, (UTF8 *)__FILE__, __LINE__)
 #define free_sbuf(b)     pool_free(POOL_SBUF,(UTF8 *)(b), (UTF8 *)__FILE__, __LINE__)
 #define alloc_bool(s)    (struct boolexp *)pool_alloc(POOL_BOOL, (UTF8 *)s, (UTF8 *)__FILE__, __LINE__)
@@ -55,6 +59,8 @@ extern void pool_reset(void);
 #define free_lbufref(b)  pool_free(POOL_LBUFREF,(UTF8 *)(b), (UTF8 *)__FILE__, __LINE__)
 #define alloc_regref(s)  (reg_ref *)pool_alloc(POOL_REGREF, (UTF8 *)s, (UTF8 *)__FILE__, __LINE__)
 #define free_regref(b)   pool_free(POOL_REGREF,(UTF8 *)(b), (UTF8 *)__FILE__, __LINE__)
+#define alloc_regframe(s) (reg_frame *)pool_alloc(POOL_REGFRAME, (UTF8 *)s, (UTF8 *)__FILE__, __LINE__)
+#define free_regframe(b) pool_free(POOL_REGFRAME,(UTF8 *)(b), (UTF8 *)__FILE__, __LINE__)
 #define alloc_string(s)  (mux_string *)pool_alloc(POOL_STRING, T(s), (UTF8 *)__FILE__, __LINE__)
 #define free_string(b)   pool_free(POOL_STRING,(UTF8 *)(b), (UTF8 *)__FILE__, __LINE__)
 
@@ -101,4 +107,14 @@ struct reg_ref
     UTF8    *reg_ptr;
 };
 
+//! \struct reg_frame
+// A copy-on-write set of global registers.  Saving the registers takes a
+// reference to the frame, and the first assignment to a shared frame copies
+// it.
+struct reg_frame
+{
+    int      refcount;
+    reg_ref *regs[MAX_GLOBAL_REGS];
+};
+
 #endif // M_ALLOC_H
@@ -0,0 +1,267 @@
+/*! \file asciiscan.cpp
+ * \brief Block-at-a-time scans for runs of 7-bit ASCII.
+ *
+ * The block width is chosen at compile time: AVX2 when the compiler targets
+ * it, SSE2 on any x86-64 or SSE2-enabled x86 build, and otherwise a portable
+ * scan eight bytes at a time.  All three give identical answers.
+ *
+ * Loads are only issued from block-aligned addresses, so a scan never
+ * touches a page the string does not already reach into.  Bytes before the
+ * first aligned block, and the block that ends a run, are examined one at a
+ * time.
+ */
+
+#include "copyright.h"
+#include "autoconf.h"
+#include "config.h"
+
+#include "asciiscan.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ASCII_SCAN_AVX2
+#define ASCII_SCAN_BLOCK 32
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && 2 <= _M_IX86_FP)
+#include <emmintrin.h>
+#define ASCII_SCAN_SSE2
+#define ASCII_SCAN_BLOCK 16
+#else
+#define ASCII_SCAN_BLOCK 8
+#endif
+
+static inline bool is_ascii_byte(UTF8 ch)
+{
+    return 0x00 < ch && ch < 0x80;
+}
+
+static inline bool is_printable_byte(UTF8 ch)
+{
+    return  (0x20 <= ch && ch <= 0x7E)
+         || '\t' == ch
+         || '\n' == ch
+         || '\r' == ch;
+}
+
+static inline bool is_aligned(const UTF8 *p)
+{
+    return 0 == (((MUX_UINT_PTR)p) & (ASCII_SCAN_BLOCK - 1));
+}
+
+#if !defined(ASCII_SCAN_AVX2) && !defined(ASCII_SCAN_SSE2)
+
+#define ONES  UINT64_C(0x0101010101010101)
+#define HIGHS UINT64_C(0x8080808080808080)
+
+static inline UINT64 load_word(const UTF8 *p)
+{
+    UINT64 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// Non-zero if any byte of v is 0x00 or has its high bit set.
+//
+static inline UINT64 word_not_ascii(UINT64 v)
+{
+    return ((v - ONES) & ~v & HIGHS) | (v & HIGHS);
+}
+
+// Non-zero if any byte of v is below 0x20, is 0x7F, or has its high bit set.
+// TAB, LF, and CR are caught here and sorted out one byte at a time.
+//
+static inline UINT64 word_not_printable(UINT64 v)
+{
+    UINT64 w = v ^ (ONES * 0x7F);
+    return ((v - ONES * 0x20) & ~v & HIGHS)
+         | ((w - ONES) & ~w & HIGHS)
+         | (v & HIGHS);
+}
+
+#endif
+
+size_t ascii_span(const UTF8 *pString)
+{
+    const UTF8 *p = pString;
+    while (!is_aligned(p))
+    {
+        if (!is_ascii_byte(*p))
+        {
+            return p - pString;
+        }
+        p++;
+    }
+
+    for (;;)
+    {
+#if defined(ASCII_SCAN_AVX2)
+        __m256i v = _mm256_load_si256((const __m256i *)p);
+        __m256i good = _mm256_cmpgt_epi8(v, _mm256_setzero_si256());
+        if (-1 != _mm256_movemask_epi8(good))
+        {
+            break;
+        }
+#elif defined(ASCII_SCAN_SSE2)
+        __m128i v = _mm_load_si128((const __m128i *)p);
+        __m128i good = _mm_cmpgt_epi8(v, _mm_setzero_si128());
+        if (0xFFFF != _mm_movemask_epi8(good))
+        {
+            break;
+        }
+#else
+        if (0 != word_not_ascii(load_word(p)))
+        {
+            break;
+        }
+#endif
+        p += ASCII_SCAN_BLOCK;
+    }
+
+    while (is_ascii_byte(*p))
+    {
+        p++;
+    }
+    return p - pString;
+}
+
+size_t ascii_printable_span(const UTF8 *pString)
+{
+    const UTF8 *p = pString;
+    while (!is_aligned(p))
+    {
+        if (!is_printable_byte(*p))
+        {
+            return p - pString;
+        }
+        p++;
+    }
+
+    for (;;)
+    {
+#if defined(ASCII_SCAN_AVX2)
+        __m256i v = _mm256_load_si256((const __m256i *)p);
+        __m256i good = _mm256_or_si256(
+            _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(0x1F)),
+                             _mm256_cmpgt_epi8(_mm256_set1_epi8(0x7F), v)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')),
+                            _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')))));
+        if (-1 != _mm256_movemask_epi8(good))
+        {
+            break;
+        }
+#elif defined(ASCII_SCAN_SSE2)
+        __m128i v = _mm_load_si128((const __m128i *)p);
+        __m128i good = _mm_or_si128(
+            _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(0x1F)),
+                          _mm_cmplt_epi8(v, _mm_set1_epi8(0x7F))),
+            _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\t')),
+            _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')),
+                         _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')))));
+        if (0xFFFF != _mm_movemask_epi8(good))
+        {
+            break;
+        }
+#else
+        if (0 != word_not_printable(load_word(p)))
+        {
+            break;
+        }
+#endif
+        p += ASCII_SCAN_BLOCK;
+    }
+
+    while (is_printable_byte(*p))
+    {
+        p++;
+    }
+    return p - pString;
+}
+
+// Fold n bytes of ASCII, all known to be in 0x01-0x7F.  chFirst and chLast
+// bound the letters to fold, and the fold flips the 0x20 bit.
+//
+static void ascii_fold(UTF8 *pDst, const UTF8 *pSrc, size_t n, UTF8 chFirst, UTF8 chLast)
+{
+    size_t i = 0;
+#if defined(ASCII_SCAN_AVX2)
+    const __m256i lo  = _mm256_set1_epi8((char)(chFirst - 1));
+    const __m256i hi  = _mm256_set1_epi8((char)(chLast + 1));
+    const __m256i bit = _mm256_set1_epi8(0x20);
+    for ( ; i + 32 <= n; i += 32)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(pSrc + i));
+        __m256i in = _mm256_and_si256(_mm256_cmpgt_epi8(v, lo),
+                                      _mm256_cmpgt_epi8(hi, v));
+        v = _mm256_xor_si256(v, _mm256_and_si256(in, bit));
+        _mm256_storeu_si256((__m256i *)(pDst + i), v);
+    }
+#elif defined(ASCII_SCAN_SSE2)
+    const __m128i lo  = _mm_set1_epi8((char)(chFirst - 1));
+    const __m128i hi  = _mm_set1_epi8((char)(chLast + 1));
+    const __m128i bit = _mm_set1_epi8(0x20);
+    for ( ; i + 16 <= n; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(pSrc + i));
+        __m128i in = _mm_and_si128(_mm_cmpgt_epi8(v, lo),
+                                   _mm_cmplt_epi8(v, hi));
+        v = _mm_xor_si128(v, _mm_and_si128(in, bit));
+        _mm_storeu_si128((__m128i *)(pDst + i), v);
+    }
+#else
+    // Every byte is below 0x80, so adding up to 0x7F to each byte cannot
+    // carry into its neighbor, and the high bit of each byte then says
+    // whether it reached the threshold.
+    //
+    const UINT64 ge = ONES * (UINT64)(0x80 - chFirst);
+    const UINT64 gt = ONES * (UINT64)(0x7F - chLast);
+    for ( ; i + 8 <= n; i += 8)
+    {
+        UINT64 v = load_word(pSrc + i);
+        UINT64 in = (v + ge) & ~(v + gt) & HIGHS;
+        v ^= in >> 2;
+        memcpy(pDst + i, &v, sizeof(v));
+    }
+#endif
+    for ( ; i < n; i++)
+    {
+        UTF8 ch = pSrc[i];
+        if (chFirst <= ch && ch <= chLast)
+        {
+            ch ^= 0x20;
+        }
+        pDst[i] = ch;
+    }
+}
+
+size_t ascii_lower(UTF8 *pDst, const UTF8 *pSrc, size_t nMax)
+{
+    size_t n = ascii_span(pSrc);
+    if (nMax < n)
+    {
+        n = nMax;
+    }
+    ascii_fold(pDst, pSrc, n, 'A', 'Z');
+    return n;
+}
+
+size_t ascii_upper(UTF8 *pDst, const UTF8 *pSrc, size_t nMax)
+{
+    size_t n = ascii_span(pSrc);
+    if (nMax < n)
+    {
+        n = nMax;
+    }
+    ascii_fold(pDst, pSrc, n, 'a', 'z');
+    return n;
+}
+
+const char *ascii_scan_method(void)
+{
+#if defined(ASCII_SCAN_AVX2)
+    return "AVX2";
+#elif defined(ASCII_SCAN_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
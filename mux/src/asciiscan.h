@@ -0,0 +1,35 @@
+/*! \file asciiscan.h
+ * \brief Block-at-a-time scans for runs of 7-bit ASCII.
+ *
+ * Nearly all text passing through the server is 7-bit ASCII, and every
+ * state machine in utf8tables.cpp treats those bytes trivially.  These
+ * scans find how far such a run extends several bytes at a time so callers
+ * only step through a state machine from the first byte that needs it.
+ */
+
+#ifndef ASCIISCAN_H
+#define ASCIISCAN_H
+
+// Number of leading bytes of a '\0'-terminated string which are in
+// 0x01-0x7F.
+//
+size_t ascii_span(const UTF8 *pString);
+
+// Number of leading bytes of a '\0'-terminated string which are printable
+// ASCII (0x20-0x7E), TAB, LF, or CR.  The ASCII, CP437, Latin-1, and Latin-2
+// conversions map each of these bytes to itself.
+//
+size_t ascii_printable_span(const UTF8 *pString);
+
+// Copy the leading run of ASCII from pSrc to pDst, folding it to lower or
+// upper case, and stop after at most nMax bytes.  Returns the number of
+// bytes copied.
+//
+size_t ascii_lower(UTF8 *pDst, const UTF8 *pSrc, size_t nMax);
+size_t ascii_upper(UTF8 *pDst, const UTF8 *pSrc, size_t nMax);
+
+// Name of the block scan compiled in, for reporting.
+//
+const char *ascii_scan_method(void);
+
+#endif // ASCIISCAN_H
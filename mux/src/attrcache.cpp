@@ -5,9 +5,21 @@
  * disk-based mode. It's not used in memory-based builds. The lower-level
  * cache is managed in svdhash.cpp
  *
- * The upper-level cache is organized by a CHashTable and a linked list. The
- * former allows random access while the linked list helps find the
- * least-recently-used attribute.
+ * The upper-level cache is organized by a CHashTable and a segmented LRU.
+ * The former allows random access while the latter decides which attribute
+ * to throw away next.
+ *
+ * New entries enter the probationary segment.  An entry found in the cache
+ * while on probation is promoted to the protected segment.  Eviction takes
+ * the oldest probationary entry first, so a single pass over many attributes
+ * (a large @dolist, for example) cycles through probation without displacing
+ * the attributes which are actually being reused.  The protected segment is
+ * limited to a share of max_cache_size.  When it grows past that, its oldest
+ * entries are demoted back to probation.
+ *
+ * A single softcode operation often reads the same attribute several times in
+ * a row (once for its flags, then for its value), so hits that follow soon
+ * after an entry arrives do not count toward promotion.
  */
 
 #include "copyright.h"
@@ -36,17 +48,46 @@ typedef struct tagAttrRecord
 
 static ATTR_RECORD TempRecord;
 
+#define CACHE_PROBATION     0
+#define CACHE_PROTECTED     1
+#define CACHE_NUM_SEGMENTS  2
+
+// The protected segment may use up to this many percent of max_cache_size.
+//
+#define CACHE_PROTECTED_PERCENT 80
+
+// Hits within this many cache lookups of an entry's arrival are considered
+// part of the same use.
+//
+#define CACHE_CORRELATED_LOOKUPS 16
+
 typedef struct tagCacheEntryHeader
 {
     struct tagCacheEntryHeader *pPrevEntry;
     struct tagCacheEntryHeader *pNextEntry;
     Aname attrKey;
     size_t nSize;
+    int    iSegment;
+    UINT32 nArrival;
 } CENT_HDR, *PCENT_HDR;
 
-static PCENT_HDR pCacheHead = 0;
-static PCENT_HDR pCacheTail = 0;
+typedef struct tagCacheSegment
+{
+    PCENT_HDR pHead;
+    PCENT_HDR pTail;
+    size_t    nSize;
+    int       nEntries;
+} CACHE_SEGMENT;
+
+static CACHE_SEGMENT CacheSegments[CACHE_NUM_SEGMENTS];
 static size_t CacheSize = 0;
+static UINT32 CacheClock = 0;
+
+static INT64 cs_ahits    = 0;   // lookups satisfied by the cache
+static INT64 cs_amisses  = 0;   // lookups which went to the hash file
+static INT64 cs_aevicts  = 0;   // entries thrown away to make room
+static INT64 cs_apromote = 0;   // entries moved from probation to protected
+static INT64 cs_ademote  = 0;   // entries moved from protected to probation
 
 int cache_init(const UTF8 *game_dir_file, const UTF8 *game_pag_file,
     int nCachePages)
@@ -142,11 +183,13 @@ void cache_tick(void)
 
 static void REMOVE_ENTRY(PCENT_HDR pEntry)
 {
+    CACHE_SEGMENT *pSeg = &CacheSegments[pEntry->iSegment];
+
     // How is X positioned?
     //
-    if (pEntry == pCacheHead)
+    if (pEntry == pSeg->pHead)
     {
-        if (pEntry == pCacheTail)
+        if (pEntry == pSeg->pTail)
         {
             // HEAD --> X --> 0
             //    0 <--  <-- TAIL
@@ -154,7 +197,7 @@ static void REMOVE_ENTRY(PCENT_HDR pEntry)
             // ASSERT: pEntry->pNextEntry == 0;
             // ASSERT: pEntry->pPrevEntry == 0;
             //
-            pCacheHead = pCacheTail = 0;
+            pSeg->pHead = pSeg->pTail = 0;
         }
         else
         {
@@ -164,12 +207,12 @@ static void REMOVE_ENTRY(PCENT_HDR pEntry)
             // ASSERT: pEntry->pNextEntry != 0;
             // ASSERT: pEntry->pPrevEntry == 0;
             //
-            pCacheHead = pEntry->pNextEntry;
-            pCacheHead->pPrevEntry = 0;
+            pSeg->pHead = pEntry->pNextEntry;
+            pSeg->pHead->pPrevEntry = 0;
             pEntry->pNextEntry = 0;
         }
     }
-    else if (pEntry == pCacheTail)
+    else if (pEntry == pSeg->pTail)
     {
         // HEAD  --> Y --> X --> 0
         //    0 <--   <--   <-- TAIL
@@ -177,8 +220,8 @@ static void REMOVE_ENTRY(PCENT_HDR pEntry)
         // ASSERT: pEntry->pNextEntry == 0;
         // ASSERT: pEntry->pPrevEntry != 0;
         //
-        pCacheTail = pEntry->pPrevEntry;
-        pCacheTail->pNextEntry = 0;
+        pSeg->pTail = pEntry->pPrevEntry;
+        pSeg->pTail->pNextEntry = 0;
         pEntry->pPrevEntry = 0;
     }
     else
@@ -194,20 +237,61 @@ static void REMOVE_ENTRY(PCENT_HDR pEntry)
         pEntry->pNextEntry = 0;
         pEntry->pPrevEntry = 0;
     }
+    pSeg->nSize -= pEntry->nSize;
+    pSeg->nEntries--;
+    CacheSize -= pEntry->nSize;
 }
 
-static void ADD_ENTRY(PCENT_HDR pEntry)
+static void ADD_ENTRY(PCENT_HDR pEntry, int iSegment)
 {
-    if (pCacheHead)
+    CACHE_SEGMENT *pSeg = &CacheSegments[iSegment];
+    if (pSeg->pHead)
     {
-        pCacheHead->pPrevEntry = pEntry;
+        pSeg->pHead->pPrevEntry = pEntry;
     }
-    pEntry->pNextEntry = pCacheHead;
+    pEntry->pNextEntry = pSeg->pHead;
     pEntry->pPrevEntry = 0;
-    pCacheHead = pEntry;
-    if (!pCacheTail)
+    pEntry->iSegment = iSegment;
+    pSeg->pHead = pEntry;
+    if (!pSeg->pTail)
     {
-        pCacheTail = pCacheHead;
+        pSeg->pTail = pSeg->pHead;
+    }
+    pSeg->nSize += pEntry->nSize;
+    pSeg->nEntries++;
+    CacheSize += pEntry->nSize;
+}
+
+// An entry was found in the cache. Entries on probation earn a place in the
+// protected segment. If that pushes the protected segment over its share,
+// its oldest entries go back on probation.
+//
+static void TOUCH_ENTRY(PCENT_HDR pEntry)
+{
+    int iSegment = pEntry->iSegment;
+    if (  CACHE_PROBATION == iSegment
+       && CACHE_CORRELATED_LOOKUPS < CacheClock - pEntry->nArrival)
+    {
+        iSegment = CACHE_PROTECTED;
+    }
+    bool bPromote = (iSegment != pEntry->iSegment);
+    REMOVE_ENTRY(pEntry);
+    ADD_ENTRY(pEntry, iSegment);
+    if (!bPromote)
+    {
+        return;
+    }
+    cs_apromote++;
+
+    size_t nProtected = (mudconf.max_cache_size / 100) * CACHE_PROTECTED_PERCENT;
+    CACHE_SEGMENT *pSeg = &CacheSegments[CACHE_PROTECTED];
+    while (  nProtected < pSeg->nSize
+          && pSeg->pTail != pEntry)
+    {
+        PCENT_HDR pOldest = pSeg->pTail;
+        REMOVE_ENTRY(pOldest);
+        ADD_ENTRY(pOldest, CACHE_PROBATION);
+        cs_ademote++;
     }
 }
 
@@ -217,24 +301,43 @@ static void TrimCache(void)
     //
     while (CacheSize > mudconf.max_cache_size)
     {
-        // Blow something away.
+        // Blow something away. Probation goes first.
         //
-        PCENT_HDR pCacheEntry = pCacheTail;
+        PCENT_HDR pCacheEntry = CacheSegments[CACHE_PROBATION].pTail;
         if (!pCacheEntry)
         {
-            CacheSize = 0;
-            break;
+            pCacheEntry = CacheSegments[CACHE_PROTECTED].pTail;
+            if (!pCacheEntry)
+            {
+                CacheSize = 0;
+                break;
+            }
         }
 
         REMOVE_ENTRY(pCacheEntry);
-        CacheSize -= pCacheEntry->nSize;
         hashdeleteLEN(&(pCacheEntry->attrKey), sizeof(Aname),
             &mudstate.acache_htab);
         MEMFREE(pCacheEntry);
         pCacheEntry = nullptr;
+        cs_aevicts++;
     }
 }
 
+// Reports how the attribute cache is doing (see @list cache).
+//
+void cache_stats(ATTR_CACHE_STATS *pStats)
+{
+    pStats->nProbation     = CacheSegments[CACHE_PROBATION].nEntries;
+    pStats->nProbationSize = CacheSegments[CACHE_PROBATION].nSize;
+    pStats->nProtected     = CacheSegments[CACHE_PROTECTED].nEntries;
+    pStats->nProtectedSize = CacheSegments[CACHE_PROTECTED].nSize;
+    pStats->nHits          = cs_ahits;
+    pStats->nMisses        = cs_amisses;
+    pStats->nEvictions     = cs_aevicts;
+    pStats->nPromotions    = cs_apromote;
+    pStats->nDemotions     = cs_ademote;
+}
+
 const UTF8 *cache_get(Aname *nam, size_t *pLen)
 {
     if (  nam == (Aname *) 0
@@ -247,17 +350,19 @@ const UTF8 *cache_get(Aname *nam, size_t *pLen)
     PCENT_HDR pCacheEntry = nullptr;
     if (!mudstate.bStandAlone)
     {
+        CacheClock++;
+
         // Check the cache, first.
         //
         pCacheEntry = (PCENT_HDR)hashfindLEN(nam, sizeof(Aname),
             &mudstate.acache_htab);
         if (pCacheEntry)
         {
-            // It was in the cache, so move this entry to the head of the queue.
-            // and return a pointer to it.
+            // It was in the cache, so move this entry to the head of the
+            // protected segment and return a pointer to it.
             //
-            REMOVE_ENTRY(pCacheEntry);
-            ADD_ENTRY(pCacheEntry);
+            cs_ahits++;
+            TOUCH_ENTRY(pCacheEntry);
             if (sizeof(CENT_HDR) < pCacheEntry->nSize)
             {
                 *pLen = pCacheEntry->nSize - sizeof(CENT_HDR);
@@ -271,6 +376,11 @@ const UTF8 *cache_get(Aname *nam, size_t *pLen)
         }
     }
 
+    if (!mudstate.bStandAlone)
+    {
+        cs_amisses++;
+    }
+
     UINT32 nHash = CRC32_ProcessInteger2(nam->object, nam->attrnum);
     UINT32 iDir = hfAttributeFile.FindFirstKey(nHash);
 
@@ -293,9 +403,9 @@ const UTF8 *cache_get(Aname *nam, size_t *pLen)
                 {
                     pCacheEntry->attrKey = *nam;
                     pCacheEntry->nSize = nLength + sizeof(CENT_HDR);
-                    CacheSize += pCacheEntry->nSize;
+                    pCacheEntry->nArrival = CacheClock;
                     memcpy((char *)(pCacheEntry+1), TempRecord.attrText, nLength);
-                    ADD_ENTRY(pCacheEntry);
+                    ADD_ENTRY(pCacheEntry, CACHE_PROBATION);
                     hashaddLEN(nam, sizeof(Aname), pCacheEntry,
                         &mudstate.acache_htab);
 
@@ -318,8 +428,8 @@ const UTF8 *cache_get(Aname *nam, size_t *pLen)
         {
             pCacheEntry->attrKey = *nam;
             pCacheEntry->nSize = sizeof(CENT_HDR);
-            CacheSize += pCacheEntry->nSize;
-            ADD_ENTRY(pCacheEntry);
+            pCacheEntry->nArrival = CacheClock;
+            ADD_ENTRY(pCacheEntry, CACHE_PROBATION);
             hashaddLEN(nam, sizeof(Aname), pCacheEntry,
                 &mudstate.acache_htab);
 
@@ -404,14 +514,17 @@ bool cache_put(Aname *nam, const UTF8 *value, size_t len)
     {
         // Update cache.
         //
+        // A rewritten attribute keeps its place in the protected segment.
+        //
+        int iSegment = CACHE_PROBATION;
         PCENT_HDR pCacheEntry = (PCENT_HDR)hashfindLEN(nam, sizeof(Aname),
             &mudstate.acache_htab);
         if (pCacheEntry)
         {
             // It was in the cache, so delete it.
             //
+            iSegment = pCacheEntry->iSegment;
             REMOVE_ENTRY(pCacheEntry);
-            CacheSize -= pCacheEntry->nSize;
             hashdeleteLEN((char *)nam, sizeof(Aname), &mudstate.acache_htab);
             MEMFREE(pCacheEntry);
             pCacheEntry = nullptr;
@@ -425,9 +538,9 @@ bool cache_put(Aname *nam, const UTF8 *value, size_t len)
         {
             pCacheEntry->attrKey = *nam;
             pCacheEntry->nSize = nSizeOfEntry;
-            CacheSize += pCacheEntry->nSize;
+            pCacheEntry->nArrival = CacheClock;
             memcpy((char *)(pCacheEntry+1), TempRecord.attrText, len);
-            ADD_ENTRY(pCacheEntry);
+            ADD_ENTRY(pCacheEntry, iSegment);
             hashaddLEN(nam, sizeof(Aname), pCacheEntry,
                 &mudstate.acache_htab);
 
@@ -489,7 +602,6 @@ void cache_del(Aname *nam)
             // It was in the cache, so delete it.
             //
             REMOVE_ENTRY(pCacheEntry);
-            CacheSize -= pCacheEntry->nSize;;
             hashdeleteLEN((char *)nam, sizeof(Aname), &mudstate.acache_htab);
             MEMFREE(pCacheEntry);
             pCacheEntry = nullptr;
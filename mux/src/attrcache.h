@@ -12,6 +12,19 @@ typedef struct Aname
     unsigned int    attrnum;
 } Aname;
 
+typedef struct
+{
+    int     nProbation;
+    size_t  nProbationSize;
+    int     nProtected;
+    size_t  nProtectedSize;
+    INT64   nHits;
+    INT64   nMisses;
+    INT64   nEvictions;
+    INT64   nPromotions;
+    INT64   nDemotions;
+} ATTR_CACHE_STATS;
+
 extern const UTF8 *cache_get(Aname *nam, size_t *pLen);
 extern bool cache_put(Aname *nam, const UTF8 *obj, size_t len);
 extern int  cache_init(const UTF8 *game_dir_file, const UTF8 *game_pag_file,
@@ -20,5 +33,6 @@ extern void cache_close(void);
 extern void cache_tick(void);
 extern bool cache_sync(void);
 extern void cache_del(Aname *nam);
+extern void cache_stats(ATTR_CACHE_STATS *pStats);
 
 #endif // !_ATTRCACHE_H
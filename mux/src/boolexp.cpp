@@ -16,6 +16,7 @@
 #include "mathutil.h"
 
 static bool parsing_internal = false;
+static bool parse_cacheable = true;
 
 /* ---------------------------------------------------------------------------
  * check_attr: indicate if attribute ATTR on player passes key when checked by
@@ -128,7 +129,7 @@ bool eval_boolexp(dbref player, dbref thing, dbref from, BOOLEXP *b)
             return false;
         }
         key = atr_get("boolexp.130", b->sub1->thing, A_LOCK, &aowner, &aflags);
-        c = eval_boolexp_atr(player, b->sub1->thing, from, key);
+        c = eval_boolexp_lock(player, b->sub1->thing, from, A_LOCK, key);
         free_lbuf(key);
         mudstate.lock_nest_lev--;
         return c;
@@ -193,9 +194,8 @@ bool eval_boolexp(dbref player, dbref thing, dbref from, BOOLEXP *b)
 
         if (bCheck)
         {
-            reg_ref **preserve = nullptr;
-            preserve = PushRegisters(MAX_GLOBAL_REGS);
-            save_global_regs(preserve);
+            reg_frame *preserve = nullptr;
+            preserve = save_global_regs();
 
             buff2 = bp = alloc_lbuf("eval_boolexp");
             mux_exec(buff, LBUF_SIZE-1, buff2, &bp, source, player, player,
@@ -204,7 +204,6 @@ bool eval_boolexp(dbref player, dbref thing, dbref from, BOOLEXP *b)
             *bp = '\0';
 
             restore_global_regs(preserve);
-            PopRegisters(preserve, MAX_GLOBAL_REGS);
 
             bCheck = !string_compare(buff2, (UTF8 *)b->sub1);
             free_lbuf(buff2);
@@ -268,20 +267,288 @@ bool eval_boolexp(dbref player, dbref thing, dbref from, BOOLEXP *b)
     }
 }
 
-bool eval_boolexp_atr(dbref player, dbref thing, dbref from, UTF8 *key)
+/* ---------------------------------------------------------------------------
+ * Compiled locks.
+ *
+ * A stored lock is parsed once and kept for each (object, lock attribute).
+ * The tree is also flattened into an array of steps so that evaluation is a
+ * loop instead of a recursion.  AND and OR become conditional jumps over the
+ * steps of their right side, so evaluation stops exactly where the recursive
+ * evaluation would have.  Object and owner tests are done in the loop, and
+ * anything else is handed to eval_boolexp() for its node.
+ */
+
+typedef enum
+{
+    LOCKOP_NODE = 0,    // r = eval_boolexp() of the node.
+    LOCKOP_CONST,       // r = player is or carries the object.
+    LOCKOP_IS,          // r = player is the object.
+    LOCKOP_OWNER,       // r = player has the same owner as the object.
+    LOCKOP_NOT,         // r = !r
+    LOCKOP_JUMP_FALSE,  // if (!r) jump to iTarget.
+    LOCKOP_JUMP_TRUE    // if (r) jump to iTarget.
+} lockop_type;
+
+typedef struct
+{
+    lockop_type op;
+    int         iTarget;
+    dbref       thing;
+    BOOLEXP    *b;
+} LOCKOP;
+
+typedef struct
 {
-    bool ret_value;
+    int      nRefs;
+    size_t   nText;
+    UTF8    *pText;
+    BOOLEXP *b;
+    int      nOps;
+    LOCKOP  *aOps;
+} LOCKPROG;
+
+typedef struct
+{
+    dbref thing;
+    int   locknum;
+} LOCKKEY;
+
+static int lockprog_count(BOOLEXP *b)
+{
+    if (TRUE_BOOLEXP == b)
+    {
+        return 0;
+    }
 
-    BOOLEXP *b = parse_boolexp(player, key, true);
-    if (b == nullptr)
+    switch (b->type)
     {
-        ret_value = true;
+    case BOOLEXP_AND:
+    case BOOLEXP_OR:
+        return lockprog_count(b->sub1) + 1 + lockprog_count(b->sub2);
+
+    case BOOLEXP_NOT:
+        return lockprog_count(b->sub1) + 1;
+
+    default:
+        return 1;
+    }
+}
+
+static void lockprog_emit(LOCKPROG *plp, BOOLEXP *b)
+{
+    LOCKOP *pop;
+    int iJump;
+
+    switch (b->type)
+    {
+    case BOOLEXP_AND:
+    case BOOLEXP_OR:
+        lockprog_emit(plp, b->sub1);
+        iJump = plp->nOps++;
+        lockprog_emit(plp, b->sub2);
+        pop = &plp->aOps[iJump];
+        pop->op = (BOOLEXP_AND == b->type) ? LOCKOP_JUMP_FALSE : LOCKOP_JUMP_TRUE;
+        pop->iTarget = plp->nOps;
+        pop->thing = NOTHING;
+        pop->b = b;
+        return;
+
+    case BOOLEXP_NOT:
+        lockprog_emit(plp, b->sub1);
+        pop = &plp->aOps[plp->nOps++];
+        pop->op = LOCKOP_NOT;
+        pop->thing = NOTHING;
+        pop->b = b;
+        return;
+
+    default:
+        pop = &plp->aOps[plp->nOps++];
+        pop->op = LOCKOP_NODE;
+        pop->thing = NOTHING;
+        pop->b = b;
+        if (BOOLEXP_CONST == b->type)
+        {
+            pop->op = LOCKOP_CONST;
+            pop->thing = b->thing;
+        }
+        else if (  BOOLEXP_IS == b->type
+                && BOOLEXP_CONST == b->sub1->type)
+        {
+            pop->op = LOCKOP_IS;
+            pop->thing = b->sub1->thing;
+        }
+        else if (BOOLEXP_OWNER == b->type)
+        {
+            pop->op = LOCKOP_OWNER;
+            pop->thing = b->sub1->thing;
+        }
+        return;
+    }
+}
+
+static LOCKPROG *lockprog_compile(BOOLEXP *b, const UTF8 *pText, size_t nText)
+{
+    LOCKPROG *plp = (LOCKPROG *)MEMALLOC(sizeof(LOCKPROG));
+    ISOUTOFMEMORY(plp);
+    plp->nRefs = 1;
+    plp->nText = nText;
+    plp->pText = StringCloneLen(pText, nText);
+    plp->b = b;
+    plp->nOps = 0;
+    plp->aOps = nullptr;
+
+    int nOps = lockprog_count(b);
+    if (0 < nOps)
+    {
+        plp->aOps = (LOCKOP *)MEMALLOC(nOps*sizeof(LOCKOP));
+        ISOUTOFMEMORY(plp->aOps);
+        lockprog_emit(plp, b);
+        mux_assert(nOps == plp->nOps);
+    }
+    return plp;
+}
+
+static void lockprog_release(LOCKPROG *plp)
+{
+    if (0 == --plp->nRefs)
+    {
+        free_boolexp(plp->b);
+        if (plp->aOps)
+        {
+            MEMFREE(plp->aOps);
+        }
+        MEMFREE(plp->pText);
+        MEMFREE(plp);
+    }
+}
+
+static bool lockprog_eval(LOCKPROG *plp, dbref player, dbref thing, dbref from)
+{
+    bool r = true;
+    int pc = 0;
+    while (pc < plp->nOps)
+    {
+        LOCKOP *pop = &plp->aOps[pc++];
+        switch (pop->op)
+        {
+        case LOCKOP_CONST:
+            r =  pop->thing == player
+              || member(pop->thing, Contents(player));
+            break;
+
+        case LOCKOP_IS:
+            r = (pop->thing == player);
+            break;
+
+        case LOCKOP_OWNER:
+            r = (Owner(pop->thing) == Owner(player));
+            break;
+
+        case LOCKOP_NOT:
+            r = !r;
+            break;
+
+        case LOCKOP_JUMP_FALSE:
+            if (!r)
+            {
+                pc = pop->iTarget;
+            }
+            break;
+
+        case LOCKOP_JUMP_TRUE:
+            if (r)
+            {
+                pc = pop->iTarget;
+            }
+            break;
+
+        default:
+            r = eval_boolexp(player, thing, from, pop->b);
+            break;
+        }
+    }
+    return r;
+}
+
+void lock_cache_clr(dbref thing, int locknum)
+{
+    LOCKKEY lk;
+    lk.thing = thing;
+    lk.locknum = locknum;
+    LOCKPROG *plp = (LOCKPROG *)hashfindLEN(&lk, sizeof(lk), &mudstate.lock_htab);
+    if (plp)
+    {
+        hashdeleteLEN(&lk, sizeof(lk), &mudstate.lock_htab);
+        lockprog_release(plp);
+    }
+}
+
+void lock_cache_flush(void)
+{
+    LOCKPROG *plp;
+    for (plp = (LOCKPROG *)hash_firstentry(&mudstate.lock_htab);
+         plp;
+         plp = (LOCKPROG *)hash_nextentry(&mudstate.lock_htab))
+    {
+        lockprog_release(plp);
+    }
+    hashflush(&mudstate.lock_htab);
+}
+
+/*! \brief Evaluate a stored lock.
+ *
+ * The compiled form of the lock is kept, and it is used again as long as the
+ * lock text has not changed.
+ *
+ * \param player    Object trying to pass the lock.
+ * \param thing     Object on which the lock is stored.
+ * \param from      Object whose lock is being checked.
+ * \param locknum   Lock attribute number.
+ * \param key       Current text of the lock.
+ * \return          true if player passes the lock.
+ */
+
+bool eval_boolexp_lock(dbref player, dbref thing, dbref from, int locknum, const UTF8 *key)
+{
+    if (  nullptr == key
+       || '\0' == key[0])
+    {
+        return true;
+    }
+
+    LOCKKEY lk;
+    lk.thing = thing;
+    lk.locknum = locknum;
+    size_t nKey = strlen((const char *)key);
+    LOCKPROG *plp = (LOCKPROG *)hashfindLEN(&lk, sizeof(lk), &mudstate.lock_htab);
+    if (  nullptr != plp
+       && (  plp->nText != nKey
+          || 0 != memcmp(plp->pText, key, nKey)))
+    {
+        lock_cache_clr(thing, locknum);
+        plp = nullptr;
+    }
+
+    if (nullptr == plp)
+    {
+        BOOLEXP *b = parse_boolexp(player, key, true);
+        plp = lockprog_compile(b, key, nKey);
+        if (  parse_cacheable
+           && hashaddLEN(&lk, sizeof(lk), plp, &mudstate.lock_htab))
+        {
+            plp->nRefs++;
+        }
     }
     else
     {
-        ret_value = eval_boolexp(player, thing, from, b);
-        free_boolexp(b);
+        plp->nRefs++;
     }
+
+    // The reference held here keeps the lock alive if it is changed while a
+    // softcode part of it is being evaluated.
+    //
+    bool ret_value = lockprog_eval(plp, player, thing, from);
+    lockprog_release(plp);
     return ret_value;
 }
 
@@ -339,6 +606,11 @@ static BOOLEXP *test_atr(UTF8 *s)
     ATTR *attrib = atr_str(buff);
     if (!attrib)
     {
+        // Whether this parses depends on who asks and on attributes which
+        // may be created later, so the result cannot be kept.
+        //
+        parse_cacheable = false;
+
         // Only #1 can lock on numbers
         //
         if (!God(parse_player))
@@ -709,6 +981,7 @@ BOOLEXP *parse_boolexp(dbref player, const UTF8 *buf, bool internal)
     memcpy(parsestore, buf, n+1);
     parsebuf = parsestore;
     parse_player = player;
+    parse_cacheable = true;
     if (!mudstate.bStandAlone)
     {
         parsing_internal = internal;
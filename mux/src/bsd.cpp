@@ -352,8 +352,257 @@ static int get_slave_result(void)
 
 #if defined(UNIX_NETWORKING_SELECT)
 int maxd = 0;
+
+/*! \brief Number of file descriptors the select() backend can watch.
+ *
+ * select() cannot watch a descriptor at or beyond FD_SETSIZE no matter how
+ * many the process is allowed to open.
+ *
+ * \return         Maximum number of descriptors.
+ */
+
+static int net_max_descriptors(void)
+{
+#ifdef HAVE_GETDTABLESIZE
+    int maxfds = getdtablesize();
+#else // HAVE_GETDTABLESIZE
+    int maxfds = sysconf(_SC_OPEN_MAX);
+#endif // HAVE_GETDTABLESIZE
+
+    if (FD_SETSIZE < maxfds)
+    {
+        maxfds = FD_SETSIZE;
+    }
+    return maxfds;
+}
 #endif // UNIX_NETWORKING_SELECT
 
+#if defined(UNIX_NETWORKING_EPOLL)
+
+// Each socket is registered with epoll once.  Interest in reading and
+// writing is only changed when the input or output queue of a descriptor
+// changes between empty and non-empty.  Events carry the socket, and the
+// descriptor is found through apPollDesc[] so that an event for a socket
+// closed earlier in the same batch finds nullptr instead of a freed DESC.
+//
+static int    epoll_fd = -1;
+static DESC **apPollDesc = nullptr;
+static int    nPollDesc = 0;
+
+#define NET_EPOLL_EVENTS 512
+
+/*! \brief Number of file descriptors the epoll backend can watch.
+ *
+ * epoll has no limit of its own, so the soft limit on open files is raised
+ * as far as the hard limit allows.
+ *
+ * \return         Maximum number of descriptors.
+ */
+
+static int net_max_descriptors(void)
+{
+#if defined(HAVE_SETRLIMIT) && defined(RLIMIT_NOFILE)
+    struct rlimit rl;
+    if (0 == getrlimit(RLIMIT_NOFILE, &rl))
+    {
+        if (rl.rlim_cur < rl.rlim_max)
+        {
+            rl.rlim_cur = rl.rlim_max;
+            if (setrlimit(RLIMIT_NOFILE, &rl) < 0)
+            {
+                getrlimit(RLIMIT_NOFILE, &rl);
+            }
+        }
+
+        if (  RLIM_INFINITY != rl.rlim_cur
+           && rl.rlim_cur < static_cast<rlim_t>(INT_MAX))
+        {
+            return static_cast<int>(rl.rlim_cur);
+        }
+        return INT_MAX;
+    }
+#endif // HAVE_SETRLIMIT && RLIMIT_NOFILE
+
+#ifdef HAVE_GETDTABLESIZE
+    return getdtablesize();
+#else // HAVE_GETDTABLESIZE
+    return sysconf(_SC_OPEN_MAX);
+#endif // HAVE_GETDTABLESIZE
+}
+
+static bool net_poll_init(void)
+{
+    if (0 <= epoll_fd)
+    {
+        return true;
+    }
+
+    epoll_fd = epoll_create(NET_EPOLL_EVENTS);
+    if (epoll_fd < 0)
+    {
+        log_perror(T("NET"), T("FAIL"), nullptr, T("epoll_create"));
+        return false;
+    }
+
+    // The epoll descriptor must not survive @restart.
+    //
+    fcntl(epoll_fd, F_SETFD, FD_CLOEXEC);
+    return true;
+}
+
+static bool net_poll_ctl(int op, SOCKET s, int interest)
+{
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    if (interest & NET_INTEREST_READ)
+    {
+        ev.events |= EPOLLIN;
+    }
+    if (interest & NET_INTEREST_WRITE)
+    {
+        ev.events |= EPOLLOUT;
+    }
+    ev.data.fd = s;
+
+    if (epoll_ctl(epoll_fd, op, s, &ev) < 0)
+    {
+        log_perror(T("NET"), T("FAIL"), nullptr, T("epoll_ctl"));
+        return false;
+    }
+    return true;
+}
+
+/*! \brief Stop watching a socket which is not a network descriptor.
+ *
+ * Sockets must be removed before they are closed.  A forked dumping process
+ * may still hold a copy, and epoll keeps reporting a socket until every copy
+ * is closed.
+ *
+ * \param s        Socket to remove.
+ * \return         None.
+ */
+
+static void net_poll_remove(SOCKET s)
+{
+    if (  0 <= epoll_fd
+       && !IS_INVALID_SOCKET(s))
+    {
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, s, &ev);
+    }
+}
+
+/*! \brief Start watching a socket which is not a network descriptor.
+ *
+ * The slave sockets are added here as soon as they are opened.  A restarted
+ * slave usually gets back the socket number of the one it replaces, so the
+ * poll loop cannot tell from the number alone that a socket is new.  Before
+ * shovechars() creates the epoll descriptor, this does nothing, and
+ * shovechars() adds the sockets which already exist.
+ *
+ * \param s        Socket to add.
+ * \param interest NET_INTEREST_READ and/or NET_INTEREST_WRITE.
+ * \return         None.
+ */
+
+static void net_poll_add(SOCKET s, int interest)
+{
+    if (  0 <= epoll_fd
+       && !IS_INVALID_SOCKET(s))
+    {
+        net_poll_ctl(EPOLL_CTL_ADD, s, interest);
+    }
+}
+
+static int net_desired_interest(DESC *d)
+{
+    int interest = 0;
+    if (nullptr == d->input_head)
+    {
+        interest |= NET_INTEREST_READ;
+    }
+    if (nullptr != d->output_head)
+    {
+        interest |= NET_INTEREST_WRITE;
+    }
+    return interest;
+}
+
+static void net_register(DESC *d)
+{
+    if (  epoll_fd < 0
+       || IS_INVALID_SOCKET(d->socket))
+    {
+        return;
+    }
+
+    if (nPollDesc <= d->socket)
+    {
+        int nNew = 2*nPollDesc;
+        if (nNew <= d->socket)
+        {
+            nNew = d->socket + 64;
+        }
+        DESC **apNew = static_cast<DESC **>(MEMREALLOC(apPollDesc, nNew * sizeof(DESC *)));
+        ISOUTOFMEMORY(apNew);
+        for (int i = nPollDesc; i < nNew; i++)
+        {
+            apNew[i] = nullptr;
+        }
+        apPollDesc = apNew;
+        nPollDesc = nNew;
+    }
+
+    apPollDesc[d->socket] = d;
+    d->poll_interest = net_desired_interest(d);
+    net_poll_ctl(EPOLL_CTL_ADD, d->socket, d->poll_interest);
+}
+
+static void net_unregister(DESC *d)
+{
+    if (  epoll_fd < 0
+       || IS_INVALID_SOCKET(d->socket))
+    {
+        return;
+    }
+
+    if (  d->socket < nPollDesc
+       && d == apPollDesc[d->socket])
+    {
+        apPollDesc[d->socket] = nullptr;
+    }
+    net_poll_remove(d->socket);
+}
+
+/*! \brief Bring the epoll interest of a descriptor in line with its queues.
+ *
+ * Called whenever the input or output queue may have changed between empty
+ * and non-empty.  Nothing is done unless the interest actually changes.
+ *
+ * \param d        Network descriptor state.
+ * \return         None.
+ */
+
+void net_update_interest(DESC *d)
+{
+    if (  epoll_fd < 0
+       || IS_INVALID_SOCKET(d->socket)
+       || d->socket >= nPollDesc
+       || d != apPollDesc[d->socket])
+    {
+        return;
+    }
+
+    const int interest = net_desired_interest(d);
+    if (interest != d->poll_interest)
+    {
+        d->poll_interest = interest;
+        net_poll_ctl(EPOLL_CTL_MOD, d->socket, interest);
+    }
+}
+#endif // UNIX_NETWORKING_EPOLL
+
 #if defined(HAVE_WORKING_FORK)
 
 pid_t slave_pid = 0;
@@ -361,12 +610,18 @@ int slave_socket = INVALID_SOCKET;
 #ifdef STUB_SLAVE
 pid_t stubslave_pid = 0;
 int stubslave_socket = INVALID_SOCKET;
+#if defined(UNIX_NETWORKING_EPOLL)
+static int stubslave_interest = 0;
+#endif // UNIX_NETWORKING_EPOLL
 #endif // STUB_SLAVE
 
 void CleanUpSlaveSocket(void)
 {
     if (!IS_INVALID_SOCKET(slave_socket))
     {
+#if defined(UNIX_NETWORKING_EPOLL)
+        net_poll_remove(slave_socket);
+#endif // UNIX_NETWORKING_EPOLL
         shutdown(slave_socket, SD_BOTH);
         if (0 == SOCKET_CLOSE(slave_socket))
         {
@@ -391,6 +646,9 @@ void CleanUpStubSlaveSocket(void)
 {
     if (!IS_INVALID_SOCKET(stubslave_socket))
     {
+#if defined(UNIX_NETWORKING_EPOLL)
+        net_poll_remove(stubslave_socket);
+#endif // UNIX_NETWORKING_EPOLL
         shutdown(stubslave_socket, SD_BOTH);
         if (0 == SOCKET_CLOSE(stubslave_socket))
         {
@@ -511,11 +769,17 @@ void boot_stubslave(dbref executor, dbref caller, dbref enactor, int)
         CleanUpStubSlaveSocket();
         goto failure;
     }
+#if defined(UNIX_NETWORKING_SELECT)
     if (  !IS_INVALID_SOCKET(stubslave_socket)
        && maxd <= stubslave_socket)
     {
         maxd = stubslave_socket + 1;
     }
+#endif // UNIX_NETWORKING_SELECT
+#if defined(UNIX_NETWORKING_EPOLL)
+    stubslave_interest = NET_INTEREST_READ;
+    net_poll_add(stubslave_socket, stubslave_interest);
+#endif // UNIX_NETWORKING_EPOLL
 
     STARTLOG(LOG_ALWAYS, "NET", "STUB");
     log_text(T("Stub slave started on fd "));
@@ -733,6 +997,9 @@ void boot_slave(dbref executor, dbref caller, dbref enactor, int eval, int key)
         maxd = slave_socket + 1;
     }
 #endif // UNIX_NETWORKING_SELECT
+#if defined(UNIX_NETWORKING_EPOLL)
+    net_poll_add(slave_socket, NET_INTEREST_READ);
+#endif // UNIX_NETWORKING_EPOLL
 
     STARTLOG(LOG_ALWAYS, "NET", "SLAVE");
     log_text(T("DNS lookup slave started on fd "));
@@ -936,17 +1203,614 @@ void shutdown_ssl()
     }
 }
 
+#if defined(UNIX_SSL_THREADS)
+
+// SSL worker threads.
+//
+// SSL handshakes and record encryption are done by a small pool of worker
+// threads so that a burst of SSL connections (for example, after a restart)
+// does not stall command processing.  Each SSL connection is given to a
+// worker along with one end of a socketpair, and the other end becomes the
+// descriptor's socket.  From then on, the game thread treats the connection
+// like any other: telnet decoding, the input and output queues, and the
+// network loop are unchanged.  The worker moves plaintext between its end of
+// the socketpair and the SSL session.
+//
+// New channels are handed to a worker under ssl_worker_mutex, and the worker
+// is woken through a pipe.  A worker never touches a DESC.  Finished channels
+// are handed back so that only the game thread allocates and frees them.
+//
+#define SSL_CHANNEL_BUFFER  16384
+#define SSL_MAX_THREADS     16
+#define SSL_CLOSE_TIMEOUT   5
+
+typedef struct ssl_channel SSL_CHANNEL;
+struct ssl_channel
+{
+    SSL_CHANNEL *next;
+    SSL    *ssl;
+    SOCKET  sockNet;        // Encrypted connection to the client.
+    SOCKET  sockLocal;      // Plaintext, paired with the descriptor's socket.
+    bool    bHandshake;     // SSL_accept() has not finished.
+    bool    bNetEOF;        // The client is gone.
+    bool    bLocalEOF;      // The game closed its end.
+    bool    bLocalShut;     // The game has been shown the end of input.
+    bool    bNetHup;        // poll() reported a hangup on sockNet.
+    bool    bLocalHup;      // poll() reported a hangup on sockLocal.
+    time_t  tClose;         // When to stop trying to flush to the client.
+    size_t  iIn;
+    size_t  nIn;
+    size_t  iOut;
+    size_t  nOut;
+    char    aIn[SSL_CHANNEL_BUFFER];    // From the client to the game.
+    char    aOut[SSL_CHANNEL_BUFFER];   // From the game to the client.
+};
+
+typedef struct
+{
+    pthread_t    thread;
+    int          fdWake[2];
+    SSL_CHANNEL *pNew;      // Handed over, but not yet picked up.
+    int          nChannels;
+} SSL_WORKER;
+
+static pthread_mutex_t ssl_worker_mutex = PTHREAD_MUTEX_INITIALIZER;
+static SSL_WORKER   ssl_workers[SSL_MAX_THREADS];
+static int          ssl_nWorkers = 0;
+static bool         ssl_bStopping = false;
+static SSL_CHANNEL *ssl_pFinished = nullptr;
+
+static bool ssl_would_block(void)
+{
+    return (  EAGAIN == errno
+           || EWOULDBLOCK == errno
+           || EINTR == errno);
+}
+
+/*! \brief Move data between a channel's SSL session and its socketpair.
+ *
+ * Runs on a worker thread.  Progress is made until every direction would
+ * block, and the events which would unblock them are returned.
+ *
+ * \param pc       Channel.
+ * \param pevNet   poll() events wanted on the client socket.
+ * \param pevLocal poll() events wanted on the socketpair.
+ * \return         true if the channel is finished.
+ */
+
+static bool ssl_channel_service(SSL_CHANNEL *pc, short *pevNet, short *pevLocal)
+{
+    bool bProgress;
+    do
+    {
+        bProgress = false;
+        *pevNet = 0;
+        *pevLocal = 0;
+
+        if (pc->bHandshake)
+        {
+            const int r = SSL_accept(pc->ssl);
+            if (1 == r)
+            {
+                pc->bHandshake = false;
+                bProgress = true;
+            }
+            else
+            {
+                switch (SSL_get_error(pc->ssl, r))
+                {
+                case SSL_ERROR_WANT_READ:
+                    *pevNet |= POLLIN;
+                    break;
+
+                case SSL_ERROR_WANT_WRITE:
+                    *pevNet |= POLLOUT;
+                    break;
+
+                default:
+                    // Negotiation failed.  Closing the socketpair shows
+                    // the game a dropped connection.
+                    //
+                    pc->bNetEOF = true;
+                    return true;
+                }
+            }
+        }
+
+        // From the client to the game.
+        //
+        if (  !pc->bHandshake
+           && !pc->bNetEOF
+           && 0 == pc->nIn)
+        {
+            const int r = SSL_read(pc->ssl, pc->aIn, sizeof(pc->aIn));
+            if (0 < r)
+            {
+                pc->iIn = 0;
+                pc->nIn = r;
+                bProgress = true;
+            }
+            else
+            {
+                switch (SSL_get_error(pc->ssl, r))
+                {
+                case SSL_ERROR_WANT_READ:
+                    *pevNet |= POLLIN;
+                    break;
+
+                case SSL_ERROR_WANT_WRITE:
+                    *pevNet |= POLLOUT;
+                    break;
+
+                default:
+                    pc->bNetEOF = true;
+                    bProgress = true;
+                    break;
+                }
+            }
+        }
+
+        if (pc->iIn < pc->nIn)
+        {
+            const ssize_t n = pc->bLocalEOF ? -1
+                : SOCKET_WRITE(pc->sockLocal, pc->aIn + pc->iIn, pc->nIn - pc->iIn, 0);
+            if (0 < n)
+            {
+                pc->iIn += n;
+                bProgress = true;
+            }
+            else if (  !pc->bLocalEOF
+                    && ssl_would_block())
+            {
+                *pevLocal |= POLLOUT;
+            }
+            else
+            {
+                // Nobody is listening.
+                //
+                pc->iIn = pc->nIn;
+            }
+
+            if (pc->iIn == pc->nIn)
+            {
+                pc->iIn = 0;
+                pc->nIn = 0;
+            }
+        }
+
+        if (  pc->bNetEOF
+           && 0 == pc->nIn
+           && !pc->bLocalShut)
+        {
+            shutdown(pc->sockLocal, SD_SEND);
+            pc->bLocalShut = true;
+        }
+
+        // From the game to the client.  Output is read even during the
+        // handshake, but it is held until the handshake finishes.
+        //
+        if (  !pc->bLocalEOF
+           && 0 == pc->nOut)
+        {
+            const ssize_t n = SOCKET_READ(pc->sockLocal, pc->aOut, sizeof(pc->aOut), 0);
+            if (0 < n)
+            {
+                pc->iOut = 0;
+                pc->nOut = n;
+                bProgress = true;
+            }
+            else if (  n < 0
+                    && ssl_would_block())
+            {
+                *pevLocal |= POLLIN;
+            }
+            else
+            {
+                pc->bLocalEOF = true;
+                pc->tClose = time(nullptr) + SSL_CLOSE_TIMEOUT;
+                bProgress = true;
+            }
+        }
+
+        if (  !pc->bHandshake
+           && pc->iOut < pc->nOut)
+        {
+            if (pc->bNetEOF)
+            {
+                pc->iOut = pc->nOut;
+            }
+            else
+            {
+                const int r = SSL_write(pc->ssl, pc->aOut + pc->iOut, static_cast<int>(pc->nOut - pc->iOut));
+                if (0 < r)
+                {
+                    pc->iOut += r;
+                    bProgress = true;
+                }
+                else
+                {
+                    switch (SSL_get_error(pc->ssl, r))
+                    {
+                    case SSL_ERROR_WANT_READ:
+                        *pevNet |= POLLIN;
+                        break;
+
+                    case SSL_ERROR_WANT_WRITE:
+                        *pevNet |= POLLOUT;
+                        break;
+
+                    default:
+                        pc->bNetEOF = true;
+                        pc->iOut = pc->nOut;
+                        bProgress = true;
+                        break;
+                    }
+                }
+            }
+
+            if (pc->iOut == pc->nOut)
+            {
+                pc->iOut = 0;
+                pc->nOut = 0;
+            }
+        }
+
+        // The channel is finished once the game has closed its end and
+        // everything it wrote has been sent.
+        //
+        if (  pc->bLocalEOF
+           && 0 == pc->nOut)
+        {
+            return true;
+        }
+    } while (bProgress);
+
+    return false;
+}
+
+static void ssl_channel_close(SSL_CHANNEL *pc)
+{
+    if (  !pc->bHandshake
+       && !pc->bNetEOF)
+    {
+        SSL_shutdown(pc->ssl);
+    }
+    SSL_free(pc->ssl);
+    pc->ssl = nullptr;
+
+    shutdown(pc->sockNet, SD_BOTH);
+    SOCKET_CLOSE(pc->sockNet);
+    SOCKET_CLOSE(pc->sockLocal);
+}
+
+static void *ssl_worker_thread(void *pArg)
+{
+    SSL_WORKER *pw = static_cast<SSL_WORKER *>(pArg);
+    SSL_CHANNEL *pOwned = nullptr;
+    int nOwned = 0;
+    struct pollfd *aPoll = nullptr;
+    int nPollAlloc = 0;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&ssl_worker_mutex);
+        while (nullptr != pw->pNew)
+        {
+            SSL_CHANNEL *pc = pw->pNew;
+            pw->pNew = pc->next;
+            pc->next = pOwned;
+            pOwned = pc;
+            nOwned++;
+        }
+        const bool bStopping = ssl_bStopping;
+        pthread_mutex_unlock(&ssl_worker_mutex);
+
+        if (nPollAlloc < 1 + 2*nOwned)
+        {
+            delete [] aPoll;
+            nPollAlloc = 1 + 2*nOwned + 64;
+            aPoll = new struct pollfd[nPollAlloc];
+        }
+
+        // Service every channel, and gather what each is waiting for.
+        //
+        const time_t tNow = time(nullptr);
+        bool bClosing = false;
+        int nPoll = 1;
+        SSL_CHANNEL **pp = &pOwned;
+        while (nullptr != *pp)
+        {
+            SSL_CHANNEL *pc = *pp;
+            if (  bStopping
+               && 0 == pc->tClose)
+            {
+                pc->tClose = tNow + SSL_CLOSE_TIMEOUT;
+            }
+
+            short evNet, evLocal;
+            if (  ssl_channel_service(pc, &evNet, &evLocal)
+               || (  0 != pc->tClose
+                  && pc->tClose <= tNow))
+            {
+                ssl_channel_close(pc);
+                *pp = pc->next;
+                nOwned--;
+
+                pthread_mutex_lock(&ssl_worker_mutex);
+                pc->next = ssl_pFinished;
+                ssl_pFinished = pc;
+                pw->nChannels--;
+                pthread_mutex_unlock(&ssl_worker_mutex);
+                continue;
+            }
+
+            if (0 != pc->tClose)
+            {
+                bClosing = true;
+            }
+
+            // poll() reports a hangup whatever the requested events, so a
+            // socket which has hung up is left out.  Reading it no longer
+            // blocks, and the next service finds the end of its data.
+            //
+            aPoll[nPoll].fd = (pc->bNetEOF || pc->bNetHup) ? -1 : pc->sockNet;
+            aPoll[nPoll].events = evNet;
+            aPoll[nPoll].revents = 0;
+            nPoll++;
+            aPoll[nPoll].fd = (pc->bLocalEOF || pc->bLocalHup) ? -1 : pc->sockLocal;
+            aPoll[nPoll].events = evLocal;
+            aPoll[nPoll].revents = 0;
+            nPoll++;
+            pp = &pc->next;
+        }
+
+        if (  bStopping
+           && 0 == nOwned)
+        {
+            break;
+        }
+
+        aPoll[0].fd = pw->fdWake[0];
+        aPoll[0].events = POLLIN;
+        aPoll[0].revents = 0;
+
+        // Closing channels are checked once a second to enforce their
+        // timeout.
+        //
+        if (0 < poll(aPoll, nPoll, bClosing ? 1000 : -1))
+        {
+            if (aPoll[0].revents & POLLIN)
+            {
+                char buf[64];
+                while (0 < read(pw->fdWake[0], buf, sizeof(buf)))
+                {
+                    ; // Nothing.
+                }
+            }
+
+            // Errors are also reported whatever the requested events.  If
+            // they were left for the next poll(), the worker would spin.
+            //
+            int iPoll = 1;
+            for (SSL_CHANNEL *pc = pOwned; nullptr != pc; pc = pc->next)
+            {
+                const short revNet = aPoll[iPoll++].revents;
+                const short revLocal = aPoll[iPoll++].revents;
+                if (revNet & (POLLERR|POLLNVAL))
+                {
+                    pc->bNetEOF = true;
+                }
+                else if (revNet & POLLHUP)
+                {
+                    pc->bNetHup = true;
+                }
+
+                if (  !pc->bLocalEOF
+                   && (revLocal & (POLLERR|POLLNVAL)))
+                {
+                    pc->bLocalEOF = true;
+                    pc->tClose = time(nullptr) + SSL_CLOSE_TIMEOUT;
+                }
+                else if (revLocal & POLLHUP)
+                {
+                    pc->bLocalHup = true;
+                }
+            }
+        }
+    }
+
+    delete [] aPoll;
+    return nullptr;
+}
+
+static bool ssl_worker_start(void)
+{
+    int nThreads = mudconf.ssl_threads;
+    if (SSL_MAX_THREADS < nThreads)
+    {
+        nThreads = SSL_MAX_THREADS;
+    }
+
+    while (ssl_nWorkers < nThreads)
+    {
+        SSL_WORKER *pw = &ssl_workers[ssl_nWorkers];
+        pw->pNew = nullptr;
+        pw->nChannels = 0;
+        if (pipe(pw->fdWake) < 0)
+        {
+            log_perror(T("NET"), T("FAIL"), T("SSL worker"), T("pipe"));
+            break;
+        }
+        for (int i = 0; i < 2; i++)
+        {
+            fcntl(pw->fdWake[i], F_SETFD, FD_CLOEXEC);
+            make_nonblocking(pw->fdWake[i]);
+        }
+
+        if (0 != pthread_create(&pw->thread, nullptr, ssl_worker_thread, pw))
+        {
+            log_perror(T("NET"), T("FAIL"), T("SSL worker"), T("pthread_create"));
+            mux_close(pw->fdWake[0]);
+            mux_close(pw->fdWake[1]);
+            break;
+        }
+        ssl_nWorkers++;
+    }
+    return 0 < ssl_nWorkers;
+}
+
+/*! \brief Free channels which the workers have finished with.
+ */
+
+static void ssl_worker_reap(void)
+{
+    pthread_mutex_lock(&ssl_worker_mutex);
+    SSL_CHANNEL *pc = ssl_pFinished;
+    ssl_pFinished = nullptr;
+    pthread_mutex_unlock(&ssl_worker_mutex);
+
+    while (nullptr != pc)
+    {
+        SSL_CHANNEL *pnext = pc->next;
+        MEMFREE(pc);
+        pc = pnext;
+    }
+}
+
+/*! \brief Stop the SSL workers after their channels finish.
+ *
+ * The game ends of every channel must already be closed.  Each worker flushes
+ * what the game wrote, subject to SSL_CLOSE_TIMEOUT, and then exits.  The
+ * workers are started again when they are next needed.
+ */
+
+static void ssl_worker_stop(void)
+{
+    if (0 == ssl_nWorkers)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&ssl_worker_mutex);
+    ssl_bStopping = true;
+    pthread_mutex_unlock(&ssl_worker_mutex);
+
+    for (int i = 0; i < ssl_nWorkers; i++)
+    {
+        mux_write(ssl_workers[i].fdWake[1], "", 1);
+    }
+
+    for (int i = 0; i < ssl_nWorkers; i++)
+    {
+        pthread_join(ssl_workers[i].thread, nullptr);
+        mux_close(ssl_workers[i].fdWake[0]);
+        mux_close(ssl_workers[i].fdWake[1]);
+    }
+    ssl_nWorkers = 0;
+    ssl_bStopping = false;
+    ssl_worker_reap();
+}
+
+/*! \brief Give an SSL session to a worker thread.
+ *
+ * The worker completes the handshake and then carries the connection.  On
+ * success, the caller uses the returned socket in place of sockNet, which
+ * now belongs to the worker.
+ *
+ * \param ssl       New SSL session, not yet bound to a socket.
+ * \param sockNet   Connected client socket.
+ * \param psockGame Plaintext socket for the descriptor.
+ * \return          false if workers are disabled or unavailable.
+ */
+
+static bool ssl_worker_attach(SSL *ssl, SOCKET sockNet, SOCKET *psockGame)
+{
+    if (mudconf.ssl_threads <= 0)
+    {
+        return false;
+    }
+
+    ssl_worker_reap();
+    if (  0 == ssl_nWorkers
+       && !ssl_worker_start())
+    {
+        return false;
+    }
+
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0)
+    {
+        log_perror(T("NET"), T("FAIL"), T("SSL worker"), T("socketpair"));
+        return false;
+    }
+
+    // The worker's sockets must not survive @restart.
+    //
+    make_nonblocking(sockNet);
+    make_nonblocking(sv[1]);
+    fcntl(sockNet, F_SETFD, FD_CLOEXEC);
+    fcntl(sv[1], F_SETFD, FD_CLOEXEC);
+    SSL_set_fd(ssl, sockNet);
+
+    SSL_CHANNEL *pc = static_cast<SSL_CHANNEL *>(MEMALLOC(sizeof(SSL_CHANNEL)));
+    ISOUTOFMEMORY(pc);
+    pc->ssl = ssl;
+    pc->sockNet = sockNet;
+    pc->sockLocal = sv[1];
+    pc->bHandshake = true;
+    pc->bNetEOF = false;
+    pc->bLocalEOF = false;
+    pc->bLocalShut = false;
+    pc->bNetHup = false;
+    pc->bLocalHup = false;
+    pc->tClose = 0;
+    pc->iIn = 0;
+    pc->nIn = 0;
+    pc->iOut = 0;
+    pc->nOut = 0;
+
+    // Choose the least busy worker.
+    //
+    pthread_mutex_lock(&ssl_worker_mutex);
+    SSL_WORKER *pw = &ssl_workers[0];
+    for (int i = 1; i < ssl_nWorkers; i++)
+    {
+        if (ssl_workers[i].nChannels < pw->nChannels)
+        {
+            pw = &ssl_workers[i];
+        }
+    }
+    pc->next = pw->pNew;
+    pw->pNew = pc;
+    pw->nChannels++;
+    pthread_mutex_unlock(&ssl_worker_mutex);
+
+    mux_write(pw->fdWake[1], "", 1);
+
+    *psockGame = sv[0];
+    return true;
+}
+#endif // UNIX_SSL_THREADS
+
 void CleanUpSSLConnections()
 {
-    DESC *d;
+    DESC *d, *dnext;
 
-    DESC_ITER_ALL(d)
+    DESC_SAFEITER_ALL(d, dnext)
     {
-        if (d->ssl_session)
+        if (  d->ssl_session
+           || d->ssl_worker)
         {
             shutdownsock(d, R_RESTART);
         }
     }
+
+#if defined(UNIX_SSL_THREADS)
+    // Give the workers a chance to deliver the disconnect messages before
+    // the process is replaced.
+    //
+    ssl_worker_stop();
+#endif // UNIX_SSL_THREADS
 }
 
 #endif
@@ -1411,12 +2275,7 @@ void shovechars(int nPorts, PortInfo aPorts[])
     CLinearTimeAbsolute ltaLastSlice;
     ltaLastSlice.GetUTC();
 
-#ifdef HAVE_GETDTABLESIZE
-    maxfds = getdtablesize();
-#else // HAVE_GETDTABLESIZE
-    maxfds = sysconf(_SC_OPEN_MAX);
-#endif // HAVE_GETDTABLESIZE
-
+    maxfds = net_max_descriptors();
     avail_descriptors = maxfds - 7;
 
     while (!mudstate.shutdown_flag)
@@ -1676,6 +2535,245 @@ void shovechars(int nPorts, PortInfo aPorts[])
 
 #endif // UNIX_NETWORKING_SELECT
 
+#if defined(UNIX_NETWORKING_EPOLL)
+
+void shovechars(int nPorts, PortInfo aPorts[])
+{
+    static struct epoll_event aEvents[NET_EPOLL_EVENTS];
+    DESC *d, *newd;
+    int i;
+
+    mudstate.debug_cmd = T("< shovechars_epoll >");
+
+    if (!net_poll_init())
+    {
+        return;
+    }
+
+    CLinearTimeAbsolute ltaLastSlice;
+    ltaLastSlice.GetUTC();
+
+    const int maxfds = net_max_descriptors();
+    const unsigned int avail_descriptors = maxfds - 7;
+
+    // Descriptors carried across @restart were created before the epoll
+    // descriptor existed.
+    //
+    DESC_ITER_ALL(d)
+    {
+        net_register(d);
+    }
+
+    for (i = 0; i < nPorts; i++)
+    {
+        net_poll_ctl(EPOLL_CTL_ADD, aPorts[i].socket, NET_INTEREST_READ);
+    }
+    bool bListening = true;
+
+#if defined(HAVE_WORKING_FORK)
+    // Slaves started before the epoll descriptor existed.  Later restarts
+    // are added by boot_slave() and boot_stubslave().
+    //
+    net_poll_add(slave_socket, NET_INTEREST_READ);
+#if defined(STUB_SLAVE)
+    net_poll_add(stubslave_socket, stubslave_interest);
+#endif // STUB_SLAVE
+#endif // HAVE_WORKING_FORK
+
+    while (!mudstate.shutdown_flag)
+    {
+        CLinearTimeAbsolute ltaCurrent;
+        ltaCurrent.GetUTC();
+        update_quotas(ltaLastSlice, ltaCurrent);
+
+        // Check the scheduler.
+        //
+        scheduler.RunTasks(ltaCurrent);
+        CLinearTimeAbsolute ltaWakeUp;
+        if (scheduler.WhenNext(&ltaWakeUp))
+        {
+            if (ltaWakeUp < ltaCurrent)
+            {
+                ltaWakeUp = ltaCurrent;
+            }
+        }
+        else
+        {
+            CLinearTimeDelta ltd = time_30m;
+            ltaWakeUp = ltaCurrent + ltd;
+        }
+
+        if (mudstate.shutdown_flag)
+        {
+            break;
+        }
+
+#if defined(HAVE_WORKING_FORK) && defined(STUB_SLAVE)
+        // Listen for replies from the stubslave socket.
+        //
+        if (!IS_INVALID_SOCKET(stubslave_socket))
+        {
+            int iInterest = NET_INTEREST_READ;
+            if (0 < Pipe_QueueLength(&Queue_Out))
+            {
+                iInterest |= NET_INTEREST_WRITE;
+            }
+
+            if (iInterest != stubslave_interest)
+            {
+                net_poll_ctl(EPOLL_CTL_MOD, stubslave_socket, iInterest);
+                stubslave_interest = iInterest;
+            }
+        }
+#endif // HAVE_WORKING_FORK && STUB_SLAVE
+
+        // Listen for new connections if there are free descriptors.
+        //
+        if (bListening != (ndescriptors < avail_descriptors))
+        {
+            bListening = !bListening;
+            for (i = 0; i < nPorts; i++)
+            {
+                net_poll_ctl(EPOLL_CTL_MOD, aPorts[i].socket, bListening ? NET_INTEREST_READ : 0);
+            }
+        }
+
+        // Wait for something to happen.
+        //
+        CLinearTimeDelta ltdTimeout = ltaWakeUp - ltaCurrent;
+        const int found = epoll_wait(epoll_fd, aEvents, NET_EPOLL_EVENTS,
+            static_cast<int>(ltdTimeout.ReturnMilliseconds()));
+
+        if (found < 0)
+        {
+            if (SOCKET_LAST_ERROR != SOCKET_EINTR)
+            {
+                log_perror(T("NET"), T("FAIL"), T("checking for activity"), T("epoll_wait"));
+            }
+            continue;
+        }
+
+        for (int j = 0; j < found; j++)
+        {
+            const SOCKET s = aEvents[j].data.fd;
+            const uint32_t events = aEvents[j].events;
+
+#if defined(HAVE_WORKING_FORK)
+            // Get usernames and hostnames.
+            //
+            if (  !IS_INVALID_SOCKET(slave_socket)
+               && s == slave_socket)
+            {
+                while (0 == get_slave_result())
+                {
+                    ; // Nothing.
+                }
+                continue;
+            }
+
+#if defined(STUB_SLAVE)
+            // Get data from stubslave.
+            //
+            if (  !IS_INVALID_SOCKET(stubslave_socket)
+               && s == stubslave_socket)
+            {
+                if (events & (EPOLLIN | EPOLLERR | EPOLLHUP))
+                {
+                    while (0 == StubSlaveRead())
+                    {
+                        ; // Nothing.
+                    }
+                }
+
+                Pipe_DecodeFrames(CHANNEL_INVALID, &Queue_Out);
+
+                if (  !IS_INVALID_SOCKET(stubslave_socket)
+                   && (events & EPOLLOUT))
+                {
+                    StubSlaveWrite();
+                }
+                continue;
+            }
+#endif // STUB_SLAVE
+#endif // HAVE_WORKING_FORK
+
+            // Check for new connection requests.
+            //
+            bool bPort = false;
+            for (i = 0; i < nPorts; i++)
+            {
+                if (s == aPorts[i].socket)
+                {
+                    bPort = true;
+                    int iSocketError;
+                    newd = new_connection(&aPorts[i], &iSocketError);
+                    if (  !newd
+                       && iSocketError
+                       && iSocketError != SOCKET_EINTR)
+                    {
+                        log_perror(T("NET"), T("FAIL"), nullptr, T("new_connection"));
+                    }
+                    break;
+                }
+            }
+
+            if (  bPort
+               || s < 0
+               || nPollDesc <= s)
+            {
+                continue;
+            }
+
+            // Check for activity on user sockets.  The descriptor may have
+            // been shut down while handling an earlier event.
+            //
+            d = apPollDesc[s];
+            if (nullptr == d)
+            {
+                continue;
+            }
+
+            // Process input from sockets with pending input.  A socket which
+            // has failed is reported even while reads are not of interest, so
+            // it is read in order to notice the failure.
+            //
+            if (events & (EPOLLIN | EPOLLERR | EPOLLHUP))
+            {
+                // Undo autodark
+                //
+                if (d->flags & DS_AUTODARK)
+                {
+                    // Clear the DS_AUTODARK on every related session.
+                    //
+                    DESC *d1;
+                    DESC_ITER_PLAYER(d->player, d1)
+                    {
+                        d1->flags &= ~DS_AUTODARK;
+                    }
+                    db[d->player].fs.word[FLAG_WORD1] &= ~DARK;
+                }
+
+                // Process received data.
+                //
+                if (!process_input(d))
+                {
+                    shutdownsock(d, R_SOCKDIED);
+                    continue;
+                }
+            }
+
+            // Process output for sockets with pending output.
+            //
+            if (events & EPOLLOUT)
+            {
+                process_output(d, true);
+            }
+        }
+    }
+}
+
+#endif // UNIX_NETWORKING_EPOLL
+
 #if defined(HAVE_WORKING_FORK) && defined(STUB_SLAVE)
 extern "C" MUX_RESULT DCL_API pipepump(void)
 {
@@ -1703,7 +2801,7 @@ extern "C" MUX_RESULT DCL_API pipepump(void)
 
     // Wait for something to happen.
     //
-    found = select(maxd, &input_set, &output_set, (fd_set *) nullptr, nullptr);
+    found = select(stubslave_socket + 1, &input_set, &output_set, (fd_set *) nullptr, nullptr);
 
     if (IS_SOCKET_ERROR(found))
     {
@@ -1838,10 +2936,26 @@ DESC *new_connection(PortInfo *Port, int *piSocketError)
 
 #ifdef UNIX_SSL
         SSL *ssl_session = nullptr;
+        bool ssl_worker = false;
 
         if (Port->fSSL && ssl_ctx)
         {
             ssl_session = SSL_new(ssl_ctx);
+#if defined(UNIX_SSL_THREADS)
+            SOCKET sockGame;
+            if (ssl_worker_attach(ssl_session, newsock, &sockGame))
+            {
+                // A worker completes the handshake.
+                //
+                ssl_session = nullptr;
+                ssl_worker = true;
+                newsock = sockGame;
+            }
+#endif // UNIX_SSL_THREADS
+        }
+
+        if (nullptr != ssl_session)
+        {
             SSL_set_fd(ssl_session, newsock);
             int ssl_result = SSL_accept(ssl_session);
             if (ssl_result != 1)
@@ -1871,6 +2985,7 @@ DESC *new_connection(PortInfo *Port, int *piSocketError)
 
 #ifdef UNIX_SSL
         d->ssl_session = ssl_session;
+        d->ssl_worker = ssl_worker;
 #endif
 
         telnet_setup(d);
@@ -1927,7 +3042,6 @@ static const UTF8 *disc_messages[] =
 void shutdownsock(DESC *d, int reason)
 {
     UTF8 *buff;
-    int i;
     DESC *dtemp;
 
     if (  R_LOGOUT == reason
@@ -2082,14 +3196,8 @@ void shutdownsock(DESC *d, int reason)
 
         if (0 == num)
         {
-            for (i = 0; i < MAX_GLOBAL_REGS; i++)
-            {
-                if (d->program_data->wait_regs[i])
-                {
-                    RegRelease(d->program_data->wait_regs[i]);
-                    d->program_data->wait_regs[i] = nullptr;
-                }
-            }
+            RegFrameRelease(d->program_data->wait_regs);
+            d->program_data->wait_regs = nullptr;
             MEMFREE(d->program_data);
             atr_clr(d->player, A_PROGCMD);
         }
@@ -2161,6 +3269,10 @@ void shutdownsock(DESC *d, int reason)
         }
 #endif
 
+#if defined(UNIX_NETWORKING_EPOLL)
+        net_unregister(d);
+#endif // UNIX_NETWORKING_EPOLL
+
         shutdown(d->socket, SD_BOTH);
         if (0 == SOCKET_CLOSE(d->socket))
         {
@@ -2337,6 +3449,7 @@ DESC *initializesock(SOCKET s, MUX_SOCKADDR *msa)
     d->timeout = mudconf.idle_timeout;
 #ifdef UNIX_SSL
     d->ssl_session = nullptr;
+    d->ssl_worker = false;
 #endif
 
     // Be sure #0 isn't wizard. Shouldn't be.
@@ -2414,6 +3527,10 @@ DESC *initializesock(SOCKET s, MUX_SOCKADDR *msa)
     d->bConnectionDropped = false; // not dropped yet
     d->bCallProcessOutputLater = false;
 #endif // WINDOWS_NETWORKING
+
+#if defined(UNIX_NETWORKING_EPOLL)
+    net_register(d);
+#endif // UNIX_NETWORKING_EPOLL
     return d;
 }
 
@@ -2468,7 +3585,7 @@ void process_output_socket(DESC *d, int bHandleShutdown)
     {
         auto save = tb;
         tb = tb->hdr.nxt;
-        MEMFREE(save);
+        free_tblock(save);
         save = nullptr;
         d->output_head = tb;
         if (nullptr == tb)
@@ -2560,6 +3677,103 @@ void process_output_socket(DESC *d, int bHandleShutdown)
  * \return                  None.
  */
 
+#if defined(UNIX_WRITEV)
+void process_output_socket(DESC *d, int bHandleShutdown)
+{
+    const UTF8 *cmdsave = mudstate.debug_cmd;
+    mudstate.debug_cmd = T("< process_output >");
+
+    // Gather several output blocks into each system call.  Blocks which are
+    // shared with other descriptors are sent from the shared copy.
+    //
+    struct iovec aiov[OUTPUT_IOV_MAX];
+    while (nullptr != d->output_head)
+    {
+        int niov = 0;
+        size_t nWanted = 0;
+        TBLOCK *tb = d->output_head;
+        while (  nullptr != tb
+              && niov < OUTPUT_IOV_MAX)
+        {
+            if (0 < tb->hdr.nchars)
+            {
+                aiov[niov].iov_base = tb->hdr.start;
+                aiov[niov].iov_len = tb->hdr.nchars;
+                nWanted += tb->hdr.nchars;
+                niov++;
+            }
+            tb = tb->hdr.nxt;
+        }
+
+        ssize_t cnt = 0;
+        if (0 < niov)
+        {
+            cnt = writev(d->socket, aiov, niov);
+            if (cnt < 0)
+            {
+                int iSocketError = SOCKET_LAST_ERROR;
+                mudstate.debug_cmd = cmdsave;
+                if (  SOCKET_EWOULDBLOCK   == iSocketError
+#ifdef SOCKET_EAGAIN
+                   || SOCKET_EAGAIN        == iSocketError
+#endif
+                   || SOCKET_EINTR         == iSocketError
+                )
+                {
+                    // The call would have blocked, so we need to mark the
+                    // buffer at the head as read-only and try again later
+                    // with the exactly same buffer.
+                    //
+                    d->output_head->hdr.flags |= TBLK_FLAG_LOCKED;
+                }
+                else if (bHandleShutdown)
+                {
+                    shutdownsock(d, R_SOCKDIED);
+                }
+                return;
+            }
+            d->output_size -= cnt;
+        }
+
+        // Consume what was written, and free the blocks which are finished.
+        //
+        size_t nLeft = static_cast<size_t>(cnt);
+        tb = d->output_head;
+        while (nullptr != tb)
+        {
+            if (nLeft < tb->hdr.nchars)
+            {
+                tb->hdr.nchars -= nLeft;
+                tb->hdr.start += nLeft;
+                break;
+            }
+            nLeft -= tb->hdr.nchars;
+
+            TBLOCK *save = tb;
+            tb = tb->hdr.nxt;
+            free_tblock(save);
+            save = nullptr;
+            d->output_head = tb;
+            if (nullptr == tb)
+            {
+                d->output_tail = nullptr;
+#if defined(UNIX_NETWORKING_EPOLL)
+                net_update_interest(d);
+#endif // UNIX_NETWORKING_EPOLL
+            }
+        }
+
+        if (static_cast<size_t>(cnt) < nWanted)
+        {
+            // A short write means the socket buffer is full.
+            //
+            break;
+        }
+    }
+
+    mudstate.debug_cmd = cmdsave;
+}
+#else // UNIX_WRITEV
 void process_output_socket(DESC *d, int bHandleShutdown)
 {
     const UTF8 *cmdsave = mudstate.debug_cmd;
@@ -2600,18 +3814,23 @@ void process_output_socket(DESC *d, int bHandleShutdown)
         }
         TBLOCK *save = tb;
         tb = tb->hdr.nxt;
-        MEMFREE(save);
+        free_tblock(save);
         save = nullptr;
         d->output_head = tb;
         if (tb == nullptr)
         {
             d->output_tail = nullptr;
+#if defined(UNIX_NETWORKING_EPOLL)
+            net_update_interest(d);
+#endif // UNIX_NETWORKING_EPOLL
         }
     }
 
     mudstate.debug_cmd = cmdsave;
 }
 
+#endif // UNIX_WRITEV
+
 #ifdef UNIX_SSL
 void process_output_ssl(DESC *d, int bHandleShutdown)
 {
@@ -2655,12 +3874,15 @@ void process_output_ssl(DESC *d, int bHandleShutdown)
         }
         TBLOCK *save = tb;
         tb = tb->hdr.nxt;
-        MEMFREE(save);
+        free_tblock(save);
         save = nullptr;
         d->output_head = tb;
         if (tb == nullptr)
         {
             d->output_tail = nullptr;
+#if defined(UNIX_NETWORKING_EPOLL)
+            net_update_interest(d);
+#endif // UNIX_NETWORKING_EPOLL
         }
     }
 
@@ -3223,7 +4445,9 @@ void telnet_setup(DESC *d)
     enable_us(d, TELNET_CHARSET);
     enable_him(d, TELNET_CHARSET);
 #ifdef UNIX_SSL
-    if (!d->ssl_session && (tls_ctx != nullptr))
+    if (  !d->ssl_session
+       && !d->ssl_worker
+       && tls_ctx != nullptr)
     {
         enable_him(d, TELNET_STARTTLS);
     }
@@ -3732,7 +4956,32 @@ static void process_input_helper(DESC *d, char *pBytes, int nBytes)
                        && TELNETSB_FOLLOWS == d->aOption[1]
                        && tls_ctx != nullptr)
                     {
-                       d->ssl_session = SSL_new(tls_ctx);
+                       SSL *ssl_session = SSL_new(tls_ctx);
+#if defined(UNIX_SSL_THREADS)
+                       SOCKET sockGame;
+                       if (ssl_worker_attach(ssl_session, d->socket, &sockGame))
+                       {
+                           // The worker now owns the client socket, and
+                           // the descriptor continues on the socketpair.
+                           //
+#if defined(UNIX_NETWORKING_EPOLL)
+                           net_unregister(d);
+#endif // UNIX_NETWORKING_EPOLL
+                           d->socket = sockGame;
+                           d->ssl_worker = true;
+                           config_socket(sockGame);
+#if defined(UNIX_NETWORKING_EPOLL)
+                           net_register(d);
+#elif defined(UNIX_NETWORKING_SELECT)
+                           if (maxd <= sockGame)
+                           {
+                               maxd = sockGame + 1;
+                           }
+#endif // UNIX_NETWORKING_EPOLL
+                           break;
+                       }
+#endif // UNIX_SSL_THREADS
+                       d->ssl_session = ssl_session;
                        SSL_set_fd(d->ssl_session, d->socket);
                        SSL_accept(d->ssl_session);
                     }
@@ -4207,6 +5456,14 @@ void close_sockets(bool emergency, const UTF8 *message)
             shutdownsock(d, R_GOING_DOWN);
         }
     }
+
+#if defined(UNIX_SSL_THREADS)
+    if (!emergency)
+    {
+        ssl_worker_stop();
+    }
+#endif // UNIX_SSL_THREADS
+
     for (int i = 0; i < num_main_game_ports; i++)
     {
         if (0 == SOCKET_CLOSE(main_game_ports[i].socket))
@@ -4662,7 +5919,8 @@ static void DCL_CDECL sighandler(int sig)
                 }
 #endif // STUB_SLAVE
                 else if (  mudconf.fork_dump
-                        && mudstate.dumping)
+                        && mudstate.dumping
+                        && !db_checkpoint_active())
                 {
                     mudstate.dumped = child;
                     if (mudstate.dumper == mudstate.dumped)
@@ -5249,7 +6507,7 @@ void process_windows_tcp(DWORD dwTimeout)
 
                 TBLOCK *save = tb;
                 tb = tb->hdr.nxt;
-                MEMFREE(save);
+                free_tblock(save);
                 save = nullptr;
                 d->output_head = tb;
                 if (nullptr == tb)
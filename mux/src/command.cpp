@@ -16,6 +16,7 @@
 #include "command.h"
 #include "comsys.h"
 #include "functions.h"
+#include "help.h"
 #include "mguests.h"
 #include "mathutil.h"
 #include "powers.h"
@@ -1167,11 +1168,10 @@ static bool process_hook(dbref executor, CMDENT *cmdp, int key, bool save_flg)
                               hk_attr->number, &aowner, &aflags);
         if (atext[0] && !(aflags & AF_NOPROG))
         {
-            reg_ref **preserve = nullptr;
+            reg_frame *preserve = nullptr;
             if (save_flg)
             {
-                preserve = PushRegisters(MAX_GLOBAL_REGS);
-                save_global_regs(preserve);
+                preserve = save_global_regs();
             }
             UTF8 *buff, *bufc;
             bufc = buff = alloc_lbuf("process_hook");
@@ -1181,7 +1181,6 @@ static bool process_hook(dbref executor, CMDENT *cmdp, int key, bool save_flg)
             if (save_flg)
             {
                 restore_global_regs(preserve);
-                PopRegisters(preserve, MAX_GLOBAL_REGS);
             }
             retval = xlate(buff);
             free_lbuf(buff);
@@ -1202,9 +1201,8 @@ void process_hook_args(dbref executor, CMDENT *cmdp, UTF8* arg1, UTF8* arg2, UTF
                               hk_attr->number, &aowner, &aflags);
         if (atext[0] && !(aflags & AF_NOPROG))
         {
-            reg_ref **preserve = nullptr;
-            preserve = PushRegisters(MAX_GLOBAL_REGS);
-            save_global_regs(preserve);
+            reg_frame *preserve = nullptr;
+            preserve = save_global_regs();
             UTF8 *bufc = nullptr;
             UTF8* inargs[5];
             if (arg1)
@@ -1270,7 +1268,6 @@ void process_hook_args(dbref executor, CMDENT *cmdp, UTF8* arg1, UTF8* arg2, UTF
                 *bufc = '\0';
             }
             restore_global_regs(preserve);
-            PopRegisters(preserve, MAX_GLOBAL_REGS);
         }
         free_lbuf(atext);
     }
@@ -3760,6 +3757,29 @@ static void list_hashstat(dbref player, const UTF8 *tab_name, CHashTable *htab)
     raw_notify(player, buff);
 }
 
+// Help indexes are tries rather than hash tables.  Size is the number of
+// trie nodes, Num is the number of topics, Probes counts the nodes visited,
+// and Long is the longest topic name.
+//
+static void list_helpstat(dbref player, int iHelpfile)
+{
+    HELP_INDEX_STATS his;
+    helpindex_stats(iHelpfile, &his);
+
+    UTF8 buff[MBUF_SIZE];
+    UTF8 *p = buff;
+
+    p += LeftJustifyString(p,  13, mudstate.aHelpDesc[iHelpfile].pBaseFilename); *p++ = ' ';
+    p += RightJustifyNumber(p,  4, his.nNodes,   ' '); *p++ = ' ';
+    p += RightJustifyNumber(p,  6, his.nTopics,  ' '); *p++ = ' ';
+    p += RightJustifyNumber(p,  7, 0,            ' '); *p++ = ' ';
+    p += RightJustifyNumber(p, 13, his.nLookups, ' '); *p++ = ' ';
+    p += RightJustifyNumber(p, 13, his.nHits,    ' '); *p++ = ' ';
+    p += RightJustifyNumber(p, 13, his.nProbes,  ' '); *p++ = ' ';
+    p += RightJustifyNumber(p,  4, static_cast<INT64>(his.nLongest), ' '); *p = '\0';
+    raw_notify(player, buff);
+}
+
 static void list_hashstats(dbref player)
 {
     raw_notify(player, T("Hash Stats    Size    Num     Del       Lookups          Hits        Probes Long"));
@@ -3773,7 +3793,13 @@ static void list_hashstats(dbref player)
     list_hashstat(player, T("Player Names"), &mudstate.player_htab);
     list_hashstat(player, T("Net Descr."), &mudstate.desc_htab);
     list_hashstat(player, T("Fwd. lists"), &mudstate.fwdlist_htab);
+    list_hashstat(player, T("Queue Objects"), &mudstate.queue_htab);
+    list_hashstat(player, T("Queue Shares"), &mudstate.share_htab);
+    list_hashstat(player, T("Semaphores"), &mudstate.semaphore_htab);
     list_hashstat(player, T("Excl. $-cmds"), &mudstate.parent_htab);
+    list_hashstat(player, T("$-cmd tables"), &mudstate.cmdtab_htab);
+    list_hashstat(player, T("Locks"), &mudstate.lock_htab);
+    list_hashstat(player, T("Regexps"), &mudstate.regexp_htab);
     list_hashstat(player, T("Mail Messages"), &mudstate.mail_htab);
     list_hashstat(player, T("Channel Names"), &mudstate.channel_htab);
 #if !defined(MEMORY_BASED)
@@ -3781,8 +3807,7 @@ static void list_hashstats(dbref player)
 #endif // MEMORY_BASED
     for (int i = 0; i < mudstate.nHelpDesc; i++)
     {
-        list_hashstat(player, mudstate.aHelpDesc[i].pBaseFilename,
-            mudstate.aHelpDesc[i].ht);
+        list_helpstat(player, i);
     }
 }
 
@@ -3807,6 +3832,74 @@ static void list_db_stats(dbref player)
 #endif // MEMORY_BASED
 }
 
+// ---------------------------------------------------------------------------
+// list_cache_stats: Show how the attribute cache segments are doing.
+//
+static void list_cache_stats(dbref player)
+{
+#ifdef MEMORY_BASED
+    raw_notify(player, T("Database is memory based."));
+#else // MEMORY_BASED
+    ATTR_CACHE_STATS acs;
+    cache_stats(&acs);
+
+    CLinearTimeAbsolute lsaNow;
+    lsaNow.GetUTC();
+    CLinearTimeDelta ltd = lsaNow - cs_ltime;
+    raw_notify(player, tprintf(T("Attr Cache Stats    Entries       Bytes  (over %d seconds)"), ltd.ReturnSeconds()));
+    UTF8 buff[MBUF_SIZE];
+    UTF8 *p = buff;
+    p += LeftJustifyString(p,  15, T("Probation"));
+    p += RightJustifyNumber(p, 12, acs.nProbation, ' ');
+    p += RightJustifyNumber(p, 12, static_cast<INT64>(acs.nProbationSize), ' '); *p = '\0';
+    raw_notify(player, buff);
+
+    p = buff;
+    p += LeftJustifyString(p,  15, T("Protected"));
+    p += RightJustifyNumber(p, 12, acs.nProtected, ' ');
+    p += RightJustifyNumber(p, 12, static_cast<INT64>(acs.nProtectedSize), ' '); *p = '\0';
+    raw_notify(player, buff);
+
+    p = buff;
+    p += LeftJustifyString(p,  27, T("Limit"));
+    p += RightJustifyNumber(p, 12, mudconf.max_cache_size, ' '); *p = '\0';
+    raw_notify(player, buff);
+
+    long iHitRate = 0;
+    if (0 < acs.nHits + acs.nMisses)
+    {
+        iHitRate = static_cast<long>((100 * acs.nHits) / (acs.nHits + acs.nMisses));
+    }
+    p = buff;
+    *p++ = '\n';
+    p += LeftJustifyString(p,  15, T("Hits"));
+    p += RightJustifyNumber(p, 12, acs.nHits, ' ');
+    memcpy(p, "  (", 3); p += 3;
+    p += mux_ltoa(iHitRate, p);
+    memcpy(p, "%)", 2); p += 2; *p = '\0';
+    raw_notify(player, buff);
+
+    const struct
+    {
+        const UTF8 *pName;
+        INT64       nCount;
+    } aCounts[] =
+    {
+        { T("Misses"),     acs.nMisses     },
+        { T("Evictions"),  acs.nEvictions  },
+        { T("Promotions"), acs.nPromotions },
+        { T("Demotions"),  acs.nDemotions  },
+    };
+    for (size_t i = 0; i < sizeof(aCounts)/sizeof(aCounts[0]); i++)
+    {
+        p = buff;
+        p += LeftJustifyString(p,  15, aCounts[i].pName);
+        p += RightJustifyNumber(p, 12, aCounts[i].nCount, ' '); *p = '\0';
+        raw_notify(player, buff);
+    }
+#endif // MEMORY_BASED
+}
+
 // ---------------------------------------------------------------------------
 // list_process: List local resource usage stats of the mux process.
 // Adapted from code by Claudius@PythonMUCK,
@@ -3972,6 +4065,7 @@ static void list_rlevels(dbref player)
 #ifdef REALITY_LVLS
 #define LIST_RLEVELS    26
 #endif
+#define LIST_CACHE      27
 
 NAMETAB list_names[] =
 {
@@ -3980,6 +4074,7 @@ NAMETAB list_names[] =
     {T("attributes"),         2,  CA_PUBLIC,  LIST_ATTRIBUTES},
     {T("bad_names"),          2,  CA_WIZARD,  LIST_BADNAMES},
     {T("buffers"),            2,  CA_WIZARD,  LIST_BUFTRACE},
+    {T("cache"),              2,  CA_WIZARD,  LIST_CACHE},
     {T("commands"),           3,  CA_PUBLIC,  LIST_COMMANDS},
     {T("config_permissions"), 3,  CA_GOD,     LIST_CONF_PERMS},
     {T("costs"),              3,  CA_PUBLIC,  LIST_COSTS},
@@ -4102,6 +4197,9 @@ void do_list(dbref executor, dbref caller, dbref enactor, int eval, int key,
     case LIST_DB_STATS:
         list_db_stats(executor);
         break;
+    case LIST_CACHE:
+        list_cache_stats(executor);
+        break;
     case LIST_PROCESS:
         list_process(executor);
         break;
@@ -1519,25 +1519,57 @@ void SendChannelMessage
     bool bSpoof = ((ch->type & CHANNEL_SPOOF) != 0);
     ch->num_messages++;
 
+    // Most listeners are players who only need the text on their
+    // connections.  For them, each message is rendered once per output
+    // profile and shared.  Everyone else goes through notify_check().
+    //
+    const int key = MSG_PUP_ALWAYS|MSG_ME_ALL|MSG_F_DOWN|MSG_OOC|MSG_SRC_COMSYS;
+    mux_string *sNormal = new mux_string(msgNormal);
+    mux_string *sNoComtitle = sNormal;
+    if (  nullptr != msgNoComtitle
+       && msgNoComtitle != msgNormal)
+    {
+        sNoComtitle = new mux_string(msgNoComtitle);
+    }
+    SHARED_TEXT stNormal;
+    SHARED_TEXT stNoComtitle;
+    shared_text_init(&stNormal, *sNormal);
+    shared_text_init(&stNoComtitle, *sNoComtitle);
+    SHARED_TEXT *pstNoComtitle = (sNoComtitle == sNormal) ? &stNormal : &stNoComtitle;
+
     struct comuser *user;
     for (user = ch->on_users; user; user = user->on_next)
     {
         if (  user->bUserIsOn
            && test_receive_access(user->who, ch))
         {
-            if (  user->ComTitleStatus
-               || bSpoof
-               || msgNoComtitle == nullptr)
+            bool bNormal = (  user->ComTitleStatus
+                           || bSpoof
+                           || msgNoComtitle == nullptr);
+            mux_string *sMsg = bNormal ? sNormal : sNoComtitle;
+            if (0 == sMsg->length_byte())
             {
-                notify_comsys(user->who, executor, msgNormal);
+                continue;
+            }
+            else if (notify_is_direct(user->who, executor, key))
+            {
+                raw_notify_shared(user->who, bNormal ? &stNormal : pstNoComtitle);
             }
             else
             {
-                notify_comsys(user->who, executor, msgNoComtitle);
+                notify_comsys(user->who, executor, *sMsg);
             }
         }
     }
 
+    shared_text_free(&stNormal);
+    shared_text_free(&stNoComtitle);
+    if (sNoComtitle != sNormal)
+    {
+        delete sNoComtitle;
+    }
+    delete sNormal;
+
     // Handle logging.
     //
     dbref obj = ch->chan_obj;
@@ -77,6 +77,7 @@ void cf_init(void)
     mudconf.ssl_certificate_file[0] = '\0';
     mudconf.ssl_certificate_key[0] = '\0';
     mudconf.ssl_certificate_password[0] = '\0';
+    mudconf.ssl_threads = 2;
 #endif
 
     mudconf.init_size = 1000;
@@ -147,6 +148,7 @@ void cf_init(void)
     mudconf.check_interval = 600;
     mudconf.events_daily_hour = 7;
     mudconf.dump_offset = 0;
+    mudconf.dump_slice = 0;
     mudconf.check_offset = 300;
     mudconf.idle_timeout = 3600;
     mudconf.conn_timeout = 120;
@@ -182,6 +184,7 @@ void cf_init(void)
     mudconf.robotcost = 1000;
     mudconf.pagecost = 10;
     mudconf.searchcost = 100;
+    mudconf.search_slice = 0;
     mudconf.waitcost = 10;
     mudconf.machinecost = 64;
     mudconf.exit_quota = 1;
@@ -191,6 +194,7 @@ void cf_init(void)
     mudconf.mail_expiration = 14;
     mudconf.queuemax = 100;
     mudconf.queue_chunk = 10;
+    mudconf.queue_fair_share = true;
     mudconf.active_q_chunk  = 10;
     mudconf.sacfactor       = 5;
     mudconf.sacadjust       = -1;
@@ -200,6 +204,7 @@ void cf_init(void)
     mudconf.autozone        = true;
     mudconf.use_hostname    = true;
     mudconf.clone_copy_cost = false;
+    mudconf.color_quantize  = false;
     mudconf.dark_sleepers   = true;
     mudconf.ex_flags        = true;
     mudconf.exam_public     = true;
@@ -289,6 +294,8 @@ void cf_init(void)
     mudconf.zone_nest_lim = 20;
     mudconf.stack_limit = 50;
     mudconf.cache_names = true;
+    mudconf.binary_database = false;
+    mudconf.cache_mmap = false;
     mudconf.toad_recipient = -1;
     mudconf.eval_comtitle = true;
     mudconf.run_startup = true;
@@ -366,10 +373,7 @@ void cf_init(void)
     mudstate.poutnew = nullptr;
     mudstate.poutbufc = nullptr;
     mudstate.poutobj = NOTHING;
-    for (i = 0; i < MAX_GLOBAL_REGS; i++)
-    {
-        mudstate.global_regs[i] = nullptr;
-    }
+    mudstate.global_regs = RegFrameEmpty();
 #if defined(STUB_SLAVE)
     mudstate.pResultsSet = nullptr;
     mudstate.iRow = RS_TOP;
@@ -1391,7 +1395,7 @@ static int add_helpfile(dbref player, UTF8 *cmd, UTF8 *str, bool bEval)
     //
     HELP_DESC *pDesc = mudstate.aHelpDesc + mudstate.nHelpDesc;
     pDesc->CommandName = StringClone(pCmdName);
-    pDesc->ht = nullptr;
+    pDesc->pIndex = nullptr;
     pDesc->pBaseFilename = StringClone(pBase);
     pDesc->bEval = bEval;
 
@@ -1767,12 +1771,15 @@ static CONFPARM conftable[] =
     {T("autozone"),                  cf_bool,        CA_GOD,    CA_PUBLIC,   (int *)&mudconf.autozone,        nullptr,            0},
     {T("bad_name"),                  cf_badname,     CA_GOD,    CA_DISABLED, nullptr,                         nullptr,            0},
     {T("badsite_file"),              cf_string_dyn,  CA_STATIC, CA_GOD,      (int *)&mudconf.site_file,       nullptr, SIZEOF_PATHNAME},
+    {T("binary_database"),           cf_bool,        CA_GOD,    CA_WIZARD,   (int *)&mudconf.binary_database, nullptr,            0},
+    {T("cache_mmap"),                cf_bool,        CA_STATIC, CA_WIZARD,   (int *)&mudconf.cache_mmap,      nullptr,            0},
     {T("cache_names"),               cf_bool,        CA_STATIC, CA_GOD,      (int *)&mudconf.cache_names,     nullptr,            0},
     {T("cache_pages"),               cf_int,         CA_STATIC, CA_WIZARD,   &mudconf.cache_pages,            nullptr,            0},
     {T("cache_tick_period"),         cf_seconds,     CA_GOD,    CA_WIZARD,   (int *)&mudconf.cache_tick_period, nullptr,          0},
     {T("check_interval"),            cf_int,         CA_GOD,    CA_WIZARD,   &mudconf.check_interval,         nullptr,            0},
     {T("check_offset"),              cf_int,         CA_GOD,    CA_WIZARD,   &mudconf.check_offset,           nullptr,            0},
     {T("clone_copies_cost"),         cf_bool,        CA_GOD,    CA_PUBLIC,   (int *)&mudconf.clone_copy_cost, nullptr,            0},
+    {T("color_quantize"),            cf_bool,        CA_GOD,    CA_WIZARD,   (int *)&mudconf.color_quantize,  nullptr,            0},
     {T("command_quota_increment"),   cf_int,         CA_GOD,    CA_WIZARD,   &mudconf.cmd_quota_incr,         nullptr,            0},
     {T("command_quota_max"),         cf_int,         CA_GOD,    CA_WIZARD,   &mudconf.cmd_quota_max,          nullptr,            0},
     {T("compress_program"),          cf_string_dyn,  CA_STATIC, CA_GOD,      (int *)&mudconf.compress,        nullptr, SIZEOF_PATHNAME},
@@ -1797,6 +1804,7 @@ static CONFPARM conftable[] =
     {T("dump_interval"),             cf_int,         CA_GOD,    CA_WIZARD,   &mudconf.dump_interval,          nullptr,            0},
     {T("dump_message"),              cf_string,      CA_GOD,    CA_WIZARD,   (int *)mudconf.dump_msg,         nullptr,          256},
     {T("dump_offset"),               cf_int,         CA_GOD,    CA_WIZARD,   &mudconf.dump_offset,            nullptr,            0},
+    {T("dump_slice"),                cf_int,         CA_GOD,    CA_WIZARD,   &mudconf.dump_slice,             nullptr,            0},
     {T("earn_limit"),                cf_int,         CA_GOD,    CA_PUBLIC,   &mudconf.paylimit,               nullptr,            0},
     {T("eval_comtitle"),             cf_bool,        CA_GOD,    CA_PUBLIC,   (int *)&mudconf.eval_comtitle,   nullptr,            0},
     {T("events_daily_hour"),         cf_int,         CA_GOD,    CA_PUBLIC,   &mudconf.events_daily_hour,      nullptr,            0},
@@ -1919,6 +1927,7 @@ static CONFPARM conftable[] =
     {T("public_flags"),              cf_bool,        CA_GOD,    CA_PUBLIC,   (int *)&mudconf.pub_flags,       nullptr,            0},
     {T("pueblo_message"),            cf_string,      CA_GOD,    CA_WIZARD,   (int *)mudconf.pueblo_msg,       nullptr,    GBUF_SIZE},
     {T("queue_active_chunk"),        cf_int,         CA_GOD,    CA_PUBLIC,   &mudconf.active_q_chunk,         nullptr,            0},
+    {T("queue_fair_share"),          cf_bool,        CA_GOD,    CA_PUBLIC,   (int *)&mudconf.queue_fair_share, nullptr,           0},
     {T("queue_idle_chunk"),          cf_int,         CA_GOD,    CA_PUBLIC,   &mudconf.queue_chunk,            nullptr,            0},
     {T("quiet_look"),                cf_bool,        CA_GOD,    CA_PUBLIC,   (int *)&mudconf.quiet_look,      nullptr,            0},
     {T("quiet_whisper"),             cf_bool,        CA_GOD,    CA_PUBLIC,   (int *)&mudconf.quiet_whisper,   nullptr,            0},
@@ -1947,6 +1956,7 @@ static CONFPARM conftable[] =
     {T("safe_wipe"),                 cf_bool,        CA_GOD,    CA_WIZARD,   (int *)&mudconf.safe_wipe,       nullptr,            0},
     {T("safer_passwords"),           cf_bool,        CA_GOD,    CA_PUBLIC,   (int *)&mudconf.safer_passwords, nullptr,            0},
     {T("search_cost"),               cf_int,         CA_GOD,    CA_PUBLIC,   &mudconf.searchcost,             nullptr,            0},
+    {T("search_slice"),              cf_int,         CA_GOD,    CA_WIZARD,   &mudconf.search_slice,           nullptr,            0},
     {T("see_owned_dark"),            cf_bool,        CA_GOD,    CA_PUBLIC,   (int *)&mudconf.see_own_dark,    nullptr,            0},
     {T("signal_action"),             cf_option,      CA_STATIC, CA_GOD,      &mudconf.sig_action,             sigactions_nametab, 0},
     {T("site_chars"),                cf_int,         CA_GOD,    CA_WIZARD,   (int *)&mudconf.site_chars,      nullptr,            0},
@@ -1956,6 +1966,7 @@ static CONFPARM conftable[] =
     {T("ssl_certificate_file"),      cf_string,      CA_STATIC, CA_DISABLED, (int *)mudconf.ssl_certificate_file,nullptr,       128},
     {T("ssl_certificate_key"),       cf_string,      CA_STATIC, CA_DISABLED, (int *)mudconf.ssl_certificate_key, nullptr,       128},
     {T("ssl_certificate_password"),  cf_string,      CA_STATIC, CA_DISABLED, (int *)mudconf.ssl_certificate_password, nullptr,  128},
+    {T("ssl_threads"),               cf_int,         CA_STATIC, CA_WIZARD,   &mudconf.ssl_threads,            nullptr,            0},
 #endif
     {T("stack_limit"),               cf_int,         CA_GOD,    CA_PUBLIC,   &mudconf.stack_limit,            nullptr,            0},
     {T("starting_money"),            cf_int,         CA_GOD,    CA_PUBLIC,   &mudconf.paystart,               nullptr,            0},
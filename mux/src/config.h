@@ -55,9 +55,27 @@
 // Build Options
 //
 #define UNIX_NETWORKING
+#if defined(HAVE_SYS_EPOLL_H) && defined(HAVE_EPOLL_CREATE) \
+ && defined(HAVE_EPOLL_CTL) && defined(HAVE_EPOLL_WAIT)
+#define UNIX_NETWORKING_EPOLL
+#elif defined(HAVE_SYS_SELECT_H) && defined(HAVE_SELECT)
+#define UNIX_NETWORKING_SELECT
+#else
+#error Platform does not provide epoll() or select().
+#endif
+#if defined(HAVE_SYS_UIO_H) && defined(HAVE_WRITEV)
+#define UNIX_WRITEV
+#endif
 #define UNIX_SIGNALS
 #define UNIX_PROCESSES
 #define UNIX_FILES
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_MMAP) \
+ && defined(HAVE_MUNMAP) && defined(HAVE_FTRUNCATE)
+#define UNIX_MAPPED_FILES
+#endif
+#if defined(HAVE_PTHREAD_H) && defined(HAVE_PTHREAD_CREATE)
+#define UNIX_THREADS
+#endif
 #define UNIX_CRYPT
 #define UNIX_TIME
 #if defined(HAVE_DLOPEN)
@@ -68,6 +86,9 @@
 #if defined(SSL_ENABLED)
 #define UNIX_SSL
 #define UNIX_DIGEST
+#if defined(UNIX_THREADS) && defined(HAVE_POLL_H)
+#define UNIX_SSL_THREADS
+#endif // UNIX_THREADS && HAVE_POLL_H
 #endif // SSL_ENABLED
 
 #endif // WIN32
@@ -145,6 +166,18 @@ extern int      setrlimit(int, struct rlimit *);
 #include <sys/stat.h>
 #endif
 
+#if defined(UNIX_MAPPED_FILES)
+#include <sys/mman.h>
+#endif // UNIX_MAPPED_FILES
+
+#if defined(UNIX_THREADS)
+#include <pthread.h>
+#endif // UNIX_THREADS
+
+#if defined(UNIX_SSL_THREADS)
+#include <poll.h>
+#endif // UNIX_SSL_THREADS
+
 #ifdef HAVE_GETTIMEOFDAY
 #ifdef NEED_GETTIMEOFDAY_DCL
 extern int gettimeofday(struct timeval *, struct timezone *);
@@ -181,9 +214,13 @@ extern int getdtablesize(void);
 #include <sys/epoll.h>
 #endif // UNIX_NETWORKING_EPOLL && HAVE_SYS_EPOLL_H
 
-#if defined(UNIX_NETWORKING_SELECT) && defined(HAVE_SYS_SELECT_H)
+#if defined(UNIX_WRITEV)
+#include <sys/uio.h>
+#endif // UNIX_WRITEV
+
+#if defined(UNIX_NETWORKING) && defined(HAVE_SYS_SELECT_H)
 #include <sys/select.h>
-#endif // UNIX_NETWORKING_SELECT && HAVE_SYS_SELECT_H
+#endif // UNIX_NETWORKING && HAVE_SYS_SELECT_H
 
 #ifdef UNIX_SSL
 #include <openssl/ssl.h>
@@ -315,6 +352,8 @@ typedef char  boolexp_type;
 #define MAX_GLOBAL_REGS     36  /* r() registers */
 
 #define OUTPUT_BLOCK_SIZE   16384
+#define SBLOCK_SHARE_MIN    256 /* Shorter shared text is copied instead */
+#define OUTPUT_IOV_MAX      16  /* Output blocks gathered per writev() */
 
 /* ---------------------------------------------------------------------------
  * Database R/W flags.
@@ -433,12 +472,6 @@ typedef unsigned __int64 UINT64;
 
 #else // WIN32
 
-#if defined(HAVE_SYS_SELECT_H) && defined(HAVE_SELECT)
-#define UNIX_NETWORKING_SELECT
-#else
-#error Platform does not provide select().
-#endif
-
 #define DCL_CDECL
 #define DCL_EXPORT
 #define DCL_API
@@ -676,6 +709,7 @@ typedef int SOCKET;
 #endif // EAGAIN
 #define SOCKET_EBADF       (EBADF)
 #define INVALID_SOCKET (-1)
+#define SD_SEND (1)
 #define SD_BOTH (2)
 
 #endif
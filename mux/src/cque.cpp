@@ -75,19 +75,275 @@ static int add_to(dbref executor, int am, int attrnum)
     return num;
 }
 
-// This Task assumes that pEntry is already unlinked from any lists it may
-// have been related to.
+// ---------------------------------------------------------------------------
+// Fair-share scheduling of the command queue.
+//
+// Tasks of equal priority run in order of their share tag (see CScheduler).
+// Each queue entry is tagged with a virtual start time: the later of the
+// scheduler's virtual time and the virtual finish time of the previous
+// entry from the same owner.  The owner's finish time then advances by the
+// owner's estimated CPU cost per entry, and it is corrected by the measured
+// cost after the entry runs.  An owner who has been using more CPU than
+// others has tags further ahead, so entries from lighter owners run first.
+//
+// The correction is by the estimate charged to that entry, and it never
+// moves the finish time back past the newest entry still waiting, so each
+// owner's own entries still run in the order they were queued.  An owner's
+// record is freed once nothing it owns is left in the queue.
+//
+struct queue_share
+{
+    INT64 iFinish;      // Virtual finish time of the owner's entries.
+    INT64 iLastFinish;  // Virtual finish time of the newest tagged entry.
+    INT64 iEstimate;    // Smoothed CPU cost per entry in 100ns.
+    int   nQueued;      // Tagged entries not yet run or discarded.
+};
+
+#define SHARE_MIN_ESTIMATE 10   // One microsecond.
+
+static CLinearTimeDelta ltdShareTotal;
+
+static struct queue_share *share_lookup(dbref owner)
+{
+    struct queue_share *ps = (struct queue_share *)
+        hashfindLEN(&owner, sizeof(owner), &mudstate.share_htab);
+    if (nullptr == ps)
+    {
+        try
+        {
+            ps = new struct queue_share;
+        }
+        catch (...)
+        {
+            ; // Nothing.
+        }
+
+        if (nullptr != ps)
+        {
+            ps->iFinish = 0;
+            ps->iLastFinish = 0;
+            ps->iEstimate = SHARE_MIN_ESTIMATE;
+            ps->nQueued = 0;
+            hashaddLEN(&owner, sizeof(owner), ps, &mudstate.share_htab);
+        }
+    }
+    return ps;
+}
+
+// Forget an entry's tag.  This happens when the entry is run, discarded,
+// or tagged again.
+//
+static void share_release(BQUE *point)
+{
+    dbref owner = point->share_owner;
+    if (NOTHING == owner)
+    {
+        return;
+    }
+    point->share_owner = NOTHING;
+
+    struct queue_share *ps = (struct queue_share *)
+        hashfindLEN(&owner, sizeof(owner), &mudstate.share_htab);
+    if (nullptr != ps)
+    {
+        ps->nQueued--;
+        if (ps->nQueued <= 0)
+        {
+            hashdeleteLEN(&owner, sizeof(owner), &mudstate.share_htab);
+            delete ps;
+        }
+    }
+}
+
+static void share_tag(PTASK_RECORD pTask, BQUE *point)
+{
+    if (  !mudconf.queue_fair_share
+       || nullptr == pTask
+       || !Good_obj(point->executor))
+    {
+        return;
+    }
+
+    share_release(point);
+
+    dbref owner = Owner(point->executor);
+    struct queue_share *ps = share_lookup(owner);
+    if (nullptr != ps)
+    {
+        INT64 iStart = scheduler.GetVirtualTime();
+        if (iStart < ps->iFinish)
+        {
+            iStart = ps->iFinish;
+        }
+        ps->iFinish = iStart + ps->iEstimate;
+        ps->iLastFinish = ps->iFinish;
+        ps->nQueued++;
+        pTask->m_iShareTag = iStart;
+        point->share_owner = owner;
+        point->share_estimate = ps->iEstimate;
+    }
+}
+
+// Replace the estimate charged to an entry with what the entry actually
+// cost.  The entry is still counted in nQueued.
+//
+static void share_charge(BQUE *point, CLinearTimeDelta &ltdUsed)
+{
+    ltdShareTotal += ltdUsed;
+
+    dbref owner = point->share_owner;
+    if (  !mudconf.queue_fair_share
+       || NOTHING == owner)
+    {
+        return;
+    }
+
+    struct queue_share *ps = (struct queue_share *)
+        hashfindLEN(&owner, sizeof(owner), &mudstate.share_htab);
+    if (nullptr == ps)
+    {
+        return;
+    }
+
+    INT64 iCost = ltdUsed.Return100ns();
+    ps->iFinish += iCost - point->share_estimate;
+
+    // Later entries from this owner which are still waiting were tagged
+    // before iLastFinish.  A new entry must not be tagged ahead of them.
+    //
+    if (  1 < ps->nQueued
+       && ps->iFinish < ps->iLastFinish)
+    {
+        ps->iFinish = ps->iLastFinish;
+    }
+
+    INT64 iNow = scheduler.GetVirtualTime();
+    if (ps->iFinish < iNow)
+    {
+        ps->iFinish = iNow;
+    }
+
+    ps->iEstimate += (iCost - ps->iEstimate)/4;
+    if (ps->iEstimate < SHARE_MIN_ESTIMATE)
+    {
+        ps->iEstimate = SHARE_MIN_ESTIMATE;
+    }
+}
+
+static int share_percent(INT64 iUsed)
+{
+    INT64 iTotal = ltdShareTotal.Return100ns();
+    if (iTotal <= 0)
+    {
+        return 0;
+    }
+    return static_cast<int>((100 * iUsed) / iTotal);
+}
+
+// ---------------------------------------------------------------------------
+// queue_cpu_owned: CPU used by queued commands of the objects an owner owns.
+//
+// The CPU is kept per object in cpu_time_used and cleared by @timecheck, so
+// this covers the same period as the rest of the @timecheck report.
+//
+static INT64 queue_cpu_owned(dbref owner)
+{
+    int nRefs;
+    dbref *aRefs = db_index_collect(owner, IX_BIT(IX_OWNER), 0,
+        mudstate.db_top - 1, &nRefs);
+
+    INT64 iUsed = 0;
+    for (int i = 0; i < nRefs; i++)
+    {
+        iUsed += db[aRefs[i]].cpu_time_used.Return100ns();
+    }
+    MEMFREE(aRefs);
+    return iUsed;
+}
+
+// ---------------------------------------------------------------------------
+// report_queue_shares: List the queue CPU used by each owner.
+//
+// Called before the per-object counters are cleared.
 //
+void report_queue_shares(dbref player, bool yes_screen, bool yes_log, bool yes_clear)
+{
+    if (yes_screen)
+    {
+        raw_notify(player, T("Queue CPU by owner (msecs, share):"));
+    }
+
+    INT64 *aUsed = (INT64 *)MEMALLOC(mudstate.db_top * sizeof(INT64));
+    ISOUTOFMEMORY(aUsed);
+    memset(aUsed, 0, mudstate.db_top * sizeof(INT64));
+
+    dbref thing;
+    DO_WHOLE_DB(thing)
+    {
+        dbref owner = Owner(thing);
+        if (  Good_obj(owner)
+           && owner < mudstate.db_top)
+        {
+            aUsed[owner] += db[thing].cpu_time_used.Return100ns();
+        }
+    }
+
+    int nOwners = 0;
+    DO_WHOLE_DB(thing)
+    {
+        if (0 == aUsed[thing])
+        {
+            continue;
+        }
+        nOwners++;
+
+        CLinearTimeDelta ltd;
+        ltd.Set100ns(aUsed[thing]);
+        long used_msecs = ltd.ReturnMilliseconds();
+        int  pct = share_percent(aUsed[thing]);
+        if (yes_log)
+        {
+            Log.tinyprintf(T("#%d\t%ld\t%d%%" ENDLINE), thing, used_msecs, pct);
+        }
+        if (yes_screen)
+        {
+            raw_notify(player, tprintf(T("#%d\t%ld\t%d%%"), thing, used_msecs, pct));
+        }
+    }
+    MEMFREE(aUsed);
+
+    if (yes_screen)
+    {
+        raw_notify(player, tprintf(T("Queue used %ld msecs for %d owners."),
+            ltdShareTotal.ReturnMilliseconds(), nOwners));
+    }
+    if (yes_log)
+    {
+        Log.tinyprintf(T("Queue used %ld msecs for %d owners." ENDLINE),
+            ltdShareTotal.ReturnMilliseconds(), nOwners);
+    }
+    if (yes_clear)
+    {
+        ltdShareTotal.Set100ns(0);
+    }
+}
+
+static void que_unlink(BQUE *point);
+
 static void Task_RunQueueEntry(void *pEntry, int iUnused)
 {
     UNUSED_PARAMETER(iUnused);
 
     BQUE *point = (BQUE *)pEntry;
+    que_unlink(point);
     dbref executor = point->executor;
 
     if (  Good_obj(executor)
        && !Going(executor))
     {
+        CLinearTimeDelta ltdEntry;
+        ltdEntry.Set100ns(0);
+
         giveto(executor, mudconf.waitcost);
         mudstate.curr_enactor = point->enactor;
         mudstate.curr_executor = executor;
@@ -97,16 +353,8 @@ static void Task_RunQueueEntry(void *pEntry, int iUnused)
         {
             // Load scratch args.
             //
-            for (int i = 0; i < MAX_GLOBAL_REGS; i++)
-            {
-                if (mudstate.global_regs[i])
-                {
-                    RegRelease(mudstate.global_regs[i]);
-                    mudstate.global_regs[i] = nullptr;
-                }
-                mudstate.global_regs[i] = point->scr[i];
-                point->scr[i] = nullptr;
-            }
+            restore_global_regs(point->scr);
+            point->scr = nullptr;
 
 #if defined(STUB_SLAVE)
             if (nullptr != mudstate.pResultsSet)
@@ -182,17 +430,18 @@ static void Task_RunQueueEntry(void *pEntry, int iUnused)
                     CLinearTimeDelta ltdUsageEnd = GetProcessorUsage();
                     CLinearTimeDelta ltd = ltdUsageEnd - ltdUsageBegin;
                     db[executor].cpu_time_used += ltd;
+                    ltdEntry += ltd;
 
                     ltd = ltaEnd - ltaBegin;
                     if (mudconf.rpt_cmdsecs < ltd)
                     {
                         STARTLOG(LOG_PROBLEMS, "CMD", "CPU");
                         log_name_and_loc(executor);
-                        UTF8 *logbuf = alloc_lbuf("do_top.LOG.cpu");
-                        mux_sprintf(logbuf, LBUF_SIZE, T(" queued command taking %s secs (enactor #%d): "),
+                        UTF8 *logbuf = alloc_gbuf("do_top.LOG.cpu");
+                        mux_sprintf(logbuf, GBUF_SIZE, T(" queued command taking %s secs (enactor #%d): "),
                             ltd.ReturnSecondsString(4), point->enactor);
                         log_text(logbuf);
-                        free_lbuf(logbuf);
+                        free_gbuf(logbuf);
                         log_text(log_cmdbuf);
                         ENDLOG;
                     }
@@ -225,22 +474,16 @@ static void Task_RunQueueEntry(void *pEntry, int iUnused)
             mudstate.inpipe = false;
             mudstate.poutobj = NOTHING;
         }
+        share_charge(point, ltdEntry);
     }
+    share_release(point);
 
-    for (int i = 0; i < MAX_GLOBAL_REGS; i++)
+    if (point->scr)
     {
-        if (point->scr[i])
-        {
-            RegRelease(point->scr[i]);
-            point->scr[i] = nullptr;
-        }
-
-        if (mudstate.global_regs[i])
-        {
-            RegRelease(mudstate.global_regs[i]);
-            mudstate.global_regs[i] = nullptr;
-        }
+        RegFrameRelease(point->scr);
+        point->scr = nullptr;
     }
+    clear_global_regs();
 
 #if defined(STUB_SLAVE)
     mudstate.iRow = RS_TOP;
@@ -277,6 +520,7 @@ static void Task_SemaphoreTimeout(void *pExpired, int iUnused)
     // A semaphore has timed out.
     //
     BQUE *point = (BQUE *)pExpired;
+    que_unlink(point);
     add_to(point->u.s.sem, -1, point->u.s.attr);
     point->u.s.sem = NOTHING;
     Task_RunQueueEntry(point, 0);
@@ -292,21 +536,151 @@ void Task_SQLTimeout(void *pExpired, int iUnused)
     Task_RunQueueEntry(point, 0);
 }
 
+// Besides its task in the scheduler, each queue entry is kept on a list of
+// entries for its executor, and an entry blocked on a semaphore is also kept
+// on a list for that semaphore. @halt and @notify use these lists to find
+// the entries they affect without looking at every task.
+//
+static void que_link(BQUE *point, PTASK_RECORD pTask)
+{
+    point->pTask = pTask;
+
+    dbref executor = point->executor;
+    BQUE *pHead = (BQUE *)hashfindLEN(&executor, sizeof(executor), &mudstate.queue_htab);
+    point->pExecPrev = nullptr;
+    point->pExecNext = pHead;
+    if (nullptr == pHead)
+    {
+        hashaddLEN(&executor, sizeof(executor), point, &mudstate.queue_htab);
+    }
+    else
+    {
+        pHead->pExecPrev = point;
+        hashreplLEN(&executor, sizeof(executor), point, &mudstate.queue_htab);
+    }
+
+    point->pSemNext = nullptr;
+    point->pSemPrev = nullptr;
+    if (Task_SemaphoreTimeout == pTask->fpTask)
+    {
+        dbref sem = point->u.s.sem;
+        pHead = (BQUE *)hashfindLEN(&sem, sizeof(sem), &mudstate.semaphore_htab);
+        point->pSemNext = pHead;
+        if (nullptr == pHead)
+        {
+            hashaddLEN(&sem, sizeof(sem), point, &mudstate.semaphore_htab);
+        }
+        else
+        {
+            pHead->pSemPrev = point;
+            hashreplLEN(&sem, sizeof(sem), point, &mudstate.semaphore_htab);
+        }
+    }
+}
+
+static void que_unlink_semaphore(BQUE *point)
+{
+    if (nullptr == point->pSemPrev)
+    {
+        dbref sem = point->u.s.sem;
+        if (nullptr == point->pSemNext)
+        {
+            hashdeleteLEN(&sem, sizeof(sem), &mudstate.semaphore_htab);
+        }
+        else
+        {
+            hashreplLEN(&sem, sizeof(sem), point->pSemNext, &mudstate.semaphore_htab);
+        }
+    }
+    else
+    {
+        point->pSemPrev->pSemNext = point->pSemNext;
+    }
+    if (nullptr != point->pSemNext)
+    {
+        point->pSemNext->pSemPrev = point->pSemPrev;
+    }
+    point->pSemNext = nullptr;
+    point->pSemPrev = nullptr;
+}
+
+// Remove an entry from the lists. This happens as soon as its task is taken
+// from the scheduler to run or is removed from the scheduler.
+//
+static void que_unlink(BQUE *point)
+{
+    if (nullptr == point->pTask)
+    {
+        return;
+    }
+
+    if (Task_SemaphoreTimeout == point->pTask->fpTask)
+    {
+        que_unlink_semaphore(point);
+    }
+
+    if (nullptr == point->pExecPrev)
+    {
+        dbref executor = point->executor;
+        if (nullptr == point->pExecNext)
+        {
+            hashdeleteLEN(&executor, sizeof(executor), &mudstate.queue_htab);
+        }
+        else
+        {
+            hashreplLEN(&executor, sizeof(executor), point->pExecNext, &mudstate.queue_htab);
+        }
+    }
+    else
+    {
+        point->pExecPrev->pExecNext = point->pExecNext;
+    }
+    if (nullptr != point->pExecNext)
+    {
+        point->pExecNext->pExecPrev = point->pExecPrev;
+    }
+    point->pExecNext = nullptr;
+    point->pExecPrev = nullptr;
+    point->pTask = nullptr;
+}
+
+// Take an entry out of the scheduler and free it without running it.
+//
+static void que_discard(BQUE *point)
+{
+    PTASK_RECORD pTask = point->pTask;
+    que_unlink(point);
+    if (nullptr != pTask)
+    {
+        scheduler.RemoveTask(pTask);
+    }
+    share_release(point);
+
+    if (point->scr)
+    {
+        RegFrameRelease(point->scr);
+        point->scr = nullptr;
+    }
+
+    MEMFREE(point->text);
+    point->text = nullptr;
+    free_qentry(point);
+}
+
 static dbref Halt_Player_Target;
 static dbref Halt_Object_Target;
 static int   Halt_Entries;
 static dbref Halt_Player_Run;
 static dbref Halt_Entries_Run;
 
-static int CallBack_HaltQueue(PTASK_RECORD p)
+// Halt the entries queued for one executor.
+//
+static void halt_executor(dbref executor)
 {
-    if (  p->fpTask == Task_RunQueueEntry
-       || p->fpTask == Task_SQLTimeout
-       || p->fpTask == Task_SemaphoreTimeout)
+    BQUE *point = (BQUE *)hashfindLEN(&executor, sizeof(executor), &mudstate.queue_htab);
+    while (nullptr != point)
     {
-        // This is a @wait, timed Semaphore Task, or timed SQL Query.
-        //
-        BQUE *point = (BQUE *)(p->arg_voidptr);
+        BQUE *pNext = point->pExecNext;
         if (que_want(point, Halt_Player_Target, Halt_Object_Target))
         {
             // Accounting for pennies and queue quota.
@@ -328,27 +702,14 @@ static int CallBack_HaltQueue(PTASK_RECORD p)
             }
             Halt_Entries++;
             Halt_Entries_Run++;
-            if (p->fpTask == Task_SemaphoreTimeout)
+            if (Task_SemaphoreTimeout == point->pTask->fpTask)
             {
                 add_to(point->u.s.sem, -1, point->u.s.attr);
             }
-
-            for (int i = 0; i < MAX_GLOBAL_REGS; i++)
-            {
-                if (point->scr[i])
-                {
-                    RegRelease(point->scr[i]);
-                    point->scr[i] = nullptr;
-                }
-            }
-
-            MEMFREE(point->text);
-            point->text = nullptr;
-            free_qentry(point);
-            return IU_REMOVE_TASK;
+            que_discard(point);
         }
+        point = pNext;
     }
-    return IU_NEXT_TASK;
 }
 
 // ------------------------------------------------------------------
@@ -371,7 +732,41 @@ int halt_que(dbref executor, dbref object)
 
     // Process @wait, timed semaphores, and untimed semaphores.
     //
-    scheduler.TraverseUnordered(CallBack_HaltQueue);
+    if (NOTHING != object)
+    {
+        halt_executor(object);
+    }
+    else
+    {
+        // Every executor with queued entries may need to be visited. They
+        // are gathered first because halting them changes the table.
+        //
+        unsigned int nExecutors = mudstate.queue_htab.GetEntryCount();
+        if (0 < nExecutors)
+        {
+            dbref *aExecutors = (dbref *)MEMALLOC(nExecutors * sizeof(dbref));
+            ISOUTOFMEMORY(aExecutors);
+
+            unsigned int n = 0;
+            BQUE *point;
+            for (point = (BQUE *)hash_firstentry(&mudstate.queue_htab);
+                 nullptr != point && n < nExecutors;
+                 point = (BQUE *)hash_nextentry(&mudstate.queue_htab))
+            {
+                if (  NOTHING == executor
+                   || executor == Owner(point->executor))
+                {
+                    aExecutors[n++] = point->executor;
+                }
+            }
+
+            for (unsigned int i = 0; i < n; i++)
+            {
+                halt_executor(aExecutors[i]);
+            }
+            MEMFREE(aExecutors);
+        }
+    }
 
     if (Halt_Player_Run != NOTHING)
     {
@@ -457,110 +852,49 @@ void do_halt(dbref executor, dbref caller, dbref enactor, int eval, int key, UTF
     notify(Owner(executor), tprintf(T("%d queue entr%s removed."), numhalted, numhalted == 1 ? "y" : "ies"));
 }
 
-static int Notify_Key;
-static int Notify_Num_Done;
-static int Notify_Num_Max;
-static int Notify_Sem;
-static int Notify_Attr;
-
-// NFY_DRAIN or NFY_NFYALL
+// @notify releases the entries blocked on a semaphore in the order that
+// the scheduler holds them: entries without a timeout in the order they were
+// queued, followed by timed entries in the order they would time out.
 //
-static int CallBack_NotifySemaphoreDrainOrAll(PTASK_RECORD p)
+static int CompareSemaphoreEntries(const void *pA, const void *pB)
 {
-    if (p->fpTask == Task_SemaphoreTimeout)
+    BQUE *pEntryA = *(BQUE **)pA;
+    BQUE *pEntryB = *(BQUE **)pB;
+    PTASK_RECORD pTaskA = pEntryA->pTask;
+    PTASK_RECORD pTaskB = pEntryB->pTask;
+
+    if (pEntryA->IsTimed != pEntryB->IsTimed)
     {
-        // This represents a semaphore.
-        //
-        BQUE *point = (BQUE *)(p->arg_voidptr);
-        if (  point->u.s.sem == Notify_Sem
-           && (  point->u.s.attr == Notify_Attr
-              || !Notify_Attr))
+        return pEntryA->IsTimed ? 1 : -1;
+    }
+    else if (pEntryA->IsTimed)
+    {
+        if (pTaskA->ltaWhen < pTaskB->ltaWhen)
         {
-            Notify_Num_Done++;
-            if (NFY_DRAIN == (Notify_Key & NFY_MASK))
-            {
-                // Discard the command
-                //
-                giveto(point->executor, mudconf.waitcost);
-                a_Queue(Owner(point->executor), -1);
-
-                for (int i = 0; i < MAX_GLOBAL_REGS; i++)
-                {
-                    if (point->scr[i])
-                    {
-                        RegRelease(point->scr[i]);
-                        point->scr[i] = nullptr;
-                    }
-                }
-
-                MEMFREE(point->text);
-                point->text = nullptr;
-                free_qentry(point);
-
-                return IU_REMOVE_TASK;
-            }
-            else
-            {
-                // Allow the command to run. The priority may have been
-                // PRIORITY_SUSPEND, so we need to change it.
-                //
-                if (isPlayer(point->enactor))
-                {
-                    p->iPriority = PRIORITY_PLAYER;
-                }
-                else
-                {
-                    p->iPriority = PRIORITY_OBJECT;
-                }
-                p->ltaWhen.GetUTC();
-                p->fpTask = Task_RunQueueEntry;
-                return IU_UPDATE_TASK;
-            }
+            return -1;
+        }
+        else if (pTaskA->ltaWhen > pTaskB->ltaWhen)
+        {
+            return 1;
         }
     }
-    return IU_NEXT_TASK;
+
+    // Must subtract so that ticket rollover is handled properly.
+    //
+    return pTaskA->m_Ticket - pTaskB->m_Ticket;
 }
 
-// NFY_NFY
+// Entries released together are tagged in this order, so @notify/all must
+// keep the order in which they were queued.
 //
-static int CallBack_NotifySemaphoreFirst(PTASK_RECORD p)
+static int CompareSemaphoreTickets(const void *pA, const void *pB)
 {
-    // If we've notified enough, exit.
-    //
-    if (  NFY_NFY == (Notify_Key & NFY_MASK)
-       && Notify_Num_Done >= Notify_Num_Max)
-    {
-        return IU_DONE;
-    }
+    BQUE *pEntryA = *(BQUE **)pA;
+    BQUE *pEntryB = *(BQUE **)pB;
 
-    if (p->fpTask == Task_SemaphoreTimeout)
-    {
-        // This represents a semaphore.
-        //
-        BQUE *point = (BQUE *)(p->arg_voidptr);
-        if (  point->u.s.sem == Notify_Sem
-           && (  point->u.s.attr == Notify_Attr
-              || !Notify_Attr))
-        {
-            Notify_Num_Done++;
-
-            // Allow the command to run. The priority may have been
-            // PRIORITY_SUSPEND, so we need to change it.
-            //
-            if (isPlayer(point->enactor))
-            {
-                p->iPriority = PRIORITY_PLAYER;
-            }
-            else
-            {
-                p->iPriority = PRIORITY_OBJECT;
-            }
-            p->ltaWhen.GetUTC();
-            p->fpTask = Task_RunQueueEntry;
-            return IU_UPDATE_TASK;
-        }
-    }
-    return IU_NEXT_TASK;
+    // Must subtract so that ticket rollover is handled properly.
+    //
+    return pEntryA->pTask->m_Ticket - pEntryB->pTask->m_Ticket;
 }
 
 // ---------------------------------------------------------------------------
@@ -578,21 +912,77 @@ int nfy_que(dbref sem, int attr, int key, int count)
         free_lbuf(str);
     }
 
-    Notify_Num_Done = 0;
-    if (0 < cSemaphore)
+    int nDone = 0;
+    BQUE *point = (BQUE *)hashfindLEN(&sem, sizeof(sem), &mudstate.semaphore_htab);
+    if (  0 < cSemaphore
+       && nullptr != point)
     {
-        Notify_Key     = key;
-        Notify_Sem     = sem;
-        Notify_Attr    = attr;
-        Notify_Num_Max = count;
+        int nEntries = 0;
+        for (BQUE *p = point; nullptr != p; p = p->pSemNext)
+        {
+            nEntries++;
+        }
+
+        BQUE **aEntries = (BQUE **)MEMALLOC(nEntries * sizeof(BQUE *));
+        ISOUTOFMEMORY(aEntries);
+
+        int n = 0;
+        for ( ; nullptr != point; point = point->pSemNext)
+        {
+            if (  point->u.s.attr == attr
+               || !attr)
+            {
+                aEntries[n++] = point;
+            }
+        }
+
         if (NFY_NFY == (key & NFY_MASK))
         {
-            scheduler.TraverseOrdered(CallBack_NotifySemaphoreFirst);
+            qsort(aEntries, n, sizeof(BQUE *), CompareSemaphoreEntries);
+            if (count < n)
+            {
+                n = (count < 0) ? 0 : count;
+            }
         }
-        else
+        else if (NFY_NFYALL == (key & NFY_MASK))
+        {
+            qsort(aEntries, n, sizeof(BQUE *), CompareSemaphoreTickets);
+        }
+
+        for (int i = 0; i < n; i++)
         {
-            scheduler.TraverseUnordered(CallBack_NotifySemaphoreDrainOrAll);
+            point = aEntries[i];
+            nDone++;
+            if (NFY_DRAIN == (key & NFY_MASK))
+            {
+                // Discard the command
+                //
+                giveto(point->executor, mudconf.waitcost);
+                a_Queue(Owner(point->executor), -1);
+                que_discard(point);
+            }
+            else
+            {
+                // Allow the command to run. The priority may have been
+                // PRIORITY_SUSPEND, so we need to change it.
+                //
+                PTASK_RECORD pTask = point->pTask;
+                que_unlink_semaphore(point);
+                if (isPlayer(point->enactor))
+                {
+                    pTask->iPriority = PRIORITY_PLAYER;
+                }
+                else
+                {
+                    pTask->iPriority = PRIORITY_OBJECT;
+                }
+                pTask->ltaWhen.GetUTC();
+                pTask->fpTask = Task_RunQueueEntry;
+                share_tag(pTask, point);
+                scheduler.UpdateTask(pTask);
+            }
         }
+        MEMFREE(aEntries);
     }
 
     // Update the sem waiters count.
@@ -606,7 +996,7 @@ int nfy_que(dbref sem, int attr, int key, int count)
         atr_clr(sem, attr);
     }
 
-    return Notify_Num_Done;
+    return nDone;
 }
 
 // ---------------------------------------------------------------------------
@@ -714,7 +1104,7 @@ static BQUE *setup_que
     UTF8    *command,
     int      nargs,
     const UTF8 *args[],
-    reg_ref *sargs[]
+    reg_frame *sargs
 )
 {
     // Can we run commands at all?
@@ -788,6 +1178,9 @@ static BQUE *setup_que
     //
     BQUE *tmp = alloc_qentry("setup_que.qblock");
     tmp->comm = nullptr;
+    tmp->pTask = nullptr;
+    tmp->share_owner = NOTHING;
+    tmp->share_estimate = 0;
 
     UTF8 *tptr = tmp->text = (UTF8 *)MEMALLOC(tlen);
     ISOUTOFMEMORY(tptr);
@@ -820,21 +1213,12 @@ static BQUE *setup_que
 
     if (sargs)
     {
-        for (a = 0; a < MAX_GLOBAL_REGS; a++)
-        {
-            tmp->scr[a] = sargs[a];
-            if (sargs[a])
-            {
-                RegAddRef(sargs[a]);
-            }
-        }
+        RegFrameAddRef(sargs);
+        tmp->scr = sargs;
     }
     else
     {
-        for (a = 0; a < MAX_GLOBAL_REGS; a++)
-        {
-            tmp->scr[a] = nullptr;
-        }
+        tmp->scr = RegFrameEmpty();
     }
 
 #if defined(STUB_SLAVE)
@@ -875,7 +1259,7 @@ void wait_que
     UTF8    *command,
     int      nargs,
     const UTF8 *args[],
-    reg_ref *sargs[]
+    reg_frame *sargs
 )
 {
     if (!(mudconf.control_flags & CF_INTERP))
@@ -908,6 +1292,8 @@ void wait_que
     tmp->u.s.sem = sem;
     tmp->u.s.attr = attr;
 
+    PTASK_RECORD pTask;
+
     if (sem == NOTHING)
     {
         // Not a semaphore, so let it run it immediately or put it on
@@ -915,12 +1301,13 @@ void wait_que
         //
         if (tmp->IsTimed)
         {
-            scheduler.DeferTask(tmp->waittime, iPriority, Task_RunQueueEntry, tmp, 0);
+            pTask = scheduler.DeferTask(tmp->waittime, iPriority, Task_RunQueueEntry, tmp, 0);
         }
         else
         {
-            scheduler.DeferImmediateTask(iPriority, Task_RunQueueEntry, tmp, 0);
+            pTask = scheduler.DeferImmediateTask(iPriority, Task_RunQueueEntry, tmp, 0);
         }
+        share_tag(pTask, tmp);
     }
     else
     {
@@ -932,7 +1319,12 @@ void wait_que
             //
             iPriority = PRIORITY_SUSPEND;
         }
-        scheduler.DeferTask(tmp->waittime, iPriority, Task_SemaphoreTimeout, tmp, 0);
+        pTask = scheduler.DeferTask(tmp->waittime, iPriority, Task_SemaphoreTimeout, tmp, 0);
+    }
+
+    if (nullptr != pTask)
+    {
+        que_link(tmp, pTask);
     }
 }
 
@@ -958,6 +1350,7 @@ static int CallBack_QueryComplete(PTASK_RECORD p)
             p->iPriority = PRIORITY_OBJECT;
             p->ltaWhen.GetUTC();
             p->fpTask    = Task_RunQueueEntry;
+            share_tag(p, point);
 
             point->u.s.sem    = NOTHING;
             point->u.s.attr   = 0;
@@ -1006,7 +1399,7 @@ void sql_que
     UTF8    *query,
     int      nargs,
     const UTF8 *args[],
-    reg_ref *sargs[]
+    reg_frame *sargs
 )
 {
     static UINT32 next_handle = 0;
@@ -1039,11 +1432,17 @@ void sql_que
 
     tmp->u.hQuery = hQuery;
 
-    scheduler.DeferTask(tmp->waittime, PRIORITY_SUSPEND, Task_SQLTimeout, tmp, 0);
+    PTASK_RECORD pTask = scheduler.DeferTask(tmp->waittime, PRIORITY_SUSPEND, Task_SQLTimeout, tmp, 0);
+    if (nullptr != pTask)
+    {
+        que_link(tmp, pTask);
+    }
     MUX_RESULT mr = mudstate.pIQueryControl->Query(hQuery, dbname, query);
     if (MUX_FAILED(mr))
     {
-        scheduler.CancelTask(Task_SQLTimeout, tmp, next_handle);
+        giveto(tmp->executor, mudconf.waitcost);
+        a_Queue(Owner(tmp->executor), -1);
+        que_discard(tmp);
     }
 }
 
@@ -1526,6 +1925,24 @@ void do_ps(dbref executor, dbref caller, dbref enactor, int eval, int key, UTF8
         notify(executor, bufp);
     }
     free_mbuf(bufp);
+
+    // Show how much of the queue's CPU the owner has used.
+    //
+    if (NOTHING == executor_targ)
+    {
+        report_queue_shares(executor, true, false, false);
+    }
+    else
+    {
+        INT64 iUsed = queue_cpu_owned(executor_targ);
+        if (0 != iUsed)
+        {
+            CLinearTimeDelta ltd;
+            ltd.Set100ns(iUsed);
+            notify(executor, tprintf(T("Queue share: %ld msecs (%d%% of queue CPU)."),
+                ltd.ReturnMilliseconds(), share_percent(iUsed)));
+        }
+    }
 }
 
 static CLinearTimeDelta ltdWarp;
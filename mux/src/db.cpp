@@ -777,6 +777,7 @@ void free_Names(OBJ *p)
 
 void s_Name(dbref thing, const UTF8 *s)
 {
+    db_checkpoint_object(thing);
     free_Names(&db[thing]);
     atr_add_raw(thing, A_NAME, s);
 #ifndef MEMORY_BASED
@@ -1661,7 +1662,7 @@ bool Commer(dbref thing)
     bool bFoundListens = false;
 
     atr_push();
-    UTF8 *buff = alloc_lbuf("Commer");
+    CAttrView av;
     unsigned char *as;
     for (int atr = atr_head(thing, &as); atr; atr = atr_next(&as))
     {
@@ -1672,16 +1673,13 @@ bool Commer(dbref thing)
             continue;
         }
 
-        int   aflags;
-        dbref aowner;
-
-        atr_get_str(buff, thing, atr, &aowner, &aflags);
-
-        if (aflags & AF_NOPROG)
+        av.get(thing, atr);
+        if (av.flags() & AF_NOPROG)
         {
             continue;
         }
 
+        const UTF8 *buff = av.text();
         if (  AMATCH_CMD != buff[0]
            && AMATCH_LISTEN != buff[0])
         {
@@ -1690,15 +1688,13 @@ bool Commer(dbref thing)
 
         // Search for unescaped ':'
         //
-        UTF8 *s = (UTF8 *)strchr((char *)buff+1, ':');
-        if (!s)
+        if (nullptr == strchr((const char *)buff+1, ':'))
         {
             continue;
         }
 
         if (AMATCH_CMD == buff[0])
         {
-            free_lbuf(buff);
             atr_pop();
             mudstate.bfCommands.Set(thing);
             if (bFoundListens)
@@ -1713,7 +1709,6 @@ bool Commer(dbref thing)
             bFoundListens = true;
         }
     }
-    free_lbuf(buff);
     atr_pop();
     mudstate.bfNoCommands.Set(thing);
     if (bFoundListens)
@@ -1926,6 +1921,16 @@ static const UTF8 *atr_encode(const UTF8 *iattr, dbref thing, dbref owner, int f
     return tprintf(T("%c%d:%d:%s"), ATR_INFO_CHAR, owner, flags, iattr);
 }
 
+#if defined(SELFCHECK)
+// Bumped whenever an attribute is read or written, which is when the text
+// seen through a CAttrView may move or go away.
+//
+static UINT32 s_nAttrEpoch = 0;
+#define ATR_VIEW_INVALIDATE()   s_nAttrEpoch++
+#else // SELFCHECK
+#define ATR_VIEW_INVALIDATE()
+#endif // SELFCHECK
+
 // atr_decode_flags_owner: Decode the owner and flags (if present) and
 // return a pointer to the attribute text.
 //
@@ -2028,6 +2033,11 @@ static void atr_decode_LEN(const UTF8 *iattr, size_t nLen, UTF8 *oattr,
 
 void atr_clr(dbref thing, int atr)
 {
+    ATR_VIEW_INVALIDATE();
+    db_checkpoint_object(thing);
+    cmdtab_clr(thing);
+    lock_cache_clr(thing, atr);
+
 #ifdef MEMORY_BASED
 
     if (  !db[thing].nALUsed
@@ -2132,6 +2142,7 @@ void atr_clr(dbref thing, int atr)
 
 void atr_add_raw_LEN(dbref thing, int atr, const UTF8 *szValue, size_t nValue)
 {
+    ATR_VIEW_INVALIDATE();
     if (  !szValue
        || '\0' == szValue[0])
     {
@@ -2139,6 +2150,20 @@ void atr_add_raw_LEN(dbref thing, int atr, const UTF8 *szValue, size_t nValue)
         return;
     }
 
+    if (db_checkpoint_pending(thing))
+    {
+        // The checkpoint reads this object's attributes, and szValue may
+        // point into a buffer which those reads reuse.
+        //
+        UTF8 *pValue = StringCloneLen(szValue, nValue);
+        db_checkpoint_object(thing);
+        atr_add_raw_LEN(thing, atr, pValue, nValue);
+        MEMFREE(pValue);
+        return;
+    }
+    cmdtab_clr(thing);
+    lock_cache_clr(thing, atr);
+
 #ifdef MEMORY_BASED
     ATRLIST *list = db[thing].pALHead;
     UTF8 *text = StringCloneLen(szValue, nValue);
@@ -2374,6 +2399,7 @@ int get_atr(const UTF8 *name)
 #ifdef MEMORY_BASED
 const UTF8 *atr_get_raw_LEN(dbref thing, int atr, size_t *pLen)
 {
+    ATR_VIEW_INVALIDATE();
     if (!Good_obj(thing))
     {
         return nullptr;
@@ -2415,6 +2441,7 @@ const UTF8 *atr_get_raw_LEN(dbref thing, int atr, size_t *pLen)
 
 const UTF8 *atr_get_raw_LEN(dbref thing, int atr, size_t *pLen)
 {
+    ATR_VIEW_INVALIDATE();
     Aname okey;
 
     makekey(thing, atr, &okey);
@@ -2570,15 +2597,142 @@ bool atr_pget_info(dbref thing, int atr, dbref *owner, int *flags)
     return false;
 }
 
+/* ---------------------------------------------------------------------------
+ * CAttrView: Look at an attribute without copying it.
+ */
+
+CAttrView::CAttrView(void)
+{
+    m_pText = T("");
+    m_nText = 0;
+    m_owner = NOTHING;
+    m_flags = 0;
+#if defined(SELFCHECK)
+    m_nEpoch = s_nAttrEpoch;
+#endif // SELFCHECK
+}
+
+CAttrView::~CAttrView(void)
+{
+#if defined(SELFCHECK)
+    m_pText = nullptr;
+#endif // SELFCHECK
+}
+
+void CAttrView::decode(const UTF8 *pRaw, size_t nRaw, dbref thing)
+{
+    m_owner = Owner(thing);
+    m_pText = atr_decode_flags_owner(pRaw, &m_owner, &m_flags);
+    m_nText = nRaw - (m_pText - pRaw);
+}
+
+/*! \brief Looks at an attribute on the object itself.
+ *
+ * \param thing  Object.
+ * \param atr    Attribute number.
+ * \return       true if the object has the attribute.
+ */
+
+bool CAttrView::get(dbref thing, int atr)
+{
+    size_t nRaw;
+    const UTF8 *pRaw = atr_get_raw_LEN(thing, atr, &nRaw);
+#if defined(SELFCHECK)
+    m_nEpoch = s_nAttrEpoch;
+#endif // SELFCHECK
+    if (nullptr == pRaw)
+    {
+        m_pText = T("");
+        m_nText = 0;
+        m_owner = Owner(thing);
+        m_flags = 0;
+        return false;
+    }
+    decode(pRaw, nRaw, thing);
+    return true;
+}
+
+/*! \brief Looks at an attribute on the object or the nearest parent which
+ * has it, the same way atr_pget() does.
+ *
+ * \param thing  Object.
+ * \param atr    Attribute number.
+ * \return       true if the value found is not empty.
+ */
+
+bool CAttrView::pget(dbref thing, int atr)
+{
+    dbref parent;
+    int lev;
+
+    ITER_PARENTS(thing, parent, lev)
+    {
+        size_t nRaw;
+        const UTF8 *pRaw = atr_get_raw_LEN(parent, atr, &nRaw);
+        if (  pRaw
+           && *pRaw)
+        {
+            decode(pRaw, nRaw, thing);
+            if (  lev == 0
+               || !(m_flags & AF_PRIVATE))
+            {
+#if defined(SELFCHECK)
+                m_nEpoch = s_nAttrEpoch;
+#endif // SELFCHECK
+                return (0 < m_nText);
+            }
+        }
+        if (  lev == 0
+           && Good_obj(Parent(parent)))
+        {
+            ATTR *ap = atr_num(atr);
+            if (  !ap
+               || ap->flags & AF_PRIVATE)
+            {
+                break;
+            }
+        }
+    }
+    m_pText = T("");
+    m_nText = 0;
+    m_owner = Owner(thing);
+    m_flags = 0;
+#if defined(SELFCHECK)
+    m_nEpoch = s_nAttrEpoch;
+#endif // SELFCHECK
+    return false;
+}
+
+const UTF8 *CAttrView::text(void) const
+{
+#if defined(SELFCHECK)
+    mux_assert(m_nEpoch == s_nAttrEpoch);
+#endif // SELFCHECK
+    return m_pText;
+}
+
+size_t CAttrView::length(void) const
+{
+    return m_nText;
+}
+
 /* ---------------------------------------------------------------------------
  * atr_free: Reset all attributes of an object.
  */
 
 void atr_free(dbref thing)
 {
+    ATR_VIEW_INVALIDATE();
+    db_checkpoint_object(thing);
+    cmdtab_clr(thing);
+
 #ifdef MEMORY_BASED
     if (db[thing].pALHead)
     {
+        for (int i = 0; i < db[thing].nALUsed; i++)
+        {
+            lock_cache_clr(thing, db[thing].pALHead[i].number);
+        }
         MEMFREE(db[thing].pALHead);
     }
     db[thing].pALHead  = nullptr;
@@ -2900,12 +3054,294 @@ bool attr_info::get_info(bool bParent)
 
 #define SIZE_HACK   1   // So mistaken refs to #-1 won't die.
 
+/* ---------------------------------------------------------------------------
+ * Secondary indexes.
+ *
+ * For each index, an object is linked onto a chain headed by the object named
+ * in the indexed field (for example, its owner), so that the objects which
+ * refer to an object can be visited without walking the whole database.  The
+ * chains are built once the database is loaded and are then kept up to date
+ * by the s_Owner(), s_Parent(), s_Zone(), s_Location(), and s_Link() macros.
+ * Chains are not kept in dbref order.
+ */
+
+static bool s_bIndexed = false;
+
+static inline dbref *db_index_field(dbref thing, int ix)
+{
+    switch (ix)
+    {
+    case IX_OWNER:
+        return &db[thing].owner;
+
+    case IX_PARENT:
+        return &db[thing].parent;
+
+    case IX_LOCATION:
+        return &db[thing].location;
+
+    case IX_LINK:
+        return &db[thing].link;
+    }
+    return &db[thing].zone;
+}
+
+static void db_index_unlink(dbref thing, int ix)
+{
+    dbref key = *db_index_field(thing, ix);
+    if (  key < 0
+       || mudstate.db_top <= key)
+    {
+        return;
+    }
+
+    dbref prev = db[thing].ix_prev[ix];
+    dbref next = db[thing].ix_next[ix];
+    if (NOTHING != prev)
+    {
+        db[prev].ix_next[ix] = next;
+    }
+    else if (db[key].ix_head[ix] == thing)
+    {
+        db[key].ix_head[ix] = next;
+    }
+    else
+    {
+        // Not on a chain.
+        //
+        return;
+    }
+
+    if (NOTHING != next)
+    {
+        db[next].ix_prev[ix] = prev;
+    }
+    db[thing].ix_prev[ix] = NOTHING;
+    db[thing].ix_next[ix] = NOTHING;
+}
+
+static void db_index_link(dbref thing, int ix)
+{
+    dbref key = *db_index_field(thing, ix);
+    if (  key < 0
+       || mudstate.db_top <= key)
+    {
+        return;
+    }
+
+    dbref next = db[key].ix_head[ix];
+    db[thing].ix_prev[ix] = NOTHING;
+    db[thing].ix_next[ix] = next;
+    if (NOTHING != next)
+    {
+        db[next].ix_prev[ix] = thing;
+    }
+    db[key].ix_head[ix] = thing;
+}
+
+/*! \brief Sets an indexed field of an object.
+ *
+ * \param thing  Object to change.
+ * \param ix     Which field (IX_OWNER, IX_PARENT, IX_ZONE, IX_LOCATION, or
+ *               IX_LINK).
+ * \param value  New value.
+ * \return       None.
+ */
+
+void db_index_set(dbref thing, int ix, dbref value)
+{
+    dbref *pField = db_index_field(thing, ix);
+    if (!s_bIndexed)
+    {
+        *pField = value;
+    }
+    else if (*pField != value)
+    {
+        db_index_unlink(thing, ix);
+        *pField = value;
+        db_index_link(thing, ix);
+    }
+}
+
+/*! \brief Builds the secondary indexes from scratch.
+ *
+ * This is done once the database has been loaded.  Each chain starts out in
+ * dbref order.
+ *
+ * \return       None.
+ */
+
+void db_index_build(void)
+{
+    dbref thing;
+    for (thing = 0; thing < mudstate.db_top; thing++)
+    {
+        for (int ix = 0; ix < NUM_IX; ix++)
+        {
+            db[thing].ix_head[ix] = NOTHING;
+            db[thing].ix_next[ix] = NOTHING;
+            db[thing].ix_prev[ix] = NOTHING;
+        }
+    }
+
+    for (thing = mudstate.db_top - 1; 0 <= thing; thing--)
+    {
+        for (int ix = 0; ix < NUM_IX; ix++)
+        {
+            db_index_link(thing, ix);
+        }
+    }
+    s_bIndexed = true;
+}
+
+bool db_indexed(void)
+{
+    return s_bIndexed;
+}
+
+static int DCL_CDECL dbref_compare(const void *s1, const void *s2)
+{
+    dbref a = *(const dbref *)s1;
+    dbref b = *(const dbref *)s2;
+    if (a < b)
+    {
+        return -1;
+    }
+    else if (a > b)
+    {
+        return 1;
+    }
+    return 0;
+}
+
+/*! \brief Sorts a list of dbrefs and removes duplicates.
+ *
+ * \param aRefs  List of dbrefs.
+ * \param nRefs  Number of dbrefs in the list.
+ * \return       Number of dbrefs left in the list.
+ */
+
+int db_sort_refs(dbref *aRefs, int nRefs)
+{
+    if (nRefs <= 1)
+    {
+        return nRefs;
+    }
+    qsort(aRefs, nRefs, sizeof(dbref), dbref_compare);
+
+    int j = 1;
+    for (int i = 1; i < nRefs; i++)
+    {
+        if (aRefs[i] != aRefs[j-1])
+        {
+            aRefs[j++] = aRefs[i];
+        }
+    }
+    return j;
+}
+
+/*! \brief Finds the objects which refer to an object.
+ *
+ * An object is collected when any of the fields selected by mask refer to
+ * key.  Before the indexes are built, the range is scanned instead.
+ *
+ * \param key         Object referred to.
+ * \param mask        IX_BIT() of each field to consider.
+ * \param low_bound   Lowest dbref to collect.
+ * \param high_bound  Highest dbref to collect.
+ * \param pnRefs      Number of dbrefs collected.
+ * \return            MEMALLOC()ed list of dbrefs in ascending order.
+ */
+
+dbref *db_index_collect(dbref key, int mask, dbref low_bound, dbref high_bound, int *pnRefs)
+{
+    if (low_bound < 0)
+    {
+        low_bound = 0;
+    }
+    if (mudstate.db_top <= high_bound)
+    {
+        high_bound = mudstate.db_top - 1;
+    }
+
+    int ix;
+    dbref thing;
+    int nRefs = 0;
+    bool bIndexed = (  s_bIndexed
+                    && 0 <= key
+                    && key < mudstate.db_top);
+    if (bIndexed)
+    {
+        for (ix = 0; ix < NUM_IX; ix++)
+        {
+            if (mask & IX_BIT(ix))
+            {
+                for (thing = db[key].ix_head[ix]; NOTHING != thing; thing = db[thing].ix_next[ix])
+                {
+                    nRefs++;
+                }
+            }
+        }
+    }
+    else if (low_bound <= high_bound)
+    {
+        nRefs = high_bound - low_bound + 1;
+    }
+
+    dbref *aRefs = (dbref *)MEMALLOC((nRefs + 1) * sizeof(dbref));
+    ISOUTOFMEMORY(aRefs);
+
+    nRefs = 0;
+    if (bIndexed)
+    {
+        for (ix = 0; ix < NUM_IX; ix++)
+        {
+            if (mask & IX_BIT(ix))
+            {
+                for (thing = db[key].ix_head[ix]; NOTHING != thing; thing = db[thing].ix_next[ix])
+                {
+                    if (  low_bound <= thing
+                       && thing <= high_bound)
+                    {
+                        aRefs[nRefs++] = thing;
+                    }
+                }
+            }
+        }
+        nRefs = db_sort_refs(aRefs, nRefs);
+    }
+    else
+    {
+        for (thing = low_bound; thing <= high_bound; thing++)
+        {
+            for (ix = 0; ix < NUM_IX; ix++)
+            {
+                if (  (mask & IX_BIT(ix))
+                   && *db_index_field(thing, ix) == key)
+                {
+                    aRefs[nRefs++] = thing;
+                    break;
+                }
+            }
+        }
+    }
+    *pnRefs = nRefs;
+    return aRefs;
+}
+
 static void initialize_objects(dbref first, dbref last)
 {
     dbref thing;
 
     for (thing = first; thing < last; thing++)
     {
+        for (int ix = 0; ix < NUM_IX; ix++)
+        {
+            *db_index_field(thing, ix) = NOTHING;
+            db[thing].ix_head[ix] = NOTHING;
+            db[thing].ix_next[ix] = NOTHING;
+            db[thing].ix_prev[ix] = NOTHING;
+        }
         s_Owner(thing, GOD);
         s_Flags(thing, FLAG_WORD1, (TYPE_GARBAGE | GOING));
         s_Powers(thing, 0);
@@ -3785,6 +4221,7 @@ void load_restart_db(void)
         d->encoding = mudconf.default_charset;
 #ifdef UNIX_SSL
         d->ssl_session = nullptr;
+        d->ssl_worker = false;
 #endif
         if (3 <= version)
         {
@@ -92,6 +92,7 @@ struct boolexp
 
 #define F_UNKNOWN   0   /* Unknown database format */
 #define F_MUX       5   /* MUX format */
+#define F_MUXBIN    6   /* MUX binary format */
 
 #define V_MASK      0x000000ff  /* Database version */
 #define V_ZONE      0x00000100  /* ZONE/DOMAIN field */
@@ -125,6 +126,16 @@ struct boolexp
 #define NOPERM      (-4)    /* Error status, no permission */
 extern const UTF8 *aszSpecialDBRefNames[1-NOPERM];
 
+// Secondary indexes.  See db_index_set().
+//
+#define IX_OWNER    0
+#define IX_PARENT   1
+#define IX_ZONE     2
+#define IX_LOCATION 3
+#define IX_LINK     4
+#define NUM_IX      5
+#define IX_BIT(ix)  (1 << (ix))
+
 typedef struct object OBJ;
 struct object
 {
@@ -146,6 +157,14 @@ struct object
 
     dbref   zone;       /* Whatever the object is zoned to.*/
 
+    // ALL: Every object is on the chain of the object named by its owner,
+    // parent, zone, location, and link.  The head of each chain is kept on
+    // that object.
+    //
+    dbref   ix_head[NUM_IX];
+    dbref   ix_next[NUM_IX];
+    dbref   ix_prev[NUM_IX];
+
     FLAGSET fs;         // ALL: Flags set on the object.
 
     POWER   powers;     /* ALL: Powers on object */
@@ -200,17 +219,19 @@ extern OBJ *db;
 #define ThAttrib(t)     db[t].throttled_attributes
 #define ThMail(t)       db[t].throttled_mail
 #define ThRefs(t)       db[t].throttled_references
+#define IndexFirst(t,ix) db[t].ix_head[ix]
+#define IndexNext(t,ix)  db[t].ix_next[ix]
 
-#define s_Location(t,n)     db[t].location = (n)
+#define s_Location(t,n)     db_index_set((t), IX_LOCATION, (n))
 
-#define s_Zone(t,n)         db[t].zone = (n)
+#define s_Zone(t,n)         db_index_set((t), IX_ZONE, (n))
 
 #define s_Contents(t,n)     db[t].contents = (n)
 #define s_Exits(t,n)        db[t].exits = (n)
 #define s_Next(t,n)         db[t].next = (n)
-#define s_Link(t,n)         db[t].link = (n)
-#define s_Owner(t,n)        db[t].owner = (n)
-#define s_Parent(t,n)       db[t].parent = (n)
+#define s_Link(t,n)         db_index_set((t), IX_LINK, (n))
+#define s_Owner(t,n)        db_index_set((t), IX_OWNER, (n))
+#define s_Parent(t,n)       db_index_set((t), IX_PARENT, (n))
 #define s_Flags(t,f,n)      db[t].fs.word[f] = (n)
 #define s_Powers(t,n)       db[t].powers = (n)
 #define s_Powers2(t,n)      db[t].powers2 = (n)
@@ -225,6 +246,12 @@ extern OBJ *db;
 #define s_Stack(t,n)        db[t].stackhead = (n)
 #endif // DEPRECATED
 
+void db_index_set(dbref thing, int ix, dbref value);
+void db_index_build(void);
+bool db_indexed(void);
+dbref *db_index_collect(dbref key, int mask, dbref low_bound, dbref high_bound, int *pnRefs);
+int  db_sort_refs(dbref *aRefs, int nRefs);
+
 int  Pennies(dbref obj);
 void s_Pennies(dbref obj, int howfew);
 void s_PenniesDirect(dbref obj, int howfew);
@@ -248,6 +275,11 @@ void db_free(void);
 void db_make_minimal(void);
 dbref    db_read(FILE *, int *, int *, int *);
 dbref    db_write(FILE *, int, int);
+bool db_checkpoint_begin(int nOutputs, FILE *af[], const int aformats[], const int aflags[]);
+bool db_checkpoint_step(int nObjects, dbref *pnWritten, dbref *pnEarly);
+bool db_checkpoint_active(void);
+bool db_checkpoint_pending(dbref thing);
+void db_checkpoint_object(dbref thing);
 void destroy_thing(dbref);
 void destroy_exit(dbref);
 void putstring(FILE *f, const UTF8 *s);
@@ -346,6 +346,67 @@ static bool get_list(FILE *f, dbref i)
     }
 }
 
+// Binary flatfiles begin with this signature. See db_read_binary().
+//
+#define BINARY_SIGNATURE      "\x89MUXDB\r\n"
+static dbref db_read_binary(FILE *f, int *db_format, int *db_version, int *db_flags);
+
+// After the header and every object have been read, make sure the next
+// attribute number to hand out is beyond every attribute in use.
+//
+static void db_read_adjust_attr_next(bool nextattr_gotten)
+{
+    // Attribute number warnings.
+    //
+    if (g_max_nam_atr < g_max_obj_atr)
+    {
+        Log.tinyprintf(T(ENDLINE "Warning: One or more attribute values are unnamed. Did you use ./Backup on a running game?"));
+    }
+
+    if (!nextattr_gotten)
+    {
+        Log.tinyprintf(T(ENDLINE "Warning: Missing +N<next free>. Adjusting."));
+    }
+
+    if (mudstate.attr_next <= g_max_nam_atr)
+    {
+        if (nextattr_gotten)
+        {
+            Log.tinyprintf(T(ENDLINE "Warning: +N<next free attr> conflicts with existing attribute names. Adjusting."));
+        }
+        mudstate.attr_next = g_max_nam_atr + 1;
+    }
+
+    if (mudstate.attr_next <= g_max_obj_atr)
+    {
+        if (nextattr_gotten)
+        {
+            Log.tinyprintf(T(ENDLINE "Warning: +N<next free attr> conflicts object attribute numbers. Adjusting."));
+        }
+        mudstate.attr_next = g_max_nam_atr + 1;
+    }
+
+    int max_atr = A_USER_START;
+    if (max_atr < g_max_nam_atr)
+    {
+        max_atr = g_max_nam_atr;
+    }
+
+    if (max_atr < g_max_obj_atr)
+    {
+        max_atr = g_max_obj_atr;
+    }
+
+    if (max_atr + 1 < mudstate.attr_next)
+    {
+        if (nextattr_gotten)
+        {
+            Log.tinyprintf(T(ENDLINE "Info: +N<next free attr> can be safely adjusted down."));
+        }
+        mudstate.attr_next = max_atr + 1;
+    }
+}
+
 dbref db_read(FILE *f, int *db_format, int *db_version, int *db_flags)
 {
     dbref i, anum;
@@ -362,6 +423,12 @@ dbref db_read(FILE *f, int *db_format, int *db_version, int *db_flags)
     g_max_nam_atr = INT_MIN;
     g_max_obj_atr = INT_MIN;
 
+    ch = getc(f);
+    ungetc(ch, f);
+    if (BINARY_SIGNATURE[0] == static_cast<char>(ch))
+    {
+        return db_read_binary(f, db_format, db_version, db_flags);
+    }
 
     bool header_gotten = false;
     bool size_gotten = false;
@@ -667,55 +734,7 @@ dbref db_read(FILE *f, int *db_format, int *db_version, int *db_flags)
             }
             else
             {
-                // Attribute number warnings.
-                //
-                if (g_max_nam_atr < g_max_obj_atr)
-                {
-                    Log.tinyprintf(T(ENDLINE "Warning: One or more attribute values are unnamed. Did you use ./Backup on a running game?"));
-                }
-
-                if (!nextattr_gotten)
-                {
-                    Log.tinyprintf(T(ENDLINE "Warning: Missing +N<next free>. Adjusting."));
-                }
-
-                if (mudstate.attr_next <= g_max_nam_atr)
-                {
-                    if (nextattr_gotten)
-                    {
-                        Log.tinyprintf(T(ENDLINE "Warning: +N<next free attr> conflicts with existing attribute names. Adjusting."));
-                    }
-                    mudstate.attr_next = g_max_nam_atr + 1;
-                }
-
-                if (mudstate.attr_next <= g_max_obj_atr)
-                {
-                    if (nextattr_gotten)
-                    {
-                        Log.tinyprintf(T(ENDLINE "Warning: +N<next free attr> conflicts object attribute numbers. Adjusting."));
-                    }
-                    mudstate.attr_next = g_max_nam_atr + 1;
-                }
-
-                int max_atr = A_USER_START;
-                if (max_atr < g_max_nam_atr)
-                {
-                    max_atr = g_max_nam_atr;
-                }
-
-                if (max_atr < g_max_obj_atr)
-                {
-                    max_atr = g_max_obj_atr;
-                }
-
-                if (max_atr + 1 < mudstate.attr_next)
-                {
-                    if (nextattr_gotten)
-                    {
-                        Log.tinyprintf(T(ENDLINE "Info: +N<next free attr> can be safely adjusted down."));
-                    }
-                    mudstate.attr_next = max_atr + 1;
-                }
+                db_read_adjust_attr_next(nextattr_gotten);
 
                 if (convert_values)
                 {
@@ -780,79 +799,133 @@ dbref db_read(FILE *f, int *db_format, int *db_version, int *db_flags)
     }
 }
 
-static bool db_write_object(FILE *f, dbref i, int db_format, int flags)
+// The object header fields written to a flatfile. A checkpoint copies these
+// for every object when it begins, so that the header portion of the image
+// does not depend on when each object is finally written.
+//
+typedef struct
+{
+    dbref location;
+    dbref zone;
+    dbref contents;
+    dbref exits;
+    dbref link;
+    dbref next;
+    dbref owner;
+    dbref parent;
+    FLAG  flags[3];
+    POWER powers;
+    POWER powers2;
+} OBJ_IMAGE;
+
+static void db_image_object(dbref i, OBJ_IMAGE *pImage)
+{
+    pImage->location = Location(i);
+    pImage->zone     = Zone(i);
+    pImage->contents = Contents(i);
+    pImage->exits    = Exits(i);
+    pImage->link     = Link(i);
+    pImage->next     = Next(i);
+    pImage->owner    = Owner(i);
+    pImage->parent   = Parent(i);
+    pImage->flags[0] = Flags(i);
+    pImage->flags[1] = Flags2(i);
+    pImage->flags[2] = Flags3(i);
+    pImage->powers   = Powers(i);
+    pImage->powers2  = Powers2(i);
+}
+
+// Returns the attribute number to write for an attribute found on an object,
+// or 0 if the attribute is not written under the given flags.
+//
+static int db_dumped_attr(int ca, int flags)
 {
-    UNUSED_PARAMETER(db_format);
+    int j;
+    if (mudstate.bStandAlone)
+    {
+        j = ca;
+    }
+    else
+    {
+        ATTR *a = atr_num(ca);
+        if (!a)
+        {
+            return 0;
+        }
+        j = a->number;
+    }
 
-    ATTR *a;
+    if (j < A_USER_START)
+    {
+        switch (j)
+        {
+        case A_NAME:
+            if (!(flags & V_ATRNAME))
+            {
+                return 0;
+            }
+            break;
+
+        case A_LIST:
+        case A_MONEY:
+            return 0;
+        }
+    }
+    return j;
+}
+
+static bool db_write_object(FILE *f, dbref i, int flags, const OBJ_IMAGE *pImage)
+{
     int ca, j;
 
+    // Format is: "!%d\n", i
+    //
+    UTF8 buf[SBUF_SIZE];
+    buf[0] = '!';
+    size_t n = mux_ltoa(i, buf+1) + 1;
+    buf[n++] = '\n';
+    fwrite(buf, sizeof(UTF8), n, f);
+
     if (!(flags & V_ATRNAME))
     {
         putstring(f, Name(i));
     }
-    putref(f, Location(i));
-    putref(f, Zone(i));
-    putref(f, Contents(i));
-    putref(f, Exits(i));
-    putref(f, Link(i));
-    putref(f, Next(i));
-    putref(f, Owner(i));
-    putref(f, Parent(i));
+    putref(f, pImage->location);
+    putref(f, pImage->zone);
+    putref(f, pImage->contents);
+    putref(f, pImage->exits);
+    putref(f, pImage->link);
+    putref(f, pImage->next);
+    putref(f, pImage->owner);
+    putref(f, pImage->parent);
     if (!(flags & V_ATRMONEY))
     {
         putref(f, Pennies(i));
     }
-    putref(f, Flags(i));
-    putref(f, Flags2(i));
-    putref(f, Flags3(i));
-    putref(f, Powers(i));
-    putref(f, Powers2(i));
+    putref(f, pImage->flags[0]);
+    putref(f, pImage->flags[1]);
+    putref(f, pImage->flags[2]);
+    putref(f, pImage->powers);
+    putref(f, pImage->powers2);
 
     // Write the attribute list.
     //
     if (!(flags & V_DATABASE))
     {
-        UTF8 buf[SBUF_SIZE];
         buf[0] = '>';
         unsigned char *as;
         for (ca = atr_head(i, &as); ca; ca = atr_next(&as))
         {
-            if (mudstate.bStandAlone)
+            j = db_dumped_attr(ca, flags);
+            if (0 == j)
             {
-                j = ca;
-            }
-            else
-            {
-                a = atr_num(ca);
-                if (!a)
-                {
-                    continue;
-                }
-                j = a->number;
-            }
-
-            if (j < A_USER_START)
-            {
-                switch (j)
-                {
-                case A_NAME:
-                    if (!(flags & V_ATRNAME))
-                    {
-                        continue;
-                    }
-                    break;
-
-                case A_LIST:
-                case A_MONEY:
-                    continue;
-                }
+                continue;
             }
 
             // Format is: ">%d\n", j
             //
             const UTF8 *p = atr_get_raw(i, j);
-            size_t n = mux_ltoa(j, buf+1) + 1;
+            n = mux_ltoa(j, buf+1) + 1;
             buf[n++] = '\n';
             fwrite(buf, sizeof(UTF8), n, f);
             putstring(f, p);
@@ -862,29 +935,12 @@ static bool db_write_object(FILE *f, dbref i, int db_format, int flags)
     return false;
 }
 
-dbref db_write(FILE *f, int format, int version)
+static void db_write_header(FILE *f, int flags)
 {
-    dbref i;
-    int flags;
     ATTR *vp;
 
-    switch (format)
-    {
-    case F_MUX:
-        flags = version;
-        break;
-
-    default:
-        Log.WriteString(T("Can only write MUX format." ENDLINE));
-        return -1;
-    }
-    if (mudstate.bStandAlone)
-    {
-        Log.WriteString(T("Writing "));
-        Log.Flush();
-    }
-    i = mudstate.attr_next;
-    mux_fprintf(f, T("+X%d\n+S%d\n+N%d\n"), flags, mudstate.db_top, i);
+    mux_fprintf(f, T("+X%d\n+S%d\n+N%d\n"), flags, mudstate.db_top,
+        mudstate.attr_next);
     mux_fprintf(f, T("-R%d\n"), mudstate.record_players);
 
     // Dump user-named attribute info.
@@ -915,10 +971,335 @@ dbref db_write(FILE *f, int format, int version)
             fwrite(Buffer, sizeof(UTF8), pBuffer-Buffer, f);
         }
     }
+}
+
+// ---------------------------------------------------------------------------
+// Binary flatfile format (F_MUXBIN).
+//
+// The text format above must be parsed a character at a time. The binary
+// format carries the same information, but every string is length-prefixed
+// and every object header has a fixed width, so loading is little more than
+// walking pointers. Objects are grouped into chunks which are located through
+// an index at the end of the file, so that chunks can be decoded in parallel.
+//
+//   signature  "\x89MUXDB\r\n"
+//   header     u32 revision, i32 flags (as +X), i32 db_top (+S),
+//              i32 attr_next (+N), i32 record_players (-R),
+//              u32 count of attribute names
+//   names      i32 number, i32 flags, string name        (one per +A)
+//   chunks     u32 object count, u32 variable section length,
+//              object headers, variable section
+//   index      u32 object count, u64 offset, u64 length  (one per chunk)
+//   trailer    u64 index offset, u32 chunk count, "MUXEND\r\n"
+//
+// An object header is 16 i32s: dbref, location, zone, contents, exits, link,
+// next, owner, parent, pennies, three flag words, two power words, and the
+// number of attributes. The variable section holds, for each object in turn,
+// its name (unless V_ATRNAME) and then its attributes (unless V_DATABASE) as
+// i32 number, string value.
+//
+// A string is a u32 length followed by that many bytes and a '\0' which is
+// not counted in the length. Integers are little-endian. Objects may appear
+// in any order.
+//
+#define BINARY_TRAILER        "MUXEND\r\n"
+#define BINARY_MAGIC_SIZE     8
+#define BINARY_REVISION       1
+#define BINARY_HEADER_SIZE    (BINARY_MAGIC_SIZE + 6*4)
+#define BINARY_TRAILER_SIZE   (8 + 4 + BINARY_MAGIC_SIZE)
+#define BINARY_OBJECT_FIELDS  16
+#define BINARY_OBJECT_SIZE    (BINARY_OBJECT_FIELDS*4)
+#define BINARY_INDEX_SIZE     (4 + 8 + 8)
+#define BINARY_CHUNK_OBJECTS  1024
+#define BINARY_MAX_THREADS    8
+
+typedef struct
+{
+    unsigned char *p;
+    size_t n;
+    size_t nAlloc;
+} BINARY_BUFFER;
+
+static void bb_reserve(BINARY_BUFFER *pbb, size_t n)
+{
+    if (pbb->nAlloc < pbb->n + n)
+    {
+        size_t nAlloc = pbb->nAlloc ? pbb->nAlloc : 65536;
+        while (nAlloc < pbb->n + n)
+        {
+            nAlloc *= 2;
+        }
+        unsigned char *p = (unsigned char *)MEMALLOC(nAlloc);
+        ISOUTOFMEMORY(p);
+        if (pbb->p)
+        {
+            memcpy(p, pbb->p, pbb->n);
+            MEMFREE(pbb->p);
+        }
+        pbb->p = p;
+        pbb->nAlloc = nAlloc;
+    }
+}
+
+static void bb_free(BINARY_BUFFER *pbb)
+{
+    if (pbb->p)
+    {
+        MEMFREE(pbb->p);
+    }
+    pbb->p = nullptr;
+    pbb->n = 0;
+    pbb->nAlloc = 0;
+}
+
+static void bb_put32(BINARY_BUFFER *pbb, UINT32 u)
+{
+    bb_reserve(pbb, 4);
+    unsigned char *p = pbb->p + pbb->n;
+    p[0] = static_cast<unsigned char>(u);
+    p[1] = static_cast<unsigned char>(u >> 8);
+    p[2] = static_cast<unsigned char>(u >> 16);
+    p[3] = static_cast<unsigned char>(u >> 24);
+    pbb->n += 4;
+}
+
+static void bb_put64(BINARY_BUFFER *pbb, UINT64 u)
+{
+    bb_put32(pbb, static_cast<UINT32>(u));
+    bb_put32(pbb, static_cast<UINT32>(u >> 32));
+}
+
+static void bb_putbytes(BINARY_BUFFER *pbb, const void *p, size_t n)
+{
+    bb_reserve(pbb, n);
+    memcpy(pbb->p + pbb->n, p, n);
+    pbb->n += n;
+}
+
+static void bb_putstring(BINARY_BUFFER *pbb, const UTF8 *p)
+{
+    size_t n = (nullptr == p) ? 0 : strlen((const char *)p);
+    bb_put32(pbb, static_cast<UINT32>(n));
+    bb_reserve(pbb, n + 1);
+    if (n)
+    {
+        memcpy(pbb->p + pbb->n, p, n);
+    }
+    pbb->p[pbb->n + n] = '\0';
+    pbb->n += n + 1;
+}
+
+static inline UINT32 get32(const unsigned char *p)
+{
+    return  static_cast<UINT32>(p[0])
+         | (static_cast<UINT32>(p[1]) << 8)
+         | (static_cast<UINT32>(p[2]) << 16)
+         | (static_cast<UINT32>(p[3]) << 24);
+}
+
+static inline UINT64 get64(const unsigned char *p)
+{
+    return static_cast<UINT64>(get32(p)) | (static_cast<UINT64>(get32(p+4)) << 32);
+}
+
+// An output flatfile in either format. Binary objects are collected into a
+// chunk and written when the chunk fills.
+//
+typedef struct
+{
+    FILE   *f;
+    int     format;
+    int     flags;
+    UINT64  nOffset;
+    UINT32  nObjects;
+    UINT32  nChunks;
+    BINARY_BUFFER bbFixed;
+    BINARY_BUFFER bbVariable;
+    BINARY_BUFFER bbIndex;
+} DB_OUTPUT;
+
+static void db_output_write(DB_OUTPUT *po, const void *p, size_t n)
+{
+    fwrite(p, 1, n, po->f);
+    po->nOffset += n;
+}
+
+static void db_output_flush_chunk(DB_OUTPUT *po)
+{
+    if (0 == po->nObjects)
+    {
+        return;
+    }
+
+    unsigned char prefix[8];
+    BINARY_BUFFER bb = { prefix, 0, sizeof(prefix) };
+    bb_put32(&bb, po->nObjects);
+    bb_put32(&bb, static_cast<UINT32>(po->bbVariable.n));
+
+    bb_put32(&po->bbIndex, po->nObjects);
+    bb_put64(&po->bbIndex, po->nOffset);
+    bb_put64(&po->bbIndex, sizeof(prefix) + po->bbFixed.n + po->bbVariable.n);
+
+    db_output_write(po, prefix, sizeof(prefix));
+    db_output_write(po, po->bbFixed.p, po->bbFixed.n);
+    db_output_write(po, po->bbVariable.p, po->bbVariable.n);
+    po->bbFixed.n = 0;
+    po->bbVariable.n = 0;
+    po->nObjects = 0;
+    po->nChunks++;
+}
+
+static void db_output_begin(DB_OUTPUT *po, FILE *f, int format, int flags)
+{
+    memset(po, 0, sizeof(DB_OUTPUT));
+    po->f = f;
+    po->format = format;
+    po->flags = flags;
+
+    if (F_MUXBIN != format)
+    {
+        db_write_header(f, flags);
+        return;
+    }
+
+    BINARY_BUFFER bb = { nullptr, 0, 0 };
+    bb_putbytes(&bb, BINARY_SIGNATURE, BINARY_MAGIC_SIZE);
+    bb_put32(&bb, BINARY_REVISION);
+    bb_put32(&bb, static_cast<UINT32>(flags));
+    bb_put32(&bb, static_cast<UINT32>(mudstate.db_top));
+    bb_put32(&bb, static_cast<UINT32>(mudstate.attr_next));
+    bb_put32(&bb, static_cast<UINT32>(mudstate.record_players));
+
+    size_t iCount = bb.n;
+    bb_put32(&bb, 0);
+    UINT32 nNames = 0;
+    for (int iAttr = A_USER_START; iAttr <= anum_alc_top; iAttr++)
+    {
+        ATTR *vp = (ATTR *) anum_get(iAttr);
+        if (  vp != nullptr
+           && !(vp->flags & AF_DELETED))
+        {
+            bb_put32(&bb, static_cast<UINT32>(vp->number));
+            bb_put32(&bb, static_cast<UINT32>(vp->flags));
+            bb_putstring(&bb, vp->name);
+            nNames++;
+        }
+    }
+    size_t nSave = bb.n;
+    bb.n = iCount;
+    bb_put32(&bb, nNames);
+    bb.n = nSave;
+
+    db_output_write(po, bb.p, bb.n);
+    bb_free(&bb);
+}
+
+static void db_output_object(DB_OUTPUT *po, dbref i, const OBJ_IMAGE *pImage)
+{
+    if (F_MUXBIN != po->format)
+    {
+        db_write_object(po->f, i, po->flags, pImage);
+        return;
+    }
+
+    BINARY_BUFFER *pbb = &po->bbVariable;
+    if (!(po->flags & V_ATRNAME))
+    {
+        bb_putstring(pbb, Name(i));
+    }
+
+    UINT32 nAttrs = 0;
+    if (!(po->flags & V_DATABASE))
+    {
+        unsigned char *as;
+        for (int ca = atr_head(i, &as); ca; ca = atr_next(&as))
+        {
+            int j = db_dumped_attr(ca, po->flags);
+            if (0 != j)
+            {
+                bb_put32(pbb, static_cast<UINT32>(j));
+                bb_putstring(pbb, atr_get_raw(i, j));
+                nAttrs++;
+            }
+        }
+    }
+
+    pbb = &po->bbFixed;
+    bb_put32(pbb, static_cast<UINT32>(i));
+    bb_put32(pbb, static_cast<UINT32>(pImage->location));
+    bb_put32(pbb, static_cast<UINT32>(pImage->zone));
+    bb_put32(pbb, static_cast<UINT32>(pImage->contents));
+    bb_put32(pbb, static_cast<UINT32>(pImage->exits));
+    bb_put32(pbb, static_cast<UINT32>(pImage->link));
+    bb_put32(pbb, static_cast<UINT32>(pImage->next));
+    bb_put32(pbb, static_cast<UINT32>(pImage->owner));
+    bb_put32(pbb, static_cast<UINT32>(pImage->parent));
+    bb_put32(pbb, static_cast<UINT32>((po->flags & V_ATRMONEY) ? 0 : Pennies(i)));
+    bb_put32(pbb, static_cast<UINT32>(pImage->flags[0]));
+    bb_put32(pbb, static_cast<UINT32>(pImage->flags[1]));
+    bb_put32(pbb, static_cast<UINT32>(pImage->flags[2]));
+    bb_put32(pbb, static_cast<UINT32>(pImage->powers));
+    bb_put32(pbb, static_cast<UINT32>(pImage->powers2));
+    bb_put32(pbb, nAttrs);
+
+    po->nObjects++;
+    if (BINARY_CHUNK_OBJECTS <= po->nObjects)
+    {
+        db_output_flush_chunk(po);
+    }
+}
+
+static void db_output_end(DB_OUTPUT *po)
+{
+    if (F_MUXBIN != po->format)
+    {
+        fputs("***END OF DUMP***\n", po->f);
+        return;
+    }
+
+    db_output_flush_chunk(po);
+
+    UINT64 nIndexOffset = po->nOffset;
+    db_output_write(po, po->bbIndex.p, po->bbIndex.n);
+
+    unsigned char trailer[BINARY_TRAILER_SIZE];
+    BINARY_BUFFER bb = { trailer, 0, sizeof(trailer) };
+    bb_put64(&bb, nIndexOffset);
+    bb_put32(&bb, po->nChunks);
+    bb_putbytes(&bb, BINARY_TRAILER, BINARY_MAGIC_SIZE);
+    db_output_write(po, trailer, sizeof(trailer));
+
+    bb_free(&po->bbFixed);
+    bb_free(&po->bbVariable);
+    bb_free(&po->bbIndex);
+}
+
+dbref db_write(FILE *f, int format, int version)
+{
+    dbref i;
+    int flags;
+
+    switch (format)
+    {
+    case F_MUX:
+    case F_MUXBIN:
+        flags = version;
+        break;
+
+    default:
+        Log.WriteString(T("Can only write MUX format." ENDLINE));
+        return -1;
+    }
+    if (mudstate.bStandAlone)
+    {
+        Log.WriteString(T("Writing "));
+        Log.Flush();
+    }
+    DB_OUTPUT out;
+    db_output_begin(&out, f, format, flags);
 
     int iDotCounter = 0;
-    UTF8 buf[SBUF_SIZE];
-    buf[0] = '!';
+    OBJ_IMAGE image;
     DO_WHOLE_DB(i)
     {
         if (mudstate.bStandAlone)
@@ -934,19 +1315,665 @@ dbref db_write(FILE *f, int format, int version)
 
         if (!isGarbage(i))
         {
-            // Format is: "!%d\n", i
-            //
-            size_t n = mux_ltoa(i, buf+1) + 1;
-            buf[n++] = '\n';
-            fwrite(buf, sizeof(UTF8), n, f);
-            db_write_object(f, i, format, flags);
+            db_image_object(i, &image);
+            db_output_object(&out, i, &image);
+        }
+    }
+    db_output_end(&out);
+    if (mudstate.bStandAlone)
+    {
+        Log.WriteString(T(ENDLINE));
+        Log.Flush();
+    }
+    return mudstate.db_top;
+}
+
+// Loading a binary flatfile.
+//
+// The whole file is read into memory. Each chunk is then decoded into
+// pointers to its names and attribute values (which are already
+// '\0'-terminated in the buffer) and checked against the buffer bounds. With
+// threads, decoding runs on worker threads ahead of the main thread, which
+// commits decoded chunks into db[] and the attribute store in file order.
+//
+typedef struct
+{
+    int         number;
+    UINT32      nValue;
+    const UTF8 *pValue;
+} BINARY_ATTR;
+
+typedef struct
+{
+    const unsigned char *pHeaders;
+    const unsigned char *pVariable;
+    UINT32       nObjects;
+    UINT32       nVariable;
+    const UTF8 **apNames;
+    UINT32      *anAttrs;
+    BINARY_ATTR *aAttrs;
+    bool         bDecoded;
+    bool         bValid;
+} BINARY_CHUNK;
+
+typedef struct
+{
+    int           flags;
+    UINT32        nChunks;
+    BINARY_CHUNK *aChunks;
+#if defined(UNIX_THREADS)
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+    UINT32          iNextChunk;
+#endif // UNIX_THREADS
+} BINARY_LOAD;
+
+static bool db_binary_decode(const BINARY_LOAD *pbl, BINARY_CHUNK *pc)
+{
+    UINT32 nAttrs = 0;
+    for (UINT32 k = 0; k < pc->nObjects; k++)
+    {
+        UINT32 n = get32(pc->pHeaders + k*BINARY_OBJECT_SIZE + (BINARY_OBJECT_FIELDS-1)*4);
+        if (pc->nVariable/8 < n)
+        {
+            return false;
+        }
+        nAttrs += n;
+        if (pc->nVariable/8 < nAttrs)
+        {
+            return false;
+        }
+    }
+
+    pc->apNames = new const UTF8 *[pc->nObjects];
+    pc->anAttrs = new UINT32[pc->nObjects];
+    pc->aAttrs  = new BINARY_ATTR[nAttrs ? nAttrs : 1];
+
+    const unsigned char *p = pc->pVariable;
+    const unsigned char *pEnd = pc->pVariable + pc->nVariable;
+    BINARY_ATTR *pa = pc->aAttrs;
+    for (UINT32 k = 0; k < pc->nObjects; k++)
+    {
+        pc->apNames[k] = nullptr;
+        if (!(pbl->flags & V_ATRNAME))
+        {
+            if (pEnd - p < 4)
+            {
+                return false;
+            }
+            UINT32 n = get32(p);
+            p += 4;
+            if (  static_cast<size_t>(pEnd - p) <= n
+               || '\0' != p[n])
+            {
+                return false;
+            }
+            pc->apNames[k] = (const UTF8 *)p;
+            p += n + 1;
+        }
+
+        UINT32 nObjAttrs = get32(pc->pHeaders + k*BINARY_OBJECT_SIZE + (BINARY_OBJECT_FIELDS-1)*4);
+        pc->anAttrs[k] = nObjAttrs;
+        for (UINT32 m = 0; m < nObjAttrs; m++)
+        {
+            if (pEnd - p < 8)
+            {
+                return false;
+            }
+            pa->number = static_cast<int>(get32(p));
+            UINT32 n = get32(p+4);
+            p += 8;
+            if (  static_cast<size_t>(pEnd - p) <= n
+               || '\0' != p[n])
+            {
+                return false;
+            }
+            pa->nValue = n;
+            pa->pValue = (const UTF8 *)p;
+            p += n + 1;
+            pa++;
+        }
+    }
+    return p == pEnd;
+}
+
+static void db_binary_free_chunk(BINARY_CHUNK *pc)
+{
+    delete [] pc->apNames;
+    delete [] pc->anAttrs;
+    delete [] pc->aAttrs;
+    pc->apNames = nullptr;
+    pc->anAttrs = nullptr;
+    pc->aAttrs  = nullptr;
+}
+
+#if defined(UNIX_THREADS)
+static void *db_binary_worker(void *arg)
+{
+    BINARY_LOAD *pbl = (BINARY_LOAD *)arg;
+    for (;;)
+    {
+        pthread_mutex_lock(&pbl->mutex);
+        UINT32 iChunk = pbl->iNextChunk++;
+        pthread_mutex_unlock(&pbl->mutex);
+        if (pbl->nChunks <= iChunk)
+        {
+            break;
+        }
+
+        BINARY_CHUNK *pc = &pbl->aChunks[iChunk];
+        bool bValid = db_binary_decode(pbl, pc);
+
+        pthread_mutex_lock(&pbl->mutex);
+        pc->bValid = bValid;
+        pc->bDecoded = true;
+        pthread_cond_broadcast(&pbl->cond);
+        pthread_mutex_unlock(&pbl->mutex);
+    }
+    return nullptr;
+}
+#endif // UNIX_THREADS
+
+static void db_binary_commit(const BINARY_LOAD *pbl, const BINARY_CHUNK *pc)
+{
+    const BINARY_ATTR *pa = pc->aAttrs;
+    for (UINT32 k = 0; k < pc->nObjects; k++)
+    {
+        const unsigned char *ph = pc->pHeaders + k*BINARY_OBJECT_SIZE;
+        dbref i = static_cast<dbref>(get32(ph));
+        if (i < 0)
+        {
+            pa += pc->anAttrs[k];
+            continue;
+        }
+        db_grow(i + 1);
+
+        if (nullptr != pc->apNames[k])
+        {
+            UTF8 *buff = alloc_mbuf("db_read_binary.s_Name");
+            StripTabsAndTruncate(pc->apNames[k], buff, MBUF_SIZE-1, MBUF_SIZE-1);
+            s_Name(i, buff);
+            free_mbuf(buff);
+        }
+
+        s_Location(i, static_cast<dbref>(get32(ph + 4)));
+        dbref zone = static_cast<dbref>(get32(ph + 8));
+        if (zone < NOTHING)
+        {
+            zone = NOTHING;
+        }
+        s_Zone(i, zone);
+        s_Contents(i, static_cast<dbref>(get32(ph + 12)));
+        s_Exits(i, static_cast<dbref>(get32(ph + 16)));
+        s_Link(i, static_cast<dbref>(get32(ph + 20)));
+        s_Next(i, static_cast<dbref>(get32(ph + 24)));
+        s_Owner(i, static_cast<dbref>(get32(ph + 28)));
+        s_Parent(i, static_cast<dbref>(get32(ph + 32)));
+        if (!(pbl->flags & V_ATRMONEY))
+        {
+            s_PenniesDirect(i, static_cast<int>(get32(ph + 36)));
+        }
+        s_Flags(i, FLAG_WORD1, static_cast<FLAG>(get32(ph + 40)));
+        s_Flags(i, FLAG_WORD2, static_cast<FLAG>(get32(ph + 44)));
+        s_Flags(i, FLAG_WORD3, static_cast<FLAG>(get32(ph + 48)));
+        s_Powers(i, static_cast<POWER>(get32(ph + 52)));
+        s_Powers2(i, static_cast<POWER>(get32(ph + 56)));
+
+        for (UINT32 m = 0; m < pc->anAttrs[k]; m++, pa++)
+        {
+            if (0 < pa->number)
+            {
+                if (g_max_obj_atr < pa->number)
+                {
+                    g_max_obj_atr = pa->number;
+                }
+                atr_add_raw_LEN(i, pa->number, pa->pValue, pa->nValue);
+            }
+        }
+
+        if (isPlayer(i))
+        {
+            c_Connected(i);
+        }
+    }
+}
+
+static dbref db_read_binary(FILE *f, int *db_format, int *db_version, int *db_flags)
+{
+    // Read the whole file. The input may be a pipe.
+    //
+    BINARY_BUFFER bb = { nullptr, 0, 0 };
+    for (;;)
+    {
+        bb_reserve(&bb, 65536);
+        size_t n = fread(bb.p + bb.n, 1, bb.nAlloc - bb.n, f);
+        if (0 == n)
+        {
+            break;
+        }
+        bb.n += n;
+    }
+
+    const unsigned char *pBase = bb.p;
+    size_t nBase = bb.n;
+    if (  nBase < BINARY_HEADER_SIZE + BINARY_TRAILER_SIZE
+       || memcmp(pBase, BINARY_SIGNATURE, BINARY_MAGIC_SIZE) != 0
+       || memcmp(pBase + nBase - BINARY_MAGIC_SIZE, BINARY_TRAILER, BINARY_MAGIC_SIZE) != 0)
+    {
+        Log.WriteString(T(ENDLINE "Binary flatfile is truncated or damaged." ENDLINE));
+        bb_free(&bb);
+        return -1;
+    }
+
+    const unsigned char *p = pBase + BINARY_MAGIC_SIZE;
+    UINT32 revision = get32(p);
+    int flags = static_cast<int>(get32(p + 4));
+    if (BINARY_REVISION != revision)
+    {
+        Log.tinyprintf(T(ENDLINE "Unsupported binary flatfile revision: %u." ENDLINE), revision);
+        bb_free(&bb);
+        return -1;
+    }
+
+    g_format = F_MUXBIN;
+    g_version = flags & V_MASK;
+    g_flags = flags & ~V_MASK;
+    if (  4 != g_version
+       || (g_flags & MANDFLAGS_V4) != MANDFLAGS_V4)
+    {
+        Log.tinyprintf(T(ENDLINE "Unsupported flatfile version: %d." ENDLINE), g_version);
+        bb_free(&bb);
+        return -1;
+    }
+
+    const unsigned char *pTrailer = pBase + nBase - BINARY_TRAILER_SIZE;
+    UINT64 nIndexOffset = get64(pTrailer);
+    UINT32 nChunks = get32(pTrailer + 8);
+    if (  nIndexOffset < BINARY_HEADER_SIZE
+       || static_cast<UINT64>(pTrailer - pBase) < nIndexOffset
+       || (static_cast<UINT64>(pTrailer - pBase) - nIndexOffset) / BINARY_INDEX_SIZE != nChunks)
+    {
+        Log.WriteString(T(ENDLINE "Binary flatfile chunk index is damaged." ENDLINE));
+        bb_free(&bb);
+        return -1;
+    }
+
+    if (mudstate.bStandAlone)
+    {
+        Log.WriteString(T("Reading binary "));
+        Log.Flush();
+    }
+
+    db_free();
+    mudstate.min_size = static_cast<int>(get32(p + 8));
+    mudstate.attr_next = static_cast<int>(get32(p + 12));
+    mudstate.record_players = static_cast<int>(get32(p + 16));
+    if (mudconf.reset_players)
+    {
+        mudstate.record_players = 0;
+    }
+
+    // User-named attributes.
+    //
+    UINT32 nNames = get32(p + 20);
+    p = pBase + BINARY_HEADER_SIZE;
+    const unsigned char *pChunkStart = pBase + nIndexOffset;
+    for (UINT32 k = 0; k < nNames; k++)
+    {
+        if (pChunkStart - p < 12)
+        {
+            break;
+        }
+        int anum = static_cast<int>(get32(p));
+        int aflags = static_cast<int>(get32(p + 4));
+        UINT32 n = get32(p + 8);
+        p += 12;
+        if (  static_cast<size_t>(pChunkStart - p) <= n
+           || '\0' != p[n])
+        {
+            break;
+        }
+
+        size_t nName;
+        bool bValid;
+        UTF8 *pName = MakeCanonicalAttributeName(p, &nName, &bValid);
+        if (bValid)
+        {
+            if (g_max_nam_atr < anum)
+            {
+                g_max_nam_atr = anum;
+            }
+            vattr_define_LEN(pName, nName, anum, aflags);
         }
+        p += n + 1;
     }
-    fputs("***END OF DUMP***\n", f);
+
+    // Locate the chunks.
+    //
+    BINARY_LOAD bl;
+    bl.flags = flags;
+    bl.nChunks = nChunks;
+    bl.aChunks = new BINARY_CHUNK[nChunks ? nChunks : 1];
+
+    bool bValid = true;
+    const unsigned char *pIndex = pBase + nIndexOffset;
+    for (UINT32 k = 0; k < nChunks; k++, pIndex += BINARY_INDEX_SIZE)
+    {
+        BINARY_CHUNK *pc = &bl.aChunks[k];
+        UINT32 nObjects = get32(pIndex);
+        UINT64 offset = get64(pIndex + 4);
+        UINT64 length = get64(pIndex + 12);
+
+        pc->apNames = nullptr;
+        pc->anAttrs = nullptr;
+        pc->aAttrs  = nullptr;
+        pc->bDecoded = true;
+        pc->bValid = false;
+        pc->nObjects = 0;
+
+        if (  offset < BINARY_HEADER_SIZE
+           || nIndexOffset < offset
+           || nIndexOffset - offset < length
+           || length < 8)
+        {
+            bValid = false;
+            continue;
+        }
+        const unsigned char *pChunk = pBase + offset;
+        UINT32 nVariable = get32(pChunk + 4);
+        if (  get32(pChunk) != nObjects
+           || length != 8 + static_cast<UINT64>(nObjects) * BINARY_OBJECT_SIZE + nVariable)
+        {
+            bValid = false;
+            continue;
+        }
+        pc->nObjects = nObjects;
+        pc->nVariable = nVariable;
+        pc->pHeaders = pChunk + 8;
+        pc->pVariable = pc->pHeaders + static_cast<size_t>(nObjects) * BINARY_OBJECT_SIZE;
+        pc->bDecoded = false;
+    }
+
+    // Decode and commit.
+    //
+#if defined(UNIX_THREADS)
+    pthread_t aThreads[BINARY_MAX_THREADS];
+    int nThreads = 0;
+    long nCPUs = sysconf(_SC_NPROCESSORS_ONLN);
+    if (  bValid
+       && 1 < nChunks
+       && 1 < nCPUs)
+    {
+        pthread_mutex_init(&bl.mutex, nullptr);
+        pthread_cond_init(&bl.cond, nullptr);
+        bl.iNextChunk = 0;
+
+        int nWanted = static_cast<int>(nCPUs < BINARY_MAX_THREADS ? nCPUs : BINARY_MAX_THREADS);
+        while (  nThreads < nWanted
+              && 0 == pthread_create(&aThreads[nThreads], nullptr, db_binary_worker, &bl))
+        {
+            nThreads++;
+        }
+    }
+#endif // UNIX_THREADS
+
+    for (UINT32 k = 0; k < nChunks && bValid; k++)
+    {
+        BINARY_CHUNK *pc = &bl.aChunks[k];
+#if defined(UNIX_THREADS)
+        if (0 < nThreads)
+        {
+            pthread_mutex_lock(&bl.mutex);
+            while (!pc->bDecoded)
+            {
+                pthread_cond_wait(&bl.cond, &bl.mutex);
+            }
+            pthread_mutex_unlock(&bl.mutex);
+        }
+        else
+#endif // UNIX_THREADS
+        {
+            pc->bValid = db_binary_decode(&bl, pc);
+        }
+
+        if (pc->bValid)
+        {
+            db_binary_commit(&bl, pc);
+        }
+        else
+        {
+            Log.tinyprintf(T(ENDLINE "Binary flatfile chunk %u is damaged." ENDLINE), k);
+            bValid = false;
+        }
+        db_binary_free_chunk(pc);
+
+        if (mudstate.bStandAlone)
+        {
+            fputc('.', stderr);
+            fflush(stderr);
+        }
+    }
+
+#if defined(UNIX_THREADS)
+    if (0 < nThreads)
+    {
+        // Stop the workers from taking any more chunks.
+        //
+        pthread_mutex_lock(&bl.mutex);
+        bl.iNextChunk = nChunks;
+        pthread_mutex_unlock(&bl.mutex);
+        for (int k = 0; k < nThreads; k++)
+        {
+            pthread_join(aThreads[k], nullptr);
+        }
+        pthread_cond_destroy(&bl.cond);
+        pthread_mutex_destroy(&bl.mutex);
+    }
+#endif // UNIX_THREADS
+
+    for (UINT32 k = 0; k < nChunks; k++)
+    {
+        db_binary_free_chunk(&bl.aChunks[k]);
+    }
+    delete [] bl.aChunks;
+    bb_free(&bb);
+
+    if (!bValid)
+    {
+        return -1;
+    }
+
+    db_read_adjust_attr_next(true);
+
+    *db_version = g_version;
+    *db_format = g_format;
+    *db_flags = g_flags;
     if (mudstate.bStandAlone)
     {
         Log.WriteString(T(ENDLINE));
         Log.Flush();
     }
+    else
+    {
+        load_player_names();
+    }
     return mudstate.db_top;
 }
+
+// ---------------------------------------------------------------------------
+// Incremental checkpoints.
+//
+// A checkpoint writes the same image as db_write(), but a slice at a time so
+// that the game keeps running in between. The image is the database as it
+// stood when the checkpoint began:
+//
+// - Header fields for every object are copied up front.
+// - Names, money, and attributes are read when an object is written. Each
+//   object which has not been written yet is pending, and anything which is
+//   about to change one of those calls db_checkpoint_object() first, so the
+//   object is written ahead of its turn with its old contents.
+// - Objects created after the checkpoint began are beyond its +S size and
+//   are not written.
+//
+#define CHECKPOINT_MAX_OUTPUTS 2
+
+typedef struct
+{
+    int        nOutputs;
+    DB_OUTPUT  aOutputs[CHECKPOINT_MAX_OUTPUTS];
+    bool       bLiveReads;
+    dbref      nTop;
+    dbref      iNext;
+    dbref      nWritten;
+    dbref      nEarly;
+    CBitField *pPending;
+    OBJ_IMAGE *pImages;
+} CHECKPOINT;
+
+static CHECKPOINT *g_pCheckpoint = nullptr;
+
+bool db_checkpoint_active(void)
+{
+    return nullptr != g_pCheckpoint;
+}
+
+bool db_checkpoint_begin(int nOutputs, FILE *af[], const int aformats[], const int aflags[])
+{
+    if (  nullptr != g_pCheckpoint
+       || nOutputs < 1
+       || CHECKPOINT_MAX_OUTPUTS < nOutputs)
+    {
+        return false;
+    }
+
+    CHECKPOINT *pc = new CHECKPOINT;
+    pc->nOutputs   = nOutputs;
+    pc->bLiveReads = false;
+    for (int k = 0; k < nOutputs; k++)
+    {
+
+        // Without names, money, or attributes in the image, the header
+        // fields copied below are all there is to write.
+        //
+        if ((aflags[k] & (V_ATRNAME|V_ATRMONEY|V_DATABASE))
+           != (V_ATRNAME|V_ATRMONEY|V_DATABASE))
+        {
+            pc->bLiveReads = true;
+        }
+        db_output_begin(&pc->aOutputs[k], af[k], aformats[k], aflags[k]);
+    }
+
+    pc->nTop     = mudstate.db_top;
+    pc->iNext    = 0;
+    pc->nWritten = 0;
+    pc->nEarly   = 0;
+    pc->pPending = new CBitField(pc->nTop);
+    pc->pPending->ClearAll();
+    pc->pImages  = nullptr;
+    if (0 < pc->nTop)
+    {
+        pc->pImages = (OBJ_IMAGE *)MEMALLOC(pc->nTop * sizeof(OBJ_IMAGE));
+        ISOUTOFMEMORY(pc->pImages);
+    }
+
+    dbref i;
+    DO_WHOLE_DB(i)
+    {
+        if (!isGarbage(i))
+        {
+            db_image_object(i, &pc->pImages[i]);
+            pc->pPending->Set(i);
+        }
+    }
+    g_pCheckpoint = pc;
+    return true;
+}
+
+static void db_checkpoint_write(CHECKPOINT *pc, dbref i)
+{
+    pc->pPending->Clear(i);
+    for (int k = 0; k < pc->nOutputs; k++)
+    {
+        db_output_object(&pc->aOutputs[k], i, &pc->pImages[i]);
+    }
+    pc->nWritten++;
+}
+
+// Returns true if the given object still needs to be written with its
+// current names, money, and attributes.
+//
+bool db_checkpoint_pending(dbref thing)
+{
+    CHECKPOINT *pc = g_pCheckpoint;
+    return  nullptr != pc
+         && pc->bLiveReads
+         && 0 <= thing
+         && thing < pc->nTop
+         && pc->pPending->IsSet(thing);
+}
+
+// Called before an object's names, money, or attributes are changed.
+//
+void db_checkpoint_object(dbref thing)
+{
+    if (db_checkpoint_pending(thing))
+    {
+        // The caller may be in the middle of walking another object's
+        // attributes.
+        //
+        atr_push();
+        db_checkpoint_write(g_pCheckpoint, thing);
+        atr_pop();
+        g_pCheckpoint->nEarly++;
+    }
+}
+
+// Writes up to nObjects pending objects. Returns true once the image is
+// complete, at which point the outputs may be closed.
+//
+bool db_checkpoint_step(int nObjects, dbref *pnWritten, dbref *pnEarly)
+{
+    CHECKPOINT *pc = g_pCheckpoint;
+    if (nullptr == pc)
+    {
+        return true;
+    }
+
+    while (  0 < nObjects
+          && pc->iNext < pc->nTop)
+    {
+        dbref i = pc->iNext++;
+        if (pc->pPending->IsSet(i))
+        {
+            db_checkpoint_write(pc, i);
+            nObjects--;
+        }
+    }
+
+    if (pc->iNext < pc->nTop)
+    {
+        return false;
+    }
+
+    for (int k = 0; k < pc->nOutputs; k++)
+    {
+        db_output_end(&pc->aOutputs[k]);
+    }
+    if (nullptr != pnWritten)
+    {
+        *pnWritten = pc->nWritten;
+    }
+    if (nullptr != pnEarly)
+    {
+        *pnEarly = pc->nEarly;
+    }
+
+    g_pCheckpoint = nullptr;
+    delete pc->pPending;
+    if (nullptr != pc->pImages)
+    {
+        MEMFREE(pc->pImages);
+    }
+    delete pc;
+    return true;
+}
@@ -709,6 +709,375 @@ TryAgain:
     return rstr;
 }
 
+// The parse cache remembers where parse_to_lite() found delimiters and which
+// function a name resolved to within a piece of text that is evaluated over
+// and over again (for example, the body of a u() or @function).  Plans are
+// keyed on the text itself, so changing an attribute leads to a new plan
+// instead of a stale one.  The result of parse_to_lite() depends only on the
+// text from the starting point to the terminating '\0' and the delimiters,
+// so replaying a recorded result is indistinguishable from scanning again.
+//
+#define PLAN_CACHE_SIZE     512
+#define PLAN_CACHE_BUCKETS  1024
+#define PLAN_FUN_NAME_LEN   32
+
+typedef struct plan_scan
+{
+    UINT32 key;         // (offset+1) << 16 | delim1 << 8 | delim2.
+    int    iWhichDelim;
+    int    iNext;       // Offset of returned pointer or -1 for nullptr.
+    size_t nLen;
+} PLAN_SCAN;
+
+typedef struct plan_fun
+{
+    UINT32 key;         // offset+1 of the '('.
+    size_t nFun;
+    UTF8   aName[PLAN_FUN_NAME_LEN];
+    FUN   *fp;
+    UFUN  *ufp;
+} PLAN_FUN;
+
+typedef struct parse_plan PARSE_PLAN;
+struct parse_plan
+{
+    UINT32      nHash;
+    size_t      nText;
+    UTF8       *pText;
+    int         nPinned;
+
+    size_t      nScan;
+    size_t      nScanAlloc;
+    PLAN_SCAN  *aScan;
+
+    size_t      nFun;
+    size_t      nFunAlloc;
+    PLAN_FUN   *aFun;
+
+    PARSE_PLAN *pHashNext;
+    PARSE_PLAN *pNewer;
+    PARSE_PLAN *pOlder;
+};
+
+static PARSE_PLAN *aPlanBuckets[PLAN_CACHE_BUCKETS];
+static PARSE_PLAN *pPlanNewest = nullptr;
+static PARSE_PLAN *pPlanOldest = nullptr;
+static int         nPlans = 0;
+static PARSE_PLAN *pActivePlan = nullptr;
+
+static inline bool plan_contains(const PARSE_PLAN *pp, const UTF8 *p)
+{
+    return (  nullptr != pp
+           && pp->pText <= p
+           && p <= pp->pText + pp->nText);
+}
+
+// Both memo tables are open-addressed with linear probing and are kept at
+// most half full.
+//
+static void *plan_grow(size_t nOldAlloc, size_t *pnAlloc, size_t nSize)
+{
+    size_t nAlloc = (0 == nOldAlloc) ? 16 : 2*nOldAlloc;
+    void *aNew = MEMALLOC(nAlloc * nSize);
+    ISOUTOFMEMORY(aNew);
+    memset(aNew, 0, nAlloc * nSize);
+    *pnAlloc = nAlloc;
+    return aNew;
+}
+
+static PLAN_SCAN *plan_scan_slot(PLAN_SCAN *aScan, size_t nAlloc, UINT32 key)
+{
+    size_t i = key & (nAlloc - 1);
+    while (  0 != aScan[i].key
+          && key != aScan[i].key)
+    {
+        i = (i + 1) & (nAlloc - 1);
+    }
+    return aScan + i;
+}
+
+static PLAN_FUN *plan_fun_slot(PLAN_FUN *aFun, size_t nAlloc, UINT32 key)
+{
+    size_t i = key & (nAlloc - 1);
+    while (  0 != aFun[i].key
+          && key != aFun[i].key)
+    {
+        i = (i + 1) & (nAlloc - 1);
+    }
+    return aFun + i;
+}
+
+static void plan_scan_add(PARSE_PLAN *pp, const PLAN_SCAN *ps)
+{
+    if (pp->nScanAlloc <= 2*(pp->nScan + 1))
+    {
+        size_t nAlloc;
+        PLAN_SCAN *aNew = static_cast<PLAN_SCAN *>(plan_grow(pp->nScanAlloc, &nAlloc, sizeof(PLAN_SCAN)));
+        for (size_t i = 0; i < pp->nScanAlloc; i++)
+        {
+            if (0 != pp->aScan[i].key)
+            {
+                *plan_scan_slot(aNew, nAlloc, pp->aScan[i].key) = pp->aScan[i];
+            }
+        }
+        if (nullptr != pp->aScan)
+        {
+            MEMFREE(pp->aScan);
+        }
+        pp->aScan = aNew;
+        pp->nScanAlloc = nAlloc;
+    }
+    PLAN_SCAN *pSlot = plan_scan_slot(pp->aScan, pp->nScanAlloc, ps->key);
+    if (0 == pSlot->key)
+    {
+        pp->nScan++;
+    }
+    *pSlot = *ps;
+}
+
+static void plan_fun_add(PARSE_PLAN *pp, const PLAN_FUN *pf)
+{
+    if (pp->nFunAlloc <= 2*(pp->nFun + 1))
+    {
+        size_t nAlloc;
+        PLAN_FUN *aNew = static_cast<PLAN_FUN *>(plan_grow(pp->nFunAlloc, &nAlloc, sizeof(PLAN_FUN)));
+        for (size_t i = 0; i < pp->nFunAlloc; i++)
+        {
+            if (0 != pp->aFun[i].key)
+            {
+                *plan_fun_slot(aNew, nAlloc, pp->aFun[i].key) = pp->aFun[i];
+            }
+        }
+        if (nullptr != pp->aFun)
+        {
+            MEMFREE(pp->aFun);
+        }
+        pp->aFun = aNew;
+        pp->nFunAlloc = nAlloc;
+    }
+    PLAN_FUN *pSlot = plan_fun_slot(pp->aFun, pp->nFunAlloc, pf->key);
+    if (0 == pSlot->key)
+    {
+        pp->nFun++;
+    }
+    *pSlot = *pf;
+}
+
+static void plan_unlink_age(PARSE_PLAN *pp)
+{
+    if (pp->pNewer)
+    {
+        pp->pNewer->pOlder = pp->pOlder;
+    }
+    else
+    {
+        pPlanNewest = pp->pOlder;
+    }
+    if (pp->pOlder)
+    {
+        pp->pOlder->pNewer = pp->pNewer;
+    }
+    else
+    {
+        pPlanOldest = pp->pNewer;
+    }
+    pp->pNewer = nullptr;
+    pp->pOlder = nullptr;
+}
+
+static void plan_link_newest(PARSE_PLAN *pp)
+{
+    pp->pOlder = pPlanNewest;
+    pp->pNewer = nullptr;
+    if (pPlanNewest)
+    {
+        pPlanNewest->pNewer = pp;
+    }
+    else
+    {
+        pPlanOldest = pp;
+    }
+    pPlanNewest = pp;
+}
+
+static void plan_free(PARSE_PLAN *pp)
+{
+    PARSE_PLAN **ppp = &aPlanBuckets[pp->nHash % PLAN_CACHE_BUCKETS];
+    while (*ppp != pp)
+    {
+        ppp = &(*ppp)->pHashNext;
+    }
+    *ppp = pp->pHashNext;
+    plan_unlink_age(pp);
+
+    if (nullptr != pp->aScan)
+    {
+        MEMFREE(pp->aScan);
+    }
+    if (nullptr != pp->aFun)
+    {
+        MEMFREE(pp->aFun);
+    }
+    MEMFREE(pp->pText);
+    MEMFREE(pp);
+    nPlans--;
+}
+
+static PARSE_PLAN *plan_lookup(const UTF8 *pText, size_t nText)
+{
+    const UINT32 nHash = HASH_ProcessBuffer(0, pText, nText);
+    PARSE_PLAN *pp = aPlanBuckets[nHash % PLAN_CACHE_BUCKETS];
+    while (nullptr != pp)
+    {
+        if (  nHash == pp->nHash
+           && nText == pp->nText
+           && 0 == memcmp(pText, pp->pText, nText))
+        {
+            plan_unlink_age(pp);
+            plan_link_newest(pp);
+            return pp;
+        }
+        pp = pp->pHashNext;
+    }
+
+    // Make room by discarding the oldest plans which are not being used.
+    //
+    PARSE_PLAN *pOld = pPlanOldest;
+    while (  PLAN_CACHE_SIZE <= nPlans
+          && nullptr != pOld)
+    {
+        PARSE_PLAN *pNewer = pOld->pNewer;
+        if (0 == pOld->nPinned)
+        {
+            plan_free(pOld);
+        }
+        pOld = pNewer;
+    }
+
+    pp = static_cast<PARSE_PLAN *>(MEMALLOC(sizeof(PARSE_PLAN)));
+    ISOUTOFMEMORY(pp);
+    memset(pp, 0, sizeof(PARSE_PLAN));
+    pp->pText = static_cast<UTF8 *>(MEMALLOC(nText + 1));
+    ISOUTOFMEMORY(pp->pText);
+    memcpy(pp->pText, pText, nText);
+    pp->pText[nText] = '\0';
+    pp->nText = nText;
+    pp->nHash = nHash;
+
+    PARSE_PLAN **ppBucket = &aPlanBuckets[nHash % PLAN_CACHE_BUCKETS];
+    pp->pHashNext = *ppBucket;
+    *ppBucket = pp;
+    plan_link_newest(pp);
+    nPlans++;
+    return pp;
+}
+
+/*! \brief Forget every function lookup remembered by the parse cache.
+ *
+ * Must be called whenever a built-in or global user-defined function is
+ * added or removed.
+ *
+ * \return         None.
+ */
+
+void parse_cache_flush_functions(void)
+{
+    for (PARSE_PLAN *pp = pPlanNewest; nullptr != pp; pp = pp->pOlder)
+    {
+        if (nullptr != pp->aFun)
+        {
+            MEMFREE(pp->aFun);
+            pp->aFun = nullptr;
+        }
+        pp->nFun = 0;
+        pp->nFunAlloc = 0;
+    }
+}
+
+// parse_to_lite() with the help of the active parse plan.
+//
+static const UTF8 *parse_to_lite_plan(const UTF8 *dstr, UTF8 delim1, UTF8 delim2, size_t *nLen, int *iWhichDelim)
+{
+    // An empty string leaves *iWhichDelim alone, so it is not remembered.
+    //
+    PARSE_PLAN *pp = pActivePlan;
+    if (  !plan_contains(pp, dstr)
+       || '\0' == dstr[0])
+    {
+        return parse_to_lite(dstr, delim1, delim2, nLen, iWhichDelim);
+    }
+
+    const UINT32 key = (static_cast<UINT32>(dstr - pp->pText + 1) << 16)
+                     | (static_cast<UINT32>(delim1) << 8) | delim2;
+    if (0 < pp->nScan)
+    {
+        const PLAN_SCAN *ps = plan_scan_slot(pp->aScan, pp->nScanAlloc, key);
+        if (key == ps->key)
+        {
+            *nLen = ps->nLen;
+            *iWhichDelim = ps->iWhichDelim;
+            return (ps->iNext < 0) ? nullptr : pp->pText + ps->iNext;
+        }
+    }
+
+    const UTF8 *rstr = parse_to_lite(dstr, delim1, delim2, nLen, iWhichDelim);
+
+    PLAN_SCAN ps;
+    ps.key = key;
+    ps.nLen = *nLen;
+    ps.iWhichDelim = *iWhichDelim;
+    ps.iNext = (nullptr == rstr) ? -1 : static_cast<int>(rstr - pp->pText);
+    plan_scan_add(pp, &ps);
+    return rstr;
+}
+
+// Look up a function name with the help of the active parse plan.  pParen is
+// the '(' in the text being evaluated that follows the name.
+//
+static void plan_find_function(const UTF8 *pParen, const UTF8 *pName, size_t nName, FUN **pfp, UFUN **pufp)
+{
+    PARSE_PLAN *pp = pActivePlan;
+    const bool bMemo = (  plan_contains(pp, pParen)
+                       && nName <= PLAN_FUN_NAME_LEN);
+    const UINT32 key = bMemo ? static_cast<UINT32>(pParen - pp->pText + 1) : 0;
+    if (  bMemo
+       && 0 < pp->nFun)
+    {
+        const PLAN_FUN *pf = plan_fun_slot(pp->aFun, pp->nFunAlloc, key);
+        if (  key == pf->key
+           && nName == pf->nFun
+           && 0 == memcmp(pName, pf->aName, nName))
+        {
+            *pfp = pf->fp;
+            *pufp = pf->ufp;
+            return;
+        }
+    }
+
+    FUN  *fp = (FUN *)hashfindLEN(pName, nName, &mudstate.func_htab);
+    UFUN *ufp = nullptr;
+
+    // If not a builtin func, check for global func.
+    //
+    if (nullptr == fp)
+    {
+        ufp = (UFUN *)hashfindLEN(pName, nName, &mudstate.ufunc_htab);
+    }
+
+    if (bMemo)
+    {
+        PLAN_FUN pf;
+        pf.key = key;
+        pf.nFun = nName;
+        memcpy(pf.aName, pName, nName);
+        pf.fp = fp;
+        pf.ufp = ufp;
+        plan_fun_add(pp, &pf);
+    }
+    *pfp = fp;
+    *pufp = ufp;
+}
+
 //-----------------------------------------------------------------------------
 // parse_arglist: Parse a line into an argument list contained in lbufs. A
 // pointer is returned to whatever follows the final delimiter. If the arglist
@@ -792,11 +1161,11 @@ static const UTF8 *parse_arglist_lite( dbref executor, dbref caller, dbref enact
         pCurr = pNext;
         if (arg < nfargs - 1)
         {
-            pNext = parse_to_lite(pCurr, ',', ')', &nLen, &iWhichDelim);
+            pNext = parse_to_lite_plan(pCurr, ',', ')', &nLen, &iWhichDelim);
         }
         else
         {
-            pNext = parse_to_lite(pCurr, '\0', ')', &nLen, &iWhichDelim);
+            pNext = parse_to_lite_plan(pCurr, '\0', ')', &nLen, &iWhichDelim);
         }
 
         // The following recognizes and returns zero arguments. We avoid
@@ -1106,44 +1475,6 @@ void PopPointers(UTF8 **p, int nNeeded)
     pPtrsFrame->nptrs += nNeeded;
 }
 
-#define REFS_PER_FRAME ((LBUF_SIZE - sizeof(void *) - sizeof(int))/sizeof(void *))
-typedef struct tag_refsframe
-{
-    int      nrefs;
-    reg_ref *refs[REFS_PER_FRAME];
-    struct tag_refsframe *next;
-} RefsFrame;
-
-static RefsFrame *pRefsFrame = nullptr;
-
-reg_ref **PushRegisters(int nNeeded)
-{
-    if (  !pRefsFrame
-       || pRefsFrame->nrefs < nNeeded)
-    {
-        RefsFrame *p = (RefsFrame *)alloc_lbuf("PushRegisters");
-        p->next = pRefsFrame;
-        p->nrefs = REFS_PER_FRAME;
-        pRefsFrame = p;
-    }
-    pRefsFrame->nrefs -= nNeeded;
-    return pRefsFrame->refs + pRefsFrame->nrefs;
-}
-
-void PopRegisters(reg_ref **p, int nNeeded)
-{
-    UNUSED_PARAMETER(p);
-
-    if (pRefsFrame->nrefs == REFS_PER_FRAME)
-    {
-        RefsFrame *q = pRefsFrame->next;
-        free_lbuf((UTF8 *)pRefsFrame);
-        pRefsFrame = q;
-    }
-    //mux_assert(p == pRefsFrame->refs + pRefsFrame->nrefs);
-    pRefsFrame->nrefs += nNeeded;
-}
-
 bool parse_rgb(size_t n, const UTF8 *p, RGB &rgb)
 {
     UTF8 ch;
@@ -1435,14 +1766,7 @@ void mux_exec( const UTF8 *pStr, size_t nStr, UTF8 *buff, UTF8 **bufc, dbref exe
             if (  0 < nFun
                && nFun <= MAX_UFUN_NAME_LEN)
             {
-                fp = (FUN *)hashfindLEN(mux_scratch, nFun, &mudstate.func_htab);
-
-                // If not a builtin func, check for global func.
-                //
-                if (nullptr == fp)
-                {
-                    ufp = (UFUN *)hashfindLEN(mux_scratch, nFun, &mudstate.ufunc_htab);
-                }
+                plan_find_function(pStr + iStr, mux_scratch, nFun, &fp, &ufp);
             }
 
             // Do the right thing if it doesn't exist.
@@ -1544,21 +1868,19 @@ void mux_exec( const UTF8 *pStr, size_t nStr, UTF8 *buff, UTF8 **bufc, dbref exe
                             i = executor;
                         }
 
-                        reg_ref **preserve = nullptr;
+                        reg_frame *preserve = nullptr;
 
                         if (ufp->flags & FN_PRES)
                         {
-                            preserve = PushRegisters(MAX_GLOBAL_REGS);
-                            save_global_regs(preserve);
+                            preserve = save_global_regs();
                         }
 
-                        mux_exec(tbuf, LBUF_SIZE-1, buff, &oldp, i, executor, enactor,
+                        mux_exec_cached(tbuf, buff, &oldp, i, executor, enactor,
                             AttrTrace(aflags, feval), (const UTF8 **)fargs, nfargs);
 
                         if (ufp->flags & FN_PRES)
                         {
                             restore_global_regs(preserve);
-                            PopRegisters(preserve, MAX_GLOBAL_REGS);
                             preserve = nullptr;
                         }
                         free_lbuf(tbuf);
@@ -1671,11 +1993,11 @@ void mux_exec( const UTF8 *pStr, size_t nStr, UTF8 *buff, UTF8 **bufc, dbref exe
                     if (  0 <= i
                        && i < MAX_GLOBAL_REGS)
                     {
-                        if (  mudstate.global_regs[i]
-                           && mudstate.global_regs[i]->reg_len > 0)
+                        if (  mudstate.global_regs->regs[i]
+                           && mudstate.global_regs->regs[i]->reg_len > 0)
                         {
-                            safe_copy_buf(mudstate.global_regs[i]->reg_ptr,
-                                mudstate.global_regs[i]->reg_len, buff, bufc);
+                            safe_copy_buf(mudstate.global_regs->regs[i]->reg_ptr,
+                                mudstate.global_regs->regs[i]->reg_len, buff, bufc);
                             nBufferAvailable = LBUF_SIZE - (*bufc - buff) - 1;
                         }
                     }
@@ -2223,7 +2545,7 @@ void mux_exec( const UTF8 *pStr, size_t nStr, UTF8 *buff, UTF8 **bufc, dbref exe
             // continue.
             //
             mudstate.nStackNest++;
-            tstr = parse_to_lite(pStr + iStr + 1, ']', '\0', &n, &at_space);
+            tstr = parse_to_lite_plan(pStr + iStr + 1, ']', '\0', &n, &at_space);
             at_space = 0;
             if (tstr == nullptr)
             {
@@ -2278,7 +2600,7 @@ void mux_exec( const UTF8 *pStr, size_t nStr, UTF8 *buff, UTF8 **bufc, dbref exe
             // continue.
             //
             mudstate.nStackNest++;
-            tstr = parse_to_lite(pStr + iStr + 1, '}', '\0', &n, &at_space);
+            tstr = parse_to_lite_plan(pStr + iStr + 1, '}', '\0', &n, &at_space);
             at_space = 0;
             if (nullptr == tstr)
             {
@@ -2436,57 +2758,118 @@ void mux_exec( const UTF8 *pStr, size_t nStr, UTF8 *buff, UTF8 **bufc, dbref exe
     isSpecial(L1, '[') = bBracketIsSpecialSave;
 }
 
+/*! \brief Evaluate text which is likely to be evaluated again.
+ *
+ * The text is evaluated from a private copy held by the parse cache, so the
+ * delimiter scans and function lookups made while evaluating it once are
+ * replayed the next time the same text is evaluated.  Otherwise, this is
+ * the same as mux_exec() on the whole string.
+ *
+ * \param pStr      '\0'-terminated text to evaluate.
+ * \return          None.
+ */
+
+void mux_exec_cached(const UTF8 *pStr, UTF8 *buff, UTF8 **bufc, dbref executor,
+               dbref caller, dbref enactor, int eval, const UTF8 *cargs[], int ncargs)
+{
+    if (  nullptr == pStr
+       || '\0' == pStr[0])
+    {
+        return;
+    }
+
+    const size_t nStr = strlen(reinterpret_cast<const char *>(pStr));
+    PARSE_PLAN *pp = plan_lookup(pStr, nStr);
+    PARSE_PLAN *pSave = pActivePlan;
+    pActivePlan = pp;
+    pp->nPinned++;
+
+    mux_exec(pp->pText, nStr, buff, bufc, executor, caller, enactor, eval,
+        cargs, ncargs);
+
+    pp->nPinned--;
+    pActivePlan = pSave;
+}
+
 /* ---------------------------------------------------------------------------
  * save_global_regs, restore_global_regs:  Save and restore the global
  * registers to protect them from various sorts of munging.
+ *
+ * The registers live in a reference-counted frame.  Saving them takes a
+ * reference, so it costs the same however many registers are set, and
+ * RegGlobalSlot() copies the frame only when one that is still shared is
+ * about to change.  Every frame, including the empty one, is non-null.
  */
 
-void save_global_regs
-(
-    reg_ref *preserve[]
-)
+static reg_frame empty_regs = { 1, { nullptr } };
+
+void RegFrameRelease(reg_frame *regframe)
 {
-    for (int i = 0; i < MAX_GLOBAL_REGS; i++)
+    regframe->refcount--;
+    if (0 == regframe->refcount)
     {
-        if (mudstate.global_regs[i])
+        for (int i = 0; i < MAX_GLOBAL_REGS; i++)
         {
-            RegAddRef(mudstate.global_regs[i]);
+            if (regframe->regs[i])
+            {
+                RegRelease(regframe->regs[i]);
+                regframe->regs[i] = nullptr;
+            }
         }
-        preserve[i] = mudstate.global_regs[i];
+        free_regframe(regframe);
     }
 }
 
-void save_and_clear_global_regs
-(
-    reg_ref *preserve[]
-)
+reg_frame *RegFrameEmpty(void)
 {
-    for (int i = 0; i < MAX_GLOBAL_REGS; i++)
-    {
-        preserve[i] = mudstate.global_regs[i];
-        mudstate.global_regs[i] = nullptr;
-    }
+    RegFrameAddRef(&empty_regs);
+    return &empty_regs;
 }
 
-void restore_global_regs
-(
-    reg_ref *preserve[]
-)
+reg_ref **RegGlobalSlot(int iRegister)
 {
-    for (int i = 0; i < MAX_GLOBAL_REGS; i++)
+    reg_frame *cur = mudstate.global_regs;
+    if (1 < cur->refcount)
     {
-        if (mudstate.global_regs[i])
-        {
-            RegRelease(mudstate.global_regs[i]);
-            mudstate.global_regs[i] = nullptr;
-        }
-
-        if (preserve[i])
+        reg_frame *copy = alloc_regframe("RegGlobalSlot");
+        copy->refcount = 1;
+        for (int i = 0; i < MAX_GLOBAL_REGS; i++)
         {
-            mudstate.global_regs[i] = preserve[i];
-            preserve[i] = nullptr;
+            copy->regs[i] = cur->regs[i];
+            if (copy->regs[i])
+            {
+                RegAddRef(copy->regs[i]);
+            }
         }
+        RegFrameRelease(cur);
+        mudstate.global_regs = cur = copy;
     }
+    return &cur->regs[iRegister];
+}
+
+reg_frame *save_global_regs(void)
+{
+    RegFrameAddRef(mudstate.global_regs);
+    return mudstate.global_regs;
+}
+
+reg_frame *save_and_clear_global_regs(void)
+{
+    reg_frame *preserve = mudstate.global_regs;
+    mudstate.global_regs = RegFrameEmpty();
+    return preserve;
+}
+
+void restore_global_regs(reg_frame *preserve)
+{
+    RegFrameRelease(mudstate.global_regs);
+    mudstate.global_regs = preserve;
+}
+
+void clear_global_regs(void)
+{
+    RegFrameRelease(mudstate.global_regs);
+    mudstate.global_regs = RegFrameEmpty();
 }
 
 static lbuf_ref *last_lbufref = nullptr;
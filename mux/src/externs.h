@@ -123,8 +123,9 @@ LBUF_OFFSET trimmed_name(dbref player, UTF8 cbuff[MBUF_SIZE], LBUF_OFFSET nMin,
 int  nfy_que(dbref, int, int, int);
 int  halt_que(dbref, dbref);
 void wait_que(dbref executor, dbref caller, dbref enactor, int, bool,
-    CLinearTimeAbsolute&, dbref, int, UTF8 *, int, const UTF8 *[], reg_ref *[]);
+    CLinearTimeAbsolute&, dbref, int, UTF8 *, int, const UTF8 *[], reg_frame *);
 void query_complete(UINT32 hQuery, UINT32 iError, CResultsSet *prs);
+void report_queue_shares(dbref player, bool yes_screen, bool yes_log, bool yes_clear);
 
 #if defined(UNIX_CRYPT)
 extern "C" char *crypt(const char *inptr, const char *inkey);
@@ -139,6 +140,9 @@ void parse_arglist(dbref executor, dbref caller, dbref enactor, UTF8 *,
 int get_gender(dbref);
 void mux_exec(const UTF8 *pdstr, size_t nStr, UTF8 *buff, UTF8 **bufc, dbref executor,
               dbref caller, dbref enactor, int eval, const UTF8 *cargs[], int ncargs);
+void mux_exec_cached(const UTF8 *pdstr, UTF8 *buff, UTF8 **bufc, dbref executor,
+              dbref caller, dbref enactor, int eval, const UTF8 *cargs[], int ncargs);
+void parse_cache_flush_functions(void);
 
 inline void BufAddRef(lbuf_ref *lbufref)
 {
@@ -187,12 +191,19 @@ inline void RegRelease(reg_ref *regref)
 }
 void RegAssign(reg_ref **regref, size_t nLength, const UTF8 *ptr);
 
-void save_global_regs(reg_ref *preserve[]);
-void save_and_clear_global_regs(reg_ref *preserve[]);
-void restore_global_regs(reg_ref *preserve[]);
+inline void RegFrameAddRef(reg_frame *regframe)
+{
+    regframe->refcount++;
+}
+
+void RegFrameRelease(reg_frame *regframe);
+reg_frame *RegFrameEmpty(void);
+reg_ref **RegGlobalSlot(int iRegister);
 
-reg_ref **PushRegisters(int nNeeded);
-void PopRegisters(reg_ref **p, int nNeeded);
+reg_frame *save_global_regs(void);
+reg_frame *save_and_clear_global_regs(void);
+void restore_global_regs(reg_frame *preserve);
+void clear_global_regs(void);
 
 extern const signed char mux_RegisterSet[256];
 extern const unsigned int ColorTable[256];
@@ -232,6 +243,8 @@ void notify_except2(dbref, dbref, dbref, dbref, const UTF8 *);
 
 void notify_check(dbref target, dbref sender, const mux_string &msg, int key);
 void notify_check(dbref, dbref, const UTF8 *, int);
+bool notify_is_direct(dbref target, dbref sender, int key);
+void cmdtab_clr(dbref thing);
 
 bool Hearer(dbref);
 void report(void);
@@ -246,6 +259,10 @@ bool atr_match
     bool  check_parents
 );
 
+typedef struct regexp_entry REGEXP;
+REGEXP *regexp_compile(const UTF8 *pattern, int options, const char **perrptr);
+int regexp_exec(REGEXP *prx, const UTF8 *subject, size_t nSubject, int *ovec, int ovecsize);
+void regexp_release(REGEXP *prx);
 bool regexp_match
 (
     UTF8 *pattern,
@@ -452,7 +469,9 @@ void SetClearFlags(dbref thing, FLAG aClearFlags[3], FLAG aSetFlags[3]);
 /* From boolexp.cpp */
 bool eval_boolexp(dbref, dbref, dbref, BOOLEXP *);
 BOOLEXP *parse_boolexp(dbref, const UTF8 *, bool);
-bool eval_boolexp_atr(dbref, dbref, dbref, UTF8 *);
+bool eval_boolexp_lock(dbref player, dbref thing, dbref from, int locknum, const UTF8 *key);
+void lock_cache_clr(dbref thing, int locknum);
+void lock_cache_flush(void);
 
 /* From functions.cpp */
 bool xlate(UTF8 *);
@@ -544,6 +563,38 @@ UTF8 *atr_pget_str_LEN(UTF8 *, dbref, int, dbref *, int *, size_t *);
 UTF8 *atr_pget_str(UTF8 *, dbref, int, dbref *, int *);
 bool atr_get_info(dbref, int, dbref *, int *);
 bool atr_pget_info(dbref, int, dbref *, int *);
+
+// CAttrView looks at an attribute's text, owner, and flags without copying
+// the text into an LBUF.  The text points into the attribute cache (or the
+// object's attribute list in memory-based builds), so it is only good until
+// the next attribute is read or written and never beyond the life of the
+// view.  SELFCHECK builds check this.
+//
+class CAttrView
+{
+public:
+    CAttrView(void);
+    ~CAttrView(void);
+
+    bool get(dbref thing, int atr);
+    bool pget(dbref thing, int atr);
+
+    const UTF8 *text(void) const;
+    size_t length(void) const;
+    dbref owner(void) const { return m_owner; }
+    int   flags(void) const { return m_flags; }
+
+private:
+    void decode(const UTF8 *pRaw, size_t nRaw, dbref thing);
+
+    const UTF8 *m_pText;
+    size_t      m_nText;
+    dbref       m_owner;
+    int         m_flags;
+#if defined(SELFCHECK)
+    UINT32      m_nEpoch;
+#endif // SELFCHECK
+};
 void atr_free(dbref);
 bool check_zone_handler(dbref player, dbref thing, bool bPlayerCheck);
 #define check_zone(player, thing) check_zone_handler(player, thing, false)
@@ -1056,18 +1107,29 @@ void dispatch_CacheTick(void *pUnused, int iUnused);
 // If you ever re-implement this object using another data structure,
 // please remember to maintain this property.
 //
+// Within a priority, tasks are ordered by m_iShareTag and then by ticket.
+// A task is tagged with the scheduler's virtual time when it is created,
+// so that the order is by ticket unless the tag is changed.  The command
+// queue re-tags its entries to share the CPU fairly between owners.
+// Running a task advances the virtual time to the task's tag.
+//
 typedef void FTASK(void *, int);
 
-typedef struct
+typedef struct task_record
 {
     CLinearTimeAbsolute ltaWhen;
 
     int        iPriority;
+    INT64      m_iShareTag;     // Virtual time. Orders tasks of equal priority.
     int        m_Ticket;        // This is the order in which the task was scheduled.
     FTASK      *fpTask;
     void       *arg_voidptr;
     int        arg_Integer;
     int        m_iVisitedMark;
+    int        m_iHeapIndex;    // Position in the priority heap or -1.
+    int        m_iSlot;         // Slot in the timer wheel or -1.
+    struct task_record *m_pNext;
+    struct task_record *m_pPrev;
 } TASK_RECORD, *PTASK_RECORD;
 
 #define PRIORITY_SYSTEM  100
@@ -1099,6 +1161,11 @@ private:
     void Update(int iNode, SCHCMP *pfCompare);
     void Sort(SCHCMP *pfCompare);
     void Remake(SCHCMP *pfCompare);
+    void Assign(int iNode, PTASK_RECORD pTask)
+    {
+        m_pHeap[iNode] = pTask;
+        pTask->m_iHeapIndex = iNode;
+    }
 
 public:
     CTaskHeap();
@@ -1108,6 +1175,8 @@ public:
     bool Insert(PTASK_RECORD, SCHCMP *);
     PTASK_RECORD PeekAtTopmost(void);
     PTASK_RECORD RemoveTopmost(SCHCMP *);
+    void Remove(PTASK_RECORD pTask, SCHCMP *pfCompare);
+    void Update(PTASK_RECORD pTask, SCHCMP *pfCompare);
     void CancelTask(FTASK *fpTask, void *arg_voidptr, int arg_Integer);
 
 #define IU_DONE        0
@@ -1118,20 +1187,71 @@ public:
     int TraverseOrdered(SCHLOOK *pfLook, SCHCMP *pfCompare);
 };
 
+// Tasks waiting for a future time are kept on a hierarchical timer wheel
+// instead of a heap so that inserting or removing one does not depend on
+// how many are waiting. Each level has WHEEL_SLOTS slots, and one slot on
+// a level spans all the slots of the level below. As the wheel turns, the
+// tasks in a slot move down a level until they reach the first level where
+// every slot is one tick wide. Tasks further out than the last level wait
+// on an overflow list. Order within a slot is not kept, so tasks which come
+// due together are ordered by the priority heap instead.
+//
+#define WHEEL_TICK      FACTOR_100NS_PER_MILLISECOND
+#define WHEEL_BITS      8
+#define WHEEL_SLOTS     (1 << WHEEL_BITS)
+#define WHEEL_MASK      (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS    4
+#define WHEEL_OVERFLOW  (WHEEL_LEVELS*WHEEL_SLOTS)
+
+class CTaskWheel
+{
+private:
+    PTASK_RECORD m_apSlots[WHEEL_OVERFLOW+1];
+    int   m_anLevel[WHEEL_LEVELS+1];
+    int   m_nTasks;
+    INT64 m_tNow;
+    bool  m_bStarted;
+    bool  m_bNextValid;
+    CLinearTimeAbsolute m_ltaNext;
+    int   m_iVisitedMark;
+
+    void Start(void);
+    void File(PTASK_RECORD pTask);
+    void Unfile(PTASK_RECORD pTask);
+    void Cascade(int iLevel);
+    bool EarliestInSlot(int iSlot, CLinearTimeAbsolute *pltaWhen);
+
+public:
+    CTaskWheel();
+    ~CTaskWheel();
+
+    void Insert(PTASK_RECORD pTask);
+    void Remove(PTASK_RECORD pTask);
+    void Update(PTASK_RECORD pTask);
+    PTASK_RECORD RemoveReady(const CLinearTimeAbsolute& ltaNow);
+    bool WhenNext(CLinearTimeAbsolute *pltaWhen);
+    void CancelTask(FTASK *fpTask, void *arg_voidptr, int arg_Integer);
+    int TraverseUnordered(SCHLOOK *pfLook);
+    int TraverseOrdered(SCHLOOK *pfLook);
+};
+
 class CScheduler
 {
 private:
-    CTaskHeap m_WhenHeap;
-    CTaskHeap m_PriorityHeap;
-    int       m_Ticket;
-    int       m_minPriority;
+    CTaskWheel m_WhenWheel;
+    CTaskHeap  m_PriorityHeap;
+    int        m_Ticket;
+    int        m_minPriority;
+    INT64      m_iVirtualTime;
 
 public:
     void TraverseUnordered(SCHLOOK *pfLook);
     void TraverseOrdered(SCHLOOK *pfLook);
-    CScheduler(void) { m_Ticket = 0; m_minPriority = PRIORITY_CF_DEQUEUE_ENABLED; }
-    void DeferTask(const CLinearTimeAbsolute& ltWhen, int iPriority, FTASK *fpTask, void *arg_voidptr, int arg_Integer);
-    void DeferImmediateTask(int iPriority, FTASK *fpTask, void *arg_voidptr, int arg_Integer);
+    CScheduler(void) { m_Ticket = 0; m_minPriority = PRIORITY_CF_DEQUEUE_ENABLED; m_iVirtualTime = 0; }
+    PTASK_RECORD DeferTask(const CLinearTimeAbsolute& ltWhen, int iPriority, FTASK *fpTask, void *arg_voidptr, int arg_Integer);
+    PTASK_RECORD DeferImmediateTask(int iPriority, FTASK *fpTask, void *arg_voidptr, int arg_Integer);
+    void RemoveTask(PTASK_RECORD pTask);
+    void UpdateTask(PTASK_RECORD pTask);
     bool WhenNext(CLinearTimeAbsolute *);
     int  RunTasks(int iCount);
     int  RunAllTasks(void);
@@ -1142,6 +1262,7 @@ public:
 
     void SetMinPriority(int arg_minPriority);
     int  GetMinPriority(void) { return m_minPriority; }
+    INT64 GetVirtualTime(void) { return m_iVirtualTime; }
 };
 
 extern CScheduler scheduler;
@@ -1218,6 +1339,7 @@ UTF8 *modSpeech(dbref player, UTF8 *message, bool bWhich, UTF8 *command);
 void stack_clr(dbref obj);
 #endif // DEPRECATED
 bool parse_and_get_attrib(dbref, UTF8 *[], UTF8 **, dbref *, dbref *, int *, UTF8 *, UTF8 **);
+bool parse_and_view_attrib(dbref, UTF8 *[], CAttrView *, dbref *, UTF8 *, UTF8 **);
 
 DEFINE_FACTORY(CLogFactory)
 
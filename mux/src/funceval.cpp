@@ -83,6 +83,46 @@ bool parse_and_get_attrib
     return true;
 }
 
+// Like parse_and_get_attrib(), but looks at the attribute through a view
+// instead of copying it.
+//
+bool parse_and_view_attrib
+(
+    dbref      executor,
+    UTF8      *fargs[],
+    CAttrView *pav,
+    dbref     *thing,
+    UTF8      *buff,
+    UTF8     **bufc
+)
+{
+    ATTR *ap;
+
+    // Two possibilities for the first arg: <obj>/<attr> and <attr>.
+    //
+    if (!parse_attrib(executor, fargs[0], thing, &ap))
+    {
+        *thing = executor;
+        ap = atr_str(fargs[0]);
+    }
+
+    // Make sure we got a good attribute.
+    //
+    if (!ap)
+    {
+        return false;
+    }
+
+    // Use it if we can access it, otherwise return an error.
+    //
+    if (!See_attr(executor, *thing, ap))
+    {
+        safe_noperm(buff, bufc);
+        return false;
+    }
+    return pav->pget(*thing, ap->number);
+}
+
 #define CWHO_ON  0
 #define CWHO_OFF 1
 #define CWHO_ALL 2
@@ -989,18 +1029,21 @@ FUNCTION(fun_children)
         return;
     }
 
-    dbref i;
+    int nChildren;
+    dbref *aChildren = db_index_collect(it, IX_BIT(IX_PARENT), 0,
+        mudstate.db_top - 1, &nChildren);
+
     ITL pContext;
     ItemToList_Init(&pContext, buff, bufc, '#');
-    DO_WHOLE_DB(i)
+    for (int i = 0; i < nChildren; i++)
     {
-        if (  Parent(i) == it
-           && !ItemToList_AddInteger(&pContext, i))
+        if (!ItemToList_AddInteger(&pContext, aChildren[i]))
         {
             break;
         }
     }
     ItemToList_Final(&pContext);
+    MEMFREE(aChildren);
 }
 
 FUNCTION(fun_objeval)
@@ -1044,15 +1087,13 @@ FUNCTION(fun_localize)
 {
     UNUSED_PARAMETER(nfargs);
 
-    reg_ref **preserve = nullptr;
-    preserve = PushRegisters(MAX_GLOBAL_REGS);
-    save_global_regs(preserve);
+    reg_frame *preserve = nullptr;
+    preserve = save_global_regs();
 
     mux_exec(fargs[0], LBUF_SIZE-1, buff, bufc, executor, caller, enactor,
         eval|EV_FCHECK|EV_STRIP_CURLY|EV_EVAL, cargs, ncargs);
 
     restore_global_regs(preserve);
-    PopRegisters(preserve, MAX_GLOBAL_REGS);
 }
 
 FUNCTION(fun_null)
@@ -1992,13 +2033,8 @@ FUNCTION(fun_mailj)
     if (  0 == nfargs
        || '\0' == fargs[0][0])
     {
-        int cnt = 0;
         MailList ml(executor);
-        for (mp = ml.FirstItem(); !ml.IsEnd(); mp = ml.NextItem())
-        {
-            cnt++;
-        }
-        safe_ltoa(cnt, buff, bufc);
+        safe_ltoa(ml.CountAll(), buff, bufc);
         return;
     }
     else if (1 == nfargs)
@@ -2019,21 +2055,13 @@ FUNCTION(fun_mailj)
                 int rc = 0;
                 int cc = 0;
                 MailList ml(playerask);
-                for (mp = ml.FirstItem(); !ml.IsEnd(); mp = ml.NextItem())
+                for (int folder = 0; folder <= MAX_FOLDERS; folder++)
                 {
-                    if (Read(mp))
-                    {
-                        rc++;
-                    }
-                    else
-                    {
-                        uc++;
-                    }
-
-                    if (Cleared(mp))
-                    {
-                        cc++;
-                    }
+                    int frc, fuc, fcc, fgc;
+                    ml.CountFolder(folder, &frc, &fuc, &fcc, &fgc);
+                    rc += frc;
+                    uc += fuc;
+                    cc += fcc;
                 }
                 safe_tprintf_str(buff, bufc, T("%d %d %d"), rc, uc, cc);
             }
@@ -2185,11 +2213,8 @@ static void hasattr_handler(UTF8 *buff, UTF8 **bufc, dbref executor, UTF8 *fargs
         {
             if (bCheckParent)
             {
-                dbref aowner;
-                int aflags;
-                UTF8 *tbuf = atr_pget(thing, pattr->number, &aowner, &aflags);
-                result = (tbuf[0] != '\0');
-                free_lbuf(tbuf);
+                CAttrView av;
+                result = av.pget(thing, pattr->number);
             }
             else
             {
@@ -303,7 +303,8 @@ FUNCTION(fun_pickrand)
 //
 typedef struct
 {
-    UTF8  *buff;;
+    UTF8  *buff;
+    UTF8  *result;
     dbref executor;
     dbref caller;
     dbref enactor;
@@ -321,17 +322,15 @@ static int u_comp(ucomp_context *pctx, const void *s1, const void *s2)
 
     const UTF8 *elems[2] = { T(s1), T(s2) };
 
-    UTF8 *tbuf = alloc_lbuf("u_comp");
-    mux_strncpy(tbuf, pctx->buff, LBUF_SIZE-1);
-    UTF8 *result = alloc_lbuf("u_comp");
-    UTF8 *bp = result;
-    mux_exec(tbuf, LBUF_SIZE-1, result, &bp, pctx->executor, pctx->caller, pctx->enactor,
-             AttrTrace(pctx->aflags, EV_STRIP_CURLY|EV_FCHECK|EV_EVAL), elems, 2);
+    // The comparator is parsed once and then evaluated from the parse plan
+    // cache, so each comparison costs neither a copy nor a re-scan of it.
+    //
+    UTF8 *bp = pctx->result;
+    mux_exec_cached(pctx->buff, pctx->result, &bp, pctx->executor, pctx->caller,
+             pctx->enactor, AttrTrace(pctx->aflags, EV_STRIP_CURLY|EV_FCHECK|EV_EVAL),
+             elems, 2);
     *bp = '\0';
-    int n = mux_atol(result);
-    free_lbuf(result);
-    free_lbuf(tbuf);
-    return n;
+    return mux_atol(pctx->result);
 }
 
 inline int ucomp_bsearch(ucomp_context* pctx, void* arr[], int sz, void* ndl)
@@ -401,8 +400,8 @@ FUNCTION(fun_sortby)
     }
 
     ucomp_context ctx;
-    ctx.buff = alloc_lbuf("fun_sortby.ctx");
-    mux_strncpy(ctx.buff, atext, LBUF_SIZE-1);
+    ctx.buff = atext;
+    ctx.result = alloc_lbuf("fun_sortby.result");
     ctx.executor = thing;
     ctx.caller   = executor;
     ctx.enactor  = enactor;
@@ -420,7 +419,7 @@ FUNCTION(fun_sortby)
 
     arr2list(ptrs, nptrs, buff, bufc, osep);
     free_lbuf(list);
-    free_lbuf(ctx.buff);
+    free_lbuf(ctx.result);
     free_lbuf(atext);
 }
 
@@ -2240,16 +2239,15 @@ static void real_regmatch(const UTF8 *search, const UTF8 *pattern, UTF8 *registe
     }
 
     const char *errptr;
-    int erroffset;
     // To capture N substrings, you need space for 3(N+1) offsets in the
     // offset vector. We'll allow 2N-1 substrings and possibly ignore some.
     //
     const int ovecsize = 6 * MAX_GLOBAL_REGS;
     int ovec[ovecsize];
 
-    pcre *re = pcre_compile((char *)pattern, PCRE_UTF8|(cis ? PCRE_CASELESS : 0),
-        &errptr, &erroffset, nullptr);
-    if (!re)
+    REGEXP *prx = regexp_compile(pattern, PCRE_UTF8|(cis ? PCRE_CASELESS : 0),
+        &errptr);
+    if (!prx)
     {
         // Matching error.
         //
@@ -2258,8 +2256,7 @@ static void real_regmatch(const UTF8 *search, const UTF8 *pattern, UTF8 *registe
         return;
     }
 
-    int matches = pcre_exec(re, nullptr, (char *)search, static_cast<int>(strlen((char *)search)), 0, 0,
-        ovec, ovecsize);
+    int matches = regexp_exec(prx, search, strlen((char *)search), ovec, ovecsize);
     if (matches == 0)
     {
         // There were too many substring matches. See docs for
@@ -2277,7 +2274,7 @@ static void real_regmatch(const UTF8 *search, const UTF8 *pattern, UTF8 *registe
     //
     if (nfargs != 3)
     {
-        MEMFREE(re);
+        regexp_release(prx);
         return;
     }
 
@@ -2307,11 +2304,11 @@ static void real_regmatch(const UTF8 *search, const UTF8 *pattern, UTF8 *registe
             len = (len > 0 ? len : 0);
 
             size_t n = len;
-            RegAssign(&mudstate.global_regs[curq], n, p);
+            RegAssign(RegGlobalSlot(curq), n, p);
             free_lbuf(p);
         }
     }
-    MEMFREE(re);
+    regexp_release(prx);
 }
 
 FUNCTION(fun_regmatch)
@@ -2353,19 +2350,16 @@ static void real_regrab(__in UTF8 *search, __in const UTF8 *pattern, __in const
     {
         return;
     }
-    pcre *re;
-    pcre_extra *study = nullptr;
     const char *errptr;
-    int erroffset;
     // To capture N substrings, you need space for 3(N+1) offsets in the
     // offset vector. We'll allow 2N-1 substrings and possibly ignore some.
     //
     const int ovecsize = 6 * MAX_GLOBAL_REGS;
     int ovec[ovecsize];
 
-    re = pcre_compile((char *)pattern, PCRE_UTF8|(cis ? PCRE_CASELESS : 0),
-        &errptr, &erroffset, nullptr);
-    if (!re)
+    REGEXP *prx = regexp_compile(pattern, PCRE_UTF8|(cis ? PCRE_CASELESS : 0),
+        &errptr);
+    if (!prx)
     {
         // Matching error.
         //
@@ -2374,18 +2368,13 @@ static void real_regrab(__in UTF8 *search, __in const UTF8 *pattern, __in const
         return;
     }
 
-    if (all)
-    {
-        study = pcre_study(re, 0, &errptr);
-    }
-
     bool first = true;
     UTF8 *s = trim_space_sep(search, sep);
     do
     {
         UTF8 *r = split_token(&s, sep);
         if (  !alarm_clock.alarmed
-           && pcre_exec(re, study, (char *)r, static_cast<int>(strlen((char *)r)), 0, 0, ovec, ovecsize) >= 0)
+           && regexp_exec(prx, r, strlen((char *)r), ovec, ovecsize) >= 0)
         {
             if (first)
             {
@@ -2403,11 +2392,7 @@ static void real_regrab(__in UTF8 *search, __in const UTF8 *pattern, __in const
         }
     } while (s);
 
-    MEMFREE(re);
-    if (study)
-    {
-        MEMFREE(study);
-    }
+    regexp_release(prx);
 }
 
 FUNCTION(fun_regrab)
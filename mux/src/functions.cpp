@@ -2204,25 +2204,21 @@ static void get_handler(UTF8 *buff, UTF8 **bufc, dbref executor, UTF8 *fargs[],
         return;
     }
 
-    dbref aowner;
-    int   aflags;
-    size_t nLen = 0;
-    UTF8 *atr_gotten = atr_pget_LEN(thing, pattr->number, &aowner, &aflags, &nLen);
+    CAttrView av;
+    av.pget(thing, pattr->number);
 
     if (  key == GET_EVAL
        || key == GET_GEVAL)
     {
-        mux_exec(atr_gotten, nLen, buff, bufc, thing, executor, executor,
-            AttrTrace(aflags, EV_FIGNORE|EV_EVAL), nullptr, 0);
+        // mux_exec_cached() evaluates its own copy of the text.
+        //
+        mux_exec_cached(av.text(), buff, bufc, thing, executor, executor,
+            AttrTrace(av.flags(), EV_FIGNORE|EV_EVAL), nullptr, 0);
     }
-    else
+    else if (0 < av.length())
     {
-        if (nLen)
-        {
-            safe_copy_buf(atr_gotten, nLen, buff, bufc);
-        }
+        safe_copy_buf(av.text(), av.length(), buff, bufc);
     }
-    free_lbuf(atr_gotten);
 }
 
 static FUNCTION(fun_get)
@@ -2312,37 +2308,33 @@ static void do_ufun(UTF8 *buff, UTF8 **bufc, dbref executor, dbref caller,
     UNUSED_PARAMETER(cargs);
     UNUSED_PARAMETER(ncargs);
 
-    UTF8 *atext;
+    CAttrView av;
     dbref thing;
-    dbref aowner;
-    int   aflags;
-    if (!parse_and_get_attrib(executor, fargs, &atext, &thing, &aowner, &aflags, buff, bufc))
+    if (!parse_and_view_attrib(executor, fargs, &av, &thing, buff, bufc))
     {
         return;
     }
 
     // If we're evaluating locally, preserve the global registers.
     //
-    reg_ref **preserve = nullptr;
+    reg_frame *preserve = nullptr;
     if (is_local)
     {
-        preserve = PushRegisters(MAX_GLOBAL_REGS);
-        save_global_regs(preserve);
+        preserve = save_global_regs();
     }
 
-    // Evaluate it using the rest of the passed function args.
+    // Evaluate it using the rest of the passed function args.  The view is
+    // good until mux_exec_cached() has taken its own copy of the text.
     //
-    mux_exec(atext, LBUF_SIZE-1, buff, bufc, thing, executor, enactor,
-        AttrTrace(aflags, EV_FCHECK|EV_EVAL),
+    mux_exec_cached(av.text(), buff, bufc, thing, executor, enactor,
+        AttrTrace(av.flags(), EV_FCHECK|EV_EVAL),
         (const UTF8 **)&(fargs[1]), nfargs - 1);
-    free_lbuf(atext);
 
     // If we're evaluating locally, restore the preserved registers.
     //
     if (is_local)
     {
         restore_global_regs(preserve);
-        PopRegisters(preserve, MAX_GLOBAL_REGS);
     }
 }
 
@@ -3976,11 +3968,20 @@ FUNCTION(fun_entrances)
         return;
     }
 
+    // Only exits and rooms whose location is thing and things and players
+    // whose link is thing can be entrances.
+    //
+    int nCandidates;
+    dbref *aCandidates = db_index_collect(thing,
+        IX_BIT(IX_LOCATION) | IX_BIT(IX_LINK), low_bound, high_bound,
+        &nCandidates);
+
     int control_thing = Examinable(executor, thing);
     ITL itl;
     ItemToList_Init(&itl, buff, bufc, '#');
-    for (i = low_bound; i <= high_bound; i++)
+    for (int j = 0; j < nCandidates; j++)
     {
+        i = aCandidates[j];
         if (  control_thing
            || Examinable(executor, i))
         {
@@ -4005,6 +4006,7 @@ FUNCTION(fun_entrances)
         }
     }
     ItemToList_Final(&itl);
+    MEMFREE(aCandidates);
 }
 
 /*
@@ -8074,7 +8076,8 @@ static FUNCTION(fun_terminfo)
     }
 
 #ifdef UNIX_SSL
-    if (d->ssl_session)
+    if (  d->ssl_session
+       || d->ssl_worker)
     {
         safe_str(T(" ssl"), buff, bufc);
     }
@@ -8158,6 +8161,116 @@ typedef struct
 
 } SortContext;
 
+// Numeric, dbref, and floating-point lists are sorted with an LSD radix sort
+// on an unsigned 64-bit image of each key which orders the same way as the
+// key.  A byte which is the same in every key does not need a pass, and for
+// typical lists of small numbers, most of them are skipped.  Unlike qsort(),
+// the result is stable.
+//
+#define RADIX_SIGN  UINT64_C(0x8000000000000000)
+
+static UINT64 radix_key(const q_rec *p, int sort_type)
+{
+    switch (sort_type)
+    {
+    case NUMERIC_LIST:
+        return static_cast<UINT64>(p->u.i64) ^ RADIX_SIGN;
+
+    case DBREF_LIST:
+        return static_cast<UINT64>(static_cast<INT64>(p->u.l)) ^ RADIX_SIGN;
+    }
+
+    // FLOAT_LIST.  Negative numbers have all their bits flipped so that
+    // larger magnitudes come first.  -0 and +0 compare equal.
+    //
+    double d = p->u.d;
+    if (0.0 == d)
+    {
+        d = 0.0;
+    }
+    UINT64 u;
+    memcpy(&u, &d, sizeof(u));
+    return (u & RADIX_SIGN) ? ~u : (u | RADIX_SIGN);
+}
+
+static bool radix_sort(q_rec *a, int n, int sort_type)
+{
+    UINT64 *keys = (UINT64 *)MEMALLOC(2 * n * sizeof(UINT64));
+    q_rec  *b    = (q_rec *)MEMALLOC(n * sizeof(q_rec));
+    if (  nullptr == keys
+       || nullptr == b)
+    {
+        if (keys)
+        {
+            MEMFREE(keys);
+        }
+        if (b)
+        {
+            MEMFREE(b);
+        }
+        return false;
+    }
+    UINT64 *keys2 = keys + n;
+
+    // Count every byte of every key in one pass.
+    //
+    int aCount[sizeof(UINT64)][256];
+    memset(aCount, 0, sizeof(aCount));
+    int i;
+    for (i = 0; i < n; i++)
+    {
+        UINT64 k = radix_key(&a[i], sort_type);
+        keys[i] = k;
+        for (size_t j = 0; j < sizeof(UINT64); j++)
+        {
+            aCount[j][(k >> (8*j)) & 0xFF]++;
+        }
+    }
+
+    q_rec  *src  = a;
+    q_rec  *dst  = b;
+    UINT64 *ksrc = keys;
+    UINT64 *kdst = keys2;
+    for (size_t j = 0; j < sizeof(UINT64); j++)
+    {
+        int *pCount = aCount[j];
+        if (n == pCount[(ksrc[0] >> (8*j)) & 0xFF])
+        {
+            continue;
+        }
+
+        int iPos = 0;
+        for (int k = 0; k < 256; k++)
+        {
+            int c = pCount[k];
+            pCount[k] = iPos;
+            iPos += c;
+        }
+
+        for (i = 0; i < n; i++)
+        {
+            int iDst = pCount[(ksrc[i] >> (8*j)) & 0xFF]++;
+            dst[iDst]  = src[i];
+            kdst[iDst] = ksrc[i];
+        }
+
+        q_rec *t = src;
+        src = dst;
+        dst = t;
+        UINT64 *kt = ksrc;
+        ksrc = kdst;
+        kdst = kt;
+    }
+
+    if (src != a)
+    {
+        memcpy(a, src, n * sizeof(q_rec));
+    }
+    MEMFREE(keys);
+    MEMFREE(b);
+    return true;
+}
+
 static bool do_asort_start(SortContext *psc, int n, UTF8 *s[], int sort_type)
 {
     if (  n < 0
@@ -8197,7 +8310,10 @@ static bool do_asort_start(SortContext *psc, int n, UTF8 *s[], int sort_type)
                 psc->m_ptrs[i].str = s[i];
                 psc->m_ptrs[i].u.i64 = mux_atoi64(s[i]);
             }
-            qsort(psc->m_ptrs, n, sizeof(q_rec), i64_comp);
+            if (!radix_sort(psc->m_ptrs, n, sort_type))
+            {
+                qsort(psc->m_ptrs, n, sizeof(q_rec), i64_comp);
+            }
             break;
 
         case DBREF_LIST:
@@ -8206,7 +8322,10 @@ static bool do_asort_start(SortContext *psc, int n, UTF8 *s[], int sort_type)
                 psc->m_ptrs[i].str = s[i];
                 psc->m_ptrs[i].u.l = dbnum(s[i]);
             }
-            qsort(psc->m_ptrs, n, sizeof(q_rec), l_comp);
+            if (!radix_sort(psc->m_ptrs, n, sort_type))
+            {
+                qsort(psc->m_ptrs, n, sizeof(q_rec), l_comp);
+            }
             break;
 
         case FLOAT_LIST:
@@ -8215,7 +8334,10 @@ static bool do_asort_start(SortContext *psc, int n, UTF8 *s[], int sort_type)
                 psc->m_ptrs[i].str = s[i];
                 psc->m_ptrs[i].u.d = mux_atof(s[i], false);
             }
-            qsort(psc->m_ptrs, n, sizeof(q_rec), f_comp);
+            if (!radix_sort(psc->m_ptrs, n, sort_type))
+            {
+                qsort(psc->m_ptrs, n, sizeof(q_rec), f_comp);
+            }
             break;
 
         case CI_ASCII_LIST:
@@ -9017,7 +9139,7 @@ static FUNCTION(fun_setq)
     else
     {
         size_t n = strlen((char *)fargs[1]);
-        RegAssign(&mudstate.global_regs[regnum], n, fargs[1]);
+        RegAssign(RegGlobalSlot(regnum), n, fargs[1]);
     }
 }
 
@@ -9041,7 +9163,7 @@ static FUNCTION(fun_setr)
     else
     {
         size_t n = strlen((char *)fargs[1]);
-        RegAssign(&mudstate.global_regs[regnum], n, fargs[1]);
+        RegAssign(RegGlobalSlot(regnum), n, fargs[1]);
         safe_copy_buf(fargs[1], n, buff, bufc);
     }
 }
@@ -9063,10 +9185,10 @@ static FUNCTION(fun_r)
     {
         safe_str(T("#-1 INVALID GLOBAL REGISTER"), buff, bufc);
     }
-    else if (mudstate.global_regs[regnum])
+    else if (mudstate.global_regs->regs[regnum])
     {
-        safe_copy_buf(mudstate.global_regs[regnum]->reg_ptr,
-            mudstate.global_regs[regnum]->reg_len, buff, bufc);
+        safe_copy_buf(mudstate.global_regs->regs[regnum]->reg_ptr,
+            mudstate.global_regs->regs[regnum]->reg_len, buff, bufc);
     }
 }
 
@@ -11423,6 +11545,7 @@ void function_add(FUN *fp)
     if (nullptr == hashfindLEN(pCased, nCased, &mudstate.func_htab))
     {
         hashaddLEN(pCased, nCased, fp, &mudstate.func_htab);
+        parse_cache_flush_functions();
     }
 }
 
@@ -11431,6 +11554,7 @@ void function_remove(FUN *fp)
     size_t nCased;
     UTF8 *pCased = mux_strupr(fp->name, nCased);
     hashdeleteLEN(pCased, nCased, &mudstate.func_htab);
+    parse_cache_flush_functions();
 }
 
 void functions_add(FUN funlist[])
@@ -11590,6 +11714,7 @@ void do_function
                 }
             }
             hashdeleteLEN(pName, nLen, &mudstate.ufunc_htab);
+            parse_cache_flush_functions();
             delete ufp;
             notify_quiet(executor, tprintf(T("Function %s deleted."), pName));
         }
@@ -11668,6 +11793,7 @@ void do_function
             ufp2->next = ufp;
         }
         hashaddLEN(pName, nLen, ufp, &mudstate.ufunc_htab);
+        parse_cache_flush_functions();
     }
     ufp->obj = obj;
     ufp->atr = pattr->number;
@@ -38,11 +38,13 @@ void do_dump(dbref executor, dbref caller, dbref enactor, int eval, int key)
 
 #if defined(HAVE_WORKING_FORK)
     if (mudstate.dumping)
+#else // HAVE_WORKING_FORK
+    if (db_checkpoint_active())
+#endif // HAVE_WORKING_FORK
     {
         notify(executor, T("Dumping in progress. Try again later."));
         return;
     }
-#endif
     notify(executor, T("Dumping..."));
     fork_and_dump(key);
 }
@@ -71,6 +73,179 @@ void report(void)
     }
 }
 
+/* ----------------------------------------------------------------------
+ * Compiled regular expression cache.
+ *
+ * Patterns are compiled and studied once, and kept in a bounded LRU list
+ * hashed by the CRC32 of the pattern and compile options.  An entry is
+ * referenced by the cache and by each caller which is using it, so eviction
+ * does not free an expression which is still being executed.
+ */
+
+#define REGEXP_CACHE_SIZE   256
+
+struct regexp_entry
+{
+    struct regexp_entry *prev;      // Next more recently used.
+    struct regexp_entry *next;      // Next less recently used.
+    UINT32      key[2];             // CRC32 of pattern and options.
+    int         refcount;
+    pcre       *re;
+    pcre_extra *study;
+    size_t      nPattern;
+    UTF8        pattern[1];
+};
+
+static REGEXP *regexp_head = nullptr;
+static REGEXP *regexp_tail = nullptr;
+static int     regexp_count = 0;
+
+static void regexp_unlink(REGEXP *prx)
+{
+    if (nullptr != prx->prev)
+    {
+        prx->prev->next = prx->next;
+    }
+    else
+    {
+        regexp_head = prx->next;
+    }
+
+    if (nullptr != prx->next)
+    {
+        prx->next->prev = prx->prev;
+    }
+    else
+    {
+        regexp_tail = prx->prev;
+    }
+    prx->prev = nullptr;
+    prx->next = nullptr;
+}
+
+static void regexp_push(REGEXP *prx)
+{
+    prx->prev = nullptr;
+    prx->next = regexp_head;
+    if (nullptr != regexp_head)
+    {
+        regexp_head->prev = prx;
+    }
+    else
+    {
+        regexp_tail = prx;
+    }
+    regexp_head = prx;
+}
+
+/*! \brief Releases a reference to a compiled regular expression.
+ *
+ * \param prx   Expression returned by regexp_compile().
+ * \return      None.
+ */
+
+void regexp_release(REGEXP *prx)
+{
+    if (0 == --prx->refcount)
+    {
+        MEMFREE(prx->re);
+        if (nullptr != prx->study)
+        {
+            MEMFREE(prx->study);
+        }
+        MEMFREE(prx);
+    }
+}
+
+static void regexp_evict(REGEXP *prx)
+{
+    hashdeleteLEN(prx->key, sizeof(prx->key), &mudstate.regexp_htab);
+    regexp_unlink(prx);
+    regexp_count--;
+    regexp_release(prx);
+}
+
+/*! \brief Finds or compiles a regular expression.
+ *
+ * The caller must pass the result to regexp_release() when it is done with
+ * it.
+ *
+ * \param pattern  Regular expression.
+ * \param options  PCRE compile options.
+ * \param perrptr  Receives the PCRE error message on failure.
+ * \return         Compiled expression or nullptr if the pattern is invalid.
+ */
+
+REGEXP *regexp_compile(const UTF8 *pattern, int options, const char **perrptr)
+{
+    size_t nPattern = strlen((const char *)pattern);
+    UINT32 key[2];
+    key[0] = CRC32_ProcessBuffer(0, pattern, nPattern);
+    key[1] = static_cast<UINT32>(options);
+
+    REGEXP *prx = (REGEXP *)hashfindLEN(key, sizeof(key), &mudstate.regexp_htab);
+    if (nullptr != prx)
+    {
+        if (  prx->nPattern == nPattern
+           && memcmp(prx->pattern, pattern, nPattern) == 0)
+        {
+            if (regexp_head != prx)
+            {
+                regexp_unlink(prx);
+                regexp_push(prx);
+            }
+            prx->refcount++;
+            return prx;
+        }
+
+        // A different pattern with the same CRC32.  Replace it.
+        //
+        regexp_evict(prx);
+    }
+
+    int erroffset;
+    pcre *re = pcre_compile((char *)pattern, options, perrptr, &erroffset, nullptr);
+    if (nullptr == re)
+    {
+        return nullptr;
+    }
+
+    prx = (REGEXP *)MEMALLOC(sizeof(REGEXP) + nPattern);
+    ISOUTOFMEMORY(prx);
+    prx->prev = nullptr;
+    prx->next = nullptr;
+    prx->key[0] = key[0];
+    prx->key[1] = key[1];
+    prx->refcount = 1;
+    prx->re = re;
+    const char *errptr;
+    prx->study = pcre_study(re, 0, &errptr);
+    prx->nPattern = nPattern;
+    memcpy(prx->pattern, pattern, nPattern + 1);
+
+    if (!hashaddLEN(prx->key, sizeof(prx->key), prx, &mudstate.regexp_htab))
+    {
+        // Not cached.
+        //
+        return prx;
+    }
+
+    prx->refcount++;
+    regexp_push(prx);
+    regexp_count++;
+    if (REGEXP_CACHE_SIZE < regexp_count)
+    {
+        regexp_evict(regexp_tail);
+    }
+    return prx;
+}
+
+int regexp_exec(REGEXP *prx, const UTF8 *subject, size_t nSubject, int *ovec, int ovecsize)
+{
+    return pcre_exec(prx->re, prx->study, (const char *)subject,
+        static_cast<int>(nSubject), 0, 0, ovec, ovecsize);
+}
+
 /* ----------------------------------------------------------------------
  * regexp_match: Load a regular expression match and insert it into
  * registers.
@@ -88,17 +263,15 @@ bool regexp_match
     int matches;
     int i;
     const char *errptr;
-    int erroffset;
 
     /*
-     * Load the regexp pattern. This allocates memory which must be
-     * later freed. A free() of the regexp does free all structures
-     * under it.
+     * Load the regexp pattern. The compiled pattern comes from the regexp
+     * cache and must be released when we are done with it.
      */
 
-    pcre *re;
+    REGEXP *prx;
     if (  alarm_clock.alarmed
-       || (re = pcre_compile((char *)pattern, PCRE_UTF8|case_opt, &errptr, &erroffset, nullptr)) == nullptr)
+       || (prx = regexp_compile(pattern, PCRE_UTF8|case_opt, &errptr)) == nullptr)
     {
         /*
          * This is a matching error. We have an error message in
@@ -118,11 +291,11 @@ bool regexp_match
      * Now we try to match the pattern. The relevant fields will
      * automatically be filled in by this.
      */
-    matches = pcre_exec(re, nullptr, (char *)str, static_cast<int>(strlen((char *)str)), 0, 0, ovec, ovecsize);
+    matches = regexp_exec(prx, str, strlen((char *)str), ovec, ovecsize);
     if (matches < 0)
     {
         delete [] ovec;
-        MEMFREE(re);
+        regexp_release(prx);
         return false;
     }
 
@@ -153,10 +326,358 @@ bool regexp_match
     }
 
     delete [] ovec;
-    MEMFREE(re);
+    regexp_release(prx);
     return true;
 }
 
+/* ----------------------------------------------------------------------
+ * Compiled $-command and ^-listen tables.
+ *
+ * The first time an object is matched against, its attributes are read once
+ * and its $-commands and ^-listens are split into pattern and action.  For a
+ * wildcard pattern, the literal text before the first wildcard is kept
+ * folded to lowercase.  Patterns are chained by the first byte of that text,
+ * so matching a command only looks at patterns which could possibly match.
+ * The table is thrown away whenever an attribute on the object changes.
+ *
+ * Tables are kept in an LRU list, and the least recently used tables are
+ * thrown away when the tables together hold more than CMDTAB_CACHE_SIZE
+ * bytes.
+ */
+
+#define CMDTAB_BUCKETS  32
+#define CMDTAB_ALWAYS   (2*CMDTAB_BUCKETS)
+#define CMDTAB_CHAINS   (2*CMDTAB_BUCKETS+1)
+#define CMDTAB_CACHE_SIZE (1024*1024)
+
+typedef struct
+{
+    int    atr;
+    int    aflags;
+} CMDATTR;
+
+typedef struct
+{
+    int    atr;
+    int    aflags;
+    UTF8  *pattern;     // Pattern without leadin character.
+    UTF8  *action;      // Action list after the ':'.
+    UTF8  *prefix;      // Literal prefix of a wildcard pattern, folded.
+    size_t nPrefix;
+    int    iNext;       // Next entry in the same chain.
+} CMDPAT;
+
+typedef struct cmdtab
+{
+    struct cmdtab *prev;    // Next more recently used.
+    struct cmdtab *next;    // Next less recently used.
+    dbref    thing;
+    size_t   nBytes;    // Memory held by this table.
+
+    int      nAttrs;
+    CMDATTR *aAttrs;    // Every attribute on the object, in order.
+    int      nEntries;
+    CMDPAT  *aEntries;
+
+    // Chains of entries in attribute order for each type.  The first half of
+    // the buckets are for parsed patterns, the second half for AF_NOPARSE
+    // patterns, and the last chain is for patterns with no literal prefix.
+    //
+    int      aChain[2][CMDTAB_CHAINS];
+} CMDTAB;
+
+static inline int cmdtab_type(UTF8 type)
+{
+    return (AMATCH_CMD == type) ? 0 : 1;
+}
+
+static inline int cmdtab_bucket(const UTF8 *str)
+{
+    return mux_tolower_ascii(str[0]) & (CMDTAB_BUCKETS-1);
+}
+
+static CMDTAB *cmdtab_head = nullptr;
+static CMDTAB *cmdtab_tail = nullptr;
+static size_t  cmdtab_bytes = 0;
+
+static void cmdtab_unlink(CMDTAB *pct)
+{
+    if (nullptr != pct->prev)
+    {
+        pct->prev->next = pct->next;
+    }
+    else
+    {
+        cmdtab_head = pct->next;
+    }
+
+    if (nullptr != pct->next)
+    {
+        pct->next->prev = pct->prev;
+    }
+    else
+    {
+        cmdtab_tail = pct->prev;
+    }
+    pct->prev = nullptr;
+    pct->next = nullptr;
+}
+
+static void cmdtab_push(CMDTAB *pct)
+{
+    pct->prev = nullptr;
+    pct->next = cmdtab_head;
+    if (nullptr != cmdtab_head)
+    {
+        cmdtab_head->prev = pct;
+    }
+    else
+    {
+        cmdtab_tail = pct;
+    }
+    cmdtab_head = pct;
+}
+
+static void cmdtab_free(CMDTAB *pct)
+{
+    for (int i = 0; i < pct->nEntries; i++)
+    {
+        MEMFREE(pct->aEntries[i].pattern);
+    }
+    if (pct->aEntries)
+    {
+        MEMFREE(pct->aEntries);
+    }
+    if (pct->aAttrs)
+    {
+        MEMFREE(pct->aAttrs);
+    }
+    MEMFREE(pct);
+}
+
+void cmdtab_clr(dbref thing)
+{
+    CMDTAB *pct = (CMDTAB *)hashfindLEN(&thing, sizeof(thing), &mudstate.cmdtab_htab);
+    if (pct)
+    {
+        hashdeleteLEN(&thing, sizeof(thing), &mudstate.cmdtab_htab);
+        cmdtab_unlink(pct);
+        cmdtab_bytes -= pct->nBytes;
+        cmdtab_free(pct);
+    }
+}
+
+static CMDTAB *cmdtab_compile(dbref thing)
+{
+    CMDTAB *pct = (CMDTAB *)MEMALLOC(sizeof(CMDTAB));
+    ISOUTOFMEMORY(pct);
+    memset(pct, 0, sizeof(CMDTAB));
+    pct->thing = thing;
+
+    int aTail[2][CMDTAB_CHAINS];
+    for (int t = 0; t < 2; t++)
+    {
+        for (int i = 0; i < CMDTAB_CHAINS; i++)
+        {
+            pct->aChain[t][i] = -1;
+            aTail[t][i] = -1;
+        }
+    }
+
+    bool bFoundCommands = false;
+    bool bFoundListens  = false;
+    int nAttrsAlloc = 0;
+    int nEntriesAlloc = 0;
+
+    atr_push();
+    CAttrView av;
+    unsigned char *as;
+    for (int atr = atr_head(thing, &as); atr; atr = atr_next(&as))
+    {
+        av.get(thing, atr);
+        const UTF8 *buff = av.text();
+        int aflags = av.flags();
+
+        if (nAttrsAlloc <= pct->nAttrs)
+        {
+            nAttrsAlloc = (0 == nAttrsAlloc) ? 16 : 2*nAttrsAlloc;
+            CMDATTR *aAttrs = (CMDATTR *)MEMALLOC(nAttrsAlloc*sizeof(CMDATTR));
+            ISOUTOFMEMORY(aAttrs);
+            if (pct->aAttrs)
+            {
+                memcpy(aAttrs, pct->aAttrs, pct->nAttrs*sizeof(CMDATTR));
+                MEMFREE(pct->aAttrs);
+            }
+            pct->aAttrs = aAttrs;
+        }
+        pct->aAttrs[pct->nAttrs].atr = atr;
+        pct->aAttrs[pct->nAttrs].aflags = aflags;
+        pct->nAttrs++;
+
+        if (  (aflags & AF_NOPROG)
+           || (  AMATCH_CMD    != buff[0]
+              && AMATCH_LISTEN != buff[0]))
+        {
+            continue;
+        }
+
+        const UTF8 *s = (const UTF8 *)strchr((const char *)buff+1, ':');
+        if (nullptr == s)
+        {
+            continue;
+        }
+
+        // The attribute's NOPROG flag is checked again at match time since it
+        // can change without the object changing.
+        //
+        ATTR *ap = atr_num(atr);
+        if (  ap
+           && 0 == (ap->flags & AF_NOPROG))
+        {
+            if (AMATCH_CMD == buff[0])
+            {
+                bFoundCommands = true;
+            }
+            else
+            {
+                bFoundListens = true;
+            }
+        }
+
+        if (nEntriesAlloc <= pct->nEntries)
+        {
+            nEntriesAlloc = (0 == nEntriesAlloc) ? 8 : 2*nEntriesAlloc;
+            CMDPAT *aEntries = (CMDPAT *)MEMALLOC(nEntriesAlloc*sizeof(CMDPAT));
+            ISOUTOFMEMORY(aEntries);
+            if (pct->aEntries)
+            {
+                memcpy(aEntries, pct->aEntries, pct->nEntries*sizeof(CMDPAT));
+                MEMFREE(pct->aEntries);
+            }
+            pct->aEntries = aEntries;
+        }
+
+        // Pattern, action, and prefix share one allocation.
+        //
+        size_t nPattern = s - (buff + 1);
+        size_t nAction  = strlen((char *)s + 1);
+        UTF8 *p = (UTF8 *)MEMALLOC(2*nPattern + nAction + 3);
+        ISOUTOFMEMORY(p);
+        pct->nBytes += 2*nPattern + nAction + 3;
+
+        int iEntry = pct->nEntries++;
+        CMDPAT *pcp = &pct->aEntries[iEntry];
+        pcp->atr = atr;
+        pcp->aflags = aflags;
+        pcp->pattern = p;
+        memcpy(p, buff + 1, nPattern);
+        p[nPattern] = '\0';
+        pcp->action = p + nPattern + 1;
+        memcpy(pcp->action, s + 1, nAction + 1);
+        pcp->prefix = pcp->action + nAction + 1;
+        pcp->nPrefix = 0;
+        pcp->iNext = -1;
+
+        if (0 == (aflags & AF_REGEXP))
+        {
+            // This follows the literal matching at the front of wild().
+            //
+            const UTF8 *q = pcp->pattern;
+            while (  '\0' != *q
+                  && '*' != *q
+                  && '?' != *q)
+            {
+                if (  '\\' == *q
+                   && '\0' == *++q)
+                {
+                    break;
+                }
+                pcp->prefix[pcp->nPrefix++] = mux_tolower_ascii(*q++);
+            }
+        }
+        pcp->prefix[pcp->nPrefix] = '\0';
+
+        int t = cmdtab_type(buff[0]);
+        int iChain = CMDTAB_ALWAYS;
+        if (0 < pcp->nPrefix)
+        {
+            iChain = cmdtab_bucket(pcp->prefix);
+            if (aflags & AF_NOPARSE)
+            {
+                iChain += CMDTAB_BUCKETS;
+            }
+        }
+        if (aTail[t][iChain] < 0)
+        {
+            pct->aChain[t][iChain] = iEntry;
+        }
+        else
+        {
+            pct->aEntries[aTail[t][iChain]].iNext = iEntry;
+        }
+        aTail[t][iChain] = iEntry;
+    }
+    atr_pop();
+    pct->nBytes += sizeof(CMDTAB)
+                 + nAttrsAlloc*sizeof(CMDATTR)
+                 + nEntriesAlloc*sizeof(CMDPAT);
+
+    if (bFoundCommands)
+    {
+        mudstate.bfNoCommands.Clear(thing);
+        mudstate.bfCommands.Set(thing);
+    }
+    else
+    {
+        mudstate.bfCommands.Clear(thing);
+        mudstate.bfNoCommands.Set(thing);
+    }
+
+    if (bFoundListens)
+    {
+        mudstate.bfNoListens.Clear(thing);
+        mudstate.bfListens.Set(thing);
+    }
+    else
+    {
+        mudstate.bfListens.Clear(thing);
+        mudstate.bfNoListens.Set(thing);
+    }
+    return pct;
+}
+
+static CMDTAB *cmdtab_get(dbref thing)
+{
+    CMDTAB *pct = (CMDTAB *)hashfindLEN(&thing, sizeof(thing), &mudstate.cmdtab_htab);
+    if (nullptr != pct)
+    {
+        if (cmdtab_head != pct)
+        {
+            cmdtab_unlink(pct);
+            cmdtab_push(pct);
+        }
+        return pct;
+    }
+
+    pct = cmdtab_compile(thing);
+    if (!hashaddLEN(&thing, sizeof(thing), pct, &mudstate.cmdtab_htab))
+    {
+        cmdtab_free(pct);
+        return nullptr;
+    }
+    cmdtab_push(pct);
+    cmdtab_bytes += pct->nBytes;
+
+    // The new table is at the head, so it is never evicted here.
+    //
+    while (  CMDTAB_CACHE_SIZE < cmdtab_bytes
+          && cmdtab_tail != pct)
+    {
+        cmdtab_clr(cmdtab_tail->thing);
+    }
+    return pct;
+}
+
 /* ----------------------------------------------------------------------
  * atr_match: Check attribute list for wild card matches and queue them.
  */
@@ -214,139 +735,126 @@ static int atr_match1
         return match;
     }
 
-    bool bFoundCommands = false;
-    bool bFoundListens  = false;
-
-    atr_push();
-    unsigned char *as;
-    for (int atr = atr_head(parent, &as); atr; atr = atr_next(&as))
+    CMDTAB *pct = cmdtab_get(parent);
+    if (nullptr == pct)
     {
-        ATTR *ap = atr_num(atr);
+        return match;
+    }
 
-        // Never check NOPROG attributes.
-        //
-        if (  !ap
-           || (ap->flags & AF_NOPROG))
+    // Only the chains which could match are visited.  They are merged so
+    // that matches are queued in attribute order.
+    //
+    const int t = cmdtab_type(type);
+    int iParse   = pct->aChain[t][cmdtab_bucket(str)];
+    int iNoParse = pct->aChain[t][CMDTAB_BUCKETS + cmdtab_bucket(raw_str)];
+    int iAlways  = pct->aChain[t][CMDTAB_ALWAYS];
+    for (;;)
+    {
+        int iEntry = iParse;
+        if (  iEntry < 0
+           || (  0 <= iNoParse
+              && iNoParse < iEntry))
         {
-            continue;
+            iEntry = iNoParse;
         }
-
-        // We need to grab the attribute even before we know whether we'll use
-        // it or not in order to maintain cached knowledge about ^-Commands
-        // and $-Commands.
-        //
-        dbref aowner;
-        int   aflags;
-        UTF8 buff[LBUF_SIZE];
-        atr_get_str(buff, parent, atr, &aowner, &aflags);
-
-        UTF8 *s = nullptr;
-        if (  0 == (aflags & AF_NOPROG)
-           &&  (  AMATCH_CMD    == buff[0]
-               || AMATCH_LISTEN == buff[0]))
+        if (  iEntry < 0
+           || (  0 <= iAlways
+              && iAlways < iEntry))
         {
-            s = (UTF8 *)strchr((char *)buff+1, ':');
-            if (s)
-            {
-                if (AMATCH_CMD == buff[0])
-                {
-                    bFoundCommands = true;
-                }
-                else
-                {
-                    bFoundListens = true;
-                }
-            }
+            iEntry = iAlways;
         }
-
-        // If we aren't the bottom level, check if we saw this attr
-        // before. Also exclude it if the attribute type is PRIVATE.
-        //
-        if (  check_exclude
-           && (  (ap->flags & AF_PRIVATE)
-              || (aflags & AF_PRIVATE)
-              || hashfindLEN(&(ap->number), sizeof(ap->number), &mudstate.parent_htab)))
+        if (iEntry < 0)
         {
-            continue;
+            break;
         }
 
-        // If we aren't the top level, remember this attr so we
-        // exclude it from now on.
-        //
-        if (hash_insert)
+        CMDPAT *pcp = &pct->aEntries[iEntry];
+        if (iEntry == iParse)
         {
-            hashaddLEN(&(ap->number), sizeof(ap->number), &atr, &mudstate.parent_htab);
+            iParse = pcp->iNext;
         }
-
-        if (aflags & AF_NOPROG)
+        else if (iEntry == iNoParse)
         {
-            continue;
+            iNoParse = pcp->iNext;
+        }
+        else
+        {
+            iAlways = pcp->iNext;
         }
 
-        // Check for the leadin character after excluding the attrib.
-        // This lets non-command attribs on the child block commands
-        // on the parent.
+        // Never check NOPROG attributes.  If we aren't the bottom level,
+        // check if we saw this attr before. Also exclude it if the attribute
+        // type is PRIVATE.
         //
-        if (buff[0] != type)
+        ATTR *ap = atr_num(pcp->atr);
+        if (  !ap
+           || (ap->flags & AF_NOPROG)
+           || (  check_exclude
+              && (  (ap->flags & AF_PRIVATE)
+                 || (pcp->aflags & AF_PRIVATE)
+                 || hashfindLEN(&(ap->number), sizeof(ap->number), &mudstate.parent_htab))))
         {
             continue;
         }
 
-        // Was there a ':'?
-        //
-        if (!s)
+        UTF8 *data = (pcp->aflags & AF_NOPARSE) ? raw_str : str;
+        size_t i;
+        for (i = 0; i < pcp->nPrefix; i++)
+        {
+            if (mux_tolower_ascii(data[i]) != pcp->prefix[i])
+            {
+                break;
+            }
+        }
+        if (i < pcp->nPrefix)
         {
             continue;
         }
-        *s++ = '\0';
 
         UTF8 *args[NUM_ENV_VARS];
-        if (  (  0 != (aflags & AF_REGEXP)
-            && regexp_match(buff + 1, (aflags & AF_NOPARSE) ? raw_str : str,
-                ((aflags & AF_CASE) ? 0 : PCRE_CASELESS), args, NUM_ENV_VARS))
-           || (  0 == (aflags & AF_REGEXP)
-              && wild(buff + 1, (aflags & AF_NOPARSE) ? raw_str : str,
-                args, NUM_ENV_VARS)))
+        if (  (  0 != (pcp->aflags & AF_REGEXP)
+            && regexp_match(pcp->pattern, data,
+                ((pcp->aflags & AF_CASE) ? 0 : PCRE_CASELESS), args, NUM_ENV_VARS))
+           || (  0 == (pcp->aflags & AF_REGEXP)
+              && wild(pcp->pattern, data, args, NUM_ENV_VARS)))
         {
             match = 1;
             CLinearTimeAbsolute lta;
-            wait_que(thing, player, player, AttrTrace(aflags, 0), false, lta,
+            wait_que(thing, player, player, AttrTrace(pcp->aflags, 0), false, lta,
                 NOTHING, 0,
-                s,
+                pcp->action,
                 NUM_ENV_VARS, (const UTF8 **)args,
                 mudstate.global_regs);
 
-            for (int i = 0; i < NUM_ENV_VARS; i++)
+            for (int j = 0; j < NUM_ENV_VARS; j++)
             {
-                if (args[i])
+                if (args[j])
                 {
-                    free_lbuf(args[i]);
+                    free_lbuf(args[j]);
                 }
             }
         }
     }
-    atr_pop();
-
-    if (bFoundCommands)
-    {
-        mudstate.bfNoCommands.Clear(parent);
-        mudstate.bfCommands.Set(parent);
-    }
-    else
-    {
-        mudstate.bfCommands.Clear(parent);
-        mudstate.bfNoCommands.Set(parent);
-    }
 
-    if (bFoundListens)
-    {
-        mudstate.bfNoListens.Clear(parent);
-        mudstate.bfListens.Set(parent);
-    }
-    else
+    // If we aren't the top level, remember this object's attrs so we exclude
+    // them from now on.  This lets non-command attribs on the child block
+    // commands on the parent.
+    //
+    if (hash_insert)
     {
-        mudstate.bfListens.Clear(parent);
-        mudstate.bfNoListens.Set(parent);
+        for (int i = 0; i < pct->nAttrs; i++)
+        {
+            ATTR *ap = atr_num(pct->aAttrs[i].atr);
+            if (  ap
+               && 0 == (ap->flags & AF_NOPROG)
+               && (  !check_exclude
+                  || (  0 == (ap->flags & AF_PRIVATE)
+                     && 0 == (pct->aAttrs[i].aflags & AF_PRIVATE)
+                     && !hashfindLEN(&(ap->number), sizeof(ap->number), &mudstate.parent_htab))))
+            {
+                hashaddLEN(&(ap->number), sizeof(ap->number), &pct->aAttrs[i].atr, &mudstate.parent_htab);
+            }
+        }
     }
     return match;
 }
@@ -435,9 +943,8 @@ static bool check_filter(dbref object, dbref player, int filter, const UTF8 *msg
         return true;
     }
 
-    reg_ref **preserve = nullptr;
-    preserve = PushRegisters(MAX_GLOBAL_REGS);
-    save_global_regs(preserve);
+    reg_frame *preserve = nullptr;
+    preserve = save_global_regs();
 
     UTF8 *nbuf = alloc_lbuf("check_filter");
     UTF8 *dp = nbuf;
@@ -449,7 +956,6 @@ static bool check_filter(dbref object, dbref player, int filter, const UTF8 *msg
     free_lbuf(buf);
 
     restore_global_regs(preserve);
-    PopRegisters(preserve, MAX_GLOBAL_REGS);
     preserve = nullptr;
 
     if (!(aflags & AF_REGEXP))
@@ -471,24 +977,21 @@ static bool check_filter(dbref object, dbref player, int filter, const UTF8 *msg
         int case_opt = (aflags & AF_CASE) ? 0 : PCRE_CASELESS;
         do
         {
-            int erroffset;
             const char *errptr;
             UTF8 *cp = parse_to(&dp, ',', EV_STRIP_CURLY);
-            pcre *re;
+            REGEXP *prx;
             if (  !alarm_clock.alarmed
-               && (re = pcre_compile((char *)cp, PCRE_UTF8|case_opt, &errptr, &erroffset, nullptr)) != nullptr)
+               && (prx = regexp_compile(cp, PCRE_UTF8|case_opt, &errptr)) != nullptr)
             {
                 const int ovecsize = 33;
                 int ovec[ovecsize];
-                int matches = pcre_exec(re, nullptr, (char *)msg, static_cast<int>(strlen((char *)msg)), 0, 0,
-                    ovec, ovecsize);
+                int matches = regexp_exec(prx, msg, strlen((char *)msg), ovec, ovecsize);
+                regexp_release(prx);
                 if (0 <= matches)
                 {
-                    MEMFREE(re);
                     free_lbuf(nbuf);
                     return false;
                 }
-                MEMFREE(re);
             }
         } while (dp != nullptr);
     }
@@ -526,9 +1029,8 @@ static UTF8 *make_prefix(dbref object, dbref player, int prefix, const UTF8 *dfl
     }
     else
     {
-        reg_ref **preserve = nullptr;
-        preserve = PushRegisters(MAX_GLOBAL_REGS);
-        save_global_regs(preserve);
+        reg_frame *preserve = nullptr;
+        preserve = save_global_regs();
 
         nbuf = cp = alloc_lbuf("add_prefix");
         mux_exec(buf, LBUF_SIZE-1, nbuf, &cp, object, player, player,
@@ -537,7 +1039,6 @@ static UTF8 *make_prefix(dbref object, dbref player, int prefix, const UTF8 *dfl
         free_lbuf(buf);
 
         restore_global_regs(preserve);
-        PopRegisters(preserve, MAX_GLOBAL_REGS);
 
         buf = nbuf;
     }
@@ -591,21 +1092,79 @@ bool html_escape(const UTF8 *src, UTF8 *dest, UTF8 **destp)
             safe_str(T("&quot;"), dest, destp);
             break;
 
-        default:
-            safe_chr(*msg_orig, dest, destp);
-            break;
-        }
+        default:
+            safe_chr(*msg_orig, dest, destp);
+            break;
+        }
+
+        // For <>&\, this may cause an extra loop around before it figures out that we are
+        // out of buffer, but no harm is done in this, and the common case is a single character.
+        //
+        if (p == *destp)
+        {
+            ret = true;
+        }
+    }
+    **destp = 0;
+    return ret;
+}
+
+/*! \brief Determine whether notify_check() would do nothing more than send
+ *         the message unchanged to the target's own connections.
+ *
+ * When this is true, a caller with the same message for many targets may
+ * render it once and share it with raw_notify_shared() instead.  Anything
+ * which would prefix, forward, match, or re-encode the message for this
+ * target makes it false.
+ *
+ * \param target    Object to be notified.
+ * \param sender    Object sending the message.
+ * \param key       MSG_* flags which would be passed to notify_check().
+ * \return          true if the message may be sent directly.
+ */
+
+bool notify_is_direct(dbref target, dbref sender, int key)
+{
+    if (  !Good_obj(target)
+       || !isPlayer(target)
+       || 0 == (key & MSG_ME)
+       || 0 != (key & (MSG_HTML|MSG_INV|MSG_NBR|MSG_NBR_A|MSG_NBR_EXITS
+                      |MSG_NBR_EXITS_A|MSG_LOC|MSG_LOC_A))
+       || mudconf.ntfy_nest_lim <= mudstate.ntfy_nest_lev + 1)
+    {
+        return false;
+    }
+
+#ifdef WOD_REALMS
+    if (0 == (key & MSG_OOC))
+    {
+        return false;
+    }
+#endif // WOD_REALMS
+
+    if (  Nospoof(target)
+       && target != sender
+       && target != mudstate.curr_enactor
+       && target != mudstate.curr_executor)
+    {
+        return false;
+    }
 
-        // For <>&\, this may cause an extra loop around before it figures out that we are
-        // out of buffer, but no harm is done in this, and the common case is a single character.
-        //
-        if (p == *destp)
-        {
-            ret = true;
-        }
+    if (  Html(target)
+       || Audible(target)
+       || Exits(target) != NOTHING)
+    {
+        return false;
     }
-    **destp = 0;
-    return ret;
+
+    if (  mudconf.player_listen
+       && !Halted(target)
+       && (  H_Listen(target)
+          || Monitor(target)))
+    {
+        return false;
+    }
+    return true;
 }
 
 void notify_check(dbref target, dbref sender, const mux_string &msg, int key)
@@ -1165,10 +1724,6 @@ static void report_timecheck
             {
                 raw_notify(player, tprintf(T("#%d\t%ld"), thing, used_msecs));
             }
-            if (yes_clear)
-            {
-                ltd.Set100ns(0);
-            }
         }
     }
 
@@ -1181,6 +1736,15 @@ static void report_timecheck
             tprintf(T("Counted %d objects using %ld msecs over %d seconds."),
             obj_counted, lTotal, lPeriod));
     }
+    report_queue_shares(player, yes_screen, yes_log, yes_clear);
+
+    if (yes_clear)
+    {
+        DO_WHOLE_DB(thing)
+        {
+            db[thing].cpu_time_used.Set100ns(0);
+        }
+    }
 
     if (yes_log)
     {
@@ -1369,166 +1933,144 @@ static DUMP_PROCEDURE DumpProcedures[NUM_DUMP_TYPES] =
 #define POPEN_WRITE_OP "w"
 #endif // UNIX_FILES
 
-void dump_database_internal(int dump_type)
+// The output file for one dump type.
+//
+typedef struct
 {
-    UTF8 tmpfile[SIZEOF_PATHNAME+32];
-    UTF8 outfn[SIZEOF_PATHNAME+32];
-    UTF8 prevfile[SIZEOF_PATHNAME+32];
     FILE *f;
-
-    if (  dump_type < 0
-       || NUM_DUMP_TYPES <= dump_type)
-    {
-        return;
-    }
-
-    bool bPotentialConflicts = false;
-#if defined(HAVE_WORKING_FORK)
-    // If we are already dumping for some reason, and suddenly get a type 1 or
-    // type 4 dump, basically don't touch mail and comsys files. The other
-    // dump will take care of them as well as can be expected for now, and if
-    // we try to, we'll just step on them.
-    //
-    if (  mudstate.dumping
-       && (  dump_type == DUMP_I_PANIC
-          || dump_type == DUMP_I_SIGNAL))
-    {
-        bPotentialConflicts = true;
-    }
-#endif // HAVE_WORKING_FORK
-
-    // Call the local dump function only if another dump is not already
-    // in progress.
-    //
-    local_dump_database(dump_type);
-    ServerEventsSinkNode *p = g_pServerEventsSinkListHead;
-    while (nullptr != p)
+    bool  bPipe;
+    int   iFormat;
+    int   fType;
+    UTF8  tmpfile[SIZEOF_PATHNAME+32];
+    UTF8  outfn[SIZEOF_PATHNAME+32];
+    UTF8  prevfile[SIZEOF_PATHNAME+32];
+} DUMP_OUTPUT;
+
+static bool dump_output_open(int dump_type, DUMP_OUTPUT *pdo)
+{
+    pdo->f = nullptr;
+    pdo->bPipe = false;
+    pdo->iFormat = F_MUX;
+    if (  mudconf.binary_database
+       && (  DUMP_I_NORMAL == dump_type
+          || DUMP_I_RESTART == dump_type))
     {
-        p->pSink->dump_database(dump_type);
-        p = p->pNext;
+        pdo->iFormat = F_MUXBIN;
     }
+    pdo->tmpfile[0] = '\0';
+    pdo->prevfile[0] = '\0';
 
     if (0 < dump_type)
     {
         DUMP_PROCEDURE *dp = &DumpProcedures[dump_type];
         bool bOpen;
 
-        mux_sprintf(outfn, sizeof(outfn), T("%s%s"), *(dp->ppszOutputBase), dp->szOutputSuffix);
+        pdo->fType = dp->fType;
+        mux_sprintf(pdo->outfn, sizeof(pdo->outfn), T("%s%s"), *(dp->ppszOutputBase), dp->szOutputSuffix);
         if (dp->bUseTemporary)
         {
-            mux_sprintf(tmpfile, sizeof(tmpfile), T("%s.#%d#"), outfn, mudstate.epoch);
-            RemoveFile(tmpfile);
-            bOpen = mux_fopen(&f, tmpfile, T("wb"));
+            mux_sprintf(pdo->tmpfile, sizeof(pdo->tmpfile), T("%s.#%d#"), pdo->outfn, mudstate.epoch);
+            RemoveFile(pdo->tmpfile);
+            bOpen = mux_fopen(&pdo->f, pdo->tmpfile, T("wb"));
         }
         else
         {
-            RemoveFile(outfn);
-            bOpen = mux_fopen(&f, outfn, T("wb"));
+            RemoveFile(pdo->outfn);
+            bOpen = mux_fopen(&pdo->f, pdo->outfn, T("wb"));
         }
 
-        if (bOpen)
+        if (!bOpen)
         {
-            DebugTotalFiles++;
-            setvbuf(f, nullptr, _IOFBF, 16384);
-            db_write(f, F_MUX, dp->fType);
-            if (fclose(f) == 0)
-            {
-                DebugTotalFiles--;
-            }
+            log_perror(T("DMP"), T("FAIL"), dp->pszErrorMessage, pdo->outfn);
+            return false;
+        }
+    }
+    else
+    {
+        // Nuke our predecessor
+        //
+        pdo->fType = OUTPUT_VERSION | OUTPUT_FLAGS;
+        if (mudconf.compress_db)
+        {
+            mux_sprintf(pdo->prevfile, sizeof(pdo->prevfile), T("%s.prev.gz"), mudconf.outdb);
+            mux_sprintf(pdo->tmpfile, sizeof(pdo->tmpfile), T("%s.#%d#.gz"), mudconf.outdb, mudstate.epoch - 1);
+            RemoveFile(pdo->tmpfile);
+            mux_sprintf(pdo->tmpfile, sizeof(pdo->tmpfile), T("%s.#%d#.gz"), mudconf.outdb, mudstate.epoch);
+            mux_sprintf(pdo->outfn, sizeof(pdo->outfn), T("%s.gz"), mudconf.outdb);
 
-            if (dp->bUseTemporary)
-            {
-                ReplaceFile(tmpfile, outfn);
-            }
+            pdo->f = popen((char *)tprintf(T("%s > %s"), mudconf.compress, pdo->tmpfile), POPEN_WRITE_OP);
+            pdo->bPipe = true;
         }
         else
         {
-            log_perror(T("DMP"), T("FAIL"), dp->pszErrorMessage, outfn);
-        }
+            mux_sprintf(pdo->prevfile, sizeof(pdo->prevfile), T("%s.prev"), mudconf.outdb);
+            mux_sprintf(pdo->tmpfile, sizeof(pdo->tmpfile), T("%s.#%d#"), mudconf.outdb, mudstate.epoch - 1);
+            RemoveFile(pdo->tmpfile);
+            mux_sprintf(pdo->tmpfile, sizeof(pdo->tmpfile), T("%s.#%d#"), mudconf.outdb, mudstate.epoch);
+            mux_strncpy(pdo->outfn, mudconf.outdb, sizeof(pdo->outfn)-1);
 
-        if (!bPotentialConflicts)
-        {
-            if (mudconf.have_mailer)
-            {
-                if (mux_fopen(&f, mudconf.mail_db, T("wb")))
-                {
-                    DebugTotalFiles++;
-                    dump_mail(f);
-                    if (fclose(f) == 0)
-                    {
-                        DebugTotalFiles--;
-                    }
-                }
-            }
-            if (mudconf.have_comsys)
+            if (!mux_fopen(&pdo->f, pdo->tmpfile, T("wb")))
             {
-                save_comsys(mudconf.comsys_db);
+                pdo->f = nullptr;
             }
         }
-        return;
-    }
-
-    // Nuke our predecessor
-    //
-    if (mudconf.compress_db)
-    {
-        mux_sprintf(prevfile, sizeof(prevfile), T("%s.prev.gz"), mudconf.outdb);
-        mux_sprintf(tmpfile, sizeof(tmpfile), T("%s.#%d#.gz"), mudconf.outdb, mudstate.epoch - 1);
-        RemoveFile(tmpfile);
-        mux_sprintf(tmpfile, sizeof(tmpfile), T("%s.#%d#.gz"), mudconf.outdb, mudstate.epoch);
-        mux_sprintf(outfn, sizeof(outfn), T("%s.gz"), mudconf.outdb);
 
-        f = popen((char *)tprintf(T("%s > %s"), mudconf.compress, tmpfile), POPEN_WRITE_OP);
-        if (f)
+        if (nullptr == pdo->f)
         {
-            DebugTotalFiles++;
-            setvbuf(f, nullptr, _IOFBF, 16384);
-            db_write(f, F_MUX, OUTPUT_VERSION | OUTPUT_FLAGS);
-            if (pclose(f) != -1)
-            {
-                DebugTotalFiles--;
-            }
-            ReplaceFile(outfn, prevfile);
-            if (ReplaceFile(tmpfile, outfn) < 0)
-            {
-                log_perror(T("SAV"), T("FAIL"), T("Renaming output file to DB file"), tmpfile);
-            }
+            log_perror(T("SAV"), T("FAIL"), T("Opening"), pdo->tmpfile);
+            return false;
         }
-        else
+    }
+    DebugTotalFiles++;
+    setvbuf(pdo->f, nullptr, _IOFBF, 16384);
+    return true;
+}
+
+static void dump_output_close(DUMP_OUTPUT *pdo)
+{
+    if (pdo->bPipe)
+    {
+        if (pclose(pdo->f) != -1)
         {
-            log_perror(T("SAV"), T("FAIL"), T("Opening"), tmpfile);
+            DebugTotalFiles--;
         }
     }
-    else
+    else if (fclose(pdo->f) == 0)
     {
-        mux_sprintf(prevfile, sizeof(prevfile), T("%s.prev"), mudconf.outdb);
-        mux_sprintf(tmpfile, sizeof(tmpfile), T("%s.#%d#"), mudconf.outdb, mudstate.epoch - 1);
-        RemoveFile(tmpfile);
-        mux_sprintf(tmpfile, sizeof(tmpfile), T("%s.#%d#"), mudconf.outdb, mudstate.epoch);
+        DebugTotalFiles--;
+    }
+    pdo->f = nullptr;
 
-        if (mux_fopen(&f, tmpfile, T("wb")))
-        {
-            DebugTotalFiles++;
-            setvbuf(f, nullptr, _IOFBF, 16384);
-            db_write(f, F_MUX, OUTPUT_VERSION | OUTPUT_FLAGS);
-            if (fclose(f) == 0)
-            {
-                DebugTotalFiles--;
-            }
-            ReplaceFile(mudconf.outdb, prevfile);
-            if (ReplaceFile(tmpfile, mudconf.outdb) < 0)
-            {
-                log_perror(T("SAV"), T("FAIL"), T("Renaming output file to DB file"), tmpfile);
-            }
-        }
-        else
+    if ('\0' != pdo->prevfile[0])
+    {
+        ReplaceFile(pdo->outfn, pdo->prevfile);
+        if (ReplaceFile(pdo->tmpfile, pdo->outfn) < 0)
         {
-            log_perror(T("SAV"), T("FAIL"), T("Opening"), tmpfile);
+            log_perror(T("SAV"), T("FAIL"), T("Renaming output file to DB file"), pdo->tmpfile);
         }
     }
+    else if ('\0' != pdo->tmpfile[0])
+    {
+        ReplaceFile(pdo->tmpfile, pdo->outfn);
+    }
+}
+
+static void dump_local(int dump_type)
+{
+    local_dump_database(dump_type);
+    ServerEventsSinkNode *p = g_pServerEventsSinkListHead;
+    while (nullptr != p)
+    {
+        p->pSink->dump_database(dump_type);
+        p = p->pNext;
+    }
+}
 
+static void dump_mail_and_comsys(void)
+{
     if (mudconf.have_mailer)
     {
+        FILE *f;
         if (mux_fopen(&f, mudconf.mail_db, T("wb")))
         {
             DebugTotalFiles++;
@@ -1546,11 +2088,204 @@ void dump_database_internal(int dump_type)
     }
 }
 
+static void dump_checkpoint_finish(void);
+
+void dump_database_internal(int dump_type)
+{
+    if (  dump_type < 0
+       || NUM_DUMP_TYPES <= dump_type)
+    {
+        return;
+    }
+
+    bool bPotentialConflicts = false;
+    if (  dump_type == DUMP_I_PANIC
+       || dump_type == DUMP_I_SIGNAL)
+    {
+#if defined(HAVE_WORKING_FORK)
+        // If we are already dumping for some reason, and suddenly get a type 1 or
+        // type 4 dump, basically don't touch mail and comsys files. The other
+        // dump will take care of them as well as can be expected for now, and if
+        // we try to, we'll just step on them.
+        //
+        if (mudstate.dumping)
+        {
+            bPotentialConflicts = true;
+        }
+#endif // HAVE_WORKING_FORK
+        if (db_checkpoint_active())
+        {
+            bPotentialConflicts = true;
+        }
+    }
+    else
+    {
+        // Any checkpoint in progress is completed first so that it does
+        // not trail behind this dump.
+        //
+        dump_checkpoint_finish();
+    }
+
+    // Call the local dump function only if another dump is not already
+    // in progress.
+    //
+    dump_local(dump_type);
+
+    DUMP_OUTPUT out;
+    if (dump_output_open(dump_type, &out))
+    {
+        db_write(out.f, out.iFormat, out.fType);
+        dump_output_close(&out);
+    }
+
+    if (!bPotentialConflicts)
+    {
+        dump_mail_and_comsys();
+    }
+}
+
+// Incremental checkpoints.
+//
+// When a dump is not done in a forked child, a checkpoint writes the
+// structure and/or flatfile from the task queue, dump_slice milliseconds at a
+// time, instead of stopping the game until the whole database is written.
+// See db_checkpoint_begin() for how the image stays consistent.
+//
+#define CHECKPOINT_CHUNK 64
+
+static DUMP_OUTPUT s_aCheckpoint[2];
+static int         s_nCheckpoint = 0;
+static bool        s_bCheckpoint = false;
+
+static void dump_checkpoint_end(dbref nWritten, dbref nEarly)
+{
+    for (int k = 0; k < s_nCheckpoint; k++)
+    {
+        dump_output_close(&s_aCheckpoint[k]);
+    }
+    s_nCheckpoint = 0;
+    s_bCheckpoint = false;
+
+    STARTLOG(LOG_DBSAVES, "DMP", "DONE");
+    log_text(tprintf(T("Checkpoint complete: %d objects, %d written ahead of turn."),
+        nWritten, nEarly));
+    ENDLOG;
+
+#if defined(HAVE_WORKING_FORK)
+    mudstate.dumping = false;
+#endif // HAVE_WORKING_FORK
+    local_dump_complete_signal();
+    ServerEventsSinkNode *p = g_pServerEventsSinkListHead;
+    while (nullptr != p)
+    {
+        p->pSink->dump_complete_signal();
+        p = p->pNext;
+    }
+}
+
+static void dispatch_Checkpoint(void *pUnused, int iUnused)
+{
+    UNUSED_PARAMETER(pUnused);
+    UNUSED_PARAMETER(iUnused);
+
+    CLinearTimeDelta ltdSlice;
+    ltdSlice.SetMilliseconds(mudconf.dump_slice);
+
+    CLinearTimeAbsolute ltaNow;
+    ltaNow.GetUTC();
+    CLinearTimeAbsolute ltaStop = ltaNow + ltdSlice;
+
+    dbref nWritten, nEarly;
+    while (!db_checkpoint_step(CHECKPOINT_CHUNK, &nWritten, &nEarly))
+    {
+        ltaNow.GetUTC();
+        if (ltaStop < ltaNow)
+        {
+            // Let the network and the queue run before the next slice.
+            //
+            CLinearTimeDelta ltdGap;
+            ltdGap.SetMilliseconds(1);
+            scheduler.DeferTask(ltaNow + ltdGap, PRIORITY_SYSTEM, dispatch_Checkpoint, 0, 0);
+            return;
+        }
+    }
+    dump_checkpoint_end(nWritten, nEarly);
+}
+
+static bool dump_checkpoint_begin(int key)
+{
+    if (  mudconf.dump_slice <= 0
+       || s_bCheckpoint)
+    {
+        return false;
+    }
+
+    FILE *af[2];
+    int aformats[2];
+    int aflags[2];
+    s_nCheckpoint = 0;
+    if (key & DUMP_STRUCT)
+    {
+        dump_local(DUMP_I_NORMAL);
+        if (dump_output_open(DUMP_I_NORMAL, &s_aCheckpoint[s_nCheckpoint]))
+        {
+            s_nCheckpoint++;
+        }
+    }
+    if (key & DUMP_FLATFILE)
+    {
+        dump_local(DUMP_I_FLAT);
+        if (dump_output_open(DUMP_I_FLAT, &s_aCheckpoint[s_nCheckpoint]))
+        {
+            s_nCheckpoint++;
+        }
+    }
+    dump_mail_and_comsys();
+
+    s_bCheckpoint = true;
+    for (int k = 0; k < s_nCheckpoint; k++)
+    {
+        af[k] = s_aCheckpoint[k].f;
+        aformats[k] = s_aCheckpoint[k].iFormat;
+        aflags[k] = s_aCheckpoint[k].fType;
+    }
+    if (  0 < s_nCheckpoint
+       && db_checkpoint_begin(s_nCheckpoint, af, aformats, aflags))
+    {
+        STARTLOG(LOG_DBSAVES, "DMP", "CHKPT");
+        log_text(tprintf(T("Checkpoint started: %d objects."), mudstate.db_top));
+        ENDLOG;
+        scheduler.DeferImmediateTask(PRIORITY_SYSTEM, dispatch_Checkpoint, 0, 0);
+    }
+    else
+    {
+        dump_checkpoint_end(0, 0);
+    }
+    return true;
+}
+
+// Completes any checkpoint in progress without yielding.
+//
+static void dump_checkpoint_finish(void)
+{
+    if (s_bCheckpoint)
+    {
+        scheduler.CancelTask(dispatch_Checkpoint, 0, 0);
+        dbref nWritten, nEarly;
+        while (!db_checkpoint_step(INT_MAX, &nWritten, &nEarly))
+        {
+            ; // Nothing.
+        }
+        dump_checkpoint_end(nWritten, nEarly);
+    }
+}
+
 static void dump_database(void)
 {
     UTF8 *buff;
 
     mudstate.epoch++;
+    dump_checkpoint_finish();
 
 #if defined(HAVE_WORKING_FORK)
     if (mudstate.dumping)
@@ -1634,6 +2369,10 @@ void fork_and_dump(int key)
     }
     bRequestAccepted = true;
 #endif // HAVE_WORKING_FORK
+    if (db_checkpoint_active())
+    {
+        return;
+    }
 
     // If no options were given, then it means DUMP_TEXT+DUMP_STRUCT.
     //
@@ -1712,8 +2451,30 @@ void fork_and_dump(int key)
         bAttemptFork = false;
     }
 #endif // !HAVE_PREAD !HAVE_PWRITE
+#if !defined(MEMORY_BASED) && defined(UNIX_MAPPED_FILES)
+    if (mudconf.cache_mmap)
+    {
+        // A forked child would share the attribute file mapping and see
+        // pages change underneath it, so the dump is done in-process.
+        //
+        bAttemptFork = false;
+    }
+#endif // !MEMORY_BASED && UNIX_MAPPED_FILES
 #endif // HAVE_WORKING_FORK
 
+    bool bCheckpoint = false;
+    if (  (key & (DUMP_STRUCT|DUMP_FLATFILE))
+#if defined(HAVE_WORKING_FORK)
+       && !bAttemptFork
+#endif // HAVE_WORKING_FORK
+       && dump_checkpoint_begin(key))
+    {
+        // The structure and flatfile are written from the task queue.
+        //
+        key &= ~(DUMP_STRUCT|DUMP_FLATFILE);
+        bCheckpoint = true;
+    }
+
     if (key & (DUMP_STRUCT|DUMP_FLATFILE))
     {
 #if defined(HAVE_WORKING_FORK)
@@ -1738,7 +2499,7 @@ void fork_and_dump(int key)
                 dump_database_internal(DUMP_I_FLAT);
             }
 #if defined(HAVE_WORKING_FORK)
-            if (mudconf.fork_dump)
+            if (bAttemptFork)
             {
                 _exit(0);
             }
@@ -1746,6 +2507,7 @@ void fork_and_dump(int key)
         else if (child < 0)
         {
             log_perror(T("DMP"), T("FORK"), nullptr, T("fork()"));
+            bCheckpoint = dump_checkpoint_begin(key);
         }
         else
         {
@@ -1775,7 +2537,8 @@ void fork_and_dump(int key)
 
 #if defined(HAVE_WORKING_FORK)
     mudstate.write_protect = false;
-    if (!bChildExists)
+    if (  !bChildExists
+       && !bCheckpoint)
     {
         // We have the ability to fork children, but we are not configured to
         // use it; or, we tried to fork a child and failed; or, we didn't
@@ -2036,7 +2799,7 @@ bool Hearer(dbref thing)
         {
             bool bFoundCommands = false;
 
-            UTF8 *buff = alloc_lbuf("Hearer");
+            CAttrView av;
             atr_push();
             unsigned char *as;
             for (int atr = atr_head(thing, &as); atr; atr = atr_next(&as))
@@ -2048,21 +2811,17 @@ bool Hearer(dbref thing)
                     continue;
                 }
 
-                int   aflags;
-                dbref aowner;
-                atr_get_str(buff, thing, atr, &aowner, &aflags);
-
-                if (aflags & AF_NOPROG)
+                av.get(thing, atr);
+                if (av.flags() & AF_NOPROG)
                 {
                     continue;
                 }
 
-                UTF8 *s = nullptr;
+                const UTF8 *buff = av.text();
                 if (  AMATCH_CMD    == buff[0]
                    || AMATCH_LISTEN == buff[0])
                 {
-                    s = (UTF8 *)strchr((char *)buff+1, ':');
-                    if (s)
+                    if (nullptr != strchr((const char *)buff+1, ':'))
                     {
                         if (AMATCH_CMD == buff[0])
                         {
@@ -2070,7 +2829,6 @@ bool Hearer(dbref thing)
                         }
                         else
                         {
-                            free_lbuf(buff);
                             atr_pop();
                             mudstate.bfListens.Set(thing);
                             return true;
@@ -2078,7 +2836,6 @@ bool Hearer(dbref thing)
                     }
                 }
             }
-            free_lbuf(buff);
             atr_pop();
 
             mudstate.bfNoListens.Set(thing);
@@ -2186,6 +2943,10 @@ static void info(int fmt, int flags, int ver)
     {
         cp = T("MUX");
     }
+    else if (fmt == F_MUXBIN)
+    {
+        cp = T("MUX binary");
+    }
     else
     {
         cp = T("*unknown*");
@@ -2225,6 +2986,7 @@ static const UTF8 *standalone_basename = nullptr;
 static bool standalone_check = false;
 static bool standalone_load = false;
 static bool standalone_unload = false;
+static bool standalone_binary = false;
 
 static void dbconvert(void)
 {
@@ -2238,6 +3000,7 @@ static void dbconvert(void)
 
     pool_init(POOL_LBUF, LBUF_SIZE);
     pool_init(POOL_MBUF, MBUF_SIZE);
+    pool_init(POOL_GBUF, GBUF_SIZE);
     pool_init(POOL_SBUF, SBUF_SIZE);
     pool_init(POOL_BOOL, sizeof(struct boolexp));
     pool_init(POOL_STRING, sizeof(mux_string));
@@ -2351,7 +3114,8 @@ static void dbconvert(void)
         }
 
         db_flags = (db_flags & ~clrflags) | setflags;
-        if (db_format != F_MUX)
+        if (  db_format != F_MUX
+           && db_format != F_MUXBIN)
         {
             db_ver = 3;
         }
@@ -2359,15 +3123,16 @@ static void dbconvert(void)
         {
             db_ver = ver;
         }
+        int out_format = standalone_binary ? F_MUXBIN : F_MUX;
         Log.WriteString(T("Output: "));
-        info(F_MUX, db_flags, db_ver);
+        info(out_format, db_flags, db_ver);
         setvbuf(fpOut, nullptr, _IOFBF, 16384);
 #ifndef MEMORY_BASED
         // Save cached modified attribute list
         //
         al_store();
 #endif // MEMORY_BASED
-        db_write(fpOut, F_MUX, db_ver | db_flags);
+        db_write(fpOut, out_format, db_ver | db_flags);
         fclose(fpOut);
     }
     CLOSE;
@@ -2476,6 +3241,7 @@ long DebugTotalMemory = 0;
 #define CLI_DO_BASENAME    CLI_USER+9
 #define CLI_DO_PID_FILE    CLI_USER+10
 #define CLI_DO_ERRORPATH   CLI_USER+11
+#define CLI_DO_BINARY      CLI_USER+12
 
 static bool bMinDB = false;
 static bool bSyntaxError = false;
@@ -2498,6 +3264,7 @@ static CLI_OptionEntry OptionTable[] =
     { "l", CLI_NONE,     CLI_DO_LOAD        },
     { "u", CLI_NONE,     CLI_DO_UNLOAD      },
     { "d", CLI_REQUIRED, CLI_DO_BASENAME    },
+    { "b", CLI_NONE,     CLI_DO_BINARY      },
 #endif // MEMORY_BASED
     { "p", CLI_REQUIRED, CLI_DO_PID_FILE    },
     { "e", CLI_REQUIRED, CLI_DO_ERRORPATH   }
@@ -2564,6 +3331,11 @@ static void CLI_CallBack(CLI_OptionEntry *p, const char *pValue)
             mudstate.bStandAlone = true;
             standalone_basename = (UTF8 *)pValue;
             break;
+
+        case CLI_DO_BINARY:
+            mudstate.bStandAlone = true;
+            standalone_binary = true;
+            break;
 #endif
 
         case CLI_DO_USAGE:
@@ -2711,7 +3483,8 @@ int DCL_CDECL main(int argc, char *argv[])
         mux_fprintf(stderr, T("Version: %s" ENDLINE), mudstate.version);
         if (mudstate.bStandAlone)
         {
-            mux_fprintf(stderr, T("Usage: %s -d <dbname> -i <infile> [-o <outfile>] [-l|-u|-k]" ENDLINE), pProg);
+            mux_fprintf(stderr, T("Usage: %s -d <dbname> -i <infile> [-o <outfile>] [-l|-u|-k] [-b]" ENDLINE), pProg);
+            mux_fprintf(stderr, T("  -b  Write the output file in binary." ENDLINE));
             mux_fprintf(stderr, T("  -d  Basename." ENDLINE));
             mux_fprintf(stderr, T("  -i  Input file." ENDLINE));
             mux_fprintf(stderr, T("  -k  Check." ENDLINE));
@@ -2806,6 +3579,7 @@ int DCL_CDECL main(int argc, char *argv[])
     mudstate.cpu_count_from.GetUTC();
     pool_init(POOL_LBUF, LBUF_SIZE);
     pool_init(POOL_MBUF, MBUF_SIZE);
+    pool_init(POOL_GBUF, GBUF_SIZE);
     pool_init(POOL_SBUF, SBUF_SIZE);
     pool_init(POOL_BOOL, sizeof(struct boolexp));
 
@@ -2813,6 +3587,7 @@ int DCL_CDECL main(int argc, char *argv[])
     pool_init(POOL_QENTRY, sizeof(BQUE));
     pool_init(POOL_LBUFREF, sizeof(lbuf_ref));
     pool_init(POOL_REGREF, sizeof(reg_ref));
+    pool_init(POOL_REGFRAME, sizeof(reg_frame));
     pool_init(POOL_STRING, sizeof(mux_string));
     tcache_init();
     pcache_init();
@@ -2909,6 +3684,7 @@ int DCL_CDECL main(int argc, char *argv[])
 
     fcache_init();
     helpindex_init();
+    palette_table_init();
 
 #ifdef MEMORY_BASED
     db_free();
@@ -2969,6 +3745,7 @@ int DCL_CDECL main(int argc, char *argv[])
             return 2;
         }
     }
+    db_index_build();
     set_signals();
     Guest.StartUp();
 
@@ -2987,6 +3764,8 @@ int DCL_CDECL main(int argc, char *argv[])
     hashreset(&mudstate.attr_name_htab);
     hashreset(&mudstate.player_htab);
     hashreset(&mudstate.fwdlist_htab);
+    hashreset(&mudstate.queue_htab);
+    hashreset(&mudstate.semaphore_htab);
     hashreset(&mudstate.desc_htab);
     hashreset(&mudstate.reference_htab);
 
@@ -13,38 +13,108 @@
 #include "command.h"
 #include "help.h"
 
-// Pointers to this struct is what gets stored in the help_htab's.
+#ifdef UNIX_DIGEST
+#include <openssl/sha.h>
+#else
+#include "sha1.h"
+#endif
+
+// The index for each help file is kept on disk next to the text as
+// <base>.indx and is mapped (or read) in whole at startup.  The image is a
+// header, the topic table, a prefix trie over the lowercased topic names,
+// and a pool of NUL-terminated topic names.  The index is rebuilt only when
+// the size or SHA-1 digest of the text file no longer matches the values
+// recorded in the header.  A modification time would miss an edit which
+// keeps the size and lands within the same second.
 //
-struct help_entry
+#define HELP_INDEX_MAGIC    0x58444E49  // 'INDX'
+#define HELP_INDEX_VERSION  2
+#define HELP_NONE           (-1)
+
+struct help_index_header
+{
+    UINT32 nMagic;
+    UINT32 nVersion;
+    UINT32 nTopics;
+    UINT32 nNodes;
+    UINT32 nKeyBytes;
+    UINT32 nReserved;
+    INT64  nSource;   // Size of the text file.
+    UINT8  aSource[SHA_DIGEST_LENGTH];  // SHA-1 digest of the text file.
+    UINT8  aPad[4];
+};
+
+// What an index records about the text file it was built from.
+//
+struct help_source
+{
+    INT64  nSize;
+    UINT8  aDigest[SHA_DIGEST_LENGTH];
+};
+
+// One per '&' line in the text file, in file order.
+//
+struct help_topic
+{
+    UINT64 pos;       // Position in file.
+    UINT32 iKey;      // Offset of the lowercased topic name in the key pool.
+    UINT32 nKey;      // Length of the topic name.
+};
+
+// Node 0 is the root.  The children of a node are chained through iSibling
+// in increasing order of ch, and a zero iChild or iSibling means none.
+//
+// iExact is the topic whose full name ends at this node.  When a name
+// appears more than once, the later topic wins.  iPrefix is the first topic
+// which claimed this node as an initial substring alias.
+//
+struct help_node
+{
+    UINT32 iChild;
+    UINT32 iSibling;
+    INT32  iExact;
+    INT32  iPrefix;
+    UINT32 ch;
+};
+
+struct help_index
 {
-    size_t pos;       // Position in file.
-    UTF8  *key;       // The key this is stored under. nullptr if this is an
-                      // automatically generated initial substring alias.
+    const struct help_index_header *pHeader;
+    const struct help_topic        *aTopics;
+    const struct help_node         *aNodes;
+    const UTF8                     *pKeys;
+
+    void   *pImage;
+    size_t  nImage;
+    bool    bMapped;
+
+    size_t  nLongest;
+    INT64   nLookups;
+    INT64   nHits;
+    INT64   nProbes;
 };
 
 void helpindex_clean(int iHelpfile)
 {
-    CHashTable *htab = mudstate.aHelpDesc[iHelpfile].ht;
-    if (nullptr == htab)
+    struct help_index *pIndex = mudstate.aHelpDesc[iHelpfile].pIndex;
+    if (nullptr == pIndex)
     {
         return;
     }
 
-    struct help_entry *htab_entry;
-    for (htab_entry = (struct help_entry *)hash_firstentry(htab);
-         htab_entry;
-         htab_entry = (struct help_entry *)hash_nextentry(htab))
+#if defined(UNIX_MAPPED_FILES)
+    if (pIndex->bMapped)
     {
-        if (htab_entry->key)
-        {
-            MEMFREE(htab_entry->key);
-            htab_entry->key = nullptr;
-        }
-        delete htab_entry;
-        htab_entry = nullptr;
+        munmap(pIndex->pImage, pIndex->nImage);
     }
-    delete mudstate.aHelpDesc[iHelpfile].ht;
-    mudstate.aHelpDesc[iHelpfile].ht = nullptr;
+    else
+#endif // UNIX_MAPPED_FILES
+    {
+        MEMFREE(pIndex->pImage);
+    }
+    pIndex->pImage = nullptr;
+    delete pIndex;
+    mudstate.aHelpDesc[iHelpfile].pIndex = nullptr;
 }
 
 static int lineno;
@@ -120,17 +190,184 @@ static void HelpIndex_End(void)
     rfp = nullptr;
 }
 
-static void helpindex_read(int iHelpfile)
+// The index is built in growable arrays and then packed into a single image
+// with the same layout as the file.
+//
+struct help_build
 {
-    helpindex_clean(iHelpfile);
+    struct help_topic *aTopics;
+    UINT32             nTopics;
+    UINT32             mTopics;
 
-    mudstate.aHelpDesc[iHelpfile].ht = new CHashTable;
-    CHashTable *htab = mudstate.aHelpDesc[iHelpfile].ht;
+    struct help_node  *aNodes;
+    UINT32             nNodes;
+    UINT32             mNodes;
 
-    UTF8 szTextFilename[SBUF_SIZE+8];
-    mux_sprintf(szTextFilename, sizeof(szTextFilename), T("%s.txt"),
-        mudstate.aHelpDesc[iHelpfile].pBaseFilename);
+    UTF8              *pKeys;
+    size_t             nKeyBytes;
+    size_t             mKeyBytes;
+};
+
+static void *GrowArray(void *p, UINT32 &m, size_t nSize)
+{
+    m = (0 == m) ? 256 : 2*m;
+    p = MEMREALLOC(p, m * nSize);
+    ISOUTOFMEMORY(p);
+    return p;
+}
+
+static UINT32 AddNode(struct help_build *pb, UINT32 ch)
+{
+    if (pb->nNodes == pb->mNodes)
+    {
+        pb->aNodes = (struct help_node *)GrowArray(pb->aNodes, pb->mNodes,
+            sizeof(struct help_node));
+    }
+    struct help_node *pNode = &pb->aNodes[pb->nNodes];
+    pNode->iChild   = 0;
+    pNode->iSibling = 0;
+    pNode->iExact   = HELP_NONE;
+    pNode->iPrefix  = HELP_NONE;
+    pNode->ch       = ch;
+    return pb->nNodes++;
+}
+
+// Returns the child of iParent for ch, adding it in order if necessary.
+//
+static UINT32 FindOrAddChild(struct help_build *pb, UINT32 iParent, UINT32 ch)
+{
+    UINT32 iPrev = 0;
+    UINT32 i = pb->aNodes[iParent].iChild;
+    while (  0 != i
+          && pb->aNodes[i].ch < ch)
+    {
+        iPrev = i;
+        i = pb->aNodes[i].iSibling;
+    }
+
+    if (  0 != i
+       && pb->aNodes[i].ch == ch)
+    {
+        return i;
+    }
+
+    UINT32 iNew = AddNode(pb, ch);
+    pb->aNodes[iNew].iSibling = i;
+    if (0 == iPrev)
+    {
+        pb->aNodes[iParent].iChild = iNew;
+    }
+    else
+    {
+        pb->aNodes[iPrev].iSibling = iNew;
+    }
+    return iNew;
+}
+
+static void AddTopic(struct help_build *pb, size_t pos, const UTF8 *pCased,
+    size_t nCased, const UTF8 *szTextFilename)
+{
+    // Avoid keys with a trailing space.
+    //
+    while (  0 < nCased
+          && mux_isspace(pCased[nCased-1]))
+    {
+        nCased--;
+    }
 
+    if (pb->nTopics == pb->mTopics)
+    {
+        pb->aTopics = (struct help_topic *)GrowArray(pb->aTopics, pb->mTopics,
+            sizeof(struct help_topic));
+    }
+    while (pb->mKeyBytes < pb->nKeyBytes + nCased + 1)
+    {
+        pb->mKeyBytes = (0 == pb->mKeyBytes) ? 4096 : 2*pb->mKeyBytes;
+        pb->pKeys = (UTF8 *)MEMREALLOC(pb->pKeys, pb->mKeyBytes);
+        ISOUTOFMEMORY(pb->pKeys);
+    }
+
+    INT32 iTopic = static_cast<INT32>(pb->nTopics++);
+    struct help_topic *pTopic = &pb->aTopics[iTopic];
+    pTopic->pos  = pos;
+    pTopic->iKey = static_cast<UINT32>(pb->nKeyBytes);
+    pTopic->nKey = static_cast<UINT32>(nCased);
+    memcpy(pb->pKeys + pb->nKeyBytes, pCased, nCased);
+    pb->pKeys[pb->nKeyBytes + nCased] = '\0';
+    pb->nKeyBytes += nCased + 1;
+
+    // Topic names which appear earlier in the help file have priority over
+    // topics names which appear later in the help file.  That is, we do not
+    // associate prefixes with this topic if they have already been used on a
+    // previous topic.
+    //
+    UINT32 iNode = 0;
+    for (size_t i = 0; i < nCased; i++)
+    {
+        iNode = FindOrAddChild(pb, iNode, pCased[i]);
+        struct help_node *pNode = &pb->aNodes[iNode];
+        if (i + 1 == nCased)
+        {
+            if (HELP_NONE != pNode->iExact)
+            {
+                Log.tinyprintf(T("helpindex_read: duplicate %s entries for %s" ENDLINE),
+                    szTextFilename, pb->pKeys + pTopic->iKey);
+            }
+            pNode->iExact = iTopic;
+        }
+        else if (  !mux_isspace(pCased[i])
+                && HELP_NONE == pNode->iExact
+                && HELP_NONE == pNode->iPrefix)
+        {
+            pNode->iPrefix = iTopic;
+        }
+    }
+}
+
+// Packs the built index into a single MEMALLOC'd image.
+//
+static void *PackIndex(struct help_build *pb, const struct help_source *psrc,
+    size_t *pnImage)
+{
+    struct help_index_header hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.nMagic    = HELP_INDEX_MAGIC;
+    hdr.nVersion  = HELP_INDEX_VERSION;
+    hdr.nTopics   = pb->nTopics;
+    hdr.nNodes    = pb->nNodes;
+    hdr.nKeyBytes = static_cast<UINT32>(pb->nKeyBytes);
+    hdr.nSource   = psrc->nSize;
+    memcpy(hdr.aSource, psrc->aDigest, sizeof(hdr.aSource));
+
+    size_t nTopics = pb->nTopics * sizeof(struct help_topic);
+    size_t nNodes  = pb->nNodes  * sizeof(struct help_node);
+    size_t nImage  = sizeof(hdr) + nTopics + nNodes + pb->nKeyBytes;
+
+    char *pImage = (char *)MEMALLOC(nImage);
+    ISOUTOFMEMORY(pImage);
+
+    char *p = pImage;
+    memcpy(p, &hdr, sizeof(hdr));     p += sizeof(hdr);
+    if (0 < nTopics)
+    {
+        memcpy(p, pb->aTopics, nTopics);
+        p += nTopics;
+    }
+    memcpy(p, pb->aNodes, nNodes);    p += nNodes;
+    if (0 < pb->nKeyBytes)
+    {
+        memcpy(p, pb->pKeys, pb->nKeyBytes);
+    }
+    *pnImage = nImage;
+    return pImage;
+}
+
+// Reads the text file and returns a packed index image, or nullptr if the
+// text file cannot be opened.
+//
+static void *BuildIndex(const UTF8 *szTextFilename,
+    const struct help_source *psrc, size_t *pnImage)
+{
     FILE *fp;
     if (!mux_fopen(&fp, szTextFilename, T("rb")))
     {
@@ -140,10 +377,14 @@ static void helpindex_read(int iHelpfile)
         log_text(p);
         free_lbuf(p);
         ENDLOG;
-        return;
+        return nullptr;
     }
     DebugTotalFiles++;
 
+    struct help_build hb;
+    memset(&hb, 0, sizeof(hb));
+    AddNode(&hb, 0);
+
     size_t pos   = 0;
     size_t nTopicOriginal = 0;
     UTF8   topic[TOPIC_NAME_LEN+1];
@@ -151,77 +392,278 @@ static void helpindex_read(int iHelpfile)
     HelpIndex_Start(fp);
     while (HelpIndex_Read(&pos, &nTopicOriginal, topic))
     {
-        // Convert the entry to all lowercase letters and add all leftmost
-        // substrings.
-        //
-        // Topic names which appear earlier in the help file have priority
-        // over topics names which appear later in the help file.  That is,
-        // we do not associate prefixes with this topic if they have already
-        // been used on a previous topic.
-        //
         size_t nCased;
         UTF8  *pCased = mux_strlwr(topic, nCased);
+        AddTopic(&hb, pos, pCased, nCased, szTextFilename);
+    }
+    HelpIndex_End();
 
-        bool bOriginal = true; // First is the longest.
+    if (fclose(fp) == 0)
+    {
+        DebugTotalFiles--;
+    }
 
-        for (size_t nTopic = nCased; 0 < nTopic; nTopic--)
+    void *pImage = PackIndex(&hb, psrc, pnImage);
+    if (nullptr != hb.aTopics)
+    {
+        MEMFREE(hb.aTopics);
+    }
+    MEMFREE(hb.aNodes);
+    if (nullptr != hb.pKeys)
+    {
+        MEMFREE(hb.pKeys);
+    }
+    return pImage;
+}
+
+// Points the index at the sections of an image after checking that the
+// image is complete, consistent, and describes the current text file.
+//
+static bool AttachIndex(struct help_index *pIndex, void *pImage, size_t nImage,
+    const struct help_source *psrc)
+{
+    if (nImage < sizeof(struct help_index_header))
+    {
+        return false;
+    }
+
+    const struct help_index_header *pHeader =
+        (const struct help_index_header *)pImage;
+    if (  HELP_INDEX_MAGIC != pHeader->nMagic
+       || HELP_INDEX_VERSION != pHeader->nVersion
+       || psrc->nSize != pHeader->nSource
+       || memcmp(psrc->aDigest, pHeader->aSource, sizeof(pHeader->aSource)) != 0
+       || 0 == pHeader->nNodes
+       || nImage != sizeof(struct help_index_header)
+                  + pHeader->nTopics * sizeof(struct help_topic)
+                  + pHeader->nNodes * sizeof(struct help_node)
+                  + pHeader->nKeyBytes)
+    {
+        return false;
+    }
+
+    const char *p = (const char *)pImage + sizeof(struct help_index_header);
+    const struct help_topic *aTopics = (const struct help_topic *)p;
+    p += pHeader->nTopics * sizeof(struct help_topic);
+    const struct help_node *aNodes = (const struct help_node *)p;
+    p += pHeader->nNodes * sizeof(struct help_node);
+    const UTF8 *pKeys = (const UTF8 *)p;
+
+    size_t nLongest = 0;
+    for (UINT32 i = 0; i < pHeader->nTopics; i++)
+    {
+        if (  pHeader->nKeyBytes <= aTopics[i].iKey
+           || pHeader->nKeyBytes - aTopics[i].iKey <= aTopics[i].nKey
+           || '\0' != pKeys[aTopics[i].iKey + aTopics[i].nKey])
         {
-            // Avoid adding any entries with a trailing space.
-            //
-            if (mux_isspace(pCased[nTopic-1]))
-            {
-                continue;
-            }
+            return false;
+        }
+        if (nLongest < aTopics[i].nKey)
+        {
+            nLongest = aTopics[i].nKey;
+        }
+    }
 
-            struct help_entry *htab_entry =
-              (struct help_entry *)hashfindLEN(pCased, nTopic, htab);
+    const INT32 nTopics = static_cast<INT32>(pHeader->nTopics);
+    for (UINT32 i = 0; i < pHeader->nNodes; i++)
+    {
+        if (  pHeader->nNodes <= aNodes[i].iChild
+           || pHeader->nNodes <= aNodes[i].iSibling
+           || aNodes[i].iExact < HELP_NONE
+           || nTopics <= aNodes[i].iExact
+           || aNodes[i].iPrefix < HELP_NONE
+           || nTopics <= aNodes[i].iPrefix)
+        {
+            return false;
+        }
+    }
 
-            if (htab_entry)
-            {
-                if (!bOriginal)
-                {
-                    continue;
-                }
-
-                hashdeleteLEN(pCased, nTopic, htab);
-
-                if (htab_entry->key)
-                {
-                    MEMFREE(htab_entry->key);
-                    htab_entry->key = nullptr;
-                    Log.tinyprintf(T("helpindex_read: duplicate %s entries for %s" ENDLINE),
-                        szTextFilename, pCased);
-                }
-                delete htab_entry;
-                htab_entry = nullptr;
-            }
+    pIndex->pHeader  = pHeader;
+    pIndex->aTopics  = aTopics;
+    pIndex->aNodes   = aNodes;
+    pIndex->pKeys    = pKeys;
+    pIndex->pImage   = pImage;
+    pIndex->nImage   = nImage;
+    pIndex->nLongest = nLongest;
+    pIndex->nLookups = 0;
+    pIndex->nHits    = 0;
+    pIndex->nProbes  = 0;
+    return true;
+}
 
-            try
-            {
-                htab_entry = new struct help_entry;
-            }
-            catch (...)
-            {
-                ; // Nothing.
-            }
+// Maps (or reads) an existing index file.
+//
+static bool LoadIndexFile(struct help_index *pIndex, const UTF8 *szIndexFilename,
+    const struct help_source *psrc)
+{
+    int fd;
+    if (!mux_open(&fd, szIndexFilename, O_RDONLY|O_BINARY))
+    {
+        return false;
+    }
 
-            if (htab_entry)
-            {
-                htab_entry->pos = pos;
-                htab_entry->key = bOriginal ? StringCloneLen(pCased, nTopic) : nullptr;
-                bOriginal = false;
+    struct stat sbIndex;
+    if (  fstat(fd, &sbIndex) < 0
+       || sbIndex.st_size < static_cast<off_t>(sizeof(struct help_index_header)))
+    {
+        mux_close(fd);
+        return false;
+    }
+    size_t nImage = static_cast<size_t>(sbIndex.st_size);
 
-                hashaddLEN(pCased, nTopic, htab_entry, htab);
-            }
+#if defined(UNIX_MAPPED_FILES)
+    void *pImage = mmap(nullptr, nImage, PROT_READ, MAP_SHARED, fd, 0);
+    mux_close(fd);
+    if (MAP_FAILED == pImage)
+    {
+        return false;
+    }
+    if (!AttachIndex(pIndex, pImage, nImage, psrc))
+    {
+        munmap(pImage, nImage);
+        return false;
+    }
+    pIndex->bMapped = true;
+    return true;
+#else // UNIX_MAPPED_FILES
+    void *pImage = MEMALLOC(nImage);
+    ISOUTOFMEMORY(pImage);
+    size_t nRead = 0;
+    while (nRead < nImage)
+    {
+        int n = mux_read(fd, (char *)pImage + nRead, static_cast<unsigned int>(nImage - nRead));
+        if (n <= 0)
+        {
+            break;
         }
+        nRead += n;
     }
-    HelpIndex_End();
+    mux_close(fd);
+    if (  nRead != nImage
+       || !AttachIndex(pIndex, pImage, nImage, psrc))
+    {
+        MEMFREE(pImage);
+        return false;
+    }
+    pIndex->bMapped = false;
+    return true;
+#endif // UNIX_MAPPED_FILES
+}
 
+// Finds the size and SHA-1 digest of the text file.
+//
+static bool HashTextFile(const UTF8 *szTextFilename, struct help_source *psrc)
+{
+    int fd;
+    if (!mux_open(&fd, szTextFilename, O_RDONLY|O_BINARY))
+    {
+        return false;
+    }
+
+    SHA_CTX shac;
+    SHA1_Init(&shac);
+    psrc->nSize = 0;
+
+    UTF8 *buf = alloc_lbuf("HashTextFile");
+    int n;
+    while (0 < (n = mux_read(fd, buf, LBUF_SIZE)))
+    {
+        SHA1_Update(&shac, buf, n);
+        psrc->nSize += n;
+    }
+    free_lbuf(buf);
+    mux_close(fd);
+
+    SHA1_Final(psrc->aDigest, &shac);
+    return (0 == n);
+}
+
+// Writes the index image to a temporary file and moves it into place.  A
+// failure here only costs a rebuild at the next load.
+//
+static void SaveIndexFile(const UTF8 *szIndexFilename, const void *pImage,
+    size_t nImage)
+{
+    UTF8 szTempFilename[SBUF_SIZE+16];
+    mux_sprintf(szTempFilename, sizeof(szTempFilename), T("%s.tmp"),
+        szIndexFilename);
+
+    FILE *fp;
+    if (!mux_fopen(&fp, szTempFilename, T("wb")))
+    {
+        STARTLOG(LOG_PROBLEMS, "HLP", "WINDX");
+        log_printf(T("Can\xE2\x80\x99t open %s for writing."), szTempFilename);
+        ENDLOG;
+        return;
+    }
+    DebugTotalFiles++;
+
+    bool bWritten = (fwrite(pImage, 1, nImage, fp) == nImage);
     if (fclose(fp) == 0)
     {
         DebugTotalFiles--;
     }
-    hashreset(htab);
+    else
+    {
+        bWritten = false;
+    }
+
+    if (  !bWritten
+       || ReplaceFile(szTempFilename, (UTF8 *)szIndexFilename) < 0)
+    {
+        RemoveFile(szTempFilename);
+    }
+}
+
+static void helpindex_read(int iHelpfile)
+{
+    helpindex_clean(iHelpfile);
+
+    UTF8 szTextFilename[SBUF_SIZE+8];
+    UTF8 szIndexFilename[SBUF_SIZE+8];
+    mux_sprintf(szTextFilename, sizeof(szTextFilename), T("%s.txt"),
+        mudstate.aHelpDesc[iHelpfile].pBaseFilename);
+    mux_sprintf(szIndexFilename, sizeof(szIndexFilename), T("%s.indx"),
+        mudstate.aHelpDesc[iHelpfile].pBaseFilename);
+
+    struct help_source src;
+    if (!HashTextFile(szTextFilename, &src))
+    {
+        STARTLOG(LOG_PROBLEMS, "HLP", "RINDX");
+        log_printf(T("Can\xE2\x80\x99t open %s for reading."), szTextFilename);
+        ENDLOG;
+        return;
+    }
+
+    struct help_index *pIndex = nullptr;
+    try
+    {
+        pIndex = new struct help_index;
+    }
+    catch (...)
+    {
+        ; // Nothing.
+    }
+    ISOUTOFMEMORY(pIndex);
+
+    if (!LoadIndexFile(pIndex, szIndexFilename, &src))
+    {
+        size_t nImage;
+        void *pImage = BuildIndex(szTextFilename, &src, &nImage);
+        if (  nullptr == pImage
+           || !AttachIndex(pIndex, pImage, nImage, &src))
+        {
+            if (nullptr != pImage)
+            {
+                MEMFREE(pImage);
+            }
+            delete pIndex;
+            return;
+        }
+        pIndex->bMapped = false;
+        SaveIndexFile(szIndexFilename, pImage, nImage);
+    }
+    mudstate.aHelpDesc[iHelpfile].pIndex = pIndex;
 }
 
 void helpindex_load(dbref player)
@@ -261,29 +703,115 @@ static const UTF8 *MakeCanonicalTopicName(UTF8 *topic_arg, size_t &nTopic)
     return topic;
 }
 
-static void ReportMatchedTopics(dbref executor, const UTF8 *topic, CHashTable *htab)
+// Walks the trie along the given bytes and returns the node reached, or
+// HELP_NONE if no topic name begins with them.
+//
+static INT32 WalkIndex(struct help_index *pIndex, const UTF8 *p, size_t n)
 {
-    bool matched = false;
-    UTF8 *topic_list = nullptr;
-    UTF8 *buffp = nullptr;
-    struct help_entry *htab_entry;
-    for (htab_entry = (struct help_entry *)hash_firstentry(htab);
-         htab_entry != nullptr;
-         htab_entry = (struct help_entry *)hash_nextentry(htab))
+    const struct help_node *aNodes = pIndex->aNodes;
+    UINT32 iNode = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        UINT32 ch = p[i];
+        UINT32 iChild = aNodes[iNode].iChild;
+        while (  0 != iChild
+              && aNodes[iChild].ch < ch)
+        {
+            pIndex->nProbes++;
+            iChild = aNodes[iChild].iSibling;
+        }
+        pIndex->nProbes++;
+        if (  0 == iChild
+           || aNodes[iChild].ch != ch)
+        {
+            return HELP_NONE;
+        }
+        iNode = iChild;
+    }
+    return static_cast<INT32>(iNode);
+}
+
+// Finds the topic for an exact name or an initial substring alias.
+//
+static const struct help_topic *FindTopic(int iHelpfile, const UTF8 *topic,
+    size_t nTopic)
+{
+    struct help_index *pIndex = mudstate.aHelpDesc[iHelpfile].pIndex;
+    if (  nullptr == pIndex
+       || 0 == nTopic)
+    {
+        return nullptr;
+    }
+
+    pIndex->nLookups++;
+    INT32 iNode = WalkIndex(pIndex, topic, nTopic);
+    if (HELP_NONE == iNode)
     {
+        return nullptr;
+    }
+
+    const struct help_node *pNode = &pIndex->aNodes[iNode];
+    INT32 iTopic = (HELP_NONE != pNode->iExact) ? pNode->iExact : pNode->iPrefix;
+    if (HELP_NONE == iTopic)
+    {
+        return nullptr;
+    }
+    pIndex->nHits++;
+    return &pIndex->aTopics[iTopic];
+}
+
+static void MatchSubtree(struct help_index *pIndex, UINT32 iNode,
+    const UTF8 *topic, UTF8 *topic_list, UTF8 **pbuffp, bool *pmatched)
+{
+    const struct help_node *pNode = &pIndex->aNodes[iNode];
+    if (HELP_NONE != pNode->iExact)
+    {
+        const UTF8 *key = pIndex->pKeys + pIndex->aTopics[pNode->iExact].iKey;
         mudstate.wild_invk_ctr = 0;
-        if (  htab_entry->key
-           && quick_wild(topic, htab_entry->key))
+        if (quick_wild(topic, key))
         {
-            if (!matched)
-            {
-                matched = true;
-                topic_list = alloc_lbuf("help_write");
-                buffp = topic_list;
-            }
-            safe_str(htab_entry->key, topic_list, &buffp);
-            safe_chr(' ', topic_list, &buffp);
-            safe_chr(' ', topic_list, &buffp);
+            *pmatched = true;
+            safe_str(key, topic_list, pbuffp);
+            safe_chr(' ', topic_list, pbuffp);
+            safe_chr(' ', topic_list, pbuffp);
+        }
+    }
+
+    for (UINT32 iChild = pNode->iChild; 0 != iChild;
+         iChild = pIndex->aNodes[iChild].iSibling)
+    {
+        pIndex->nProbes++;
+        MatchSubtree(pIndex, iChild, topic, topic_list, pbuffp, pmatched);
+    }
+}
+
+// Lists the topic names which match a wildcard pattern.  Only the subtree
+// under the literal part of the pattern needs to be visited, and the names
+// come out in sorted order.
+//
+static void ReportMatchedTopics(dbref executor, const UTF8 *topic, int iHelpfile)
+{
+    bool matched = false;
+    UTF8 *topic_list = alloc_lbuf("help_write");
+    UTF8 *buffp = topic_list;
+
+    struct help_index *pIndex = mudstate.aHelpDesc[iHelpfile].pIndex;
+    if (nullptr != pIndex)
+    {
+        size_t nLiteral = 0;
+        while (  '\0' != topic[nLiteral]
+              && '*'  != topic[nLiteral]
+              && '?'  != topic[nLiteral]
+              && '\\' != topic[nLiteral])
+        {
+            nLiteral++;
+        }
+
+        INT32 iNode = WalkIndex(pIndex, topic, nLiteral);
+        if (HELP_NONE != iNode)
+        {
+            MatchSubtree(pIndex, static_cast<UINT32>(iNode), topic, topic_list,
+                &buffp, &matched);
         }
     }
 
@@ -296,18 +824,33 @@ static void ReportMatchedTopics(dbref executor, const UTF8 *topic, CHashTable *h
         notify(executor, tprintf(T("Here are the entries which match \xE2\x80\x98%s\xE2\x80\x99:"), topic));
         *buffp = '\0';
         notify(executor, topic_list);
-        free_lbuf(topic_list);
+    }
+    free_lbuf(topic_list);
+}
+
+void helpindex_stats(int iHelpfile, HELP_INDEX_STATS *pStats)
+{
+    memset(pStats, 0, sizeof(HELP_INDEX_STATS));
+    struct help_index *pIndex = mudstate.aHelpDesc[iHelpfile].pIndex;
+    if (nullptr != pIndex)
+    {
+        pStats->nTopics  = pIndex->pHeader->nTopics;
+        pStats->nNodes   = pIndex->pHeader->nNodes;
+        pStats->nLongest = pIndex->nLongest;
+        pStats->nLookups = pIndex->nLookups;
+        pStats->nHits    = pIndex->nHits;
+        pStats->nProbes  = pIndex->nProbes;
     }
 }
 
-static bool ReportTopic(dbref executor, struct help_entry *htab_entry, int iHelpfile,
-    UTF8 *result)
+static bool ReportTopic(dbref executor, const struct help_topic *pTopic,
+    int iHelpfile, UTF8 *result)
 {
     UTF8 szTextFilename[SBUF_SIZE+8];
     mux_sprintf(szTextFilename, sizeof(szTextFilename), T("%s.txt"),
         mudstate.aHelpDesc[iHelpfile].pBaseFilename);
 
-    size_t offset = htab_entry->pos;
+    size_t offset = static_cast<size_t>(pTopic->pos);
     FILE *fp;
     if (!mux_fopen(&fp, szTextFilename, T("rb")))
     {
@@ -412,14 +955,11 @@ static void help_write(dbref executor, UTF8 *topic_arg, int iHelpfile)
     size_t nTopic;
     const UTF8 *topic = MakeCanonicalTopicName(topic_arg, nTopic);
 
-    CHashTable *htab = mudstate.aHelpDesc[iHelpfile].ht;
-    struct help_entry *htab_entry =
-        (struct help_entry *)hashfindLEN(topic, nTopic, htab);
-
-    if (htab_entry)
+    const struct help_topic *pTopic = FindTopic(iHelpfile, topic, nTopic);
+    if (pTopic)
     {
         UTF8 *result = alloc_lbuf("help_write");
-        if (ReportTopic(executor, htab_entry, iHelpfile, result))
+        if (ReportTopic(executor, pTopic, iHelpfile, result))
         {
             notify(executor, result);
         }
@@ -431,7 +971,7 @@ static void help_write(dbref executor, UTF8 *topic_arg, int iHelpfile)
     }
     else
     {
-        ReportMatchedTopics(executor, topic, htab);
+        ReportMatchedTopics(executor, topic, iHelpfile);
         return;
     }
 }
@@ -486,14 +1026,11 @@ void help_helper(dbref executor, int iHelpfile, UTF8 *topic_arg,
     size_t nTopic;
     const UTF8 *topic = MakeCanonicalTopicName(topic_arg, nTopic);
 
-    CHashTable *htab = mudstate.aHelpDesc[iHelpfile].ht;
-    struct help_entry *htab_entry =
-        (struct help_entry *)hashfindLEN(topic, nTopic, htab);
-
-    if (htab_entry)
+    const struct help_topic *pTopic = FindTopic(iHelpfile, topic, nTopic);
+    if (pTopic)
     {
         UTF8 *result = alloc_lbuf("help_helper");
-        if (ReportTopic(executor, htab_entry, iHelpfile, result))
+        if (ReportTopic(executor, pTopic, iHelpfile, result))
         {
             safe_str(result, buff, bufc);
         }
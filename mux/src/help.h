@@ -5,7 +5,18 @@
 
 #define  TOPIC_NAME_LEN     30
 
+typedef struct
+{
+    UINT32 nTopics;
+    UINT32 nNodes;
+    size_t nLongest;
+    INT64  nLookups;
+    INT64  nHits;
+    INT64  nProbes;
+} HELP_INDEX_STATS;
+
 void helpindex_clean(int);
 void helpindex_load(dbref);
 void helpindex_init(void);
+void helpindex_stats(int iHelpfile, HELP_INDEX_STATS *pStats);
 void help_helper(dbref executor, int iHelpfile, UTF8 *topic_arg, UTF8 *buff, UTF8 **bufc);
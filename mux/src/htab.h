@@ -42,12 +42,19 @@ struct bque
     UTF8    *text;                  // buffer for comm, env, and scr text
     UTF8    *comm;                  // command
     UTF8    *env[NUM_ENV_VARS];     // environment vars
-    reg_ref *scr[MAX_GLOBAL_REGS];  // temp vars
+    reg_frame *scr;                 // temp vars
 #if defined(STUB_SLAVE)
     CResultsSet *pResultsSet;       // Results Set
     int     iRow;                   // Current Row
 #endif // STUB_SLAVE
     bool    IsTimed;                // Is there a waittime time on this entry?
+    struct task_record *pTask;      // Scheduled task for this entry
+    dbref   share_owner;            // Owner charged for the share tag, or NOTHING
+    INT64   share_estimate;         // Estimated cost charged for the share tag
+    BQUE    *pExecNext;             // Entries for the same executor
+    BQUE    *pExecPrev;
+    BQUE    *pSemNext;              // Entries blocked on the same semaphore
+    BQUE    *pSemPrev;
 };
 
 class CBitField
@@ -57,6 +57,33 @@ typedef struct cmd_block
 } CBLK;
 
 #define TBLK_FLAG_LOCKED    0x01
+#define TBLK_FLAG_SHARED    0x02    // Refers to an SBLOCK and has no data.
+
+// A shared block holds text which has been rendered once and is queued on
+// several descriptors.  It is never modified, and it is freed when the last
+// TBLOCK referring to it is freed.
+//
+typedef struct shared_block SBLOCK;
+struct shared_block
+{
+    int      refcount;
+    size_t   nchars;
+    UTF8     data[1];
+};
+
+// What is sent for a message depends only on how the descriptor renders
+// color and on its character encoding.  A message for many descriptors is
+// rendered once for each of these output profiles that it reaches.
+//
+#define OUTPUT_COLOR_MODES  6
+#define OUTPUT_PROFILES     (OUTPUT_COLOR_MODES*5)
+
+typedef struct
+{
+    const UTF8       *text;
+    const mux_string *mtext;
+    SBLOCK           *rendered[OUTPUT_PROFILES];
+} SHARED_TEXT;
 
 typedef struct text_block TBLOCK;
 typedef struct text_block_hdr
@@ -66,6 +93,7 @@ typedef struct text_block_hdr
     UTF8    *end;
     size_t   nchars;
     int      flags;
+    SBLOCK  *shared;
 }   TBLOCKHDR;
 
 typedef struct text_block
@@ -78,7 +106,7 @@ typedef struct prog_data PROG;
 struct prog_data
 {
     dbref    wait_enactor;
-    reg_ref *wait_regs[MAX_GLOBAL_REGS];
+    reg_frame *wait_regs;
 };
 
 // Input state
@@ -158,6 +186,7 @@ struct descriptor_data
 
 #ifdef UNIX_SSL
   SSL *ssl_session;
+  bool ssl_worker;                // Encrypted by an SSL worker thread.
 #endif
 
 #if defined(WINDOWS_NETWORKING)
@@ -171,6 +200,10 @@ struct descriptor_data
   bool bCallProcessOutputLater;   // Does the socket need priming for output.
 #endif // WINDOWS_NETWORKING
 
+#if defined(UNIX_NETWORKING_EPOLL)
+  int poll_interest;              // NET_INTEREST_* registered with epoll.
+#endif // UNIX_NETWORKING_EPOLL
+
   CLinearTimeAbsolute connected_at;
   CLinearTimeAbsolute last_time;
 
@@ -284,11 +317,20 @@ extern void update_quotas(CLinearTimeAbsolute& tLast, const CLinearTimeAbsolute&
 extern void raw_notify(dbref, const UTF8 *);
 extern void raw_notify(dbref player, const mux_string &sMsg);
 extern void raw_notify_newline(dbref);
+extern void raw_notify_shared(dbref player, SHARED_TEXT *pst);
 extern void clearstrings(DESC *);
 extern void queue_write_LEN(DESC *, const UTF8 *, size_t n);
 extern void queue_write(DESC *, const UTF8 *);
 extern void queue_string(DESC *, const UTF8 *);
 extern void queue_string(DESC *d, const mux_string &s);
+extern void queue_write_shared(DESC *d, SBLOCK *sb);
+extern SBLOCK *sblock_create(const UTF8 *b, size_t n, size_t nSize);
+extern void sblock_release(SBLOCK *sb);
+extern void free_tblock(TBLOCK *tb);
+extern void shared_text_init(SHARED_TEXT *pst, const UTF8 *text);
+extern void shared_text_init(SHARED_TEXT *pst, const mux_string &text);
+extern void queue_shared_text(DESC *d, SHARED_TEXT *pst);
+extern void shared_text_free(SHARED_TEXT *pst);
 extern void freeqs(DESC *);
 extern void welcome_user(DESC *);
 extern void save_command(DESC *, CBLK *);
@@ -363,6 +405,12 @@ extern NAMETAB sigactions_nametab[];
 extern int maxd;
 #endif // UNIX_NETWORKING_SELECT
 
+#if defined(UNIX_NETWORKING_EPOLL)
+#define NET_INTEREST_READ  0x01
+#define NET_INTEREST_WRITE 0x02
+void net_update_interest(DESC *d);
+#endif // UNIX_NETWORKING_EPOLL
+
 extern long DebugTotalSockets;
 
 #if defined(WINDOWS_NETWORKING)
@@ -532,7 +532,7 @@ UTF8 *get_rlevel_desc
     int aflags;
     UTF8 *buff = alloc_lbuf("get_rlevel_desc.");
     UTF8 *bp = buff;;
-    reg_ref **preserve = nullptr;
+    reg_frame *preserve = nullptr;
     bool need_pres = false;
     bool bFirst = true;
 
@@ -549,8 +549,7 @@ UTF8 *get_rlevel_desc
             if (!need_pres)
             {
                 need_pres = true;
-                preserve = PushRegisters(MAX_GLOBAL_REGS);
-                save_global_regs(preserve);
+                preserve = save_global_regs();
             }
 
             mux_exec(d, LBUF_SIZE-1, buff, &bp, thing, thing, player,
@@ -579,8 +578,7 @@ UTF8 *get_rlevel_desc
             if (!need_pres)
             {
                 need_pres = true;
-                preserve = PushRegisters(MAX_GLOBAL_REGS);
-                save_global_regs(preserve);
+                preserve = save_global_regs();
             }
 
             mux_exec(d, LBUF_SIZE-1, buff, &bp, thing, thing, player,
@@ -598,7 +596,6 @@ UTF8 *get_rlevel_desc
     if (need_pres)
     {
         restore_global_regs(preserve);
-        PopRegisters(preserve, MAX_GLOBAL_REGS);
     }
 
     *bp = '\0';
@@ -635,7 +632,7 @@ void did_it_rlevel
     int i;
     bool found_a_desc;
 
-    reg_ref **preserve = nullptr;
+    reg_frame *preserve = nullptr;
     bool need_pres = false;
 
     // Message to player.
@@ -668,8 +665,7 @@ void did_it_rlevel
                 if (!need_pres)
                 {
                     need_pres = true;
-                    preserve = PushRegisters(MAX_GLOBAL_REGS);
-                    save_global_regs(preserve);
+                    preserve = save_global_regs();
                 }
                 buff = bp = alloc_lbuf("did_it.1");
                 mux_exec(d, LBUF_SIZE-1, buff, &bp, thing, thing, player,
@@ -707,8 +703,7 @@ void did_it_rlevel
                 if (!need_pres)
                 {
                     need_pres = true;
-                    preserve = PushRegisters(MAX_GLOBAL_REGS);
-                    save_global_regs(preserve);
+                    preserve = save_global_regs();
                 }
                 buff = bp = alloc_lbuf("did_it.1");
                 mux_exec(d, LBUF_SIZE-1, buff, &bp, thing, thing, player,
@@ -750,8 +745,7 @@ void did_it_rlevel
           if (!need_pres)
           {
              need_pres = true;
-             preserve = PushRegisters(MAX_GLOBAL_REGS);
-             save_global_regs(preserve);
+             preserve = save_global_regs();
           }
           buff = bp = alloc_lbuf("did_it.1");
           mux_exec(d, LBUF_SIZE-1, buff, &bp, thing, thing, player,
@@ -777,8 +771,7 @@ void did_it_rlevel
             if (!need_pres)
             {
                 need_pres = true;
-                preserve = PushRegisters(MAX_GLOBAL_REGS);
-                save_global_regs(preserve);
+                preserve = save_global_regs();
             }
             buff = bp = alloc_lbuf("did_it.2");
             mux_exec(d, LBUF_SIZE-1, buff, &bp, thing, thing, player,
@@ -835,7 +828,6 @@ void did_it_rlevel
     if (need_pres)
     {
         restore_global_regs(preserve);
-        PopRegisters(preserve, MAX_GLOBAL_REGS);
     }
 
     // Do the action attribute.
@@ -473,9 +473,8 @@ static void look_exits(dbref player, dbref loc, const UTF8 *exit_name)
         UTF8 *FormatOutput = alloc_lbuf("look_exits.FO");
         tPtr = FormatOutput;
 
-        reg_ref **preserve = nullptr;
-        preserve = PushRegisters(MAX_GLOBAL_REGS);
-        save_and_clear_global_regs(preserve);
+        reg_frame *preserve = nullptr;
+        preserve = save_and_clear_global_regs();
 
         mux_exec(ExitFormat, LBUF_SIZE-1, FormatOutput, &tPtr, loc, player, player,
             AttrTrace(aflags, EV_FCHECK|EV_EVAL|EV_TOP),
@@ -483,7 +482,6 @@ static void look_exits(dbref player, dbref loc, const UTF8 *exit_name)
         *tPtr = '\0';
 
         restore_global_regs(preserve);
-        PopRegisters(preserve, MAX_GLOBAL_REGS);
         notify(player, FormatOutput);
 
         free_lbuf(FormatOutput);
@@ -650,9 +648,8 @@ static void look_contents(dbref player, dbref loc, const UTF8 *contents_name, in
         const UTF8 *ParameterList[] =
             { VisibleObjectList, ContentsNameScratch };
 
-        reg_ref **preserve = nullptr;
-        preserve = PushRegisters(MAX_GLOBAL_REGS);
-        save_and_clear_global_regs(preserve);
+        reg_frame *preserve = nullptr;
+        preserve = save_and_clear_global_regs();
 
         mux_exec(ContentsFormat, LBUF_SIZE-1, FormatOutput, &tPtr, loc, player, player,
             AttrTrace(aflags, EV_FCHECK|EV_EVAL|EV_TOP),
@@ -660,7 +657,6 @@ static void look_contents(dbref player, dbref loc, const UTF8 *contents_name, in
         *tPtr = '\0';
 
         restore_global_regs(preserve);
-        PopRegisters(preserve, MAX_GLOBAL_REGS);
         notify(player, FormatOutput);
 
         free_lbuf(FormatOutput);
@@ -1021,9 +1017,8 @@ static bool show_a_desc(dbref player, dbref loc)
     UTF8 *DescFormat = atr_pget(loc, A_DESCFORMAT, &aowner1, &aflags1);
     if (*DescFormat)
     {
-        reg_ref **preserve = nullptr;
-        preserve = PushRegisters(MAX_GLOBAL_REGS);
-        save_global_regs(preserve);
+        reg_frame *preserve = nullptr;
+        preserve = save_global_regs();
 
         UTF8 *FormatOutput = alloc_lbuf("look_description.FO");
         UTF8 *tPtr = FormatOutput;
@@ -1073,7 +1068,6 @@ static bool show_a_desc(dbref player, dbref loc)
         free_lbuf(temp);
 
         restore_global_regs(preserve);
-        PopRegisters(preserve, MAX_GLOBAL_REGS);
 
         ret = true;
     }
@@ -1269,9 +1263,8 @@ void look_in(dbref player, dbref loc, int key)
         UTF8 *FormatOutput = alloc_lbuf("look_name.FO");
         UTF8 *tPtr = FormatOutput;
 
-        reg_ref **preserve = nullptr;
-        preserve = PushRegisters(MAX_GLOBAL_REGS);
-        save_and_clear_global_regs(preserve);
+        reg_frame *preserve = nullptr;
+        preserve = save_and_clear_global_regs();
 
         mux_exec(NameFormat, LBUF_SIZE-1, FormatOutput, &tPtr, loc, player, player,
             AttrTrace(aflags, EV_FCHECK|EV_EVAL|EV_TOP),
@@ -1279,7 +1272,6 @@ void look_in(dbref player, dbref loc, int key)
         *tPtr = '\0';
 
         restore_global_regs(preserve);
-        PopRegisters(preserve, MAX_GLOBAL_REGS);
         notify(player, FormatOutput);
 
         free_lbuf(FormatOutput);
@@ -2113,11 +2105,58 @@ void do_entrances(dbref executor, dbref caller, dbref enactor, int eval, int key
             mudconf.many_coins));
         return;
     }
+    // Entrances are found through the location, link, and parent indexes,
+    // and through the forwardlists that mention thing.
+    //
+    int nCandidates;
+    dbref *aCandidates = db_index_collect(thing,
+        IX_BIT(IX_LOCATION) | IX_BIT(IX_LINK) | IX_BIT(IX_PARENT),
+        low_bound, high_bound, &nCandidates);
+
+    int nForwarders = 0;
+    int nKey;
+    UTF8 *pKey;
+    for (fp = (FWDLIST *)hash_firstkey(&mudstate.fwdlist_htab, &nKey, &pKey);
+         nullptr != fp;
+         fp = (FWDLIST *)hash_nextkey(&mudstate.fwdlist_htab, &nKey, &pKey))
+    {
+        nForwarders++;
+    }
+    if (0 < nForwarders)
+    {
+        dbref *aMore = (dbref *)MEMALLOC((nCandidates + nForwarders + 1) * sizeof(dbref));
+        ISOUTOFMEMORY(aMore);
+        memcpy(aMore, aCandidates, nCandidates * sizeof(dbref));
+        MEMFREE(aCandidates);
+        aCandidates = aMore;
+
+        for (fp = (FWDLIST *)hash_firstkey(&mudstate.fwdlist_htab, &nKey, &pKey);
+             nullptr != fp;
+             fp = (FWDLIST *)hash_nextkey(&mudstate.fwdlist_htab, &nKey, &pKey))
+        {
+            memcpy(&i, pKey, sizeof(i));
+            if (  low_bound <= i
+               && i <= high_bound)
+            {
+                for (j = 0; j < fp->count; j++)
+                {
+                    if (fp->data[j] == thing)
+                    {
+                        aCandidates[nCandidates++] = i;
+                        break;
+                    }
+                }
+            }
+        }
+        nCandidates = db_sort_refs(aCandidates, nCandidates);
+    }
+
     message = alloc_lbuf("do_entrances");
     control_thing = Examinable(executor, thing);
     count = 0;
-    for (i = low_bound; i <= high_bound; i++)
+    for (int k = 0; k < nCandidates; k++)
     {
+        i = aCandidates[k];
         if (control_thing || Examinable(executor, i))
         {
             switch (Typeof(i))
@@ -2186,6 +2225,7 @@ void do_entrances(dbref executor, dbref caller, dbref enactor, int eval, int key
         }
     }
     free_lbuf(message);
+    MEMFREE(aCandidates);
     notify(executor, tprintf(T("%d entrance%s found."), count,
         (count == 1) ? "" : "s"));
 }
@@ -1113,6 +1113,18 @@ static bool mail_match(struct mail *mp, struct mail_selector ms, int num)
     return false;
 }
 
+// Narrows a walk over the messages in a folder to the message numbers
+// allowed by the selector.
+//
+static void folder_range(MailList &ml, int folder, const struct mail_selector &ms,
+    int *piLow, int *piHigh)
+{
+    int nItems = ml.FolderSize(folder);
+    *piLow  = (0 < ms.low) ? ms.low : 1;
+    *piHigh = (  0 < ms.high
+              && ms.high < nItems) ? ms.high : nItems;
+}
+
 // Adjust the flags of a set of messages.
 // If negate is true, clear the flag.
 static void do_mail_flags(dbref player, UTF8 *msglist, mail_flag flag, bool negate)
@@ -1139,11 +1151,11 @@ static void do_mail_flags(dbref player, UTF8 *msglist, mail_flag flag, bool nega
                 j++;
                 if (negate)
                 {
-                    mp->read &= ~flag;
+                    ml.SetFlags(mp, mp->read & ~flag);
                 }
                 else
                 {
-                    mp->read |= flag;
+                    ml.SetFlags(mp, mp->read | flag);
                 }
 
                 switch (flag)
@@ -1237,8 +1249,7 @@ static void do_mail_file(dbref player, UTF8 *msglist, UTF8 *folder)
 
                 // Clear the folder.
                 //
-                mp->read &= M_FMASK;
-                mp->read |= FolderBit(foldernum);
+                ml.SetFlags(mp, (mp->read & M_FMASK) | FolderBit(foldernum));
                 raw_notify(player, tprintf(T("MAIL: Msg %d filed in folder %d"), i,
                             foldernum));
             }
@@ -1501,56 +1512,56 @@ static void do_mail_read(dbref player, UTF8 *arg1, UTF8 *arg2)
     }
 
     UTF8 *status, *names;
-    int i = 0, j = 0;
+    int j = 0;
     UTF8 *buff = alloc_lbuf("do_mail_read.1");
 
+    // Only the messages within the selected range need to be visited.
+    //
     MailList ml(player);
-    struct mail *mp;
-    for (mp = ml.FirstItem(); !ml.IsEnd(); mp = ml.NextItem())
+    int iLow, iHigh;
+    folder_range(ml, folder, ms, &iLow, &iHigh);
+    for (int i = iLow; i <= iHigh; i++)
     {
-        if (Folder(mp) == folder)
+        struct mail *mp = ml.FolderItem(folder, i);
+        if (mail_match(mp, ms, i))
         {
-            i++;
-            if (mail_match(mp, ms, i))
-            {
-                // Read it.
-                //
-                j++;
-
-                UTF8 *bp = buff;
-                safe_str(MessageFetch(mp->number), buff, &bp);
-                *bp = '\0';
-
-                raw_notify(player, (UTF8 *)DASH_LINE);
-                status = status_string(mp);
-                names = make_namelist(player, mp->tolist);
+            // Read it.
+            //
+            j++;
 
-                UTF8 szFromName[MBUF_SIZE];
-                trimmed_name(mp->from, szFromName, 16, 16, 0);
+            UTF8 *bp = buff;
+            safe_str(MessageFetch(mp->number), buff, &bp);
+            *bp = '\0';
 
-                UTF8 szSubjectBuffer[MBUF_SIZE];
-                StripTabsAndTruncate(mp->subject, szSubjectBuffer, MBUF_SIZE-1, 65);
-
-                raw_notify(player, tprintf(T("%-3d         From:  %s  At: %-25s  %s\r\nFldr   : %-2d Status: %s\r\nTo     : %-65s\r\nSubject: %s"),
-                               i, szFromName,
-                               mp->time,
-                               (Connected(mp->from) &&
-                               (!Hidden(mp->from) || See_Hidden(player))) ?
-                               " (Conn)" : "      ", folder,
-                               status,
-                               names,
-                               szSubjectBuffer));
-                free_lbuf(names);
-                free_lbuf(status);
-                raw_notify(player, (UTF8 *)DASH_LINE);
-                raw_notify(player, buff);
-                raw_notify(player, (UTF8 *)DASH_LINE);
-                if (Unread(mp))
-                {
-                    // Mark message as read.
-                    //
-                    mp->read |= M_ISREAD;
-                }
+            raw_notify(player, (UTF8 *)DASH_LINE);
+            status = status_string(mp);
+            names = make_namelist(player, mp->tolist);
+
+            UTF8 szFromName[MBUF_SIZE];
+            trimmed_name(mp->from, szFromName, 16, 16, 0);
+
+            UTF8 szSubjectBuffer[MBUF_SIZE];
+            StripTabsAndTruncate(mp->subject, szSubjectBuffer, MBUF_SIZE-1, 65);
+
+            raw_notify(player, tprintf(T("%-3d         From:  %s  At: %-25s  %s\r\nFldr   : %-2d Status: %s\r\nTo     : %-65s\r\nSubject: %s"),
+                           i, szFromName,
+                           mp->time,
+                           (Connected(mp->from) &&
+                           (!Hidden(mp->from) || See_Hidden(player))) ?
+                           " (Conn)" : "      ", folder,
+                           status,
+                           names,
+                           szSubjectBuffer));
+            free_lbuf(names);
+            free_lbuf(status);
+            raw_notify(player, (UTF8 *)DASH_LINE);
+            raw_notify(player, buff);
+            raw_notify(player, (UTF8 *)DASH_LINE);
+            if (Unread(mp))
+            {
+                // Mark message as read.
+                //
+                ml.SetFlags(mp, mp->read | M_ISREAD);
             }
         }
     }
@@ -1760,42 +1771,39 @@ static void do_mail_list(dbref player, UTF8 *arg1, UTF8 *arg2, bool sub)
     {
         return;
     }
-    int i = 0;
     UTF8 *time;
     UTF8 szSubjectBuffer[MBUF_SIZE];
 
     raw_notify(player, tprintf(T(FOLDER_LINE), folder));
 
     MailList ml(player);
-    struct mail *mp;
-    for (mp = ml.FirstItem(); !ml.IsEnd(); mp = ml.NextItem())
+    int iLow, iHigh;
+    folder_range(ml, folder, ms, &iLow, &iHigh);
+    for (int i = iLow; i <= iHigh; i++)
     {
-        if (Folder(mp) == folder)
+        struct mail *mp = ml.FolderItem(folder, i);
+        if (mail_match(mp, ms, i))
         {
-            i++;
-            if (mail_match(mp, ms, i))
-            {
-                time = mail_list_time(mp->time);
-                size_t nSize = MessageFetchSize(mp->number);
+            time = mail_list_time(mp->time);
+            size_t nSize = MessageFetchSize(mp->number);
 
-                UTF8 szFromName[MBUF_SIZE];
-                trimmed_name(mp->from, szFromName, 16, 16, 0);
+            UTF8 szFromName[MBUF_SIZE];
+            trimmed_name(mp->from, szFromName, 16, 16, 0);
 
-                if (sub)
-                {
-                    StripTabsAndTruncate(mp->subject, szSubjectBuffer, MBUF_SIZE-1, 25);
+            if (sub)
+            {
+                StripTabsAndTruncate(mp->subject, szSubjectBuffer, MBUF_SIZE-1, 25);
 
-                    raw_notify(player, tprintf(T("[%s] %-3d (%4d) From: %s Sub: %s"),
-                        status_chars(mp), i, nSize, szFromName, szSubjectBuffer));
-                }
-                else
-                {
-                    raw_notify(player, tprintf(T("[%s] %-3d (%4d) From: %s At: %s %s"),
-                        status_chars(mp), i, nSize, szFromName, time,
-                            ((Connected(mp->from) && (!Hidden(mp->from) || See_Hidden(player))) ? "Conn" : " ")));
-                }
-                free_lbuf(time);
+                raw_notify(player, tprintf(T("[%s] %-3d (%4d) From: %s Sub: %s"),
+                    status_chars(mp), i, nSize, szFromName, szSubjectBuffer));
+            }
+            else
+            {
+                raw_notify(player, tprintf(T("[%s] %-3d (%4d) From: %s At: %s %s"),
+                    status_chars(mp), i, nSize, szFromName, time,
+                        ((Connected(mp->from) && (!Hidden(mp->from) || See_Hidden(player))) ? "Conn" : " ")));
             }
+            free_lbuf(time);
         }
     }
     raw_notify(player, (UTF8 *)DASH_LINE);
@@ -2148,21 +2156,8 @@ static void do_mail_reply(dbref player, UTF8 *msg, bool all, int key)
  *-------------------------------------------------------------------------*/
 struct mail *mail_fetch(dbref player, int num)
 {
-    int i = 0;
     MailList ml(player);
-    struct mail *mp;
-    for (mp = ml.FirstItem(); !ml.IsEnd(); mp = ml.NextItem())
-    {
-        if (Folder(mp) == player_folder(player))
-        {
-            i++;
-            if (i == num)
-            {
-                return mp;
-            }
-        }
-    }
-    return nullptr;
+    return ml.FolderItem(player_folder(player), num);
 }
 
 const UTF8 *mail_fetch_message(dbref player, int num)
@@ -2189,53 +2184,16 @@ int mail_fetch_from(dbref player, int num)
 //
 void count_mail(dbref player, int folder, int *rcount, int *ucount, int *ccount)
 {
-    int rc = 0;
-    int uc = 0;
-    int cc = 0;
-
+    int gc;
     MailList ml(player);
-    struct mail *mp;
-    for (mp = ml.FirstItem(); !ml.IsEnd(); mp = ml.NextItem())
-    {
-        if (Folder(mp) == folder)
-        {
-            if (Read(mp))
-            {
-                rc++;
-            }
-            else
-            {
-                uc++;
-            }
-
-            if (Cleared(mp))
-            {
-                cc++;
-            }
-        }
-    }
-    *rcount = rc;
-    *ucount = uc;
-    *ccount = cc;
+    ml.CountFolder(folder, rcount, ucount, ccount, &gc);
 }
 
 static void urgent_mail(dbref player, int folder, int *ucount)
 {
-    int uc = 0;
-
+    int rc, uc, cc;
     MailList ml(player);
-    struct mail *mp;
-    for (mp = ml.FirstItem(); !ml.IsEnd(); mp = ml.NextItem())
-    {
-        if (Folder(mp) == folder)
-        {
-            if (Unread(mp) && Urgent(mp))
-            {
-                uc++;
-            }
-        }
-    }
-    *ucount = uc;
+    ml.CountFolder(folder, &rc, &uc, &cc, ucount);
 }
 
 static void mail_return(dbref player, dbref target)
@@ -4972,9 +4930,78 @@ void do_mail
     }
 }
 
+struct mail_box *MailList::Box(void)
+{
+    return (struct mail_box *)hashfindLEN(&m_player, sizeof(m_player), &mudstate.mail_htab);
+}
+
+// Adds (iDelta == 1) or removes (iDelta == -1) a message from the counts
+// of its folder.
+//
+void MailList::CountItem(struct mail *mp, int iDelta)
+{
+    struct mail_folder *pf = &m_pBox->aFolders[Folder(mp)];
+    if (Read(mp))
+    {
+        pf->nRead += iDelta;
+    }
+    else
+    {
+        pf->nUnread += iDelta;
+        if (Urgent(mp))
+        {
+            pf->nUrgent += iDelta;
+        }
+    }
+
+    if (Cleared(mp))
+    {
+        pf->nCleared += iDelta;
+    }
+}
+
+// Returns the folder with its message array current.
+//
+struct mail_folder *MailList::IndexFolder(int folder)
+{
+    struct mail_folder *pf = &m_pBox->aFolders[folder];
+    if (pf->bIndexed)
+    {
+        return pf;
+    }
+
+    int nItems = pf->nRead + pf->nUnread;
+    if (pf->nAlloc < nItems)
+    {
+        if (nullptr != pf->aItems)
+        {
+            MEMFREE(pf->aItems);
+        }
+        pf->aItems = (struct mail **)MEMALLOC(nItems * sizeof(struct mail *));
+        ISOUTOFMEMORY(pf->aItems);
+        pf->nAlloc = nItems;
+    }
+
+    pf->nItems = 0;
+    struct mail *mp = m_pBox->head;
+    do
+    {
+        if (Folder(mp) == folder)
+        {
+            pf->aItems[pf->nItems++] = mp;
+        }
+        mp = mp->next;
+    } while (mp != m_pBox->head);
+
+    mux_assert(pf->nItems == nItems);
+    pf->bIndexed = true;
+    return pf;
+}
+
 struct mail *MailList::FirstItem(void)
 {
-    m_miHead = (struct mail *)hashfindLEN(&m_player, sizeof(m_player), &mudstate.mail_htab);
+    m_pBox = Box();
+    m_miHead = (nullptr == m_pBox) ? nullptr : m_pBox->head;
     m_mi = m_miHead;
     m_bRemoved = false;
     return m_mi;
@@ -5006,30 +5033,51 @@ MailList::MailList(dbref player)
 {
     m_mi       = nullptr;
     m_miHead   = nullptr;
+    m_pBox     = nullptr;
     m_player   = player;
     m_bRemoved = false;
 }
 
+static void FreeMailBox(struct mail_box *pBox)
+{
+    for (int i = 0; i <= MAX_FOLDERS; i++)
+    {
+        if (nullptr != pBox->aFolders[i].aItems)
+        {
+            MEMFREE(pBox->aFolders[i].aItems);
+            pBox->aFolders[i].aItems = nullptr;
+        }
+    }
+    delete pBox;
+}
+
 void MailList::RemoveItem(void)
 {
     if (  nullptr == m_mi
-       || NOTHING == m_player)
+       || NOTHING == m_player
+       || nullptr == m_pBox)
     {
         return;
     }
 
     struct mail *miNext = m_mi->next;
 
+    CountItem(m_mi, -1);
+    m_pBox->nMessages--;
+    m_pBox->aFolders[Folder(m_mi)].bIndexed = false;
+
     if (m_mi == m_miHead)
     {
         if (miNext == m_miHead)
         {
             hashdeleteLEN(&m_player, sizeof(m_player), &mudstate.mail_htab);
-            miNext   = nullptr;
+            FreeMailBox(m_pBox);
+            m_pBox = nullptr;
+            miNext = nullptr;
         }
         else
         {
-            hashreplLEN(&m_player, sizeof(m_player), miNext, &mudstate.mail_htab);
+            m_pBox->head = miNext;
         }
         m_miHead = miNext;
     }
@@ -5056,13 +5104,12 @@ void MailList::RemoveItem(void)
 
 void MailList::AppendItem(struct mail *miNew)
 {
-    struct mail *miHead = (struct mail *)
-        hashfindLEN(&m_player, sizeof(m_player), &mudstate.mail_htab);
-
-    if (miHead)
+    m_pBox = Box();
+    if (m_pBox)
     {
         // Add new item to the end of the list.
         //
+        struct mail *miHead = m_pBox->head;
         struct mail *miEnd = miHead->prev;
 
         miNew->next = miHead;
@@ -5073,22 +5120,60 @@ void MailList::AppendItem(struct mail *miNew)
     }
     else
     {
-        hashaddLEN(&m_player, sizeof(m_player), miNew, &mudstate.mail_htab);
+        try
+        {
+            m_pBox = new struct mail_box;
+        }
+        catch (...)
+        {
+            ; // Nothing.
+        }
+        ISOUTOFMEMORY(m_pBox);
+        memset(m_pBox, 0, sizeof(struct mail_box));
+        for (int i = 0; i <= MAX_FOLDERS; i++)
+        {
+            m_pBox->aFolders[i].bIndexed = true;
+        }
+
+        m_pBox->head = miNew;
+        hashaddLEN(&m_player, sizeof(m_player), m_pBox, &mudstate.mail_htab);
         miNew->next = miNew;
         miNew->prev = miNew;
     }
+
+    CountItem(miNew, 1);
+    m_pBox->nMessages++;
+
+    // The new message is last in the list, so it is also last in its
+    // folder.
+    //
+    struct mail_folder *pf = &m_pBox->aFolders[Folder(miNew)];
+    if (pf->bIndexed)
+    {
+        if (pf->nItems == pf->nAlloc)
+        {
+            int nAlloc = (0 == pf->nAlloc) ? 16 : 2*pf->nAlloc;
+            struct mail **aItems = (struct mail **)MEMREALLOC(pf->aItems,
+                nAlloc * sizeof(struct mail *));
+            ISOUTOFMEMORY(aItems);
+            pf->aItems = aItems;
+            pf->nAlloc = nAlloc;
+        }
+        pf->aItems[pf->nItems++] = miNew;
+    }
 }
 
 void MailList::RemoveAll(void)
 {
-    struct mail *miHead = (struct mail *)
-        hashfindLEN(&m_player, sizeof(m_player), &mudstate.mail_htab);
-
-    if (nullptr != miHead)
+    struct mail_box *pBox = Box();
+    if (nullptr == pBox)
     {
-        hashdeleteLEN(&m_player, sizeof(m_player), &mudstate.mail_htab);
+        m_mi = nullptr;
+        return;
     }
+    hashdeleteLEN(&m_player, sizeof(m_player), &mudstate.mail_htab);
 
+    struct mail *miHead = pBox->head;
     struct mail *mi;
     struct mail *miNext;
     for (mi = miHead; nullptr != mi; mi = miNext)
@@ -5107,9 +5192,83 @@ void MailList::RemoveAll(void)
         mi->time = nullptr;
         delete mi;
     }
+    FreeMailBox(pBox);
+    m_pBox = nullptr;
     m_mi = nullptr;
 }
 
+// Changes the flags of a message in this list, keeping the folder counts
+// and arrays current.
+//
+void MailList::SetFlags(struct mail *mp, int read)
+{
+    m_pBox = Box();
+    if (nullptr == m_pBox)
+    {
+        mp->read = read;
+        return;
+    }
+
+    int fOld = Folder(mp);
+    CountItem(mp, -1);
+    mp->read = read;
+    CountItem(mp, 1);
+    if (Folder(mp) != fOld)
+    {
+        m_pBox->aFolders[fOld].bIndexed = false;
+        m_pBox->aFolders[Folder(mp)].bIndexed = false;
+    }
+}
+
+int MailList::CountAll(void)
+{
+    m_pBox = Box();
+    return (nullptr == m_pBox) ? 0 : m_pBox->nMessages;
+}
+
+void MailList::CountFolder(int folder, int *rcount, int *ucount, int *ccount,
+    int *gcount)
+{
+    m_pBox = Box();
+    if (  nullptr == m_pBox
+       || folder < 0
+       || MAX_FOLDERS < folder)
+    {
+        *rcount = *ucount = *ccount = *gcount = 0;
+        return;
+    }
+
+    struct mail_folder *pf = &m_pBox->aFolders[folder];
+    *rcount = pf->nRead;
+    *ucount = pf->nUnread;
+    *ccount = pf->nCleared;
+    *gcount = pf->nUrgent;
+}
+
+int MailList::FolderSize(int folder)
+{
+    m_pBox = Box();
+    if (  nullptr == m_pBox
+       || folder < 0
+       || MAX_FOLDERS < folder)
+    {
+        return 0;
+    }
+    return m_pBox->aFolders[folder].nRead + m_pBox->aFolders[folder].nUnread;
+}
+
+// Returns the num'th (1-based) message in a folder.
+//
+struct mail *MailList::FolderItem(int folder, int num)
+{
+    if (  num < 1
+       || FolderSize(folder) < num)
+    {
+        return nullptr;
+    }
+    return IndexFolder(folder)->aItems[num-1];
+}
+
 static void ListMailInFolderNumber(dbref player, int folder_num, UTF8 *msglist)
 {
     int original_folder = player_folder(player);
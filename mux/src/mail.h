@@ -87,13 +87,44 @@ struct mail_body
     int    m_nRefs;
 };
 
+// Each player's messages are kept in a circular list in arrival order.  The
+// mailbox stored in mail_htab also keeps per-folder counts, which are
+// updated as messages are added, removed, or change flags, and per-folder
+// arrays of the messages in list order, which are rebuilt on demand after a
+// message leaves the folder.
+//
+struct mail_folder
+{
+    struct mail **aItems;
+    int           nAlloc;
+    int           nItems;
+    bool          bIndexed;
+
+    int           nRead;
+    int           nUnread;
+    int           nCleared;
+    int           nUrgent;   // Unread and urgent.
+};
+
+struct mail_box
+{
+    struct mail       *head;
+    int                nMessages;
+    struct mail_folder aFolders[MAX_FOLDERS+1];
+};
+
 class MailList
 {
 private:
-    struct mail *m_miHead;
-    struct mail *m_mi;
-    dbref        m_player;
-    bool         m_bRemoved;
+    struct mail     *m_miHead;
+    struct mail     *m_mi;
+    struct mail_box *m_pBox;
+    dbref            m_player;
+    bool             m_bRemoved;
+
+    struct mail_box *Box(void);
+    void CountItem(struct mail *mp, int iDelta);
+    struct mail_folder *IndexFolder(int folder);
 
 public:
     MailList(dbref player);
@@ -103,6 +134,12 @@ public:
     void RemoveItem(void);
     void RemoveAll(void);
     void AppendItem(struct mail *newp);
+
+    void SetFlags(struct mail *mp, int read);
+    int  CountAll(void);
+    void CountFolder(int folder, int *rcount, int *ucount, int *ccount, int *gcount);
+    int  FolderSize(int folder);
+    struct mail *FolderItem(int folder, int num);
 };
 
 #endif // !_MAIL_H
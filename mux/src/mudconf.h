@@ -9,6 +9,7 @@
 #include "alloc.h"
 #include "htab.h"
 #include "utf8tables.h"
+#include "asciiscan.h"
 #include "stringutil.h"
 
 #define WIDTHOF_DOING_STRING 45
@@ -25,7 +26,7 @@ typedef struct tag_int_array
 typedef struct
 {
     const UTF8 *CommandName;
-    CHashTable *ht;
+    struct help_index *pIndex;
     UTF8       *pBaseFilename;
     bool       bEval;
 } HELP_DESC;
@@ -34,8 +35,11 @@ typedef struct confdata CONFDATA;
 struct confdata
 {
     bool    autozone;           // New objects are automatically zoned.
+    bool    binary_database;    // Write the structure database in binary.
     bool    cache_names;        /* Should object names be cached separately */
+    bool    cache_mmap;         // Map the attribute database instead of caching pages.
     bool    clone_copy_cost;    /* Does @clone copy value? */
+    bool    color_quantize;     // Down-convert client colors from a table.
     bool    compress_db;        // should we use compress.
     bool    dark_sleepers;      /* Are sleeping players 'dark'? */
     bool    destroy_going_now;  // Does GOING act like DESTROY_OK?
@@ -57,6 +61,7 @@ struct confdata
     bool    pemit_players;      /* Can you @pemit to faraway players? */
     bool    player_listen;      /* Are AxHEAR triggered on players? */
     bool    pub_flags;          /* true = flags() works on anything */
+    bool    queue_fair_share;   /* Share queue CPU fairly between owners */
     bool    quiet_look;         /* true = don't see attribs when looking */
     bool    quiet_whisper;      /* Can others tell when you whisper? */
     bool    quotas;             /* true = have building quotas */
@@ -106,6 +111,7 @@ struct confdata
     int     digcost;            /* cost of @dig command */
     int     dump_interval;      /* interval between ckp dumps in seconds */
     int     dump_offset;        /* when to take first checkpoint dump */
+    int     dump_slice;         // msec per slice of an in-process dump.
     int     events_daily_hour;  /* At what hour should @daily be executed? */
     int     exit_quota;         /* quota needed to make an exit */
     int     func_invk_lim;      /* Max funcs invoked by a command */
@@ -172,6 +178,7 @@ struct confdata
     int     sacadjust;          /* sacrifice earns (obj_cost/sfactor) + sadj */
     int     sacfactor;          /* ... */
     int     searchcost;         /* cost of commands that search the whole DB */
+    int     search_slice;       // msec per slice of an @search eval class.
     int     sig_action;         // What to do with fatal signals.
     int     stack_limit;        /* How big can stacks get? */
     int     start_quota;        /* Quota for new players */
@@ -197,6 +204,7 @@ struct confdata
     UTF8    ssl_certificate_file[128];      // SSL certificate file (.pem format)
     UTF8    ssl_certificate_key[128];       // SSL certificate private key file (.pem format)
     UTF8    ssl_certificate_password[128];  // SSL certificate private key password
+    int     ssl_threads;                    // Number of SSL worker threads.
 #endif
 
     UTF8    guest_prefix[32];   /* Prefix for the guest char's name */
@@ -503,7 +511,7 @@ struct statedata
     UTF8    *poutnew;           /* The output being build by the current command */
     UTF8    *itext[MAX_ITEXT];  // Text of iter(). Equivalent to ##.
 
-    reg_ref *global_regs[MAX_GLOBAL_REGS];  /* Global registers */
+    reg_frame *global_regs;     // Global registers, shared copy-on-write.
     ALIST   iter_alist;         /* Attribute list for iterations */
     BADNAME *badname_head;      /* List of disallowed names */
     HELP_DESC *aHelpDesc;       // Table of help files hashes.
@@ -535,17 +543,23 @@ struct statedata
 #endif // MEMORY_BASED
     CHashTable attr_name_htab;  /* Attribute names hashtable */
     CHashTable channel_htab;    /* Channels hashtable */
+    CHashTable cmdtab_htab;     /* Compiled $-commands and ^-listens */
     CHashTable command_htab;    /* Commands hashtable */
     CHashTable desc_htab;       /* Socket descriptor hashtable */
     CHashTable flags_htab;      /* Flags hashtable */
     CHashTable func_htab;       /* Functions hashtable */
     CHashTable fwdlist_htab;    /* Room forwardlists */
+    CHashTable lock_htab;       /* Compiled locks */
     CHashTable logout_cmd_htab; /* Logged-out commands hashtable (WHO, etc) */
     CHashTable mail_htab;       /* Mail players hashtable */
     CHashTable parent_htab;     /* Parent $-command exclusion */
     CHashTable player_htab;     /* Player name->number hashtable */
     CHashTable powers_htab;     /* Powers hashtable */
+    CHashTable queue_htab;      /* Queue entries by executor */
+    CHashTable share_htab;      /* Queue CPU shares by owner */
     CHashTable reference_htab;  /* @reference hashtable */
+    CHashTable regexp_htab;     /* Compiled regular expressions */
+    CHashTable semaphore_htab;  /* Queue entries by semaphore */
     CHashTable ufunc_htab;      /* Local functions hashtable */
     CHashTable vattr_name_htab; /* User attribute names hashtable */
     CHashTable scratch_htab;    /* Multi-purpose scratch hash table */
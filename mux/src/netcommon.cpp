@@ -221,6 +221,43 @@ void raw_notify(dbref player, const mux_string &sMsg)
     }
 }
 
+/*! \brief Send a line of shared text to every connection of a player.
+ *
+ * This is raw_notify() for a message going to many players at once.
+ *
+ * \param player    Player to notify.
+ * \param pst       Shared text state.
+ * \return          None.
+ */
+
+void raw_notify_shared(dbref player, SHARED_TEXT *pst)
+{
+    if (  mudstate.inpipe
+       && player == mudstate.poutobj)
+    {
+        if (nullptr == pst->mtext)
+        {
+            raw_notify(player, pst->text);
+        }
+        else
+        {
+            raw_notify(player, *pst->mtext);
+        }
+        return;
+    }
+
+    if (!Connected(player))
+    {
+        return;
+    }
+
+    DESC *d;
+    DESC_ITER_PLAYER(player, d)
+    {
+        queue_shared_text(d, pst);
+    }
+}
+
 void raw_notify_newline(dbref player)
 {
     if (  mudstate.inpipe
@@ -259,16 +296,22 @@ void DCL_CDECL raw_broadcast(int inflags, __in_z const UTF8 *fmt, ...)
     mux_vsnprintf(buff, LBUF_SIZE, fmt, ap);
     va_end(ap);
 
+    // Each rendering of the message is built once and shared by every
+    // descriptor which wants it rendered that way.
+    //
+    SHARED_TEXT st;
+    shared_text_init(&st, buff);
+
     DESC *d;
     DESC_ITER_CONN(d)
     {
         if ((Flags(d->player) & inflags) == inflags)
         {
-            queue_string(d, buff);
-            queue_write_LEN(d, T("\r\n"), 2);
+            queue_shared_text(d, &st);
             process_output(d, false);
         }
     }
+    shared_text_free(&st);
 }
 
 /* ---------------------------------------------------------------------------
@@ -322,9 +365,13 @@ static void add_to_output_queue(DESC *d, const UTF8 *b, size_t n)
             tp->hdr.end = tp->data;
             tp->hdr.nchars = 0;
             tp->hdr.flags = 0;
+            tp->hdr.shared = nullptr;
 
             d->output_head = tp;
             d->output_tail = tp;
+#if defined(UNIX_NETWORKING_EPOLL)
+            net_update_interest(d);
+#endif // UNIX_NETWORKING_EPOLL
         }
         else
         {
@@ -345,9 +392,18 @@ static void add_to_output_queue(DESC *d, const UTF8 *b, size_t n)
         // string.  If so, copy it and update the pointers.
         //
         // We cannot update a buffer marked TBLK_FLAG_LOCKED.  If fact, we
-        // should not read or write to such a buffer in any fashion.
+        // should not read or write to such a buffer in any fashion.  A
+        // TBLK_FLAG_SHARED block has no room of its own.
         //
-        left = OUTPUT_BLOCK_SIZE - (tp->hdr.end - (UTF8 *)tp + 1);
+        if (tp->hdr.flags & TBLK_FLAG_SHARED)
+        {
+            left = 0;
+        }
+        else
+        {
+            left = OUTPUT_BLOCK_SIZE - (tp->hdr.end - (UTF8 *)tp + 1);
+        }
+
         if (  n <= left
            && 0 == (tp->hdr.flags & TBLK_FLAG_LOCKED))
         {
@@ -379,6 +435,7 @@ static void add_to_output_queue(DESC *d, const UTF8 *b, size_t n)
                 tp->hdr.end = tp->data;
                 tp->hdr.nchars = 0;
                 tp->hdr.flags = 0;
+                tp->hdr.shared = nullptr;
 
                 d->output_tail->hdr.nxt = tp;
                 d->output_tail = tp;
@@ -392,33 +449,11 @@ static void add_to_output_queue(DESC *d, const UTF8 *b, size_t n)
     } while (n > 0);
 }
 
-/*! \brief Add text to the output queue of the indicated network descriptor.
- *
- * This is the network output interface available to the rest of the server.
- * Above this point, we would typically find the Telnet negotiation, encoding,
- * and parsing layer.  Below this point, there exists only input and output
- * byte streams which may or may not use multi-threaded access to the network,
- * may or may not use SSL, and must be resilient to platform interface
- * concerns, abuse from the network, and the mis-match in flow rates between
- * inside and outside.
- *
- * Since the network layer is necessarily dealing intimately with the outside,
- * it necessarily has some hysteresis built into it so that on average, it's
- * attention is spent on useful things, and postponable things are postponed.
- *
- * \param d         Network descriptor state.
- * \param b         buffer to add to the output queue.
- * \param n         Number of bytes in buffer, b, to add to the output queue.
- * \return          None.
- */
-
-void queue_write_LEN(DESC *d, const UTF8 *b, size_t n)
+// Make room in the output queue for another n bytes, throwing away the
+// oldest output if the queue would exceed output_limit.
+//
+static void trim_output_queue(DESC *d, size_t n)
 {
-    if (0 == n)
-    {
-        return;
-    }
-
     // If the output queue has grown enough that it needs to be chopped, spend
     // some time attempting to push at least some of it out. It may be that
     // writes are already flowing out to the network, but we check anyway.
@@ -492,18 +527,17 @@ void queue_write_LEN(DESC *d, const UTF8 *b, size_t n)
                 {
                     d->output_tail = nullptr;
                 }
-                MEMFREE(tp);
+                free_tblock(tp);
                 tp = nullptr;
             }
         }
     }
+}
 
-    // Append the request to the end of the output queue for later transmission.
-    //
-    add_to_output_queue(d, b, n);
-    d->output_size += n;
-    d->output_tot += n;
-
+// Called after output has been appended to the queue.
+//
+static void kick_output_queue(DESC *d)
+{
 #if defined(WINDOWS_NETWORKING)
     // As part of the heuristics for good performance, we may not call
     // process_output now, but if output is not flowing, we mark that output
@@ -516,9 +550,99 @@ void queue_write_LEN(DESC *d, const UTF8 *b, size_t n)
     {
         d->bCallProcessOutputLater = true;
     }
+#else // WINDOWS_NETWORKING
+    UNUSED_PARAMETER(d);
 #endif // WINDOWS_NETWORKING
 }
 
+/*! \brief Add text to the output queue of the indicated network descriptor.
+ *
+ * This is the network output interface available to the rest of the server.
+ * Above this point, we would typically find the Telnet negotiation, encoding,
+ * and parsing layer.  Below this point, there exists only input and output
+ * byte streams which may or may not use multi-threaded access to the network,
+ * may or may not use SSL, and must be resilient to platform interface
+ * concerns, abuse from the network, and the mis-match in flow rates between
+ * inside and outside.
+ *
+ * Since the network layer is necessarily dealing intimately with the outside,
+ * it necessarily has some hysteresis built into it so that on average, it's
+ * attention is spent on useful things, and postponable things are postponed.
+ *
+ * \param d         Network descriptor state.
+ * \param b         buffer to add to the output queue.
+ * \param n         Number of bytes in buffer, b, to add to the output queue.
+ * \return          None.
+ */
+
+void queue_write_LEN(DESC *d, const UTF8 *b, size_t n)
+{
+    if (0 == n)
+    {
+        return;
+    }
+
+    trim_output_queue(d, n);
+
+    // Append the request to the end of the output queue for later transmission.
+    //
+    add_to_output_queue(d, b, n);
+    d->output_size += n;
+    d->output_tot += n;
+    kick_output_queue(d);
+}
+
+/*! \brief Queue a shared block on the indicated network descriptor.
+ *
+ * Large blocks are queued by reference, so a message queued on many
+ * descriptors is held in memory once.  Small blocks are cheaper to copy.
+ * Either way, the descriptor is charged for the full length against its
+ * output_limit because it must still send all of it.
+ *
+ * \param d         Network descriptor state.
+ * \param sb        Shared block to queue.
+ * \return          None.
+ */
+
+void queue_write_shared(DESC *d, SBLOCK *sb)
+{
+    const size_t n = sb->nchars;
+    if (n < SBLOCK_SHARE_MIN)
+    {
+        queue_write_LEN(d, sb->data, n);
+        return;
+    }
+
+    trim_output_queue(d, n);
+
+    TBLOCK *tp = (TBLOCK *)MEMALLOC(sizeof(TBLOCKHDR));
+    ISOUTOFMEMORY(tp);
+    tp->hdr.nxt = nullptr;
+    tp->hdr.start = sb->data;
+    tp->hdr.end = sb->data + n;
+    tp->hdr.nchars = n;
+    tp->hdr.flags = TBLK_FLAG_SHARED;
+    tp->hdr.shared = sb;
+    sb->refcount++;
+
+    if (nullptr == d->output_head)
+    {
+        d->output_head = tp;
+        d->output_tail = tp;
+#if defined(UNIX_NETWORKING_EPOLL)
+        net_update_interest(d);
+#endif // UNIX_NETWORKING_EPOLL
+    }
+    else
+    {
+        d->output_tail->hdr.nxt = tp;
+        d->output_tail = tp;
+    }
+    d->output_size += n;
+    d->output_tot += n;
+    kick_output_queue(d);
+}
+
 void queue_write(DESC *d, const UTF8 *b)
 {
     queue_write_LEN(d, b, strlen((const char *)b));
@@ -570,7 +694,36 @@ static const UTF8 *encode_iac(const UTF8 *szString)
     return Buffer;
 }
 
-void queue_string(DESC *d, const UTF8 *s)
+// Convert text to the character encoding of the descriptor.
+//
+static const UTF8 *convert_charset(DESC *d, const UTF8 *p)
+{
+    if (CHARSET_UTF8 == d->encoding)
+    {
+        return p;
+    }
+    else if (CHARSET_LATIN1 == d->encoding)
+    {
+        return ConvertToLatin1(p);
+    }
+    else if (CHARSET_LATIN2 == d->encoding)
+    {
+        return ConvertToLatin2(p);
+    }
+    else if (CHARSET_CP437 == d->encoding)
+    {
+        return ConvertToCp437(p);
+    }
+    else // if (CHARSET_ASCII == d->encoding)
+    {
+        return ConvertToAscii(p);
+    }
+}
+
+// Render text with color as the descriptor wants it, and then encode it for
+// the wire.  The result is in a static buffer.
+//
+static const UTF8 *render_string(DESC *d, const UTF8 *s)
 {
     const UTF8 *p;
     if (  (d->flags & DS_CONNECTED)
@@ -589,67 +742,168 @@ void queue_string(DESC *d, const UTF8 *s)
     {
         p = strip_color(s);
     }
+    return encode_iac(convert_charset(d, p));
+}
 
-    const UTF8 *q;
-    if (CHARSET_UTF8 == d->encoding)
+void queue_string(DESC *d, const UTF8 *s)
+{
+    queue_write(d, render_string(d, s));
+}
+
+static const UTF8 *render_string(DESC *d, const mux_string &s)
+{
+    const UTF8 *p = s.export_TextConverted((d->flags & DS_CONNECTED) && Ansi(d->player), NoBleed(d->player), Color256(d->player), Html(d->player));
+    return encode_iac(convert_charset(d, p));
+}
+
+void queue_string(DESC *d, const mux_string &s)
+{
+    queue_write(d, render_string(d, s));
+}
+
+/*! \brief Allocate a shared block holding a copy of the given text.
+ *
+ * The block has room for nSize bytes, of which the first n are copied from
+ * b.  Any remaining room is left for the caller to fill in, and the caller
+ * must then update nchars to match.
+ *
+ * The caller holds the only reference, and must release it with
+ * sblock_release() after queuing it.
+ *
+ * \param b         Text.
+ * \param n         Number of bytes in b.
+ * \param nSize     Number of bytes of room in the block, at least n.
+ * \return          Shared block.
+ */
+
+SBLOCK *sblock_create(const UTF8 *b, size_t n, size_t nSize)
+{
+    mux_assert(n <= nSize);
+    SBLOCK *sb = (SBLOCK *)MEMALLOC(sizeof(SBLOCK) + nSize);
+    ISOUTOFMEMORY(sb);
+    sb->refcount = 1;
+    sb->nchars = n;
+    memcpy(sb->data, b, n);
+    sb->data[n] = '\0';
+    sb->data[nSize] = '\0';
+    return sb;
+}
+
+void sblock_release(SBLOCK *sb)
+{
+    if (  nullptr != sb
+       && 0 == --sb->refcount)
     {
-        q = p;
+        MEMFREE(sb);
     }
-    else
+}
+
+void free_tblock(TBLOCK *tb)
+{
+    if (tb->hdr.flags & TBLK_FLAG_SHARED)
     {
-        if (CHARSET_LATIN1 == d->encoding)
-        {
-            q = ConvertToLatin1(p);
-        }
-        else if (CHARSET_LATIN2 == d->encoding)
-        {
-            q = ConvertToLatin2(p);
-        }
-        else if (CHARSET_CP437 == d->encoding)
+        sblock_release(tb->hdr.shared);
+    }
+    MEMFREE(tb);
+}
+
+// The output profile of a descriptor.  Descriptors with the same profile are
+// sent the same bytes for the same message.
+//
+static int output_profile(DESC *d)
+{
+    int iColor;
+    if (  (d->flags & DS_CONNECTED)
+       && Ansi(d->player))
+    {
+        if (Html(d->player))
         {
-            q = ConvertToCp437(p);
+            iColor = 1;
         }
-        else // if (CHARSET_ASCII == d->encoding)
+        else
         {
-            q = ConvertToAscii(p);
+            iColor = 2 + (NoBleed(d->player) ? 1 : 0) + (Color256(d->player) ? 2 : 0);
         }
     }
+    else
+    {
+        iColor = 0;
+    }
 
-    q = encode_iac(q);
-    queue_write(d, q);
+    int iEncoding = d->encoding;
+    if (  iEncoding < 0
+       || 5 <= iEncoding)
+    {
+        iEncoding = CHARSET_ASCII;
+    }
+    return iColor*5 + iEncoding;
 }
 
-void queue_string(DESC *d, const mux_string &s)
+/*! \brief Prepare a line of text to be sent to many descriptors.
+ *
+ * The text is not copied, and it must remain valid until shared_text_free().
+ *
+ * \param pst       Shared text state.
+ * \param text      Line of text, without the trailing newline.
+ * \return          None.
+ */
+
+void shared_text_init(SHARED_TEXT *pst, const UTF8 *text)
 {
-    const UTF8 *p = s.export_TextConverted((d->flags & DS_CONNECTED) && Ansi(d->player), NoBleed(d->player), Color256(d->player), Html(d->player));
+    pst->text = text;
+    pst->mtext = nullptr;
+    for (int i = 0; i < OUTPUT_PROFILES; i++)
+    {
+        pst->rendered[i] = nullptr;
+    }
+}
 
-    const UTF8 *q;
-    if (CHARSET_UTF8 == d->encoding)
+void shared_text_init(SHARED_TEXT *pst, const mux_string &text)
+{
+    pst->text = nullptr;
+    pst->mtext = &text;
+    for (int i = 0; i < OUTPUT_PROFILES; i++)
     {
-        q = p;
+        pst->rendered[i] = nullptr;
     }
-    else
+}
+
+/*! \brief Queue a line of shared text on a descriptor.
+ *
+ * The text is rendered the first time it is needed for each output profile.
+ * Afterwards, descriptors with the same profile share the rendered copy.
+ *
+ * \param d         Network descriptor state.
+ * \param pst       Shared text state.
+ * \return          None.
+ */
+
+void queue_shared_text(DESC *d, SHARED_TEXT *pst)
+{
+    const int iProfile = output_profile(d);
+    SBLOCK *sb = pst->rendered[iProfile];
+    if (nullptr == sb)
     {
-        if (CHARSET_LATIN1 == d->encoding)
-        {
-            q = ConvertToLatin1(p);
-        }
-        else if (CHARSET_LATIN2 == d->encoding)
-        {
-            q = ConvertToLatin2(p);
-        }
-        else if (CHARSET_CP437 == d->encoding)
-        {
-            q = ConvertToCp437(p);
-        }
-        else // if (CHARSET_ASCII == d->encoding)
-        {
-            q = ConvertToAscii(p);
-        }
+        const UTF8 *p = (nullptr == pst->mtext)
+                      ? render_string(d, pst->text)
+                      : render_string(d, *pst->mtext);
+        const size_t n = strlen((const char *)p);
+        sb = sblock_create(p, n, n + 2);
+        sb->data[n] = '\r';
+        sb->data[n+1] = '\n';
+        sb->nchars = n + 2;
+        pst->rendered[iProfile] = sb;
     }
+    queue_write_shared(d, sb);
+}
 
-    q = encode_iac(q);
-    queue_write(d, q);
+void shared_text_free(SHARED_TEXT *pst)
+{
+    for (int i = 0; i < OUTPUT_PROFILES; i++)
+    {
+        sblock_release(pst->rendered[i]);
+        pst->rendered[i] = nullptr;
+    }
 }
 
 void freeqs(DESC *d)
@@ -661,7 +915,7 @@ void freeqs(DESC *d)
     while (tb)
     {
         tnext = tb->hdr.nxt;
-        MEMFREE(tb);
+        free_tblock(tb);
         tb = tnext;
     }
     d->output_head = nullptr;
@@ -782,6 +1036,9 @@ void save_command(DESC *d, CBLK *command)
         // We have added our first command to an empty list. Go process it later.
         //
         scheduler.DeferImmediateTask(PRIORITY_SYSTEM, Task_ProcessCommand, d, 0);
+#if defined(UNIX_NETWORKING_EPOLL)
+        net_update_interest(d);
+#endif // UNIX_NETWORKING_EPOLL
     }
     else
     {
@@ -2738,14 +2995,7 @@ void do_command(DESC *d, UTF8 *command)
         }
         mudstate.curr_executor = d->player;
         mudstate.curr_enactor = d->player;
-        for (int i = 0; i < MAX_GLOBAL_REGS; i++)
-        {
-            if (mudstate.global_regs[i])
-            {
-                RegRelease(mudstate.global_regs[i]);
-                mudstate.global_regs[i] = nullptr;
-            }
-        }
+        clear_global_regs();
 
 #if defined(STUB_SLAVE)
         mudstate.iRow = RS_TOP;
@@ -2935,6 +3185,9 @@ void Task_ProcessCommand(void *arg_voidptr, int arg_iInteger)
                 else
                 {
                     d->input_tail = nullptr;
+#if defined(UNIX_NETWORKING_EPOLL)
+                    net_update_interest(d);
+#endif // UNIX_NETWORKING_EPOLL
                 }
                 d->input_size -= strlen((char *)t->cmd);
                 d->last_time.GetUTC();
@@ -332,6 +332,7 @@ void s_Pennies(dbref obj, int howfew)
 {
     if (Good_obj(obj))
     {
+        db_checkpoint_object(obj);
         if (  !mudstate.bStandAlone
            && OwnsOthers(obj))
         {
@@ -130,7 +130,7 @@ bool could_doit(dbref player, dbref thing, int locknum)
     dbref aowner;
     int   aflags;
     UTF8 *key = atr_get("could_doit.134", thing, locknum, &aowner, &aflags);
-    bool doit = eval_boolexp_atr(player, thing, thing, key);
+    bool doit = eval_boolexp_lock(player, thing, thing, locknum, key);
     free_lbuf(key);
     return doit;
 }
@@ -1274,7 +1274,7 @@ void handle_prog(DESC *d, UTF8 *message)
         return;
     }
     dbref aowner;
-    int aflags, i;
+    int aflags;
     UTF8 *cmd = atr_get("handle_prog.1215", d->player, A_PROGCMD, &aowner, &aflags);
     CLinearTimeAbsolute lta;
     wait_que(d->program_data->wait_enactor, d->player, d->player,
@@ -1291,14 +1291,8 @@ void handle_prog(DESC *d, UTF8 *message)
        && all->program_data)
     {
         PROG *program = all->program_data;
-        for (i = 0; i < MAX_GLOBAL_REGS; i++)
-        {
-            if (program->wait_regs[i])
-            {
-                RegRelease(program->wait_regs[i]);
-                program->wait_regs[i] = nullptr;
-            }
-        }
+        RegFrameRelease(program->wait_regs);
+        program->wait_regs = nullptr;
 
         // Set info for all player descriptors to nullptr
         //
@@ -1369,20 +1363,13 @@ void do_quitprog(dbref player, dbref caller, dbref enactor, int eval, int key, U
     }
 
     d = (DESC *)hashfindLEN(&doer, sizeof(doer), &mudstate.desc_htab);
-    int i;
 
     if (  d
        && d->program_data)
     {
         PROG *program = d->program_data;
-        for (i = 0; i < MAX_GLOBAL_REGS; i++)
-        {
-            if (program->wait_regs[i])
-            {
-                RegRelease(program->wait_regs[i]);
-                program->wait_regs[i] = nullptr;
-            }
-        }
+        RegFrameRelease(program->wait_regs);
+        program->wait_regs = nullptr;
 
         // Set info for all player descriptors to nullptr.
         //
@@ -1525,14 +1512,7 @@ void do_prog
     PROG *program = (PROG *)MEMALLOC(sizeof(PROG));
     ISOUTOFMEMORY(program);
     program->wait_enactor = player;
-    for (int i = 0; i < MAX_GLOBAL_REGS; i++)
-    {
-        program->wait_regs[i] = mudstate.global_regs[i];
-        if (mudstate.global_regs[i])
-        {
-            RegAddRef(mudstate.global_regs[i]);
-        }
-    }
+    program->wait_regs = save_global_regs();
 
     // Now, start waiting.
     //
@@ -2511,7 +2491,7 @@ void did_it(dbref player, dbref thing, int what, const UTF8 *def, int owhat,
     //
 
     bool need_pres = false;
-    reg_ref **preserve = nullptr;
+    reg_frame *preserve = nullptr;
 
     // message to player.
     //
@@ -2521,8 +2501,7 @@ void did_it(dbref player, dbref thing, int what, const UTF8 *def, int owhat,
         if (*d)
         {
             need_pres = true;
-            preserve = PushRegisters(MAX_GLOBAL_REGS);
-            save_global_regs(preserve);
+            preserve = save_global_regs();
 
             buff = bp = alloc_lbuf("did_it.1");
             mux_exec(d, LBUF_SIZE-1, buff, &bp, thing, player, player,
@@ -2578,8 +2557,7 @@ void did_it(dbref player, dbref thing, int what, const UTF8 *def, int owhat,
             if (!need_pres)
             {
                 need_pres = true;
-                preserve = PushRegisters(MAX_GLOBAL_REGS);
-                save_global_regs(preserve);
+                preserve = save_global_regs();
             }
             buff = bp = alloc_lbuf("did_it.2");
             mux_exec(d, LBUF_SIZE-1, buff, &bp, thing, player, player,
@@ -2670,7 +2648,6 @@ void did_it(dbref player, dbref thing, int what, const UTF8 *def, int owhat,
     if (need_pres)
     {
         restore_global_regs(preserve);
-        PopRegisters(preserve, MAX_GLOBAL_REGS);
     }
 
     // Do the action attribute.
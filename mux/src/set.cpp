@@ -141,7 +141,7 @@ void do_chzone
 
     // Everything is okay, do the change.
     //
-    db[thing].zone = zone;
+    s_Zone(thing, zone);
     if (!isPlayer(thing))
     {
         // If the object is a player, resetting these flags is rather
@@ -669,8 +669,9 @@ const UTF8 *latin2_utf8[256] =
 
 bool utf8_strlen(const UTF8 *pString, size_t &nString)
 {
-    nString = 0;
-    int i = 0;
+    size_t nAscii = ascii_span(pString);
+    nString = nAscii;
+    size_t i = nAscii;
     while ('\0' != pString[i])
     {
         unsigned char t = utf8_FirstByte[pString[i]];
@@ -679,7 +680,7 @@ bool utf8_strlen(const UTF8 *pString, size_t &nString)
             return false;
         }
 
-        int j;
+        size_t j;
         for (j = i + 1; j < i + t; j++)
         {
             if (  '\0' == pString[j]
@@ -696,8 +697,8 @@ bool utf8_strlen(const UTF8 *pString, size_t &nString)
 
 bool utf8_strlen(const UTF8 *pString, mux_cursor &nString)
 {
-    LBUF_OFFSET nPoints = 0;
-    LBUF_OFFSET nBytes  = 0;
+    LBUF_OFFSET nPoints = static_cast<LBUF_OFFSET>(ascii_span(pString));
+    LBUF_OFFSET nBytes  = nPoints;
     while ('\0' != pString[nBytes])
     {
         unsigned char t = utf8_FirstByte[pString[nBytes]];
@@ -743,8 +744,25 @@ const UTF8 *ConvertToAscii(const UTF8 *pString)
     static UTF8 buffer[2*LBUF_SIZE];
     UTF8 *q = buffer;
 
-    while ('\0' != *pString)
+    while (  '\0' != *pString
+          && q < buffer + sizeof(buffer) - 1)
     {
+        // Printable ASCII converts to itself.
+        //
+        size_t nAscii = ascii_printable_span(pString);
+        if (0 < nAscii)
+        {
+            size_t nRoom = buffer + sizeof(buffer) - 1 - q;
+            if (nRoom < nAscii)
+            {
+                nAscii = nRoom;
+            }
+            memcpy(q, pString, nAscii);
+            q += nAscii;
+            pString += nAscii;
+            continue;
+        }
+
         const UTF8 *p = pString;
         int iState = TR_ASCII_START_STATE;
         do
@@ -809,6 +827,22 @@ const UTF8 *ConvertToCp437(const UTF8 *pString)
     while (  '\0' != *pString
           && q < buffer + sizeof(buffer) - 1)
     {
+        // Printable ASCII converts to itself.
+        //
+        size_t nAscii = ascii_printable_span(pString);
+        if (0 < nAscii)
+        {
+            size_t nRoom = buffer + sizeof(buffer) - 1 - q;
+            if (nRoom < nAscii)
+            {
+                nAscii = nRoom;
+            }
+            memcpy(q, pString, nAscii);
+            q += nAscii;
+            pString += nAscii;
+            continue;
+        }
+
         const UTF8 *p = pString;
         int iState = TR_CP437_START_STATE;
         do
@@ -873,6 +907,22 @@ const UTF8 *ConvertToLatin1(const UTF8 *pString)
     while (  '\0' != *pString
           && q < buffer + sizeof(buffer) - 1)
     {
+        // Printable ASCII converts to itself.
+        //
+        size_t nAscii = ascii_printable_span(pString);
+        if (0 < nAscii)
+        {
+            size_t nRoom = buffer + sizeof(buffer) - 1 - q;
+            if (nRoom < nAscii)
+            {
+                nAscii = nRoom;
+            }
+            memcpy(q, pString, nAscii);
+            q += nAscii;
+            pString += nAscii;
+            continue;
+        }
+
         const UTF8 *p = pString;
         int iState = TR_LATIN1_START_STATE;
         do
@@ -937,6 +987,22 @@ const UTF8 *ConvertToLatin2(const UTF8 *pString)
     while (  '\0' != *pString
           && q < buffer + sizeof(buffer) - 1)
     {
+        // Printable ASCII converts to itself.
+        //
+        size_t nAscii = ascii_printable_span(pString);
+        if (0 < nAscii)
+        {
+            size_t nRoom = buffer + sizeof(buffer) - 1 - q;
+            if (nRoom < nAscii)
+            {
+                nAscii = nRoom;
+            }
+            memcpy(q, pString, nAscii);
+            q += nAscii;
+            pString += nAscii;
+            continue;
+        }
+
         const UTF8 *p = pString;
         int iState = TR_LATIN2_START_STATE;
         do
@@ -1464,7 +1530,7 @@ void NearestIndex_tree_v(int iHere, const YUV &yuv, int &iBest, INT64 &rBest)
     }
 }
 
-int FindNearestPaletteEntry(RGB &rgb, bool fColor256)
+static int NearestPaletteEntry(RGB &rgb, bool fColor256)
 {
     YUV yuv16;
     rgb2yuv16(&rgb, &yuv16);
@@ -1475,7 +1541,7 @@ int FindNearestPaletteEntry(RGB &rgb, bool fColor256)
     return j;
 }
 
-int FindNearestPalette8Entry(RGB &rgb)
+static int NearestPalette8Entry(RGB &rgb)
 {
     YUV yuv16;
     rgb2yuv16(&rgb, &yuv16);
@@ -1495,6 +1561,128 @@ int FindNearestPalette8Entry(RGB &rgb)
     return iNearest;
 }
 
+// Softcode which draws gradients can use thousands of distinct colors on a
+// screen, and each of them is approximated again for every listener.  This
+// direct-mapped cache remembers the nearest 16-color, 256-color, and 8-color
+// (background) entries for recently seen colors.  A tag is the packed RGB
+// value with the valid bit set, so the zero-filled cache starts out empty.
+//
+#define PALETTE_CACHE_SIZE  4096
+#define PALETTE_CACHE_SHIFT 20
+#define PALETTE_CACHE_VALID 0x01000000
+
+#define PALETTE_SLOT_16     0
+#define PALETTE_SLOT_256    1
+#define PALETTE_SLOT_8      2
+#define PALETTE_SLOTS       3
+
+typedef struct
+{
+    UINT32 tag;
+    short  index[PALETTE_SLOTS];    // -1 when not yet known.
+} PALETTE_CACHE_ENTRY;
+
+static PALETTE_CACHE_ENTRY palette_cache[PALETTE_CACHE_SIZE];
+
+static int CachedPaletteEntry(RGB &rgb, int iSlot)
+{
+    UINT32 tag = PALETTE_CACHE_VALID
+               | (static_cast<UINT32>(rgb.r) << 16)
+               | (static_cast<UINT32>(rgb.g) << 8)
+               | (static_cast<UINT32>(rgb.b));
+    PALETTE_CACHE_ENTRY *pEntry =
+        &palette_cache[(tag * 2654435761U) >> PALETTE_CACHE_SHIFT];
+
+    if (pEntry->tag != tag)
+    {
+        pEntry->tag = tag;
+        for (int i = 0; i < PALETTE_SLOTS; i++)
+        {
+            pEntry->index[i] = -1;
+        }
+    }
+
+    int iColor = pEntry->index[iSlot];
+    if (iColor < 0)
+    {
+        if (PALETTE_SLOT_8 == iSlot)
+        {
+            iColor = NearestPalette8Entry(rgb);
+        }
+        else
+        {
+            iColor = NearestPaletteEntry(rgb, PALETTE_SLOT_256 == iSlot);
+        }
+        pEntry->index[iSlot] = static_cast<short>(iColor);
+    }
+    return iColor;
+}
+
+int FindNearestPaletteEntry(RGB &rgb, bool fColor256)
+{
+    return CachedPaletteEntry(rgb, fColor256 ? PALETTE_SLOT_256 : PALETTE_SLOT_16);
+}
+
+int FindNearestPalette8Entry(RGB &rgb)
+{
+    return CachedPaletteEntry(rgb, PALETTE_SLOT_8);
+}
+
+// With color_quantize, colors are down-converted for clients from a table
+// indexed by the top five bits of each channel and built from the center of
+// each cell.  This trades a little accuracy for a single lookup.
+//
+#define PALETTE_QUANT_BITS  5
+#define PALETTE_QUANT_SHIFT (8 - PALETTE_QUANT_BITS)
+#define PALETTE_QUANT_SIZE  (1 << (3*PALETTE_QUANT_BITS))
+
+static UINT8 palette_quantized[2][PALETTE_QUANT_SIZE];
+static bool  palette_quantized_built = false;
+
+static inline int palette_quant_index(const RGB &rgb)
+{
+    return (rgb.r >> PALETTE_QUANT_SHIFT) << (2*PALETTE_QUANT_BITS)
+         | (rgb.g >> PALETTE_QUANT_SHIFT) << PALETTE_QUANT_BITS
+         | (rgb.b >> PALETTE_QUANT_SHIFT);
+}
+
+void palette_table_init(void)
+{
+    if (  !mudconf.color_quantize
+       || palette_quantized_built)
+    {
+        return;
+    }
+
+    const int mask = (1 << PALETTE_QUANT_BITS) - 1;
+    const int center = 1 << (PALETTE_QUANT_SHIFT - 1);
+    for (int i = 0; i < PALETTE_QUANT_SIZE; i++)
+    {
+        RGB rgb;
+        rgb.r = (((i >> (2*PALETTE_QUANT_BITS)) & mask) << PALETTE_QUANT_SHIFT) | center;
+        rgb.g = (((i >> PALETTE_QUANT_BITS) & mask) << PALETTE_QUANT_SHIFT) | center;
+        rgb.b = ((i & mask) << PALETTE_QUANT_SHIFT) | center;
+        palette_quantized[0][i] = static_cast<UINT8>(NearestPaletteEntry(rgb, false));
+        palette_quantized[1][i] = static_cast<UINT8>(NearestPaletteEntry(rgb, true));
+    }
+    palette_quantized_built = true;
+}
+
+// Nearest palette entry for a color sent to a client.  Only client output
+// may use the quantized table.  Color codes kept in strings must name the
+// exact nearest entry.
+//
+static int FindClientPaletteEntry(RGB &rgb, bool fColor256)
+{
+    if (mudconf.color_quantize)
+    {
+        palette_table_init();
+        return palette_quantized[fColor256][palette_quant_index(rgb)];
+    }
+    return FindNearestPaletteEntry(rgb, fColor256);
+}
+
+
 #define CS_FOREGROUND UINT64_C(0x0000000001FFFFFF)
 #define CS_FOREGROUND_RED     UINT64_C(0x0000000000FF0000)
 #define CS_FOREGROUND_GREEN   UINT64_C(0x000000000000FF00)
@@ -2484,7 +2672,7 @@ static UTF8 *ColorTransitionANSI
         else
         {
             cs2rgb(CS_FG_FIELD(csNext), &rgb);
-            iColor = COLOR_INDEX_FG + FindNearestPaletteEntry(rgb, true);
+            iColor = COLOR_INDEX_FG + FindClientPaletteEntry(rgb, true);
         }
     }
     else
@@ -2503,7 +2691,7 @@ static UTF8 *ColorTransitionANSI
         else
         {
             cs2rgb(CS_FG_FIELD(csNext), &rgb);
-            iColor = COLOR_INDEX_FG + FindNearestPaletteEntry(rgb, false);
+            iColor = COLOR_INDEX_FG + FindClientPaletteEntry(rgb, false);
         }
 
         // For foreground 256-to-16-color down-conversion, we 'borrow' the
@@ -2541,7 +2729,7 @@ static UTF8 *ColorTransitionANSI
         else
         {
             cs2rgb(CS_BG_FIELD(csNext), &rgb);
-            iColor = COLOR_INDEX_BG + FindNearestPaletteEntry(rgb, true);
+            iColor = COLOR_INDEX_BG + FindClientPaletteEntry(rgb, true);
         }
     }
     else
@@ -3205,6 +3393,24 @@ UTF8 *strip_color(const UTF8 *pString, size_t *pnBytes, size_t *pnPoints)
     size_t nPoints = 0;
     while ('\0' != *pString)
     {
+        // Color codes live in the Private Use Area, so a run of ASCII can be
+        // copied without looking for them.
+        //
+        size_t nAscii = ascii_span(pString);
+        if (0 < nAscii)
+        {
+            size_t nCopy = LBUF_SIZE - (pBuffer - aBuffer) - 1;
+            if (nAscii < nCopy)
+            {
+                nCopy = nAscii;
+            }
+            memcpy(pBuffer, pString, nCopy);
+            pBuffer += nCopy;
+            pString += nAscii;
+            nPoints += nAscii;
+            continue;
+        }
+
         if (COLOR_NOTCOLOR == mux_color(pString))
         {
             utf8_safe_chr(pString, aBuffer, &pBuffer);
@@ -4923,6 +5129,14 @@ UTF8 *mux_strlwr(const UTF8 *a, size_t &n)
     n = 0;
     while ('\0' != *a)
     {
+        size_t nAscii = ascii_lower(Buffer + n, a, LBUF_SIZE-1 - n);
+        if (0 < nAscii)
+        {
+            n += nAscii;
+            a += nAscii;
+            continue;
+        }
+
         size_t j;
         size_t m;
         bool bXor;
@@ -4979,6 +5193,14 @@ UTF8 *mux_strupr(const UTF8 *a, size_t &n)
     n = 0;
     while ('\0' != *a)
     {
+        size_t nAscii = ascii_upper(Buffer + n, a, LBUF_SIZE-1 - n);
+        if (0 < nAscii)
+        {
+            n += nAscii;
+            a += nAscii;
+            continue;
+        }
+
         size_t j;
         size_t m;
         bool bXor;
@@ -5806,9 +6028,12 @@ CF_HAND(cf_art_rule)
 mux_string::mux_string(void)
 {
     m_iLast = CursorMin;
+    m_autf = m_asmall;
+    m_nutf = sizeof(m_asmall);
     m_autf[0] = '\0';
-    m_ncs = 0;
-    m_pcs = nullptr;
+    m_prun = nullptr;
+    m_nrun = 0;
+    m_nrun_alloc = 0;
 }
 
 /*! \brief Constructs mux_string object.
@@ -5822,9 +6047,12 @@ mux_string::mux_string(void)
 mux_string::mux_string(const mux_string &sStr)
 {
     m_iLast = CursorMin;
+    m_autf = m_asmall;
+    m_nutf = sizeof(m_asmall);
     m_autf[0] = '\0';
-    m_ncs = 0;
-    m_pcs = nullptr;
+    m_prun = nullptr;
+    m_nrun = 0;
+    m_nrun_alloc = 0;
     import(sStr);
 }
 
@@ -5840,22 +6068,44 @@ mux_string::mux_string(const mux_string &sStr)
 mux_string::mux_string(const UTF8 *pStr)
 {
     m_iLast = CursorMin;
+    m_autf = m_asmall;
+    m_nutf = sizeof(m_asmall);
     m_autf[0] = '\0';
-    m_ncs = 0;
-    m_pcs = nullptr;
+    m_prun = nullptr;
+    m_nrun = 0;
+    m_nrun_alloc = 0;
     import(pStr);
 }
 
 /*! \brief Destructs mux_string object.
  *
- * This destructor deletes the m_pcs array if necessary.
+ * This destructor deletes the heap buffer and m_prun array if necessary.
  *
  * \return         None.
  */
 
 mux_string::~mux_string(void)
 {
-    realloc_m_pcs(0);
+    if (m_asmall != m_autf)
+    {
+        delete [] m_autf;
+    }
+    delete [] m_prun;
+}
+
+/*! \brief Deep copy of another mux_string.
+ *
+ * \param sStr     mux_string to be copied.
+ * \return         This mux_string.
+ */
+
+mux_string &mux_string::operator =(const mux_string &sStr)
+{
+    if (this != &sStr)
+    {
+        import(sStr);
+    }
+    return *this;
 }
 
 /*! \brief Self-checks mux_string to validate the invariant.
@@ -5875,21 +6125,23 @@ void mux_string::Validate(void) const
     //
     mux_assert(m_iLast.m_point <= LBUF_SIZE-1);
 
-    // m_iLast.m_point is always between 0 and LBUF_SIZE-1 inclusively.
+    // The buffer always has room for the terminating '\0', and heap buffers
+    // are never larger than LBUF_SIZE.
     //
-    mux_assert(m_ncs <= LBUF_SIZE-1);
-
-    // When m_pcs is nullptr, m_ncs must be 0, and this is equivalent to every
-    // code point having CS_NORMAL color.  When m_pcs is not nullptr, m_ncs
-    // must be between 1 and LBUF_SIZE-1, inclusively, and it must be large
-    // enough to contain colors for every code point.
+    mux_assert(  m_iLast.m_byte < m_nutf
+              && (  (  m_asmall == m_autf
+                    && sizeof(m_asmall) == m_nutf)
+                 || (  m_asmall != m_autf
+                    && m_nutf <= LBUF_SIZE)));
+
+    // When m_nrun is 0, every code point has CS_NORMAL color.  Otherwise,
+    // m_prun must be large enough to hold m_nrun runs, and there is at least
+    // one code point.
     //
-    mux_assert(  ( nullptr == m_pcs
-                 && 0 == m_ncs)
-              || ( nullptr != m_pcs
-                 && 1 <= m_ncs
-                 && m_ncs <= LBUF_SIZE-1
-                 && m_iLast.m_point <= m_ncs));
+    mux_assert(  m_nrun <= m_nrun_alloc
+              && (  0 == m_nrun
+                 || (  nullptr != m_prun
+                    && 0 < m_iLast.m_point)));
 
     // m_iLast.m_byte bytes of m_atuf[] contain the non-color UTF-8-encoded
     // code points.  A terminating '\0' at m_autf[m_iLast.m_byte] is not
@@ -5905,7 +6157,7 @@ void mux_string::Validate(void) const
     size_t npoints = 0;
 
     const UTF8 *p = m_autf;
-    while (  p < (m_autf + LBUF_SIZE)
+    while (  p < (m_autf + m_nutf)
           && '\0' != *p)
     {
         // Each code point must be valid encoding.
@@ -5931,14 +6183,28 @@ void mux_string::Validate(void) const
     mux_assert(nbytes == m_iLast.m_byte);
     mux_assert(npoints == m_iLast.m_point);
 
-    if (nullptr != m_pcs)
+    if (0 < m_nrun)
     {
-        // Every ColorState must be valid.
+        // Runs start at point 0, are ordered, do not extend past the end of
+        // the string, and always change the color.  A single CS_NORMAL run
+        // is represented by having no runs at all.
         //
+        mux_assert(0 == m_prun[0].iStart);
+        mux_assert(  1 < m_nrun
+                  || CS_NORMAL != m_prun[0].cs);
+
         size_t i;
-        for (i = 0; i < m_iLast.m_point; i++)
+        for (i = 0; i < m_nrun; i++)
         {
-            ValidateColorState(m_pcs[i]);
+            // Every ColorState must be valid.
+            //
+            ValidateColorState(m_prun[i].cs);
+            mux_assert(m_prun[i].iStart < m_iLast.m_point);
+            if (0 < i)
+            {
+                mux_assert(m_prun[i-1].iStart < m_prun[i].iStart);
+                mux_assert(m_prun[i-1].cs != m_prun[i].cs);
+            }
         }
     }
 }
@@ -5994,31 +6260,21 @@ void mux_string::append(const mux_string &sStr, mux_cursor iStart, mux_cursor iE
     LBUF_OFFSET nBytes = iEnd.m_byte - iStart.m_byte;
     LBUF_OFFSET nPoints = iEnd.m_point - iStart.m_point;
 
-    if (  0 != m_ncs
-       || 0 != sStr.m_ncs)
+    grow_m_autf(m_iLast.m_byte + nBytes);
+    memmove(m_autf + m_iLast.m_byte, sStr.m_autf + iStart.m_byte, nBytes);
+
+    if (  0 != m_nrun
+       || 0 != sStr.m_nrun)
     {
         // One of the strings specifies ColorStates, so the result will need
         // to as well.
         //
-        realloc_m_pcs(m_iLast.m_point + nPoints);
-    }
-
-    memcpy(m_autf + m_iLast.m_byte, sStr.m_autf + iStart.m_byte, nBytes);
-
-    if (0 != sStr.m_ncs)
-    {
-        memcpy(m_pcs + m_iLast.m_point, sStr.m_pcs + iStart.m_point, nPoints * sizeof(m_pcs[0]));
-    }
-    else if (0 != m_ncs)
-    {
-        for (size_t i = 0; i < nPoints; i++)
-        {
-            m_pcs[m_iLast.m_point + i] = CS_NORMAL;
-        }
+        color_copy(m_iLast.m_point, sStr, iStart.m_point, nPoints);
     }
 
     m_iLast(m_iLast.m_byte + nBytes, m_iLast.m_point + nPoints);
     m_autf[m_iLast.m_byte] = '\0';
+    color_normalize();
 }
 
 void mux_string::append(const UTF8 *pStr)
@@ -6095,7 +6351,9 @@ void mux_string::append_TextPlain(const UTF8 *pStr)
         nLen = (LBUF_SIZE-1) - m_iLast.m_byte;
     }
 
+    grow_m_autf(m_iLast.m_byte + nLen);
     memcpy(m_autf + m_iLast.m_byte, pStr, nLen * sizeof(m_autf[0]));
+    m_autf[m_iLast.m_byte + nLen] = '\0';
 
     mux_cursor i = m_iLast, j = i;
     while (  cursor_next(i)
@@ -6104,20 +6362,14 @@ void mux_string::append_TextPlain(const UTF8 *pStr)
         j = i;
     }
 
-    if (0 != m_ncs)
+    if (0 != m_nrun)
     {
-        // Note that mux_string invariant is not maintained on the following
-        // call to realloc_m_pcs().
-        //
-        realloc_m_pcs(j.m_point);
-        for (size_t k = m_iLast.m_point; k < j.m_point; k++)
-        {
-            m_pcs[k] = CS_NORMAL;
-        }
+        color_set(m_iLast.m_point, j.m_point, CS_NORMAL);
     }
 
     m_iLast = j;
     m_autf[m_iLast.m_byte] = '\0';
+    color_normalize();
 }
 
 void mux_string::append_TextPlain(const UTF8 *pStr, size_t nLen)
@@ -6136,16 +6388,9 @@ void mux_string::append_TextPlain(const UTF8 *pStr, size_t nLen)
         nLen = (LBUF_SIZE-1) - m_iLast.m_byte;
     }
 
-    if (0 != m_ncs)
-    {
-        realloc_m_pcs(m_iLast.m_point + nLen);
-        for (size_t i = 0; i < nLen; i++)
-        {
-            m_pcs[m_iLast.m_point + i] = CS_NORMAL;
-        }
-    }
-
+    grow_m_autf(m_iLast.m_byte + nLen);
     memcpy(m_autf + m_iLast.m_byte, pStr, nLen * sizeof(m_autf[0]));
+    m_autf[m_iLast.m_byte + nLen] = '\0';
 
     mux_cursor i = m_iLast, j = i;
     while (  cursor_next(i)
@@ -6154,8 +6399,14 @@ void mux_string::append_TextPlain(const UTF8 *pStr, size_t nLen)
         j = i;
     }
 
+    if (0 != m_nrun)
+    {
+        color_set(m_iLast.m_point, j.m_point, CS_NORMAL);
+    }
+
     m_iLast = j;
     m_autf[m_iLast.m_byte] = '\0';
+    color_normalize();
 }
 
 /*! \brief Compress each run of consecutive occurrences of the
@@ -6262,18 +6513,19 @@ void mux_string::delete_Chars(mux_cursor iStart, mux_cursor iEnd)
         //
         m_iLast = iStart;
         m_autf[m_iLast.m_byte] = '\0';
+        color_normalize();
         return;
     }
 
     size_t nBytesMove = m_iLast.m_byte - iEnd.m_byte;
-    size_t nPointsMove = m_iLast.m_point - iEnd.m_point;
     memmove(m_autf + iStart.m_byte, m_autf + iEnd.m_byte, nBytesMove);
-    if (0 != m_ncs)
+    if (0 != m_nrun)
     {
-        memmove(m_pcs + iStart.m_point, m_pcs + iEnd.m_point, nPointsMove * sizeof(m_pcs[0]));
+        color_delete(iStart.m_point, iEnd.m_point);
     }
     m_iLast(m_iLast.m_byte - (iEnd.m_byte - iStart.m_byte), m_iLast.m_point - (iEnd.m_point - iStart.m_point));
     m_autf[m_iLast.m_byte] = '\0';
+    color_normalize();
 }
 
 /*! \brief Perform a search-and-replace-all operation, or prepend or
@@ -6375,14 +6627,10 @@ void mux_string::encode_Html(void)
         if (nullptr != pTo)
         {
             sTo->import(pTo);
-            if (nullptr != m_pcs)
+            if (0 != m_nrun)
             {
-                ColorState cs = m_pcs[iPos.m_point];
-                sTo->realloc_m_pcs(sTo->m_iLast.m_point);
-                for (size_t i = 0; i < sTo->m_iLast.m_point; i++)
-                {
-                    sTo->m_pcs[i] = cs;
-                }
+                sTo->color_set(0, sTo->m_iLast.m_point, color_at(iPos.m_point));
+                sTo->color_normalize();
             }
             replace_Chars(*sTo, iPos, mux_cursor(1, 1));
         }
@@ -6439,12 +6687,13 @@ LBUF_OFFSET mux_string::export_Char_UTF8(size_t iFirst, UTF8 *pBuffer) const
 ColorState mux_string::export_Color(size_t n) const
 {
     if (  m_iLast.m_point <= n
-       || 0 == m_ncs)
+       || 0 == m_nrun)
     {
         return CS_NORMAL;
     }
-    ValidateColorState(m_pcs[n]);
-    return m_pcs[n];
+    ColorState cs = color_at(n);
+    ValidateColorState(cs);
+    return cs;
 }
 
 double mux_string::export_Float(bool bStrict) const
@@ -6510,24 +6759,31 @@ LBUF_OFFSET mux_string::export_TextColor
     //  try to copy, and has a value in the ranges (0, nLeft] and (0, nAvail].
     //
     LBUF_OFFSET nBytesWanted  = iEnd.m_byte - iStart.m_byte;
-    LBUF_OFFSET nPointsWanted = iEnd.m_point - iStart.m_point;
-    if (0 == m_ncs)
+    if (0 == m_nrun)
     {
         return export_TextPlain(pBuffer, iStart, iEnd, nBytesMax);
     }
+
+    // Color can only change at the beginning of a run, so the number of runs
+    // in the range bounds the number of transitions.
+    //
+    size_t iRun = color_find(iStart.m_point);
+    size_t nRunsWanted = color_find(iEnd.m_point - 1) - iRun + 1;
     bool bPlentyOfRoom = (nBytesMax >
-        static_cast<size_t>(nBytesWanted + (COLOR_MAXIMUM_BINARY_TRANSITION_LENGTH * nPointsWanted) + COLOR_MAXIMUM_BINARY_NORMAL + 1));
+        static_cast<size_t>(nBytesWanted + (COLOR_MAXIMUM_BINARY_TRANSITION_LENGTH * nRunsWanted) + COLOR_MAXIMUM_BINARY_NORMAL + 1));
     mux_cursor iPos = iStart, iCopy = iStart;
     size_t nTransition = 0;
     const UTF8 *pTransition = nullptr;
     ColorState csPrev = CS_NORMAL;
+    ColorState csCurrent = CS_NORMAL;
     LBUF_OFFSET nCopy = 0, nDone = 0;
 
     if (bPlentyOfRoom)
     {
         while (iPos < iEnd)
         {
-            if (csPrev != m_pcs[iPos.m_point])
+            csCurrent = color_next(iRun, iPos.m_point);
+            if (csPrev != csCurrent)
             {
                 if (iCopy < iPos)
                 {
@@ -6538,11 +6794,11 @@ LBUF_OFFSET mux_string::export_TextColor
                 }
 
                 pTransition = ColorTransitionBinary( csPrev,
-                                                     m_pcs[iPos.m_point],
+                                                     csCurrent,
                                                      &nTransition);
                 memcpy(pBuffer + nDone, pTransition, nTransition * sizeof(pTransition[0]));
                 nDone = static_cast<LBUF_OFFSET>(nDone + nTransition);
-                csPrev = m_pcs[iPos.m_point];
+                csPrev = csCurrent;
             }
             cursor_next(iPos);
         }
@@ -6568,9 +6824,10 @@ LBUF_OFFSET mux_string::export_TextColor
     LBUF_OFFSET nChar = 0;
     while (iPos < iEnd)
     {
-        if (csPrev != m_pcs[iPos.m_point])
+        csCurrent = color_next(iRun, iPos.m_point);
+        if (csPrev != csCurrent)
         {
-            pTransition = ColorTransitionBinary( csPrev, m_pcs[iPos.m_point],
+            pTransition = ColorTransitionBinary( csPrev, csCurrent,
                                                  &nTransition);
         }
         else
@@ -6583,7 +6840,7 @@ LBUF_OFFSET mux_string::export_TextColor
             if (  !bNearEnd
                || nTransition)
             {
-                ColorBinaryNormal(m_pcs[iPos.m_point], &nNeededAfter);
+                ColorBinaryNormal(csCurrent, &nNeededAfter);
                 bNearEnd = true;
             }
             if (nBytesMax < nDone + nTransition + nChar + nNeededAfter)
@@ -6598,7 +6855,7 @@ LBUF_OFFSET mux_string::export_TextColor
         {
             memcpy(pBuffer + nDone, pTransition, nTransition * sizeof(pTransition[0]));
             nDone = static_cast<LBUF_OFFSET>(nDone + nTransition);
-            csPrev = m_pcs[iPos.m_point];
+            csPrev = csCurrent;
         }
         memcpy(pBuffer + nDone, m_autf + iPos.m_byte, nChar * sizeof(m_autf[0]));
         nDone = static_cast<LBUF_OFFSET>(nDone + nChar);
@@ -6632,7 +6889,7 @@ UTF8 *mux_string::export_TextConverted
 ) const
 {
     static UTF8 Buffer[2*LBUF_SIZE];
-    if (  0 == m_ncs
+    if (  0 == m_nrun
        || 0 == m_iLast.m_point
        || !fColor)
     {
@@ -6659,13 +6916,14 @@ UTF8 *mux_string::export_TextConverted
     ColorState csCurrent = CS_NORMAL;
     UTF8 *pTransition = nullptr;
 
-    bool bPlentyOfRoom = (m_iLast.m_byte + (COLOR_MAXIMUM_ANSI_TRANSITION_LENGTH * m_ncs) + nNormal + 1) < sizeof(Buffer);
+    size_t iRun = 0;
+    bool bPlentyOfRoom = (m_iLast.m_byte + (COLOR_MAXIMUM_ANSI_TRANSITION_LENGTH * m_nrun) + nNormal + 1) < sizeof(Buffer);
 
     if (bPlentyOfRoom)
     {
         while (curIn < m_iLast)
         {
-            csCurrent = m_pcs[curIn.m_point];
+            csCurrent = color_next(iRun, curIn.m_point);
             ValidateColorState(csCurrent);
             if (csPrev != csCurrent)
             {
@@ -6709,7 +6967,7 @@ UTF8 *mux_string::export_TextConverted
     LBUF_OFFSET nChar = 0;
     while (curIn < m_iLast)
     {
-        csCurrent = m_pcs[curIn.m_point];
+        csCurrent = color_next(iRun, curIn.m_point);
         ValidateColorState(csCurrent);
         if (csPrev != csCurrent)
         {
@@ -6773,10 +7031,11 @@ void mux_string::export_TextHtml
     UTF8  *aBuffer
 ) const
 {
-    if (  0 == m_ncs
+    if (  0 == m_nrun
        || 0 == m_iLast.m_point)
     {
         export_TextPlain(aBuffer);
+        return;
     }
 
     // Converting to HTML is performed in two passes. The first pass
@@ -6790,7 +7049,7 @@ void mux_string::export_TextHtml
 
     HTMLtag tagmap[5] = { kIntense, kUnderline, kBlink, kInverse, kColor };
 
-    if (CS_NORMAL == m_pcs[0])
+    if (CS_NORMAL == m_prun[0].cs)
     {
         List[nList].fBeginEnd = true;
         List[nList].kTag = kNormal;
@@ -6801,10 +7060,11 @@ void mux_string::export_TextHtml
 
     ColorState csPrev = CS_NORMAL;
     ColorState csNext = CS_NORMAL;
+    size_t iRun = 0;
 
     for (size_t i = 0; i < m_iLast.m_point; i++)
     {
-        csNext = m_pcs[i];
+        csNext = color_next(iRun, i);
         if (0 != (csNext & ~CS_ALLBITS))
         {
             STARTLOG(LOG_BUGS, "BUG", "INFO");
@@ -7141,12 +7401,16 @@ void mux_string::export_TextHtml
             mux_cursor curStart;
             if (cursor_from_point(curStart, iCopy))
             {
+                // Copy through the end of the run containing iCopy.
+                //
+                size_t iNext = color_find(iCopy) + 1;
                 mux_cursor cur = curStart;
                 do
                 {
                     cursor_next(cur);
                 } while (  cur < m_iLast
-                        && m_pcs[curStart.m_point] == m_pcs[cur.m_point]);
+                        && (  m_nrun <= iNext
+                           || cur.m_point < m_prun[iNext].iStart));
 
                 size_t n = cur.m_byte - curStart.m_byte;
                 if (0 < n)
@@ -7213,7 +7477,7 @@ LBUF_OFFSET mux_string::export_TextPlain
 
 void mux_string::import(dbref num)
 {
-    realloc_m_pcs(0);
+    m_nrun = 0;
 
     m_autf[0] = '#';
     LBUF_OFFSET n = 1;
@@ -7232,7 +7496,7 @@ void mux_string::import(dbref num)
 
 void mux_string::import(INT64 iInt)
 {
-    realloc_m_pcs(0);
+    m_nrun = 0;
 
     // mux_i64toa() sets the '\0'.
     //
@@ -7248,7 +7512,7 @@ void mux_string::import(INT64 iInt)
 
 void mux_string::import(long lLong)
 {
-    realloc_m_pcs(0);
+    m_nrun = 0;
 
     // mux_ltoa() sets the '\0'.
     //
@@ -7265,26 +7529,29 @@ void mux_string::import(long lLong)
 
 void mux_string::import(const mux_string &sStr, mux_cursor iStart)
 {
-    if (sStr.m_iLast <= iStart)
+    if (this == &sStr)
+    {
+        delete_Chars(CursorMin, iStart);
+    }
+    else if (sStr.m_iLast <= iStart)
     {
         m_iLast = CursorMin;
         m_autf[m_iLast.m_byte] = '\0';
-        realloc_m_pcs(0);
+        m_nrun = 0;
     }
     else
     {
-        m_iLast = sStr.m_iLast - iStart;
+        mux_cursor iLast = sStr.m_iLast - iStart;
+        grow_m_autf(iLast.m_byte);
+        m_iLast = iLast;
         memcpy(m_autf, sStr.m_autf + iStart.m_byte, m_iLast.m_byte);
         m_autf[m_iLast.m_byte] = '\0';
 
-        if (0 == sStr.m_ncs)
+        m_nrun = 0;
+        if (0 != sStr.m_nrun)
         {
-            realloc_m_pcs(0);
-        }
-        else
-        {
-            realloc_m_pcs(m_iLast.m_point);
-            memcpy(m_pcs, sStr.m_pcs + iStart.m_point, m_iLast.m_point * sizeof(m_pcs[0]));
+            color_copy(0, sStr, iStart.m_point, m_iLast.m_point);
+            color_normalize();
         }
     }
 }
@@ -7326,11 +7593,11 @@ void mux_string::import(const UTF8 *pStr, size_t nLen)
 {
     m_iLast = CursorMin;
 
+    m_nrun = 0;
     if (  nullptr == pStr
        || '\0' == *pStr
        || 0 == nLen)
     {
-        realloc_m_pcs(0);
         m_autf[m_iLast.m_byte] = '\0';
         return;
     }
@@ -7340,9 +7607,13 @@ void mux_string::import(const UTF8 *pStr, size_t nLen)
         nLen = LBUF_SIZE-1;
     }
 
-    bool fColor = false;
-    static ColorState acsTemp[LBUF_SIZE];
+    // Color codes are removed, so the text never needs more than nLen bytes
+    // plus the rest of a code point that nLen may have split.
+    //
+    grow_m_autf(nLen + UTF8_SIZE4 - 1);
+
     ColorState cs = CS_NORMAL;
+    ColorState csRun = CS_NORMAL;
 
     LBUF_OFFSET iPoint = 0;
     size_t iStr = 0;
@@ -7352,12 +7623,26 @@ void mux_string::import(const UTF8 *pStr, size_t nLen)
         unsigned int iCode = mux_color(pStr + iStr);
         if (COLOR_NOTCOLOR == iCode)
         {
-            safe_chr_utf8(pStr + iStr, m_autf, &pch);
-            acsTemp[iPoint++] = cs;
-            if (CS_NORMAL != cs)
+            if (csRun != cs)
             {
-                fColor = true;
+                // Start a new run, and if this is the first color, also
+                // record the uncolored text before it.
+                //
+                grow_m_prun(m_nrun + 2);
+                if (  0 == m_nrun
+                   && 0 < iPoint)
+                {
+                    m_prun[m_nrun].cs = CS_NORMAL;
+                    m_prun[m_nrun].iStart = 0;
+                    m_nrun++;
+                }
+                m_prun[m_nrun].cs = cs;
+                m_prun[m_nrun].iStart = iPoint;
+                m_nrun++;
+                csRun = cs;
             }
+            safe_chr_utf8(pStr + iStr, m_autf, &pch);
+            iPoint++;
         }
         else
         {
@@ -7368,16 +7653,7 @@ void mux_string::import(const UTF8 *pStr, size_t nLen)
 
     m_iLast(static_cast<LBUF_OFFSET>(pch - m_autf), iPoint);
     m_autf[m_iLast.m_byte] = '\0';
-
-    if (fColor)
-    {
-        realloc_m_pcs(m_iLast.m_point);
-        memcpy(m_pcs, acsTemp, m_iLast.m_point * sizeof(m_pcs[0]));
-    }
-    else
-    {
-        realloc_m_pcs(0);
-    }
+    color_normalize();
 }
 
 void mux_string::prepend(dbref num)
@@ -7434,64 +7710,367 @@ void mux_string::prepend(const UTF8 *pStr, size_t n)
     delete sStore;
 }
 
-/*! \brief Resizes or deletes the m_pcs array if necessary.
+/*! \brief Makes room in m_autf for a string of a given size.
  *
- * If asked to resize the array to 0, this method will delete the
- * array and set m_pcs to nullptr.  Otherwise when this method returns
- * the m_pcs array will exist and have at least the required size.
- * Any color states that were already initialized and would fit within
- * the resulting array will be preserved.
+ * Strings start in the small buffer inside the object.  When that is too
+ * small, the text moves to a heap buffer that doubles as needed up to
+ * LBUF_SIZE.  The current text and its terminating '\0' are preserved.
  *
- * \param ncs      Size of m_pcs array required.
+ * \param nBytes   Length of string (not including '\0') that must fit.
  * \return         None.
  */
 
-void mux_string::realloc_m_pcs(size_t ncs)
+void mux_string::grow_m_autf(size_t nBytes)
 {
-    if (  0 == ncs
-       && 0 != m_ncs)
+    if (LBUF_SIZE-1 < nBytes)
     {
-        delete [] m_pcs;
-        m_pcs = nullptr;
-        m_ncs = 0;
+        nBytes = LBUF_SIZE-1;
     }
-    else if (m_ncs < ncs)
+
+    if (nBytes < m_nutf)
     {
-        // extend in chunks of 8
-        //
-        ncs |= 0x7;
-        ncs++;
+        return;
+    }
+
+    size_t nutf = 2*m_nutf;
+    while (nutf <= nBytes)
+    {
+        nutf *= 2;
+    }
+    if (LBUF_SIZE < nutf)
+    {
+        nutf = LBUF_SIZE;
+    }
 
-        ColorState *pcsOld = m_pcs;
-        m_pcs = nullptr;
+    UTF8 *pNew = nullptr;
+    try
+    {
+        pNew = new UTF8[nutf];
+    }
+    catch (...)
+    {
+        ; // Nothing.
+    }
+    ISOUTOFMEMORY(pNew);
+
+    memcpy(pNew, m_autf, m_iLast.m_byte + 1);
+    if (m_asmall != m_autf)
+    {
+        delete [] m_autf;
+    }
+    m_autf = pNew;
+    m_nutf = nutf;
+}
+
+/*! \brief Makes room in m_prun for a given number of color runs.
+ *
+ * Runs that are already in use are preserved.
+ *
+ * \param nRuns    Number of runs required.
+ * \return         None.
+ */
+
+void mux_string::grow_m_prun(size_t nRuns)
+{
+    if (nRuns <= m_nrun_alloc)
+    {
+        return;
+    }
+
+    // extend in chunks of 8
+    //
+    nRuns |= 0x7;
+    nRuns++;
+
+    COLOR_RUN *pNew = nullptr;
+    try
+    {
+        pNew = new COLOR_RUN[nRuns];
+    }
+    catch (...)
+    {
+        ; // Nothing.
+    }
+    ISOUTOFMEMORY(pNew);
+
+    if (0 < m_nrun)
+    {
+        memcpy(pNew, m_prun, m_nrun * sizeof(m_prun[0]));
+    }
+    delete [] m_prun;
+    m_prun = pNew;
+    m_nrun_alloc = nRuns;
+}
+
+/*! \brief Finds the color run containing a code point.
+ *
+ * \param iPoint   Code point.
+ * \return         Index into m_prun.  There must be at least one run.
+ */
+
+size_t mux_string::color_find(size_t iPoint) const
+{
+    size_t lo = 0;
+    size_t hi = m_nrun;
+    while (1 < hi - lo)
+    {
+        size_t mid = (lo + hi)/2;
+        if (m_prun[mid].iStart <= iPoint)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+ColorState mux_string::color_at(size_t iPoint) const
+{
+    if (0 == m_nrun)
+    {
+        return CS_NORMAL;
+    }
+    return m_prun[color_find(iPoint)].cs;
+}
+
+/*! \brief Sets the color of a range of code points.
+ *
+ * The range may extend past the end of the string when the caller is about
+ * to lengthen it.  Runs which become redundant are left for
+ * color_normalize().
+ *
+ * \param iStart   First code point.
+ * \param iEnd     Code point after the last one.
+ * \param cs       New color.
+ * \return         None.
+ */
+
+void mux_string::color_set(size_t iStart, size_t iEnd, ColorState cs)
+{
+    if (iEnd <= iStart)
+    {
+        return;
+    }
+
+    if (0 == m_nrun)
+    {
+        if (CS_NORMAL == cs)
+        {
+            return;
+        }
+        grow_m_prun(1);
+        m_prun[0].cs = CS_NORMAL;
+        m_prun[0].iStart = 0;
+        m_nrun = 1;
+    }
+
+    // Runs i through j-1 start inside [iStart, iEnd].  They are replaced by
+    // a run of cs at iStart and a run at iEnd that resumes the color that
+    // was there.
+    //
+    ColorState csAfter = m_prun[color_find(iEnd)].cs;
+    size_t i = color_find(iStart);
+    if (m_prun[i].iStart < iStart)
+    {
+        i++;
+    }
+    size_t j = i;
+    while (  j < m_nrun
+          && m_prun[j].iStart <= iEnd)
+    {
+        j++;
+    }
+
+    grow_m_prun(m_nrun - (j - i) + 2);
+    memmove(m_prun + i + 2, m_prun + j, (m_nrun - j) * sizeof(m_prun[0]));
+    m_nrun = m_nrun - (j - i) + 2;
+    m_prun[i].cs = cs;
+    m_prun[i].iStart = static_cast<LBUF_OFFSET>(iStart);
+    m_prun[i+1].cs = csAfter;
+    m_prun[i+1].iStart = static_cast<LBUF_OFFSET>(iEnd);
+}
+
+/*! \brief Copies the colors of a range of code points from another string.
+ *
+ * \param iAt      First code point to color in this string.
+ * \param sStr     String to copy from.  It may be this string.
+ * \param iFrom    First code point in sStr.
+ * \param nPoints  Number of code points.
+ * \return         None.
+ */
+
+void mux_string::color_copy(size_t iAt, const mux_string &sStr, size_t iFrom, size_t nPoints)
+{
+    if (0 == sStr.m_nrun)
+    {
+        color_set(iAt, iAt + nPoints, CS_NORMAL);
+        return;
+    }
+
+    // Copying within this string would change the runs we are reading, so
+    // work from a snapshot.
+    //
+    const COLOR_RUN *prun = sStr.m_prun;
+    size_t nrun = sStr.m_nrun;
+    COLOR_RUN *pSnapshot = nullptr;
+    if (this == &sStr)
+    {
         try
         {
-            m_pcs = new ColorState[ncs];
+            pSnapshot = new COLOR_RUN[nrun];
         }
         catch (...)
         {
             ; // Nothing.
         }
-        ISOUTOFMEMORY(m_pcs);
+        ISOUTOFMEMORY(pSnapshot);
+        memcpy(pSnapshot, m_prun, nrun * sizeof(m_prun[0]));
+        prun = pSnapshot;
+    }
 
-        if (0 == m_ncs)
+    size_t k = sStr.color_find(iFrom);
+    size_t iPoint = iFrom;
+    while (iPoint < iFrom + nPoints)
+    {
+        size_t iNext = iFrom + nPoints;
+        if (  k + 1 < nrun
+           && prun[k+1].iStart < iNext)
         {
-            // Initialize the implicit CS_NORMAL ColorStates to maintain the
-            // mux_string invariant.
+            iNext = prun[k+1].iStart;
+        }
+        color_set(iAt + (iPoint - iFrom), iAt + (iNext - iFrom), prun[k].cs);
+        iPoint = iNext;
+        k++;
+    }
+    delete [] pSnapshot;
+}
+
+/*! \brief Removes the colors for a range of code points.
+ *
+ * Colors after the range move down to take its place.
+ *
+ * \param iStart   First code point to remove.
+ * \param iEnd     Code point after the last one.
+ * \return         None.
+ */
+
+void mux_string::color_delete(size_t iStart, size_t iEnd)
+{
+    if (  0 == m_nrun
+       || iEnd <= iStart)
+    {
+        return;
+    }
+
+    ColorState csAfter = m_prun[color_find(iEnd)].cs;
+    size_t i = color_find(iStart);
+    if (m_prun[i].iStart < iStart)
+    {
+        i++;
+    }
+    size_t j = i;
+    while (  j < m_nrun
+          && m_prun[j].iStart <= iEnd)
+    {
+        j++;
+    }
+
+    grow_m_prun(m_nrun - (j - i) + 1);
+    memmove(m_prun + i + 1, m_prun + j, (m_nrun - j) * sizeof(m_prun[0]));
+    m_nrun = m_nrun - (j - i) + 1;
+    m_prun[i].cs = csAfter;
+    m_prun[i].iStart = static_cast<LBUF_OFFSET>(iStart);
+
+    size_t nPoints = iEnd - iStart;
+    for (j = i + 1; j < m_nrun; j++)
+    {
+        m_prun[j].iStart = static_cast<LBUF_OFFSET>(m_prun[j].iStart - nPoints);
+    }
+}
+
+/*! \brief Opens a gap of code points in the colors.
+ *
+ * Colors at and after iAt move up.  The gap takes the color of the code
+ * point before it, and the caller is expected to color it.
+ *
+ * \param iAt      Where to open the gap.
+ * \param nPoints  Size of the gap.
+ * \return         None.
+ */
+
+void mux_string::color_insert(size_t iAt, size_t nPoints)
+{
+    if (  0 == m_nrun
+       || 0 == nPoints)
+    {
+        return;
+    }
+
+    size_t i = color_find(iAt);
+    if (m_prun[i].iStart < iAt)
+    {
+        i++;
+    }
+    for (size_t j = i; j < m_nrun; j++)
+    {
+        m_prun[j].iStart = static_cast<LBUF_OFFSET>(m_prun[j].iStart + nPoints);
+    }
+
+    if (0 == iAt)
+    {
+        // There is no code point before the gap, so it starts out normal.
+        //
+        grow_m_prun(m_nrun + 1);
+        memmove(m_prun + 1, m_prun, m_nrun * sizeof(m_prun[0]));
+        m_nrun++;
+        m_prun[0].cs = CS_NORMAL;
+        m_prun[0].iStart = 0;
+    }
+}
+
+/*! \brief Restores the color run invariant after an edit.
+ *
+ * Drops runs past the end of the string, merges neighboring runs of the
+ * same color, and forgets the runs entirely if everything is CS_NORMAL.
+ *
+ * \return         None.
+ */
+
+void mux_string::color_normalize(void)
+{
+    size_t j = 0;
+    for (size_t i = 0; i < m_nrun; i++)
+    {
+        if (m_iLast.m_point <= m_prun[i].iStart)
+        {
+            break;
+        }
+
+        if (  0 < j
+           && m_prun[j-1].iStart == m_prun[i].iStart)
+        {
+            // An empty run.
             //
-            for (size_t i = 0; i < ncs; i++)
-            {
-                m_pcs[i] = CS_NORMAL;
-            }
+            j--;
         }
-        else
+
+        if (  0 < j
+           && m_prun[j-1].cs == m_prun[i].cs)
         {
-            memcpy(m_pcs, pcsOld, m_ncs * sizeof(m_pcs[0]));
-            delete [] pcsOld;
+            continue;
         }
+        m_prun[j++] = m_prun[i];
+    }
 
-        m_ncs = ncs;
+    if (  1 == j
+       && CS_NORMAL == m_prun[0].cs)
+    {
+        j = 0;
     }
+    m_nrun = j;
 }
 
 /*! \brief Replaces a substring within a string with another.
@@ -7547,47 +8126,35 @@ void mux_string::replace_Chars
 
         // Move text if necessary.
         //
+        grow_m_autf(iLast.m_byte);
         if (CursorMin < nMove)
         {
             memmove(m_autf + iStart.m_byte + nCopy.m_byte,
                     m_autf + iStart.m_byte + nLen.m_byte, nMove.m_byte * sizeof(m_autf[0]));
         }
 
-        // Update color if necessary to be consistent with the move.
+        // Update color if necessary to be consistent with the move.  Each
+        // replacement code point keeps the color that was at its position,
+        // with the last color propagated past the old end of the string.
         //
-        if (0 != m_ncs)
+        if (0 != m_nrun)
         {
-            realloc_m_pcs(iLast.m_point);
-
-            // Propagate the last color state out further.
-            //
-            for (int i = m_iLast.m_point; i < iLast.m_point; i++)
+            if (nCopy.m_point < nLen.m_point)
             {
-                m_pcs[i] = m_pcs[m_iLast.m_point-1];
+                color_delete(iStart.m_point + nCopy.m_point,
+                             iStart.m_point + nLen.m_point);
             }
-
-            // If there is a move operation, the color also needs to be moved.
-            // A copy on the end of the string without a move may require some
-            // color state to be initialized.
-            //
-            if (CursorMin < nMove)
+            else if (nLen.m_point < nCopy.m_point)
             {
-                memmove(m_pcs + iStart.m_point + nCopy.m_point,
-                        m_pcs + iStart.m_point + nLen.m_point, nMove.m_point * sizeof(m_pcs[0]));
+                size_t nGap = nCopy.m_point - nLen.m_point;
+                size_t iGap = iStart.m_point + nLen.m_point;
+                color_insert(iGap, nGap);
+                color_copy(iGap, *this, iGap + nGap, nGap);
             }
         }
-        else if (0 != sTo.m_ncs)
-        {
-            realloc_m_pcs(iLast.m_point);
-        }
 
         m_iLast = iLast;
     }
-    else if (  0 == m_ncs
-            && 0 != sTo.m_ncs)
-    {
-        realloc_m_pcs(m_iLast.m_point);
-    }
 
     // Copy replacement text over substring.
     //
@@ -7595,12 +8162,13 @@ void mux_string::replace_Chars
 
     // If the replacement string contains color, replace the color as well.
     //
-    if (0 != sTo.m_ncs)
+    if (0 != sTo.m_nrun)
     {
-        memcpy(m_pcs + iStart.m_point, sTo.m_pcs, nCopy.m_point * sizeof(m_pcs[0]));
+        color_copy(iStart.m_point, sTo, 0, nCopy.m_point);
     }
 
     m_autf[m_iLast.m_byte] = '\0';
+    color_normalize();
 }
 
 bool mux_string::replace_Point(const UTF8 *p, const mux_cursor &i)
@@ -7610,17 +8178,26 @@ bool mux_string::replace_Point(const UTF8 *p, const mux_cursor &i)
 
     if (n != m)
     {
-        if (  m < n
-           && sizeof(m_autf) <= m_iLast.m_byte + m - n)
+        if (  n < m
+           && LBUF_SIZE-1 < m_iLast.m_byte + m - n)
         {
             // We need to truncate the trailing point to make room for an expansion.
             //
             do
             {
                 cursor_prev(m_iLast);
-            } while (sizeof(m_autf) <= m_iLast.m_byte + m - n);
+            } while (LBUF_SIZE-1 < m_iLast.m_byte + m - n);
             m_autf[m_iLast.m_byte] = '\0';
+            color_normalize();
+
+            if (m_iLast.m_byte < i.m_byte + n)
+            {
+                // The point itself did not fit.
+                //
+                return false;
+            }
         }
+        grow_m_autf(m_iLast.m_byte + m - n);
 
         if (i.m_byte + n  < m_iLast.m_byte)
         {
@@ -7654,7 +8231,6 @@ void mux_string::replace_Char(const mux_cursor &i, const mux_string &sStr, const
 void mux_string::reverse(void)
 {
     mux_string *sTemp = new mux_string;
-    sTemp->realloc_m_pcs(m_ncs);
 
     mux_cursor i = m_iLast, j = i;
 
@@ -7795,16 +8371,8 @@ void mux_string::set_Color(size_t n, ColorState csColor)
     {
         return;
     }
-    if (  0 == m_ncs
-       && csColor != CS_NORMAL)
-    {
-        realloc_m_pcs(m_iLast.m_point);
-    }
-
-    if (0 != m_ncs)
-    {
-        m_pcs[n] = csColor;
-    }
+    color_set(n, n + 1, csColor);
+    color_normalize();
 }
 
 bool mux_string::compare_Char(const mux_cursor &i, const mux_string &sStr) const
@@ -7906,6 +8474,7 @@ void mux_string::stripWithTable
             //
             m_iLast = iStripStart;
             m_autf[m_iLast.m_byte] = '\0';
+            color_normalize();
         }
         else
         {
@@ -8042,6 +8611,7 @@ void mux_string::trim(const UTF8 ch, bool bLeft, bool bRight)
             cursor_next(iEnd);
             m_iLast = iEnd;
             m_autf[m_iLast.m_byte] = '\0';
+            color_normalize();
         }
     }
 
@@ -8121,6 +8691,7 @@ void mux_string::trim(const UTF8 *p, size_t n, bool bLeft, bool bRight)
             cursor_next(iEnd);
             m_iLast = iEnd;
             m_autf[m_iLast.m_byte] = '\0';
+            color_normalize();
         }
     }
 
@@ -8155,6 +8726,7 @@ void mux_string::truncate(mux_cursor iEnd)
     }
     m_iLast = iEnd;
     m_autf[m_iLast.m_byte] = '\0';
+    color_normalize();
 }
 
 void mux_string::UpperCase(void)
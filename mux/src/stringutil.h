@@ -114,6 +114,11 @@ inline size_t TrimPartialSequence(size_t n, __in_ecount(n) const UTF8 *p)
 //
 inline bool mux_isprint(__in const unsigned char *p)
 {
+    if (*p < 0x80)
+    {
+        return mux_isprint_ascii(*p);
+    }
+
     unsigned short iState = CL_PRINT_START_STATE;
     do
     {
@@ -1576,6 +1581,7 @@ typedef struct
 extern PALETTE_ENTRY palette[];
 
 int FindNearestPaletteEntry(RGB &rgb, bool fColor256);
+void palette_table_init(void);
 UTF8 *LettersToBinary(UTF8 *pLetters);
 
 UTF8 *convert_to_html(const UTF8 *pString);
@@ -1875,49 +1881,90 @@ static const mux_cursor CursorMax(LBUF_SIZE - 1, LBUF_SIZE - 1);
 
 static const mux_cursor curAscii(1, 1);
 
+// Most mux_strings hold a word, a name, or a short line, so the first
+// MUX_STRING_SMALL bytes are kept inside the object, and only longer strings
+// grow a buffer on the heap.
+//
+#define MUX_STRING_SMALL 128
+
+// A COLOR_RUN gives the ColorState for every code point from iStart up to the
+// iStart of the next run.
+//
+typedef struct
+{
+    ColorState  cs;
+    LBUF_OFFSET iStart;
+} COLOR_RUN;
+
 class mux_string
 {
-    // m_nutf, m_ncs, m_autf, m_ncs, and m_pcs work together as follows:
+    // m_iLast, m_autf, m_nutf, m_prun, and m_nrun work together as follows:
     //
-    // m_nutf is always between 0 and LBUF_SIZE-1 inclusively.  The first
-    // m_nutf bytes of m_atuf[] contain the non-color UTF-8-encoded code
-    // points.  A terminating '\0' at m_autf[m_nutf] is not included in this
-    // size even though '\0' is a UTF-8 code point.  In this way, m_nutf
-    // corresponds to strlen() in units of bytes.  The use of both a length
-    // and a terminating '\0' is intentionally redundant.
+    // m_iLast.m_byte is always between 0 and LBUF_SIZE-1 inclusively.  The
+    // first m_iLast.m_byte bytes of m_autf[] contain the non-color
+    // UTF-8-encoded code points.  A terminating '\0' at m_autf[m_iLast.m_byte]
+    // is not included in this size even though '\0' is a UTF-8 code point.  In
+    // this way, m_iLast.m_byte corresponds to strlen() in units of bytes.  The
+    // use of both a length and a terminating '\0' is intentionally redundant.
     //
-    // m_ncp is between 0 and LBUF_SIZE-1 inclusively and represents the
-    // number of non-color UTF-8-encoded code points stored in m_autf[].
-    // The terminating '\0' is not included in this size.  In this way, m_ncp
-    // corresponds to strlen() in units of code points.
+    // m_autf points either to m_asmall[] or to a heap buffer.  m_nutf is the
+    // number of bytes available there, and it is always larger than
+    // m_iLast.m_byte.  Heap buffers grow by doubling up to LBUF_SIZE.
     //
-    // If color is associated with the above code points, m_pcs will point
-    // to an array of ColorStates, otherwise, it is nullptr.  When m_pcs is
-    // nullptr, it is equivalent to every code point having CS_NORMAL color.
-    // Each color state corresponds with a UTF-8 code point in m_autf[].
-    // There is no guaranteed association between a position in m_autf[] and
-    // a position in m_pcs because UTF-8 code points are variable length.
+    // m_iLast.m_point is between 0 and LBUF_SIZE-1 inclusively and
+    // represents the number of non-color UTF-8-encoded code points stored in
+    // m_autf[].  The terminating '\0' is not included in this size.  In this
+    // way, m_iLast.m_point corresponds to strlen() in units of code points.
     //
-    // Not all ColorStates in m_pcs may be used. m_ncs is between 0 and
-    // LBUF_SIZE-1 inclusively and represents how many ColorStates are
-    // allocated and available for use.  m_ncp is always less than or equal to
-    // m_ncs.
+    // If color is associated with the above code points, m_prun points to
+    // m_nrun runs ordered by iStart.  The first run starts at point 0,
+    // every run starts before m_iLast.m_point, and neighboring runs have
+    // different colors.  The last run extends to the end of the string.  When
+    // m_nrun is 0, it is equivalent to every code point having CS_NORMAL
+    // color.  m_prun is only allocated once color is seen, and m_nrun_alloc
+    // is its size.
     //
-    // To recap, m_nutf has units of bytes while m_ncp and m_ncs are in units
-    // of code points.
+    // To recap, m_iLast.m_byte and m_nutf have units of bytes, m_iLast.m_point
+    // and iStart are in units of code points, and m_nrun counts runs.
     //
 private:
     mux_cursor  m_iLast;
-    UTF8        m_autf[LBUF_SIZE];
-    size_t      m_ncs;
-    ColorState *m_pcs;
-    void realloc_m_pcs(size_t ncs);
+    UTF8       *m_autf;
+    size_t      m_nutf;
+    COLOR_RUN  *m_prun;
+    size_t      m_nrun;
+    size_t      m_nrun_alloc;
+    UTF8        m_asmall[MUX_STRING_SMALL];
+
+    void grow_m_autf(size_t nBytes);
+    void grow_m_prun(size_t nRuns);
+    size_t color_find(size_t iPoint) const;
+    ColorState color_at(size_t iPoint) const;
+    void color_set(size_t iStart, size_t iEnd, ColorState cs);
+    void color_copy(size_t iAt, const mux_string &sStr, size_t iFrom, size_t nPoints);
+    void color_delete(size_t iStart, size_t iEnd);
+    void color_insert(size_t iAt, size_t nPoints);
+    void color_normalize(void);
+
+    // Returns the color of iPoint while walking forward through the string.
+    // iRun starts at color_find() of the first point and follows along.
+    //
+    inline ColorState color_next(size_t &iRun, size_t iPoint) const
+    {
+        while (  iRun + 1 < m_nrun
+              && m_prun[iRun + 1].iStart <= iPoint)
+        {
+            iRun++;
+        }
+        return m_prun[iRun].cs;
+    }
 
 public:
     mux_string(void);
     mux_string(const mux_string &sStr);
     mux_string(const UTF8 *pStr);
     ~mux_string(void);
+    mux_string &operator =(const mux_string &sStr);
 
     void Validate(void) const;
 
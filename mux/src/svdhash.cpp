@@ -422,10 +422,21 @@ CHashPage::CHashPage(void)
 {
     m_nPageSize = 0;
     m_pPage = 0;
+#if !defined(MEMORY_BASED) && defined(UNIX_MAPPED_FILES)
+    m_bAttached = false;
+#endif // !MEMORY_BASED && UNIX_MAPPED_FILES
 }
 
 CHashPage::~CHashPage(void)
 {
+#if !defined(MEMORY_BASED) && defined(UNIX_MAPPED_FILES)
+    if (m_bAttached)
+    {
+        // The page belongs to someone else (usually a file mapping).
+        //
+        m_pPage = 0;
+    }
+#endif // !MEMORY_BASED && UNIX_MAPPED_FILES
     if (m_pPage)
     {
         delete [] m_pPage;
@@ -1236,6 +1247,28 @@ bool CHashPage::ReadPage(HANDLE hFile, HF_FILEOFFSET oWhere)
 }
 #endif // UNIX_FILES
 
+#if defined(UNIX_MAPPED_FILES)
+// Attach
+//
+// Points this CHashPage at a page owned by someone else (for example, a page
+// inside a file mapping) instead of a private buffer.  Lookups and updates
+// then operate on that memory in place.
+//
+void CHashPage::Attach(unsigned char *pPage, unsigned int nPageSize)
+{
+    if (  m_pPage
+       && !m_bAttached)
+    {
+        delete [] m_pPage;
+    }
+    m_pPage = pPage;
+    m_nPageSize = nPageSize;
+    m_bAttached = true;
+    SetFixedPointers();
+    SetVariablePointers();
+}
+#endif // UNIX_MAPPED_FILES
+
 #endif // MEMORY_BASED
 
 UINT32 CHashPage::GetDepth(void)
@@ -1278,12 +1311,24 @@ bool CHashPage::Defrag(HP_HEAPLENGTH nExtra)
     }
     if (IS_HP_SUCCESS(errInserted))
     {
-        // Swap buffers.
-        //
-        unsigned char *tmp;
-        tmp = hpNew->m_pPage;
-        hpNew->m_pPage = m_pPage;
-        m_pPage = tmp;
+#if !defined(MEMORY_BASED) && defined(UNIX_MAPPED_FILES)
+        if (m_bAttached)
+        {
+            // We cannot trade away a page we do not own, so the result is
+            // copied back in place.
+            //
+            memcpy(m_pPage, hpNew->m_pPage, m_nPageSize);
+        }
+        else
+#endif // !MEMORY_BASED && UNIX_MAPPED_FILES
+        {
+            // Swap buffers.
+            //
+            unsigned char *tmp;
+            tmp = hpNew->m_pPage;
+            hpNew->m_pPage = m_pPage;
+            m_pPage = tmp;
+        }
 
         SetFixedPointers();
         SetVariablePointers();
@@ -1341,6 +1386,9 @@ CHashFile::CHashFile(void)
     SeedRandomNumberGenerator();
     m_Cache = nullptr;
     m_nCache = 0;
+#if defined(UNIX_MAPPED_FILES)
+    m_pScratch = nullptr;
+#endif // UNIX_MAPPED_FILES
     Init();
 }
 
@@ -1359,6 +1407,12 @@ void CHashFile::Init(void)
     m_hpCacheLookup = nullptr;
     iCache = 0;
     m_iLastFlushed = 0;
+#if defined(UNIX_MAPPED_FILES)
+    m_bMapped = false;
+    m_pPageMap = nullptr;
+    m_nPageMap = 0;
+    m_nDirMap = 0;
+#endif // UNIX_MAPPED_FILES
 }
 
 #if defined(WINDOWS_FILES)
@@ -1669,7 +1723,7 @@ void CHashFile::InitCache(int nCachePages)
     m_iOldest = 0;
 }
 
-int CHashFile::Open(const UTF8 *szDirFile, const UTF8 *szPageFile, int nCachePages)
+int CHashFile::OpenFileSet(const UTF8 *szDirFile, const UTF8 *szPageFile, int nCachePages)
 {
     CloseAll();
     FinalCache();
@@ -1797,6 +1851,20 @@ int CHashFile::Open(const UTF8 *szDirFile, const UTF8 *szPageFile, int nCachePag
     return HF_OPEN_STATUS_OLD;
 }
 
+int CHashFile::Open(const UTF8 *szDirFile, const UTF8 *szPageFile, int nCachePages)
+{
+    int cc = OpenFileSet(szDirFile, szPageFile, nCachePages);
+#if defined(UNIX_MAPPED_FILES)
+    if (  HF_OPEN_STATUS_ERROR != cc
+       && mudconf.cache_mmap
+       && !SwitchToMapped())
+    {
+        Log.WriteString(T("CHashFile::Open - Could not map the attribute files. Using the page cache instead." ENDLINE));
+    }
+#endif // UNIX_MAPPED_FILES
+    return cc;
+}
+
 void CHashFile::Sync(void)
 {
 #if defined(WINDOWS_FILES)
@@ -1807,6 +1875,19 @@ void CHashFile::Sync(void)
     {
         cs_syncs++;
         bool bAllFlushed = true;
+#if defined(UNIX_MAPPED_FILES)
+        if (m_bMapped)
+        {
+            // Modified pages are already in the kernel's page cache. Ask for
+            // them to be written, but do not wait.
+            //
+            if (  0 != msync(m_pPageMap, oEndOfFile, MS_ASYNC)
+               || 0 != msync(m_pDir, m_nDirMap, MS_ASYNC))
+            {
+                bAllFlushed = false;
+            }
+        }
+#endif // UNIX_MAPPED_FILES
         for (int i = 0; i < m_nCache; i++)
         {
             if (!FlushCache(i))
@@ -1856,6 +1937,9 @@ void CHashFile::CloseAll(void)
 #endif // UNIX_FILES
     {
         Sync();
+#if defined(UNIX_MAPPED_FILES)
+        UnmapAll();
+#endif // UNIX_MAPPED_FILES
         if (m_pDir)
         {
             delete [] m_pDir;
@@ -1908,6 +1992,12 @@ CHashFile::~CHashFile(void)
 bool CHashFile::Insert(HP_HEAPLENGTH nRecord, UINT32 nHash, void *pRecord)
 {
     cs_writes++;
+#if defined(UNIX_MAPPED_FILES)
+    if (m_bMapped)
+    {
+        return InsertMapped(nRecord, nHash, pRecord);
+    }
+#endif // UNIX_MAPPED_FILES
     for (;;)
     {
         UINT32 iFileDir = nHash >> (32-m_nDirDepth);
@@ -1947,10 +2037,12 @@ bool CHashFile::Insert(HP_HEAPLENGTH nRecord, UINT32 nHash, void *pRecord)
 #if defined(HAVE_WORKING_FORK)
         // First, if we are @dumping, then we have a @forked process
         // that is also reading from the file. We must pause and let
-        // this reader process finish.
+        // this reader process finish. A checkpoint is written by this
+        // process, so there is no one to wait for.
         //
         if (  !mudstate.bStandAlone
-           && mudstate.dumping)
+           && mudstate.dumping
+           && !db_checkpoint_active())
         {
             STARTLOG(LOG_DBSAVES, "DMP", "DUMP");
             log_text(T("Waiting on previously-forked child before page-splitting... "));
@@ -2091,6 +2183,29 @@ bool CHashFile::DoubleDirectory(void)
     unsigned int nNewDir     = 2 * m_nDir;
     UINT32       nNewDirDepth = m_nDirDepth + 1;
 
+#if defined(UNIX_MAPPED_FILES)
+    if (m_bMapped)
+    {
+        // Grow the directory file, and spread the old entries out over the
+        // new space. Working from the top down keeps every entry from being
+        // overwritten before it is copied.
+        //
+        if (!MapDirectory(nNewDir))
+        {
+            return false;
+        }
+        for (unsigned int iDir = m_nDir; 0 < iDir; )
+        {
+            iDir--;
+            HF_FILEOFFSET oPage = m_pDir[iDir];
+            m_pDir[2*iDir]   = oPage;
+            m_pDir[2*iDir+1] = oPage;
+        }
+        m_nDirDepth = nNewDirDepth;
+        m_nDir = nNewDir;
+        return true;
+    }
+#endif // UNIX_MAPPED_FILES
 
     HF_PFILEOFFSET pNewDir = nullptr;
     try
@@ -2163,14 +2278,32 @@ UINT32 CHashFile::FindFirstKey(UINT32 nHash)
         cs_fails++;
         return HF_FIND_END;
     }
-    iCache = ReadCache(iFileDir, &cs_rhits);
-    if (iCache < 0)
+
+    CHashPage *php;
+#if defined(UNIX_MAPPED_FILES)
+    if (m_bMapped)
     {
-        cs_fails++;
-        return HF_FIND_END;
+        php = MapPage(iFileDir);
+        if (nullptr == php)
+        {
+            cs_fails++;
+            return HF_FIND_END;
+        }
+        cs_rhits++;
+    }
+    else
+#endif // UNIX_MAPPED_FILES
+    {
+        iCache = ReadCache(iFileDir, &cs_rhits);
+        if (iCache < 0)
+        {
+            cs_fails++;
+            return HF_FIND_END;
+        }
+        php = &m_Cache[iCache].m_hp;
     }
     UINT32 nStart, nEnd;
-    m_Cache[iCache].m_hp.GetRange(m_nDirDepth, nStart, nEnd);
+    php->GetRange(m_nDirDepth, nStart, nEnd);
     if (iFileDir < nStart || nEnd < iFileDir)
     {
         Log.tinyprintf(T("CHashFile::Find - Directory entry (0x%08X) points to the wrong page (0x%08X-0x%08X)." ENDLINE),
@@ -2179,7 +2312,7 @@ UINT32 CHashFile::FindFirstKey(UINT32 nHash)
     }
 
     unsigned int numchecks;
-    UINT32 iDir = m_Cache[iCache].m_hp.FindFirstKey(nHash, &numchecks);
+    UINT32 iDir = php->FindFirstKey(nHash, &numchecks);
 
     if (iDir == HP_DIR_EMPTY)
     {
@@ -2195,7 +2328,7 @@ UINT32 CHashFile::FindNextKey(UINT32 iDir, UINT32 nHash)
 
     unsigned int numchecks;
 
-    iDir = m_Cache[iCache].m_hp.FindNextKey(iDir, nHash, &numchecks);
+    iDir = CurrentPage().FindNextKey(iDir, nHash, &numchecks);
 
     if (iDir == HP_DIR_EMPTY)
     {
@@ -2207,16 +2340,38 @@ UINT32 CHashFile::FindNextKey(UINT32 iDir, UINT32 nHash)
 
 void CHashFile::Copy(UINT32 iDir, HP_PHEAPLENGTH pnRecord, void *pRecord)
 {
-    m_Cache[iCache].m_hp.HeapCopy(iDir, pnRecord, pRecord);
+    CurrentPage().HeapCopy(iDir, pnRecord, pRecord);
 }
 
 void CHashFile::Remove(UINT32 iDir)
 {
     cs_dels++;
-    m_Cache[iCache].m_hp.HeapFree(iDir);
+    CurrentPage().HeapFree(iDir);
+#if defined(UNIX_MAPPED_FILES)
+    if (m_bMapped)
+    {
+        return;
+    }
+#endif // UNIX_MAPPED_FILES
     m_Cache[iCache].m_iState = HF_CACHE_UNPROTECTED;
 }
 
+// CurrentPage
+//
+// The page found by the most recent FindFirstKey(). FindNextKey(), Copy(),
+// and Remove() all operate on it.
+//
+CHashPage &CHashFile::CurrentPage(void)
+{
+#if defined(UNIX_MAPPED_FILES)
+    if (m_bMapped)
+    {
+        return m_hpMapped;
+    }
+#endif // UNIX_MAPPED_FILES
+    return m_Cache[iCache].m_hp;
+}
+
 bool CHashFile::FlushCache(int iCache)
 {
     switch (m_Cache[iCache].m_iState)
@@ -2313,6 +2468,15 @@ void CHashFile::ResetAge(int iEntry)
 
 void CHashFile::Tick(void)
 {
+#if defined(UNIX_MAPPED_FILES)
+    if (m_bMapped)
+    {
+        // The kernel writes mapped pages back on its own schedule.
+        //
+        return;
+    }
+#endif // UNIX_MAPPED_FILES
+
     int nCycle = mudconf.check_interval;
     if (mudconf.dump_interval < nCycle)
     {
@@ -2384,6 +2548,259 @@ int CHashFile::ReadCache(UINT32 iFileDir, int *phits)
     return -1;
 }
 
+#if defined(UNIX_MAPPED_FILES)
+
+// The mapped mode (cache_mmap) serves CHashPage lookups directly out of
+// shared file mappings of the .pag and .dir files instead of copying pages
+// into m_Cache. The kernel's page cache takes the place of HF_CACHE, and
+// updates are made in place.
+//
+// The page mapping is reserved larger than the file so that the file can
+// usually grow by a page without remapping. Nothing touches the reserved
+// space beyond oEndOfFile.
+//
+#define HF_MIN_MAPPED_PAGES 64
+
+bool CHashFile::MapPageFile(HF_FILEOFFSET oSize)
+{
+    if (0 != ftruncate(m_hPageFile, oSize))
+    {
+        Log.tinyprintf(T("CHashFile::MapPageFile - ftruncate error %u." ENDLINE), errno);
+        return false;
+    }
+
+    if (oSize <= m_nPageMap)
+    {
+        return true;
+    }
+
+    size_t nMap = 2 * static_cast<size_t>(oSize);
+    if (nMap < HF_MIN_MAPPED_PAGES * HF_SIZEOF_PAGE)
+    {
+        nMap = HF_MIN_MAPPED_PAGES * HF_SIZEOF_PAGE;
+    }
+    void *pMap = mmap(nullptr, nMap, PROT_READ|PROT_WRITE, MAP_SHARED,
+        m_hPageFile, 0);
+    if (MAP_FAILED == pMap)
+    {
+        // Try again without any room to grow.
+        //
+        nMap = oSize;
+        pMap = mmap(nullptr, nMap, PROT_READ|PROT_WRITE, MAP_SHARED,
+            m_hPageFile, 0);
+        if (MAP_FAILED == pMap)
+        {
+            Log.tinyprintf(T("CHashFile::MapPageFile - mmap error %u." ENDLINE), errno);
+            return false;
+        }
+    }
+
+    if (nullptr != m_pPageMap)
+    {
+        munmap(m_pPageMap, m_nPageMap);
+    }
+    m_pPageMap = static_cast<unsigned char *>(pMap);
+    m_nPageMap = nMap;
+    return true;
+}
+
+bool CHashFile::MapDirectory(unsigned int nDir)
+{
+    size_t nBytes = nDir * sizeof(HF_FILEOFFSET);
+    if (0 != ftruncate(m_hDirFile, nBytes))
+    {
+        Log.tinyprintf(T("CHashFile::MapDirectory - ftruncate error %u." ENDLINE), errno);
+        return false;
+    }
+
+    void *pMap = mmap(nullptr, nBytes, PROT_READ|PROT_WRITE, MAP_SHARED,
+        m_hDirFile, 0);
+    if (MAP_FAILED == pMap)
+    {
+        Log.tinyprintf(T("CHashFile::MapDirectory - mmap error %u." ENDLINE), errno);
+        return false;
+    }
+
+    if (0 != m_nDirMap)
+    {
+        munmap(m_pDir, m_nDirMap);
+    }
+    m_pDir = static_cast<HF_PFILEOFFSET>(pMap);
+    m_nDirMap = nBytes;
+    return true;
+}
+
+// SwitchToMapped
+//
+// Called after the file set has been opened (and created or rebuilt, if
+// necessary) through the page cache. The cache is written out, both files are
+// mapped, and the cache is released.
+//
+bool CHashFile::SwitchToMapped(void)
+{
+    Sync();
+    WriteDirectory();
+
+    try
+    {
+        m_pScratch = new unsigned char[HF_SIZEOF_PAGE];
+    }
+    catch (...)
+    {
+        ; // Nothing.
+    }
+    if (nullptr == m_pScratch)
+    {
+        return false;
+    }
+
+    if (!MapPageFile(oEndOfFile))
+    {
+        UnmapAll();
+        return false;
+    }
+
+    HF_PFILEOFFSET pDir = m_pDir;
+    m_pDir = nullptr;
+    if (!MapDirectory(m_nDir))
+    {
+        m_pDir = pDir;
+        UnmapAll();
+        return false;
+    }
+    memcpy(m_pDir, pDir, m_nDir * sizeof(HF_FILEOFFSET));
+    delete [] pDir;
+
+    if (m_hpCacheLookup)
+    {
+        delete [] m_hpCacheLookup;
+        m_hpCacheLookup = nullptr;
+    }
+    FinalCache();
+    m_bMapped = true;
+    return true;
+}
+
+void CHashFile::UnmapAll(void)
+{
+    if (0 != m_nDirMap)
+    {
+        munmap(m_pDir, m_nDirMap);
+        m_pDir = nullptr;
+        m_nDirMap = 0;
+    }
+    if (nullptr != m_pPageMap)
+    {
+        munmap(m_pPageMap, m_nPageMap);
+        m_pPageMap = nullptr;
+        m_nPageMap = 0;
+    }
+    if (nullptr != m_pScratch)
+    {
+        delete [] m_pScratch;
+        m_pScratch = nullptr;
+    }
+    m_bMapped = false;
+}
+
+CHashPage *CHashFile::MapPage(UINT32 iFileDir)
+{
+    HF_FILEOFFSET oPage = m_pDir[iFileDir];
+    if (  oEndOfFile < HF_SIZEOF_PAGE
+       || oEndOfFile - HF_SIZEOF_PAGE < oPage)
+    {
+        Log.tinyprintf(T("CHashFile::MapPage - Directory entry (0x%08X) points past the end of the page file." ENDLINE),
+            iFileDir);
+        return nullptr;
+    }
+    m_hpMapped.Attach(m_pPageMap + oPage, HF_SIZEOF_PAGE);
+    return &m_hpMapped;
+}
+
+bool CHashFile::InsertMapped(HP_HEAPLENGTH nRecord, UINT32 nHash, void *pRecord)
+{
+    for (;;)
+    {
+        UINT32 iFileDir = nHash >> (32-m_nDirDepth);
+        if (iFileDir >= m_nDir)
+        {
+            Log.WriteString(T("CHashFile::Insert - iFileDir out of range." ENDLINE));
+            return false;
+        }
+        CHashPage *php = MapPage(iFileDir);
+        if (nullptr == php)
+        {
+            Log.WriteString(T("CHashFile::Insert - Page wasn\xE2\x80\x99t valid." ENDLINE));
+            return false;
+        }
+        cs_whits++;
+
+        UINT32 nStart, nEnd;
+        php->GetRange(m_nDirDepth, nStart, nEnd);
+        if (iFileDir < nStart || nEnd < iFileDir)
+        {
+            Log.tinyprintf(T("CHashFile::Insert - Directory entry (0x%08X) points to the wrong page (0x%08X-0x%08X)." ENDLINE),
+                iFileDir, nStart, nEnd);
+            return false;
+        }
+        int errInserted = php->Insert(nRecord, nHash, pRecord);
+        if (IS_HP_SUCCESS(errInserted))
+        {
+            return true;
+        }
+        else if (HP_INSERT_ERROR_ILLEGAL == errInserted)
+        {
+            return false;
+        }
+
+        HF_FILEOFFSET oOld = m_pDir[iFileDir];
+        if (m_nDirDepth == php->GetDepth())
+        {
+            if (!DoubleDirectory())
+            {
+                return false;
+            }
+        }
+
+        // Split a private copy of the full page. Half of the records are
+        // written back in place, and the other half go to a new page at the
+        // end of the .pag file.
+        //
+        memcpy(m_pScratch, m_pPageMap + oOld, HF_SIZEOF_PAGE);
+        m_hpScratch.Attach(m_pScratch, HF_SIZEOF_PAGE);
+
+        HF_FILEOFFSET oNew = oEndOfFile;
+        if (!MapPageFile(oNew + HF_SIZEOF_PAGE))
+        {
+            return false;
+        }
+        oEndOfFile = oNew + HF_SIZEOF_PAGE;
+
+        m_hpMapped.Attach(m_pPageMap + oOld, HF_SIZEOF_PAGE);
+        m_hpSplit.Attach(m_pPageMap + oNew, HF_SIZEOF_PAGE);
+        if (!m_hpScratch.Split(m_hpMapped, m_hpSplit))
+        {
+            memcpy(m_pPageMap + oOld, m_pScratch, HF_SIZEOF_PAGE);
+            oEndOfFile = oNew;
+            if (0 != ftruncate(m_hPageFile, oEndOfFile))
+            {
+                Log.tinyprintf(T("CHashFile::Insert - ftruncate error %u." ENDLINE), errno);
+            }
+            return false;
+        }
+
+        // Update the directory.
+        //
+        m_hpSplit.GetRange(m_nDirDepth, nStart, nEnd);
+        for ( ; nStart <= nEnd; nStart++)
+        {
+            m_pDir[nStart] = oNew;
+        }
+    }
+}
+
+#endif // UNIX_MAPPED_FILES
+
 #endif // MEMORY_BASED
 
 CHashTable::CHashTable(void)
@@ -130,6 +130,9 @@ private:
     int             m_iDir;
     int             m_nProbesLeft;
     UINT32          m_nDirEmptyTrigger;
+#if !defined(MEMORY_BASED) && defined(UNIX_MAPPED_FILES)
+    bool            m_bAttached;
+#endif // !MEMORY_BASED && UNIX_MAPPED_FILES
 
 #ifdef HP_PROTECTION
     bool ValidateAllocatedBlock(UINT32 iDir);
@@ -168,6 +171,9 @@ public:
 #if !defined(MEMORY_BASED)
     bool WritePage(HANDLE hFile, HF_FILEOFFSET oWhere);
     bool ReadPage(HANDLE hFile, HF_FILEOFFSET oWhere);
+#if defined(UNIX_MAPPED_FILES)
+    void Attach(unsigned char *pPage, unsigned int nPageSize);
+#endif // UNIX_MAPPED_FILES
 #endif // MEMORY_BASED
 
     UINT32 GetDepth(void);
@@ -212,7 +218,25 @@ private:
     HF_CACHE        *m_Cache;
     int             m_nCache;
     HF_PFILEOFFSET  m_pDir;
+#if defined(UNIX_MAPPED_FILES)
+    bool            m_bMapped;
+    unsigned char  *m_pPageMap;
+    size_t          m_nPageMap;
+    size_t          m_nDirMap;
+    CHashPage       m_hpMapped;
+    CHashPage       m_hpSplit;
+    CHashPage       m_hpScratch;
+    unsigned char  *m_pScratch;
+
+    bool MapPageFile(HF_FILEOFFSET oSize);
+    bool MapDirectory(unsigned int nDir);
+    bool SwitchToMapped(void);
+    void UnmapAll(void);
+    CHashPage *MapPage(UINT32 iFileDir);
+    bool InsertMapped(HP_HEAPLENGTH nRecord, UINT32 nHash, void *pRecord);
+#endif // UNIX_MAPPED_FILES
     bool DoubleDirectory(void);
+    CHashPage &CurrentPage(void);
 
     int AllocateEmptyPage(int nSafe, int Safe[]);
     int ReadCache(UINT32 iFileDir, int *pHits);
@@ -226,6 +250,7 @@ private:
     void FinalCache(void);
 
     bool CreateFileSet(const UTF8 *szDirFile, const UTF8 *szPageFile);
+    int OpenFileSet(const UTF8 *szDirFile, const UTF8 *szPageFile, int nCachePages);
     bool RebuildDirectory(void);
     bool ReadDirectory(void);
 
@@ -60,6 +60,9 @@ void dispatch_DatabaseDump(void *pUnused, int iUnused)
         mudstate.debug_cmd = T("< dump >");
 #if defined(HAVE_WORKING_FORK)
         if (mudstate.dumping)
+#else // HAVE_WORKING_FORK
+        if (db_checkpoint_active())
+#endif // HAVE_WORKING_FORK
         {
             // There is a dump in progress. These usually happen very quickly.
             // We will reschedule ourselves to try again in 20 seconds.
@@ -69,7 +72,6 @@ void dispatch_DatabaseDump(void *pUnused, int iUnused)
             nNextTimeInSeconds = 20;
         }
         else
-#endif // HAVE_WORKING_FORK
         {
             fork_and_dump(0);
         }
@@ -372,7 +374,7 @@ bool CTaskHeap::Insert(PTASK_RECORD pTask, SCHCMP *pfCompare)
     }
     pTask->m_iVisitedMark = m_iVisitedMark-1;
 
-    m_pHeap[m_nCurrent] = pTask;
+    Assign(m_nCurrent, pTask);
     m_nCurrent++;
     SiftUp(m_nCurrent-1, pfCompare);
     return true;
@@ -472,6 +474,15 @@ static int ComparePriority(PTASK_RECORD pTaskA, PTASK_RECORD pTaskB)
     int i = (pTaskA->iPriority) - (pTaskB->iPriority);
     if (i == 0)
     {
+        if (pTaskA->m_iShareTag < pTaskB->m_iShareTag)
+        {
+            return -1;
+        }
+        else if (pTaskA->m_iShareTag > pTaskB->m_iShareTag)
+        {
+            return 1;
+        }
+
         // Must subtract so that ticket rollover is handled properly.
         //
         return  (pTaskA->m_Ticket) - (pTaskB->m_Ticket);
@@ -499,71 +510,588 @@ static int CompareWhen(PTASK_RECORD pTaskA, PTASK_RECORD pTaskB)
     }
 }
 
-void CScheduler::DeferTask(const CLinearTimeAbsolute& ltaWhen, int iPriority,
-                           FTASK *fpTask, void *arg_voidptr, int arg_Integer)
+static int qsort_CompareWhen(const void *pA, const void *pB)
 {
-    PTASK_RECORD pTask = new TASK_RECORD;
-    if (!pTask) return;
+    return CompareWhen(*(PTASK_RECORD *)pA, *(PTASK_RECORD *)pB);
+}
 
-    pTask->ltaWhen = ltaWhen;
-    pTask->iPriority = iPriority;
-    pTask->fpTask = fpTask;
-    pTask->arg_voidptr = arg_voidptr;
-    pTask->arg_Integer = arg_Integer;
-    pTask->m_Ticket = m_Ticket++;
+static INT64 WheelTick(CLinearTimeAbsolute &lta)
+{
+    return lta.Return100ns() / WHEEL_TICK;
+}
+
+CTaskWheel::CTaskWheel(void)
+{
+    for (int i = 0; i <= WHEEL_OVERFLOW; i++)
+    {
+        m_apSlots[i] = nullptr;
+    }
+    for (int i = 0; i <= WHEEL_LEVELS; i++)
+    {
+        m_anLevel[i] = 0;
+    }
+    m_nTasks = 0;
+    m_tNow = 0;
+    m_bStarted = false;
+    m_bNextValid = false;
+    m_iVisitedMark = 0;
+}
+
+CTaskWheel::~CTaskWheel(void)
+{
+    for (int i = 0; i <= WHEEL_OVERFLOW; i++)
+    {
+        PTASK_RECORD pTask = m_apSlots[i];
+        while (pTask)
+        {
+            PTASK_RECORD pNext = pTask->m_pNext;
+            delete pTask;
+            pTask = pNext;
+        }
+        m_apSlots[i] = nullptr;
+    }
+}
+
+// The wheel starts turning from the current time. Tasks scheduled before
+// that (or immediately) are filed in the current slot.
+//
+void CTaskWheel::Start(void)
+{
+    CLinearTimeAbsolute ltaNow;
+    ltaNow.GetUTC();
+    m_tNow = WheelTick(ltaNow);
+    m_bStarted = true;
+}
+
+void CTaskWheel::File(PTASK_RECORD pTask)
+{
+    INT64 t = WheelTick(pTask->ltaWhen);
+    if (t < m_tNow)
+    {
+        t = m_tNow;
+    }
+
+    INT64 d = t - m_tNow;
+    int iLevel;
+    int iSlot = WHEEL_OVERFLOW;
+    for (iLevel = 0; iLevel < WHEEL_LEVELS; iLevel++)
+    {
+        if (d < (static_cast<INT64>(1) << (WHEEL_BITS*(iLevel+1))))
+        {
+            iSlot = iLevel*WHEEL_SLOTS
+                  + static_cast<int>((t >> (WHEEL_BITS*iLevel)) & WHEEL_MASK);
+            break;
+        }
+    }
+
+    pTask->m_iSlot = iSlot;
+    pTask->m_pPrev = nullptr;
+    pTask->m_pNext = m_apSlots[iSlot];
+    if (pTask->m_pNext)
+    {
+        pTask->m_pNext->m_pPrev = pTask;
+    }
+    m_apSlots[iSlot] = pTask;
+    m_anLevel[iLevel]++;
+}
+
+void CTaskWheel::Unfile(PTASK_RECORD pTask)
+{
+    int iSlot = pTask->m_iSlot;
+    if (pTask->m_pPrev)
+    {
+        pTask->m_pPrev->m_pNext = pTask->m_pNext;
+    }
+    else
+    {
+        m_apSlots[iSlot] = pTask->m_pNext;
+    }
+    if (pTask->m_pNext)
+    {
+        pTask->m_pNext->m_pPrev = pTask->m_pPrev;
+    }
+    pTask->m_pNext = nullptr;
+    pTask->m_pPrev = nullptr;
+    pTask->m_iSlot = -1;
+    m_anLevel[iSlot/WHEEL_SLOTS]--;
+}
+
+// Re-file the tasks in the current slot of a level (or the overflow list)
+// now that the wheel has turned far enough for them to fit on a lower
+// level.
+//
+void CTaskWheel::Cascade(int iLevel)
+{
+    int iSlot = WHEEL_OVERFLOW;
+    if (iLevel < WHEEL_LEVELS)
+    {
+        iSlot = iLevel*WHEEL_SLOTS
+              + static_cast<int>((m_tNow >> (WHEEL_BITS*iLevel)) & WHEEL_MASK);
+    }
+
+    PTASK_RECORD pTask = m_apSlots[iSlot];
+    m_apSlots[iSlot] = nullptr;
+    while (pTask)
+    {
+        PTASK_RECORD pNext = pTask->m_pNext;
+        m_anLevel[iLevel]--;
+        File(pTask);
+        pTask = pNext;
+    }
+}
+
+void CTaskWheel::Insert(PTASK_RECORD pTask)
+{
+    if (!m_bStarted)
+    {
+        Start();
+    }
+    pTask->m_iVisitedMark = m_iVisitedMark-1;
+    File(pTask);
+    m_nTasks++;
+
+    if (  m_bNextValid
+       && pTask->ltaWhen < m_ltaNext)
+    {
+        m_ltaNext = pTask->ltaWhen;
+    }
+}
+
+void CTaskWheel::Remove(PTASK_RECORD pTask)
+{
+    if (pTask->m_iSlot < 0)
+    {
+        return;
+    }
+    Unfile(pTask);
+    m_nTasks--;
+
+    if (  m_bNextValid
+       && pTask->ltaWhen <= m_ltaNext)
+    {
+        m_bNextValid = false;
+    }
+}
+
+void CTaskWheel::Update(PTASK_RECORD pTask)
+{
+    Remove(pTask);
+    Insert(pTask);
+}
+
+// Turn the wheel up to ltaNow, and return the tasks that are due as a list
+// linked through m_pNext.
+//
+PTASK_RECORD CTaskWheel::RemoveReady(const CLinearTimeAbsolute& ltaNow)
+{
+    if (!m_bStarted)
+    {
+        Start();
+    }
+
+    CLinearTimeAbsolute lta(ltaNow);
+    INT64 tTarget = WheelTick(lta);
+    PTASK_RECORD pReady = nullptr;
+    PTASK_RECORD pTask;
+
+    while (m_tNow < tTarget)
+    {
+        if (0 == m_nTasks)
+        {
+            m_tNow = tTarget;
+            break;
+        }
+
+        // Everything in the current slot of the first level is due.
+        //
+        int iSlot = static_cast<int>(m_tNow & WHEEL_MASK);
+        while (nullptr != (pTask = m_apSlots[iSlot]))
+        {
+            Remove(pTask);
+            pTask->m_pNext = pReady;
+            pReady = pTask;
+        }
+
+        // Turn the wheel. Empty levels are passed over a whole slot at a
+        // time rather than a tick at a time.
+        //
+        int iLevel = 0;
+        while (  iLevel < WHEEL_LEVELS
+              && 0 == m_anLevel[iLevel])
+        {
+            iLevel++;
+        }
+
+        INT64 tNext = m_tNow + 1;
+        if (0 < iLevel)
+        {
+            tNext = (m_tNow | ((static_cast<INT64>(1) << (WHEEL_BITS*iLevel)) - 1)) + 1;
+            if (tTarget < tNext)
+            {
+                m_tNow = tTarget;
+                break;
+            }
+        }
+        m_tNow = tNext;
+
+        for (iLevel = 1; iLevel <= WHEEL_LEVELS; iLevel++)
+        {
+            if (0 != (m_tNow & ((static_cast<INT64>(1) << (WHEEL_BITS*iLevel)) - 1)))
+            {
+                break;
+            }
+            Cascade(iLevel);
+        }
+    }
+
+    // Tasks in the slot for this tick may not be due yet.
+    //
+    pTask = m_apSlots[m_tNow & WHEEL_MASK];
+    while (pTask)
+    {
+        PTASK_RECORD pNext = pTask->m_pNext;
+        if (pTask->ltaWhen < ltaNow)
+        {
+            Remove(pTask);
+            pTask->m_pNext = pReady;
+            pReady = pTask;
+        }
+        pTask = pNext;
+    }
+    return pReady;
+}
+
+bool CTaskWheel::EarliestInSlot(int iSlot, CLinearTimeAbsolute *pltaWhen)
+{
+    PTASK_RECORD pTask = m_apSlots[iSlot];
+    if (nullptr == pTask)
+    {
+        return false;
+    }
+
+    *pltaWhen = pTask->ltaWhen;
+    for (pTask = pTask->m_pNext; pTask; pTask = pTask->m_pNext)
+    {
+        if (pTask->ltaWhen < *pltaWhen)
+        {
+            *pltaWhen = pTask->ltaWhen;
+        }
+    }
+    return true;
+}
+
+bool CTaskWheel::WhenNext(CLinearTimeAbsolute *pltaWhen)
+{
+    if (0 == m_nTasks)
+    {
+        return false;
+    }
+    if (m_bNextValid)
+    {
+        *pltaWhen = m_ltaNext;
+        return true;
+    }
 
-    // Must add to the WhenHeap so that network is still serviced.
+    // On each level, the first occupied slot ahead of the wheel holds that
+    // level's earliest task. The current slot on a level above the first
+    // holds tasks a full turn ahead, so it is looked at last. A slot is
+    // only searched if it could start before the best time so far.
     //
-    if (!m_WhenHeap.Insert(pTask, CompareWhen))
+    bool bFound = false;
+    CLinearTimeAbsolute ltaSlot;
+    for (int iLevel = 0; iLevel < WHEEL_LEVELS; iLevel++)
     {
-        delete pTask;
+        if (0 == m_anLevel[iLevel])
+        {
+            continue;
+        }
+
+        int nShift = WHEEL_BITS*iLevel;
+        int iFirst = (0 == iLevel) ? 0 : 1;
+        for (int i = iFirst; i < iFirst + WHEEL_SLOTS; i++)
+        {
+            INT64 t = ((m_tNow >> nShift) + i) << nShift;
+            int iSlot = iLevel*WHEEL_SLOTS + static_cast<int>((t >> nShift) & WHEEL_MASK);
+            if (nullptr == m_apSlots[iSlot])
+            {
+                continue;
+            }
+
+            ltaSlot.Set100ns(t*WHEEL_TICK);
+            if (  !bFound
+               || ltaSlot < m_ltaNext)
+            {
+                if (EarliestInSlot(iSlot, &ltaSlot))
+                {
+                    if (  !bFound
+                       || ltaSlot < m_ltaNext)
+                    {
+                        m_ltaNext = ltaSlot;
+                        bFound = true;
+                    }
+                }
+            }
+            break;
+        }
+    }
+
+    if (  0 != m_anLevel[WHEEL_LEVELS]
+       && EarliestInSlot(WHEEL_OVERFLOW, &ltaSlot)
+       && (  !bFound
+          || ltaSlot < m_ltaNext))
+    {
+        m_ltaNext = ltaSlot;
+        bFound = true;
+    }
+
+    m_bNextValid = bFound;
+    *pltaWhen = m_ltaNext;
+    return bFound;
+}
+
+void CTaskWheel::CancelTask(FTASK *fpTask, void *arg_voidptr, int arg_Integer)
+{
+    for (int i = 0; i <= WHEEL_OVERFLOW; i++)
+    {
+        for (PTASK_RECORD p = m_apSlots[i]; p; p = p->m_pNext)
+        {
+            if (  p->fpTask == fpTask
+               && p->arg_voidptr == arg_voidptr
+               && p->arg_Integer == arg_Integer)
+            {
+                p->fpTask = nullptr;
+            }
+        }
+    }
+}
+
+// Like CTaskHeap::TraverseUnordered, this visits every record exactly once
+// even if records are updated or removed along the way.
+//
+int CTaskWheel::TraverseUnordered(SCHLOOK *pfLook)
+{
+    m_iVisitedMark++;
+    if (m_iVisitedMark == 0)
+    {
+        for (int i = 0; i <= WHEEL_OVERFLOW; i++)
+        {
+            for (PTASK_RECORD p = m_apSlots[i]; p; p = p->m_pNext)
+            {
+                p->m_iVisitedMark = m_iVisitedMark;
+            }
+        }
+        m_iVisitedMark++;
     }
+
+    int bUnvisitedRecords;
+    do
+    {
+        bUnvisitedRecords = false;
+        for (int i = 0; i <= WHEEL_OVERFLOW; i++)
+        {
+            PTASK_RECORD p = m_apSlots[i];
+            while (p)
+            {
+                PTASK_RECORD pNext = p->m_pNext;
+                if (p->m_iVisitedMark != m_iVisitedMark)
+                {
+                    bUnvisitedRecords = true;
+                    p->m_iVisitedMark = m_iVisitedMark;
+
+                    int cmd = pfLook(p);
+                    switch (cmd)
+                    {
+                    case IU_REMOVE_TASK:
+                        Remove(p);
+                        delete p;
+                        break;
+
+                    case IU_DONE:
+                        return false;
+
+                    case IU_UPDATE_TASK:
+                        Update(p);
+                        p->m_iVisitedMark = m_iVisitedMark;
+                        break;
+                    }
+                }
+                p = pNext;
+            }
+        }
+    } while (bUnvisitedRecords);
+    return true;
 }
 
-void CScheduler::DeferImmediateTask(int iPriority, FTASK *fpTask, void *arg_voidptr, int arg_Integer)
+// Visit the records in When-order. Records may be updated along the way,
+// but they are not re-filed until the traversal is finished.
+//
+int CTaskWheel::TraverseOrdered(SCHLOOK *pfLook)
 {
-    PTASK_RECORD pTask = new TASK_RECORD;
-    if (!pTask) return;
+    if (0 == m_nTasks)
+    {
+        return true;
+    }
 
-    //pTask->ltaWhen = ltaWhen;
-    pTask->iPriority = iPriority;
-    pTask->fpTask = fpTask;
-    pTask->arg_voidptr = arg_voidptr;
-    pTask->arg_Integer = arg_Integer;
-    pTask->m_Ticket = m_Ticket++;
+    PTASK_RECORD *ap = nullptr;
+    try
+    {
+        ap = new PTASK_RECORD[m_nTasks];
+    }
+    catch (...)
+    {
+        ; // Nothing.
+    }
+
+    if (nullptr == ap)
+    {
+        return false;
+    }
+
+    int n = 0;
+    for (int i = 0; i <= WHEEL_OVERFLOW; i++)
+    {
+        for (PTASK_RECORD p = m_apSlots[i]; p; p = p->m_pNext)
+        {
+            ap[n++] = p;
+        }
+    }
+    qsort(ap, n, sizeof(PTASK_RECORD), qsort_CompareWhen);
 
-    // Must add to the WhenHeap so that network is still serviced.
+    int i;
+    for (i = 0; i < n; i++)
+    {
+        int cmd = pfLook(ap[i]);
+        if (IU_DONE == cmd)
+        {
+            break;
+        }
+        else if (IU_UPDATE_TASK != cmd)
+        {
+            ap[i] = nullptr;
+        }
+    }
+
+    for (int j = 0; j < i && j < n; j++)
+    {
+        if (nullptr != ap[j])
+        {
+            Update(ap[j]);
+        }
+    }
+    delete [] ap;
+    return true;
+}
+
+static PTASK_RECORD NewTask(int iPriority, INT64 iShareTag, int iTicket, FTASK *fpTask, void *arg_voidptr, int arg_Integer)
+{
+    PTASK_RECORD pTask = nullptr;
+    try
+    {
+        pTask = new TASK_RECORD;
+    }
+    catch (...)
+    {
+        ; // Nothing.
+    }
+
+    if (nullptr != pTask)
+    {
+        pTask->iPriority = iPriority;
+        pTask->m_iShareTag = iShareTag;
+        pTask->fpTask = fpTask;
+        pTask->arg_voidptr = arg_voidptr;
+        pTask->arg_Integer = arg_Integer;
+        pTask->m_Ticket = iTicket;
+        pTask->m_iVisitedMark = 0;
+        pTask->m_iHeapIndex = -1;
+        pTask->m_iSlot = -1;
+        pTask->m_pNext = nullptr;
+        pTask->m_pPrev = nullptr;
+    }
+    return pTask;
+}
+
+PTASK_RECORD CScheduler::DeferTask(const CLinearTimeAbsolute& ltaWhen, int iPriority,
+                           FTASK *fpTask, void *arg_voidptr, int arg_Integer)
+{
+    PTASK_RECORD pTask = NewTask(iPriority, m_iVirtualTime, m_Ticket++, fpTask, arg_voidptr, arg_Integer);
+    if (!pTask) return nullptr;
+
+    pTask->ltaWhen = ltaWhen;
+
+    // Must add to the WhenWheel so that network is still serviced.
     //
-    if (!m_WhenHeap.Insert(pTask, CompareWhen))
+    m_WhenWheel.Insert(pTask);
+    return pTask;
+}
+
+PTASK_RECORD CScheduler::DeferImmediateTask(int iPriority, FTASK *fpTask, void *arg_voidptr, int arg_Integer)
+{
+    PTASK_RECORD pTask = NewTask(iPriority, m_iVirtualTime, m_Ticket++, fpTask, arg_voidptr, arg_Integer);
+    if (!pTask) return nullptr;
+
+    // Must add to the WhenWheel so that network is still serviced.
+    //
+    m_WhenWheel.Insert(pTask);
+    return pTask;
+}
+
+// Remove a task that has not run yet and free it. A task which has already
+// been taken off the queues to run is only disarmed.
+//
+void CScheduler::RemoveTask(PTASK_RECORD pTask)
+{
+    if (0 <= pTask->m_iSlot)
+    {
+        m_WhenWheel.Remove(pTask);
+    }
+    else if (0 <= pTask->m_iHeapIndex)
+    {
+        m_PriorityHeap.Remove(pTask, ComparePriority);
+    }
+    else
+    {
+        pTask->fpTask = nullptr;
+        return;
+    }
+    delete pTask;
+}
+
+// Re-file a task after its ltaWhen or iPriority has been changed.
+//
+void CScheduler::UpdateTask(PTASK_RECORD pTask)
+{
+    if (0 <= pTask->m_iSlot)
+    {
+        m_WhenWheel.Update(pTask);
+    }
+    else if (0 <= pTask->m_iHeapIndex)
     {
-        delete pTask;
+        m_PriorityHeap.Update(pTask, ComparePriority);
     }
 }
 
 void CScheduler::CancelTask(FTASK *fpTask, void *arg_voidptr, int arg_Integer)
 {
-    m_WhenHeap.CancelTask(fpTask, arg_voidptr, arg_Integer);
+    m_WhenWheel.CancelTask(fpTask, arg_voidptr, arg_Integer);
     m_PriorityHeap.CancelTask(fpTask, arg_voidptr, arg_Integer);
 }
 
 void CScheduler::ReadyTasks(const CLinearTimeAbsolute& ltaNow)
 {
-    // Move ready-to-run tasks off the WhenHeap and onto the PriorityHeap.
+    // Move ready-to-run tasks off the WhenWheel and onto the PriorityHeap.
     //
-    PTASK_RECORD pTask = m_WhenHeap.PeekAtTopmost();
-    while (  pTask
-          && pTask->ltaWhen < ltaNow)
+    PTASK_RECORD pTask = m_WhenWheel.RemoveReady(ltaNow);
+    while (pTask)
     {
-        pTask = m_WhenHeap.RemoveTopmost(CompareWhen);
-        if (pTask)
+        PTASK_RECORD pNext = pTask->m_pNext;
+        pTask->m_pNext = nullptr;
+        if (  nullptr == pTask->fpTask
+           || !m_PriorityHeap.Insert(pTask, ComparePriority))
         {
-            if (  nullptr == pTask->fpTask
-               || !m_PriorityHeap.Insert(pTask, ComparePriority))
-            {
-                delete pTask;
-            }
+            delete pTask;
         }
-        pTask = m_WhenHeap.PeekAtTopmost();
+        pTask = pNext;
     }
 }
 
@@ -601,6 +1129,10 @@ int CScheduler::RunTasks(int iCount)
         {
             if (pTask->fpTask)
             {
+                if (m_iVirtualTime < pTask->m_iShareTag)
+                {
+                    m_iVirtualTime = pTask->m_iShareTag;
+                }
                 pTask->fpTask(pTask->arg_voidptr, pTask->arg_Integer);
                 nTasks++;
             }
@@ -638,15 +1170,9 @@ bool CScheduler::WhenNext(CLinearTimeAbsolute  *ltaWhen)
         }
     }
 
-    // Check the When Queue next.
+    // Check the When Wheel next.
     //
-    pTask = m_WhenHeap.PeekAtTopmost();
-    if (pTask)
-    {
-        *ltaWhen = pTask->ltaWhen;
-        return true;
-    }
-    return false;
+    return m_WhenWheel.WhenNext(ltaWhen);
 }
 
 #define HEAP_LEFT_CHILD(x) (2*(x)+1)
@@ -673,11 +1199,11 @@ void CTaskHeap::SiftDown(int iSubRoot, SCHCMP *pfCompare)
         if (pfCompare(Ref, m_pHeap[child]) <= 0)
             break;
 
-        m_pHeap[parent] = m_pHeap[child];
+        Assign(parent, m_pHeap[child]);
         parent = child;
         child = HEAP_LEFT_CHILD(parent);
     }
-    m_pHeap[parent] = Ref;
+    Assign(parent, Ref);
 }
 
 void CTaskHeap::SiftUp(int child, SCHCMP *pfCompare)
@@ -690,8 +1216,8 @@ void CTaskHeap::SiftUp(int child, SCHCMP *pfCompare)
 
         PTASK_RECORD Tmp;
         Tmp = m_pHeap[child];
-        m_pHeap[child] = m_pHeap[parent];
-        m_pHeap[parent] = Tmp;
+        Assign(child, m_pHeap[parent]);
+        Assign(parent, Tmp);
 
         child = parent;
     }
@@ -702,15 +1228,24 @@ PTASK_RECORD CTaskHeap::Remove(int iNode, SCHCMP *pfCompare)
     if (iNode < 0 || m_nCurrent <= iNode) return nullptr;
 
     PTASK_RECORD pTask = m_pHeap[iNode];
+    pTask->m_iHeapIndex = -1;
 
     m_nCurrent--;
-    m_pHeap[iNode] = m_pHeap[m_nCurrent];
-    SiftDown(iNode, pfCompare);
-    SiftUp(iNode, pfCompare);
+    if (iNode < m_nCurrent)
+    {
+        Assign(iNode, m_pHeap[m_nCurrent]);
+        SiftDown(iNode, pfCompare);
+        SiftUp(iNode, pfCompare);
+    }
 
     return pTask;
 }
 
+void CTaskHeap::Remove(PTASK_RECORD pTask, SCHCMP *pfCompare)
+{
+    Remove(pTask->m_iHeapIndex, pfCompare);
+}
+
 void CTaskHeap::Update(int iNode, SCHCMP *pfCompare)
 {
     if (iNode < 0 || m_nCurrent <= iNode)
@@ -722,9 +1257,14 @@ void CTaskHeap::Update(int iNode, SCHCMP *pfCompare)
     SiftUp(iNode, pfCompare);
 }
 
+void CTaskHeap::Update(PTASK_RECORD pTask, SCHCMP *pfCompare)
+{
+    Update(pTask->m_iHeapIndex, pfCompare);
+}
+
 void CScheduler::TraverseUnordered(SCHLOOK *pfLook)
 {
-    if (m_WhenHeap.TraverseUnordered(pfLook, CompareWhen))
+    if (m_WhenWheel.TraverseUnordered(pfLook))
     {
         m_PriorityHeap.TraverseUnordered(pfLook, ComparePriority);
     }
@@ -733,7 +1273,7 @@ void CScheduler::TraverseUnordered(SCHLOOK *pfLook)
 void CScheduler::TraverseOrdered(SCHLOOK *pfLook)
 {
     m_PriorityHeap.TraverseOrdered(pfLook, ComparePriority);
-    m_WhenHeap.TraverseOrdered(pfLook, CompareWhen);
+    m_WhenWheel.TraverseOrdered(pfLook);
 }
 
 // The following guarantees that in spite of any changes to the heap
@@ -779,7 +1319,7 @@ int CTaskHeap::TraverseUnordered(SCHLOOK *pfLook, SCHCMP *pfCompare)
             switch (cmd)
             {
             case IU_REMOVE_TASK:
-                Remove(i, pfCompare);
+                delete Remove(i, pfCompare);
                 break;
 
             case IU_DONE:
@@ -822,8 +1362,8 @@ void CTaskHeap::Sort(SCHCMP *pfCompare)
     while (m_nCurrent--)
     {
         PTASK_RECORD p = m_pHeap[m_nCurrent];
-        m_pHeap[m_nCurrent] = m_pHeap[0];
-        m_pHeap[0] = p;
+        Assign(m_nCurrent, m_pHeap[0]);
+        Assign(0, p);
         SiftDown(0, pfCompare);
     }
     m_nCurrent = s_nCurrent;
@@ -847,6 +1387,5 @@ void CScheduler::SetMinPriority(int arg_minPriority)
 
 void CScheduler::Shrink(void)
 {
-    m_WhenHeap.Shrink();
     m_PriorityHeap.Shrink();
 }
@@ -0,0 +1,382 @@
+/*! \file utf8bench.cpp
+ * \brief Time the ASCII fast paths against the UTF-8 state machines.
+ *
+ * Builds a buffer of text shaped like typical game output -- mostly ASCII
+ * with an occasional accented letter or symbol -- and runs each operation
+ * both ways: a code point at a time through the state machine, and with the
+ * ASCII runs taken by asciiscan.cpp first.  Both must produce the same
+ * answer.
+ *
+ * Usage: utf8bench [iterations]
+ */
+
+#include "copyright.h"
+#include "autoconf.h"
+#include "config.h"
+#include "utf8tables.h"
+#include "asciiscan.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_SIZE 8000
+
+static UTF8 aSource[BENCH_SIZE];
+static UTF8 aResult1[2*BENCH_SIZE];
+static UTF8 aResult2[2*BENCH_SIZE];
+
+static const char *aPhrases[] =
+{
+    "The Grand Hall stretches out before you, its vaulted ceiling lost in shadow. ",
+    "Wizard says, \"Welcome to the game! Type 'help' to get started.\"\r\n",
+    "You see a [brass lantern], a (worn map), and 3 gold coins here.\r\n",
+    "Obvious exits: North <N>, South <S>, Up <U>.\r\n",
+    "\xC3\x89lodie waves to the caf\xC3\xA9 crowd. ",
+    "Temperature: 21\xC2\xB0" "C -- na\xC3\xAFve r\xC3\xA9sum\xC3\xA9 \xE2\x80\x94 done.\r\n",
+};
+
+static void build_source(void)
+{
+    // Four ASCII phrases for every accented one.
+    //
+    static const int aOrder[] = { 0, 1, 2, 4, 3, 0, 2, 1, 3, 5 };
+    size_t n = 0;
+    for (int i = 0; ; i = (i + 1) % (sizeof(aOrder)/sizeof(aOrder[0])))
+    {
+        const char *p = aPhrases[aOrder[i]];
+        size_t m = strlen(p);
+        if (BENCH_SIZE - 1 < n + m)
+        {
+            break;
+        }
+        memcpy(aSource + n, p, m);
+        n += m;
+    }
+    aSource[n] = '\0';
+}
+
+static inline size_t point_size(UTF8 ch)
+{
+    if (ch < 0x80)
+    {
+        return 1;
+    }
+    else if (ch < 0xE0)
+    {
+        return 2;
+    }
+    else if (ch < 0xF0)
+    {
+        return 3;
+    }
+    return 4;
+}
+
+static bool walk_print(const UTF8 *p)
+{
+    int iState = CL_PRINT_START_STATE;
+    do
+    {
+        unsigned char iColumn = cl_print_itt[*p++];
+        unsigned short iOffset = cl_print_sot[iState];
+        for (;;)
+        {
+            int y = cl_print_sbt[iOffset];
+            if (y < 128)
+            {
+                if (iColumn < y)
+                {
+                    iState = cl_print_sbt[iOffset+1];
+                    break;
+                }
+                iColumn = static_cast<unsigned char>(iColumn - y);
+                iOffset += 2;
+            }
+            else
+            {
+                y = 256-y;
+                if (iColumn < y)
+                {
+                    iState = cl_print_sbt[iOffset+iColumn+1];
+                    break;
+                }
+                iColumn = static_cast<unsigned char>(iColumn - y);
+                iOffset = static_cast<unsigned short>(iOffset + y + 1);
+            }
+        }
+    } while (iState < CL_PRINT_ACCEPTING_STATES_START);
+    return 1 == iState - CL_PRINT_ACCEPTING_STATES_START;
+}
+
+static UTF8 walk_latin1(const UTF8 *p)
+{
+    int iState = TR_LATIN1_START_STATE;
+    do
+    {
+        unsigned char iColumn = tr_latin1_itt[*p++];
+        unsigned short iOffset = tr_latin1_sot[iState];
+        for (;;)
+        {
+            int y = tr_latin1_sbt[iOffset];
+            if (y < 128)
+            {
+                if (iColumn < y)
+                {
+                    iState = tr_latin1_sbt[iOffset+1];
+                    break;
+                }
+                iColumn = static_cast<unsigned char>(iColumn - y);
+                iOffset += 2;
+            }
+            else
+            {
+                y = 256-y;
+                if (iColumn < y)
+                {
+                    iState = tr_latin1_sbt[iOffset+iColumn+1];
+                    break;
+                }
+                iColumn = static_cast<unsigned char>(iColumn - y);
+                iOffset = static_cast<unsigned short>(iOffset + y + 1);
+            }
+        }
+    } while (iState < TR_LATIN1_ACCEPTING_STATES_START);
+    return static_cast<UTF8>(iState - TR_LATIN1_ACCEPTING_STATES_START);
+}
+
+// Count code points.
+//
+static size_t count_slow(const UTF8 *p)
+{
+    size_t n = 0;
+    while ('\0' != *p)
+    {
+        p += point_size(*p);
+        n++;
+    }
+    return n;
+}
+
+static size_t count_fast(const UTF8 *p)
+{
+    size_t n = 0;
+    while ('\0' != *p)
+    {
+        size_t nAscii = ascii_span(p);
+        if (0 < nAscii)
+        {
+            p += nAscii;
+            n += nAscii;
+            continue;
+        }
+        p += point_size(*p);
+        n++;
+    }
+    return n;
+}
+
+// Count printable code points.
+//
+static size_t print_slow(const UTF8 *p)
+{
+    size_t n = 0;
+    while ('\0' != *p)
+    {
+        if (walk_print(p))
+        {
+            n++;
+        }
+        p += point_size(*p);
+    }
+    return n;
+}
+
+static size_t print_fast(const UTF8 *p)
+{
+    size_t n = 0;
+    while ('\0' != *p)
+    {
+        if (  *p < 0x80
+           ? (0x20 <= *p && *p < 0x7F)
+           : walk_print(p))
+        {
+            n++;
+        }
+        p += point_size(*p);
+    }
+    return n;
+}
+
+// Convert to Latin-1.
+//
+static size_t latin1_slow(const UTF8 *p, UTF8 *q)
+{
+    UTF8 *q0 = q;
+    while ('\0' != *p)
+    {
+        *q++ = walk_latin1(p);
+        p += point_size(*p);
+    }
+    *q = '\0';
+    return q - q0;
+}
+
+static size_t latin1_fast(const UTF8 *p, UTF8 *q)
+{
+    UTF8 *q0 = q;
+    while ('\0' != *p)
+    {
+        size_t nAscii = ascii_printable_span(p);
+        if (0 < nAscii)
+        {
+            memcpy(q, p, nAscii);
+            q += nAscii;
+            p += nAscii;
+            continue;
+        }
+        *q++ = walk_latin1(p);
+        p += point_size(*p);
+    }
+    *q = '\0';
+    return q - q0;
+}
+
+// Fold ASCII letters to lower case and copy everything else.
+//
+static size_t lower_slow(const UTF8 *p, UTF8 *q)
+{
+    UTF8 *q0 = q;
+    while ('\0' != *p)
+    {
+        UTF8 ch = *p++;
+        if ('A' <= ch && ch <= 'Z')
+        {
+            ch ^= 0x20;
+        }
+        *q++ = ch;
+    }
+    *q = '\0';
+    return q - q0;
+}
+
+static size_t lower_fast(const UTF8 *p, UTF8 *q)
+{
+    UTF8 *q0 = q;
+    while ('\0' != *p)
+    {
+        size_t nAscii = ascii_lower(q, p, 2*BENCH_SIZE);
+        if (0 < nAscii)
+        {
+            q += nAscii;
+            p += nAscii;
+            continue;
+        }
+        *q++ = *p++;
+    }
+    *q = '\0';
+    return q - q0;
+}
+
+static double seconds(clock_t t)
+{
+    return static_cast<double>(t)/CLOCKS_PER_SEC;
+}
+
+static void report(const char *pName, clock_t tSlow, clock_t tFast, bool bSame)
+{
+    double s = seconds(tSlow);
+    double f = seconds(tFast);
+    printf("%-10s %9.3fs %9.3fs %7.2fx %s\n", pName, s, f,
+        (0.0 < f) ? s/f : 0.0, bSame ? "" : "MISMATCH");
+}
+
+int main(int argc, char *argv[])
+{
+    int nIterations = 20000;
+    if (2 <= argc)
+    {
+        nIterations = atoi(argv[1]);
+        if (nIterations <= 0)
+        {
+            nIterations = 1;
+        }
+    }
+
+    build_source();
+    size_t nSource = strlen((char *)aSource);
+    size_t nAscii = 0;
+    for (size_t i = 0; i < nSource; i++)
+    {
+        if (aSource[i] < 0x80)
+        {
+            nAscii++;
+        }
+    }
+    printf("%s scan, %d iterations over %u bytes (%u%% ASCII)\n",
+        ascii_scan_method(), nIterations, static_cast<unsigned>(nSource),
+        static_cast<unsigned>(100*nAscii/nSource));
+    printf("%-10s %10s %10s %8s\n", "", "machine", "prefilter", "speedup");
+
+    volatile size_t nSink = 0;
+    size_t r1 = 0, r2 = 0;
+    clock_t t0, tSlow, tFast;
+
+    t0 = clock();
+    for (int i = 0; i < nIterations; i++)
+    {
+        nSink += r1 = count_slow(aSource);
+    }
+    tSlow = clock() - t0;
+    t0 = clock();
+    for (int i = 0; i < nIterations; i++)
+    {
+        nSink += r2 = count_fast(aSource);
+    }
+    tFast = clock() - t0;
+    report("strlen", tSlow, tFast, r1 == r2);
+
+    t0 = clock();
+    for (int i = 0; i < nIterations; i++)
+    {
+        nSink += r1 = print_slow(aSource);
+    }
+    tSlow = clock() - t0;
+    t0 = clock();
+    for (int i = 0; i < nIterations; i++)
+    {
+        nSink += r2 = print_fast(aSource);
+    }
+    tFast = clock() - t0;
+    report("isprint", tSlow, tFast, r1 == r2);
+
+    t0 = clock();
+    for (int i = 0; i < nIterations; i++)
+    {
+        nSink += r1 = latin1_slow(aSource, aResult1);
+    }
+    tSlow = clock() - t0;
+    t0 = clock();
+    for (int i = 0; i < nIterations; i++)
+    {
+        nSink += r2 = latin1_fast(aSource, aResult2);
+    }
+    tFast = clock() - t0;
+    report("latin1", tSlow, tFast, r1 == r2 && 0 == memcmp(aResult1, aResult2, r1));
+
+    t0 = clock();
+    for (int i = 0; i < nIterations; i++)
+    {
+        nSink += r1 = lower_slow(aSource, aResult1);
+    }
+    tSlow = clock() - t0;
+    t0 = clock();
+    for (int i = 0; i < nIterations; i++)
+    {
+        nSink += r2 = lower_fast(aSource, aResult2);
+    }
+    tFast = clock() - t0;
+    report("lower", tSlow, tFast, r1 == r2 && 0 == memcmp(aResult1, aResult2, r1));
+
+    return 0;
+}
@@ -6,7 +6,7 @@
 #include "copyright.h"
 #include "autoconf.h"
 #include "config.h"
-#include "externs.h"
+#include "utf8tables.h"
 
 // utf/cl_Printable.txt
 //
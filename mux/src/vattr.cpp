@@ -609,11 +609,13 @@ void do_dbclean(dbref executor, dbref caller, dbref enactor, int eval, int key)
 
 #if defined(HAVE_WORKING_FORK)
     if (mudstate.dumping)
+#else // HAVE_WORKING_FORK
+    if (db_checkpoint_active())
+#endif // HAVE_WORKING_FORK
     {
         notify(executor, T("Dumping in progress. Try again later."));
         return;
     }
-#endif // HAVE_WORKING_FORK
 #ifndef MEMORY_BASED
     // Save cached modified attribute list
     //
@@ -626,6 +628,7 @@ void do_dbclean(dbref executor, dbref caller, dbref enactor, int eval, int key)
     notify(executor, T("Removing stale attributes names..."));
     int cVAttributes = dbclean_RemoveStaleAttributeNames();
     notify(executor, T("Renumbering and compacting attribute numbers..."));
+    lock_cache_flush();
     dbclean_RenumberAttributes(cVAttributes);
     notify(executor, tprintf(T("Next Attribute number to allocate: %d"), mudstate.attr_next));
     notify(executor, T("Checking Integrity of the attribute data structures..."));
@@ -635,6 +638,10 @@ void do_dbclean(dbref executor, dbref caller, dbref enactor, int eval, int key)
 
 void vattr_delete_LEN(UTF8 *pName, size_t nName)
 {
+    // Compiled locks may refer to this attribute by number.
+    //
+    lock_cache_flush();
+
     // Delete from hashtable.
     //
     UINT32 nHash = HASH_ProcessBuffer(0, pName, nName);
@@ -659,6 +666,10 @@ void vattr_delete_LEN(UTF8 *pName, size_t nName)
 
 ATTR *vattr_rename_LEN(UTF8 *pOldName, size_t nOldName, UTF8 *pNewName, size_t nNewName)
 {
+    // Compiled locks may refer to this attribute by its old name.
+    //
+    lock_cache_flush();
+
     // Find and Delete old name from hashtable.
     //
     UINT32 nHash = HASH_ProcessBuffer(0, pOldName, nOldName);
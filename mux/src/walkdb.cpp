@@ -127,6 +127,42 @@ void do_find(dbref executor, dbref caller, dbref enactor, int eval, int key, UTF
 // ---------------------------------------------------------------------------
 // get_stats, do_stats: Get counts of items in the db.
 //
+static void stats_count(STATS *info, dbref i)
+{
+    info->s_total++;
+    if (Going(i) && (Typeof(i) != TYPE_ROOM))
+    {
+        info->s_garbage++;
+        return;
+    }
+    switch (Typeof(i))
+    {
+    case TYPE_ROOM:
+
+        info->s_rooms++;
+        break;
+
+    case TYPE_EXIT:
+
+        info->s_exits++;
+        break;
+
+    case TYPE_THING:
+
+        info->s_things++;
+        break;
+
+    case TYPE_PLAYER:
+
+        info->s_players++;
+        break;
+
+    default:
+
+        info->s_garbage++;
+    }
+}
+
 bool get_stats(dbref player, dbref who, STATS *info)
 {
     // Do we have permission?
@@ -152,41 +188,24 @@ bool get_stats(dbref player, dbref who, STATS *info)
     info->s_garbage = 0;
 
     dbref i;
-    DO_WHOLE_DB(i)
+    if (  NOTHING != who
+       && Good_dbref(who)
+       && db_indexed())
     {
-        if ((who == NOTHING) || (who == Owner(i)))
+        // Only the objects on who's owner chain need to be counted.
+        //
+        for (i = IndexFirst(who, IX_OWNER); NOTHING != i; i = IndexNext(i, IX_OWNER))
         {
-            info->s_total++;
-            if (Going(i) && (Typeof(i) != TYPE_ROOM))
+            stats_count(info, i);
+        }
+    }
+    else
+    {
+        DO_WHOLE_DB(i)
+        {
+            if ((who == NOTHING) || (who == Owner(i)))
             {
-                info->s_garbage++;
-                continue;
-            }
-            switch (Typeof(i))
-            {
-            case TYPE_ROOM:
-
-                info->s_rooms++;
-                break;
-
-            case TYPE_EXIT:
-
-                info->s_exits++;
-                break;
-
-            case TYPE_THING:
-
-                info->s_things++;
-                break;
-
-            case TYPE_PLAYER:
-
-                info->s_players++;
-                break;
-
-            default:
-
-                info->s_garbage++;
+                stats_count(info, i);
             }
         }
     }
@@ -775,119 +794,163 @@ bool search_setup(dbref player, UTF8 *searchfor, SEARCH *parm)
     return true;
 }
 
-void search_perform(dbref executor, dbref caller, dbref enactor, SEARCH *parm)
+// Choose the objects a search needs to look at.  When the search is
+// restricted by owner, parent, or zone, only the objects on that index chain
+// within the search range are candidates, and they are returned in dbref
+// order (so results come out the same as a scan would find them).  Otherwise,
+// nullptr is returned, and the whole range must be scanned.
+//
+static dbref *search_candidates(SEARCH *parm, int *pnCandidates)
 {
-    POWER thing1powers, thing2powers;
-    UTF8 *result, *bp;
+    dbref key = NOTHING;
+    int ix = IX_OWNER;
+    if (parm->s_rst_owner != ANY_OWNER)
+    {
+        key = parm->s_rst_owner;
+        ix  = IX_OWNER;
+    }
+    else if (parm->s_parent != NOTHING)
+    {
+        key = parm->s_parent;
+        ix  = IX_PARENT;
+    }
+    else if (parm->s_zone != NOTHING)
+    {
+        key = parm->s_zone;
+        ix  = IX_ZONE;
+    }
 
-    UTF8 *buff = alloc_sbuf("search_perform.num");
-    int save_invk_ctr = mudstate.func_invk_ctr;
+    if (  !db_indexed()
+       || !Good_dbref(key))
+    {
+        *pnCandidates = parm->high_bound - parm->low_bound + 1;
+        return nullptr;
+    }
+    return db_index_collect(key, IX_BIT(ix), parm->low_bound, parm->high_bound, pnCandidates);
+}
 
-    dbref thing;
-    for (thing = parm->low_bound; thing <= parm->high_bound; thing++)
+// Check everything about an object except the eval class.
+//
+static bool search_match(dbref thing, SEARCH *parm)
+{
+    // Check for matching type.
+    //
+    if (  (parm->s_rst_type != NOTYPE)
+       && (parm->s_rst_type != Typeof(thing)))
     {
-        mudstate.func_invk_ctr = save_invk_ctr;
+        return false;
+    }
 
-        // Check for matching type.
-        //
-        if (  (parm->s_rst_type != NOTYPE)
-           && (parm->s_rst_type != Typeof(thing)))
-        {
-            continue;
-        }
+    // Check for matching owner.
+    //
+    if (  (parm->s_rst_owner != ANY_OWNER)
+       && (parm->s_rst_owner != Owner(thing)))
+    {
+        return false;
+    }
 
-        // Check for matching owner.
-        //
-        if (  (parm->s_rst_owner != ANY_OWNER)
-           && (parm->s_rst_owner != Owner(thing)))
-        {
-            continue;
-        }
+    // Toss out destroyed things.
+    //
+    if (Going(thing))
+    {
+        return false;
+    }
 
-        // Toss out destroyed things.
-        //
-        if (Going(thing))
-        {
-            continue;
-        }
+    // Check for matching parent.
+    //
+    if (  (parm->s_parent != NOTHING)
+       && (parm->s_parent != Parent(thing)))
+    {
+        return false;
+    }
 
-        // Check for matching parent.
-        //
-        if (  (parm->s_parent != NOTHING)
-           && (parm->s_parent != Parent(thing)))
-        {
-            continue;
-        }
+    // Check for matching zone.
+    //
+    if (  (parm->s_zone != NOTHING)
+       && (parm->s_zone != Zone(thing)))
+    {
+        return false;
+    }
 
-        // Check for matching zone.
-        //
-        if (  (parm->s_zone != NOTHING)
-           && (parm->s_zone != Zone(thing)))
+    // Check for matching flags.
+    //
+    for (int i = FLAG_WORD1; i <= FLAG_WORD3; i++)
+    {
+        FLAG f = parm->s_fset.word[i];
+        if ((db[thing].fs.word[i] & f) != f)
         {
-            continue;
+            return false;
         }
+    }
 
-        // Check for matching flags.
-        //
-        bool b = false;
-        for (int i = FLAG_WORD1; i <= FLAG_WORD3; i++)
-        {
-            FLAG f = parm->s_fset.word[i];
-            if ((db[thing].fs.word[i] & f) != f)
-            {
-                b = true;
-                break;
-            }
-        }
-        if (b)
-        {
-            continue;
-        }
+    // Check for matching power.
+    //
+    POWER thing1powers = Powers(thing);
+    POWER thing2powers = Powers2(thing);
+    if ((thing1powers & parm->s_pset.word1) != parm->s_pset.word1)
+    {
+        return false;
+    }
+    if ((thing2powers & parm->s_pset.word2) != parm->s_pset.word2)
+    {
+        return false;
+    }
 
-        // Check for matching power.
-        //
-        thing1powers = Powers(thing);
-        thing2powers = Powers2(thing);
-        if ((thing1powers & parm->s_pset.word1) != parm->s_pset.word1)
-        {
-            continue;
-        }
-        if ((thing2powers & parm->s_pset.word2) != parm->s_pset.word2)
+    // Check for matching name.
+    //
+    if (parm->s_rst_name != nullptr)
+    {
+        if (!string_prefix(PureName(thing), parm->s_rst_name))
         {
-            continue;
+            return false;
         }
+    }
+    return true;
+}
 
-        // Check for matching name.
-        //
-        if (parm->s_rst_name != nullptr)
-        {
-            if (!string_prefix(PureName(thing), parm->s_rst_name))
-                continue;
-        }
+// Check the eval class.  buff is a scratch SBUF.
+//
+static bool search_eval(dbref executor, dbref caller, dbref enactor,
+                        dbref thing, SEARCH *parm, UTF8 *buff)
+{
+    buff[0] = '#';
+    mux_ltoa(thing, buff+1);
+    UTF8 *buff2 = replace_tokens(parm->s_rst_eval, buff, nullptr, nullptr);
+    UTF8 *result, *bp;
+    result = bp = alloc_lbuf("search_perform");
+    mux_exec(buff2, LBUF_SIZE-1, result, &bp, executor, caller, enactor,
+        EV_FCHECK | EV_EVAL | EV_NOTRACE, nullptr, 0);
+    *bp = '\0';
+    free_lbuf(buff2);
+    bool bPassed = ('\0' != result[0] && xlate(result));
+    free_lbuf(result);
+    return bPassed;
+}
 
-        // Check for successful evaluation.
-        //
-        if (parm->s_rst_eval != nullptr)
+void search_perform(dbref executor, dbref caller, dbref enactor, SEARCH *parm)
+{
+    UTF8 *buff = alloc_sbuf("search_perform.num");
+    int save_invk_ctr = mudstate.func_invk_ctr;
+
+    int nCandidates;
+    dbref *aCandidates = search_candidates(parm, &nCandidates);
+    for (int i = 0; i < nCandidates; i++)
+    {
+        dbref thing = (nullptr == aCandidates) ? parm->low_bound + i : aCandidates[i];
+        mudstate.func_invk_ctr = save_invk_ctr;
+
+        if (  search_match(thing, parm)
+           && (  nullptr == parm->s_rst_eval
+              || search_eval(executor, caller, enactor, thing, parm, buff)))
         {
-            buff[0] = '#';
-            mux_ltoa(thing, buff+1);
-            UTF8 *buff2 = replace_tokens(parm->s_rst_eval, buff, nullptr, nullptr);
-            result = bp = alloc_lbuf("search_perform");
-            mux_exec(buff2, LBUF_SIZE-1, result, &bp, executor, caller, enactor,
-                EV_FCHECK | EV_EVAL | EV_NOTRACE, nullptr, 0);
-            *bp = '\0';
-            free_lbuf(buff2);
-            if (!*result || !xlate(result))
-            {
-                free_lbuf(result);
-                continue;
-            }
-            free_lbuf(result);
+            // It passed everything. Amazing.
+            //
+            olist_add(thing);
         }
-
-        // It passed everything. Amazing.
-        //
-        olist_add(thing);
+    }
+    if (nullptr != aCandidates)
+    {
+        MEMFREE(aCandidates);
     }
     free_sbuf(buff);
     mudstate.func_invk_ctr = save_invk_ctr;
@@ -930,27 +993,12 @@ static void search_mark(dbref player, int key)
     return;
 }
 
-void do_search(dbref executor, dbref caller, dbref enactor, int eval, int key, UTF8 *arg, const UTF8 *cargs[], int ncargs)
+// Display or mark the objects on the current olist.
+//
+static void search_report(dbref executor, int key, SEARCH *parm)
 {
-    UNUSED_PARAMETER(eval);
-    UNUSED_PARAMETER(cargs);
-    UNUSED_PARAMETER(ncargs);
-
     UTF8 *buff, *outbuf, *bp;
     dbref thing, from, to;
-    SEARCH searchparm;
-
-    if ((key != SRCH_SEARCH) && (mudconf.control_flags & CF_DBCHECK))
-    {
-        er_mark_disabled(executor);
-        return;
-    }
-    if (!search_setup(executor, arg, &searchparm))
-    {
-        return;
-    }
-    olist_push();
-    search_perform(executor, caller, enactor, &searchparm);
     bool destitute = true;
     bool flag;
 
@@ -959,7 +1007,6 @@ void do_search(dbref executor, dbref caller, dbref enactor, int eval, int key, U
     if (key != SRCH_SEARCH)
     {
         search_mark(executor, key);
-        olist_pop();
         return;
     }
     outbuf = alloc_lbuf("do_search.outbuf");
@@ -971,8 +1018,8 @@ void do_search(dbref executor, dbref caller, dbref enactor, int eval, int key, U
 
     // Room search.
     //
-    if (  searchparm.s_rst_type == TYPE_ROOM
-       || searchparm.s_rst_type == NOTYPE)
+    if (  parm->s_rst_type == TYPE_ROOM
+       || parm->s_rst_type == NOTYPE)
     {
         flag = true;
         for (thing = olist_first(); thing != NOTHING; thing = olist_next())
@@ -996,8 +1043,8 @@ void do_search(dbref executor, dbref caller, dbref enactor, int eval, int key, U
 
     // Exit search.
     //
-    if (  searchparm.s_rst_type == TYPE_EXIT
-       || searchparm.s_rst_type == NOTYPE)
+    if (  parm->s_rst_type == TYPE_EXIT
+       || parm->s_rst_type == NOTYPE)
     {
         flag = true;
         for (thing = olist_first(); thing != NOTHING; thing = olist_next())
@@ -1039,8 +1086,8 @@ void do_search(dbref executor, dbref caller, dbref enactor, int eval, int key, U
 
     // Object search
     //
-    if (  searchparm.s_rst_type == TYPE_THING
-       || searchparm.s_rst_type == NOTYPE)
+    if (  parm->s_rst_type == TYPE_THING
+       || parm->s_rst_type == NOTYPE)
     {
         flag = true;
         for (thing = olist_first(); thing != NOTHING; thing = olist_next())
@@ -1074,8 +1121,8 @@ void do_search(dbref executor, dbref caller, dbref enactor, int eval, int key, U
 
     // Player search
     //
-    if (  searchparm.s_rst_type == TYPE_PLAYER
-       || searchparm.s_rst_type == NOTYPE)
+    if (  parm->s_rst_type == TYPE_PLAYER
+       || parm->s_rst_type == NOTYPE)
     {
         flag = true;
         for (thing = olist_first(); thing != NOTHING; thing = olist_next())
@@ -1094,7 +1141,7 @@ void do_search(dbref executor, dbref caller, dbref enactor, int eval, int key, U
             buff = unparse_object(executor, thing, 0);
             safe_str(buff, outbuf, &bp);
             free_lbuf(buff);
-            if (searchparm.s_wizard)
+            if (parm->s_wizard)
             {
                 safe_str(T(" [location: "), outbuf, &bp);
                 buff = unparse_object(executor, Location(thing), false);
@@ -1122,6 +1169,256 @@ void do_search(dbref executor, dbref caller, dbref enactor, int eval, int key, U
         notify(executor, outbuf);
     }
     free_lbuf(outbuf);
+}
+
+// Sliced searches.
+//
+// When search_slice is set, a @search or @mark with an eval class runs from
+// the task queue, search_slice milliseconds at a time, so that a slow eval
+// over a large database does not stop the game.  The results are reported
+// once the whole range has been examined.
+//
+typedef struct
+{
+    dbref  executor;
+    dbref  caller;
+    dbref  enactor;
+    int    key;
+    SEARCH parm;
+    dbref *aCandidates;
+    int    nCandidates;
+    int    iNext;
+    dbref *aFound;
+    int    nFound;
+} SEARCH_TASK;
+
+static void search_task_free(SEARCH_TASK *pst)
+{
+    if (nullptr != pst->parm.s_rst_name)
+    {
+        MEMFREE(pst->parm.s_rst_name);
+    }
+    if (nullptr != pst->parm.s_rst_eval)
+    {
+        MEMFREE(pst->parm.s_rst_eval);
+    }
+    if (nullptr != pst->aCandidates)
+    {
+        MEMFREE(pst->aCandidates);
+    }
+    MEMFREE(pst->aFound);
+    delete pst;
+}
+
+// Is the player still allowed to run a search which search_setup() accepted
+// earlier?  This follows the checks there, using the player's current
+// powers and control.
+//
+static bool search_still_permitted(dbref player, SEARCH *parm)
+{
+    parm->s_wizard = Search(player);
+    if (  parm->s_wizard
+       || parm->s_rst_type == TYPE_PLAYER
+       || parm->s_rst_owner == player)
+    {
+        return true;
+    }
+
+    // Without Search, a search of every owner is only allowed for players,
+    // or for the children or zone members of an object the player controls.
+    //
+    if (parm->s_rst_owner == ANY_OWNER)
+    {
+        if (  Good_obj(parm->s_parent)
+           && Controls(player, parm->s_parent))
+        {
+            return true;
+        }
+        if (  Good_obj(parm->s_zone)
+           && Controls(player, parm->s_zone))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void dispatch_Search(void *pArg, int iUnused)
+{
+    UNUSED_PARAMETER(iUnused);
+
+    SEARCH_TASK *pst = (SEARCH_TASK *)pArg;
+    if (  !Good_obj(pst->executor)
+       || Going(pst->executor))
+    {
+        search_task_free(pst);
+        return;
+    }
+
+    // The player's powers and the configuration can change between slices.
+    //
+    if (  pst->key != SRCH_SEARCH
+       && (mudconf.control_flags & CF_DBCHECK))
+    {
+        er_mark_disabled(pst->executor);
+        search_task_free(pst);
+        return;
+    }
+    if (!search_still_permitted(pst->executor, &pst->parm))
+    {
+        notify(pst->executor, T("You need a search warrant to do that!"));
+        search_task_free(pst);
+        return;
+    }
+
+    CLinearTimeDelta ltdSlice;
+    ltdSlice.SetMilliseconds(mudconf.search_slice);
+
+    CLinearTimeAbsolute ltaNow;
+    ltaNow.GetUTC();
+    CLinearTimeAbsolute ltaStop = ltaNow + ltdSlice;
+
+    dbref save_executor = mudstate.curr_executor;
+    dbref save_enactor = mudstate.curr_enactor;
+    mudstate.curr_executor = pst->executor;
+    mudstate.curr_enactor = pst->enactor;
+
+    reg_frame *preserve = save_global_regs();
+
+    UTF8 *buff = alloc_sbuf("dispatch_Search");
+    int save_invk_ctr = mudstate.func_invk_ctr;
+    alarm_clock.set(mudconf.max_cmdsecs);
+
+    while (  pst->iNext < pst->nCandidates
+          && !alarm_clock.alarmed)
+    {
+        dbref thing = (nullptr == pst->aCandidates)
+                    ? pst->parm.low_bound + pst->iNext
+                    : pst->aCandidates[pst->iNext];
+        pst->iNext++;
+        mudstate.func_invk_ctr = save_invk_ctr;
+
+        if (  search_match(thing, &pst->parm)
+           && search_eval(pst->executor, pst->caller, pst->enactor, thing,
+                  &pst->parm, buff))
+        {
+            pst->aFound[pst->nFound++] = thing;
+        }
+
+        ltaNow.GetUTC();
+        if (ltaStop < ltaNow)
+        {
+            break;
+        }
+    }
+
+    bool bAlarmed = alarm_clock.alarmed;
+    alarm_clock.clear();
+    mudstate.func_invk_ctr = save_invk_ctr;
+    free_sbuf(buff);
+
+    restore_global_regs(preserve);
+
+    mudstate.curr_executor = save_executor;
+    mudstate.curr_enactor = save_enactor;
+
+    if (bAlarmed)
+    {
+        notify(pst->executor, T("GAME: Expensive activity abbreviated."));
+        search_task_free(pst);
+        return;
+    }
+
+    if (pst->iNext < pst->nCandidates)
+    {
+        // Let the network and the queue run before the next slice.
+        //
+        CLinearTimeDelta ltdGap;
+        ltdGap.SetMilliseconds(1);
+        scheduler.DeferTask(ltaNow + ltdGap, PRIORITY_PLAYER, dispatch_Search, pst, 0);
+        return;
+    }
+
+    olist_push();
+    for (int i = 0; i < pst->nFound; i++)
+    {
+        olist_add(pst->aFound[i]);
+    }
+    search_report(pst->executor, pst->key, &pst->parm);
+    olist_pop();
+    search_task_free(pst);
+}
+
+static void search_begin_task(dbref executor, dbref caller, dbref enactor,
+                              int key, SEARCH *parm)
+{
+    SEARCH_TASK *pst = nullptr;
+    try
+    {
+        pst = new SEARCH_TASK;
+    }
+    catch (...)
+    {
+        ; // Nothing.
+    }
+    ISOUTOFMEMORY(pst);
+
+    pst->executor = executor;
+    pst->caller   = caller;
+    pst->enactor  = enactor;
+    pst->key      = key;
+    pst->parm     = *parm;
+    pst->iNext    = 0;
+    pst->nFound   = 0;
+
+    // The name and eval class point into the command's buffers, so keep
+    // copies.
+    //
+    if (nullptr != parm->s_rst_name)
+    {
+        pst->parm.s_rst_name = StringClone(parm->s_rst_name);
+    }
+    pst->parm.s_rst_eval = StringClone(parm->s_rst_eval);
+
+    pst->aCandidates = search_candidates(&pst->parm, &pst->nCandidates);
+    if (pst->nCandidates < 0)
+    {
+        pst->nCandidates = 0;
+    }
+    pst->aFound = (dbref *)MEMALLOC((pst->nCandidates + 1) * sizeof(dbref));
+    ISOUTOFMEMORY(pst->aFound);
+
+    scheduler.DeferImmediateTask(PRIORITY_PLAYER, dispatch_Search, pst, 0);
+}
+
+void do_search(dbref executor, dbref caller, dbref enactor, int eval, int key, UTF8 *arg, const UTF8 *cargs[], int ncargs)
+{
+    UNUSED_PARAMETER(eval);
+    UNUSED_PARAMETER(cargs);
+    UNUSED_PARAMETER(ncargs);
+
+    SEARCH searchparm;
+
+    if ((key != SRCH_SEARCH) && (mudconf.control_flags & CF_DBCHECK))
+    {
+        er_mark_disabled(executor);
+        return;
+    }
+    if (!search_setup(executor, arg, &searchparm))
+    {
+        return;
+    }
+
+    if (  nullptr != searchparm.s_rst_eval
+       && 0 < mudconf.search_slice)
+    {
+        search_begin_task(executor, caller, enactor, key, &searchparm);
+        return;
+    }
+
+    olist_push();
+    search_perform(executor, caller, enactor, &searchparm);
+    search_report(executor, key, &searchparm);
     olist_pop();
 }
 